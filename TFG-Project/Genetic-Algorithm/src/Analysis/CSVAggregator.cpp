@@ -0,0 +1,312 @@
+#include "CSVAggregator.h"
+
+#include <CSV/csv2.hpp>
+
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <filesystem>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+
+/// <summary>
+/// CSVAggregator constructor.
+/// </summary>
+/// <param name="outputFolder"> Folder where the aggregated csv files are exported. </param>
+/// <param name="threads"> Number of files parsed at the same time. </param>
+CSVAggregator::CSVAggregator(const std::string& outputFolder, unsigned int threads) :
+	outputFolder(outputFolder),
+	threads(std::max(threads, 1u)) {
+}
+
+/// <summary>
+/// CSVAggregator destructor.
+/// </summary>
+CSVAggregator::~CSVAggregator() {
+
+}
+
+/// <summary>
+/// Finds every csv file inside a folder and its subfolders.
+/// </summary>
+/// <param name="inputFolder"> Folder with the simulations. </param>
+/// <returns> If any csv file has been found. </returns>
+bool CSVAggregator::LoadFolder(const std::string& inputFolder) {
+	if (!std::filesystem::is_directory(inputFolder)) {
+		std::cout << "Could not open the folder " << inputFolder << std::endl;
+		return false;
+	}
+
+	// The aggregated files are not simulations, the output folder is skipped.
+	auto output = std::filesystem::weakly_canonical(outputFolder);
+	paths.clear();
+	for (auto it = std::filesystem::recursive_directory_iterator(inputFolder); it != std::filesystem::recursive_directory_iterator(); ++it) {
+		if (it->is_directory() && std::filesystem::weakly_canonical(it->path()) == output) {
+			it.disable_recursion_pending();
+			continue;
+		}
+		if (it->is_regular_file() && it->path().extension() == ".csv")
+			paths.push_back(it->path().string());
+	}
+	std::sort(paths.begin(), paths.end());
+
+	if (paths.empty()) {
+		std::cout << "No csv files found in " << inputFolder << std::endl;
+		return false;
+	}
+	return true;
+}
+
+/// <summary>
+/// Parses all the files and exports the aggregated results.
+/// </summary>
+void CSVAggregator::Run() {
+	auto start = std::chrono::steady_clock::now();
+
+	files.assign(paths.size(), SimulationFile());
+	std::atomic<size_t> nextFile{ 0 };
+	auto worker = [&]() {
+		for (size_t i = nextFile++; i < paths.size(); i = nextFile++)
+			files[i] = ParseFile(paths[i]);
+	};
+
+	unsigned int workers = std::min<unsigned int>(threads, paths.size());
+	std::vector<std::thread> pool;
+	for (unsigned int i = 0; i < workers; ++i)
+		pool.emplace_back(worker);
+	for (auto& thread : pool)
+		thread.join();
+
+	// Files with the same configuration header are runs of the same configuration.
+	std::map<std::vector<std::string>, std::vector<size_t>> groups;
+	size_t invalidFiles = 0;
+	for (size_t i = 0; i < files.size(); ++i) {
+		if (files[i].valid)
+			groups[files[i].configuration].push_back(i);
+		else
+			invalidFiles++;
+	}
+
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	std::cout << "Parsed " << files.size() - invalidFiles << " simulations (" << invalidFiles << " skipped) in " << seconds << "s on " << workers << " threads, "
+		<< groups.size() << " configurations" << std::endl;
+
+	if (groups.empty())
+		return;
+
+	std::filesystem::create_directories(outputFolder);
+	WriteSummary(groups);
+	WriteConvergence(groups);
+}
+
+/// <summary>
+/// Parses one simulation file.
+/// </summary>
+/// <param name="path"> Csv path. </param>
+/// <returns> File values, not valid if it was not exported by WriteCSV. </returns>
+CSVAggregator::SimulationFile CSVAggregator::ParseFile(const std::string& path) {
+	SimulationFile file;
+
+	csv2::Reader<csv2::delimiter<','>, csv2::quote_character<'"'>, csv2::first_row_is_header<false>, csv2::trim_policy::trim_whitespace> reader;
+	if (!reader.mmap(path))
+		return file;
+
+	// WriteCSV layout: configuration header, configuration values, tournament members, empty row,
+	// generation header, one row per generation and the "Average:" row.
+	const size_t firstGenerationRow = 5;
+	const size_t generationColumns = 5;
+	size_t rowIndex = 0;
+	std::string value;
+	std::vector<std::string> cells;
+	for (const auto row : reader) {
+		// Only the first columns are needed, the rotations and velocities are not read.
+		cells.clear();
+		for (const auto cell : row) {
+			value.clear();
+			cell.read_value(value);
+			cells.push_back(value);
+			if (rowIndex >= firstGenerationRow && cells.size() == generationColumns)
+				break;
+		}
+
+		if (rowIndex == 0) {
+			if (cells.empty() || cells[0] != configurationColumns[0])
+				return file;
+		}
+		else if (rowIndex == 1) {
+			if (cells.size() < legacyConfigurationColumns)
+				return file;
+			cells.resize(configurationColumns.size() - 1);
+			file.configuration = cells;
+		}
+		else if (rowIndex == 2) {
+			file.configuration.push_back((cells.size() > 5) ? cells[5] : "");
+		}
+		else if (rowIndex >= firstGenerationRow) {
+			if (cells.empty() || cells[0].rfind("Average", 0) == 0)
+				break;
+			if (cells.size() < generationColumns)
+				return file;
+
+			GenerationRow generation;
+			generation.deathPercentage = std::strtof(cells[1].c_str(), nullptr);
+			generation.averageFitness = std::strtof(cells[2].c_str(), nullptr);
+			generation.topFitness = std::strtof(cells[3].c_str(), nullptr);
+			generation.minFitness = std::strtof(cells[4].c_str(), nullptr);
+			file.generations.push_back(generation);
+		}
+		rowIndex++;
+	}
+
+	file.valid = !file.generations.empty();
+	return file;
+}
+
+/// <summary>
+/// Mean and standard deviation of some values.
+/// </summary>
+/// <param name="values"> Values. </param>
+/// <returns> Mean and standard deviation. </returns>
+std::pair<float, float> CSVAggregator::MeanDeviation(const std::vector<float>& values) {
+	if (values.empty())
+		return std::pair<float, float>(0.0f, 0.0f);
+
+	float mean = 0.0f;
+	for (auto value : values)
+		mean += value / values.size();
+
+	float variance = 0.0f;
+	for (auto value : values)
+		variance += (value - mean) * (value - mean) / values.size();
+
+	return std::pair<float, float>(mean, std::sqrt(variance));
+}
+
+/// <summary>
+/// Exports the summary table of every configuration.
+/// </summary>
+/// <param name="groups"> Index of the files of every configuration. </param>
+void CSVAggregator::WriteSummary(const std::map<std::vector<std::string>, std::vector<size_t>>& groups) const {
+	std::string title(outputFolder + "/Summary.csv");
+	std::ofstream stream(title);
+	csv2::Writer<csv2::delimiter<','>> writer(stream);
+
+	std::vector<std::string> header = { "Configuration" };
+	header.insert(header.end(), configurationColumns.begin(), configurationColumns.end());
+	header.insert(header.end(), { "Runs", "Generations", "Mean final average fitness", "Std final average fitness", "Mean final top fitness", "Std final top fitness"
+		, "Best top fitness", "Mean death percentage", "Mean convergence generation" });
+
+	std::vector<std::vector<std::string>> rows = { header };
+
+	size_t configuration = 1;
+	for (const auto& [configurationValues, indices] : groups) {
+		std::vector<float> finalAverageFitness;
+		std::vector<float> finalTopFitness;
+		std::vector<float> deathPercentage;
+		std::vector<float> convergenceGeneration;
+		float bestTopFitness = 0.0f;
+		size_t generations = 0;
+
+		for (auto index : indices) {
+			const auto& runGenerations = files[index].generations;
+			generations = std::max(generations, runGenerations.size());
+			finalAverageFitness.push_back(runGenerations.back().averageFitness);
+			finalTopFitness.push_back(runGenerations.back().topFitness);
+
+			float runDeath = 0.0f;
+			float runBestTopFitness = 0.0f;
+			for (const auto& generation : runGenerations) {
+				runDeath += generation.deathPercentage / runGenerations.size();
+				runBestTopFitness = std::max(runBestTopFitness, generation.topFitness);
+			}
+			deathPercentage.push_back(runDeath);
+			bestTopFitness = std::max(bestTopFitness, runBestTopFitness);
+
+			// First generation reaching 95% of the best top fitness of the run.
+			for (size_t i = 0; i < runGenerations.size(); ++i) {
+				if (runGenerations[i].topFitness >= 0.95f * runBestTopFitness) {
+					convergenceGeneration.push_back(static_cast<float>(i + 1));
+					break;
+				}
+			}
+		}
+
+		auto averageFitness = MeanDeviation(finalAverageFitness);
+		auto topFitness = MeanDeviation(finalTopFitness);
+
+		std::vector<std::string> row = { std::to_string(configuration++) };
+		row.insert(row.end(), configurationValues.begin(), configurationValues.end());
+		row.insert(row.end(), {
+			std::to_string(indices.size()), std::to_string(generations), std::to_string(averageFitness.first), std::to_string(averageFitness.second)
+			, std::to_string(topFitness.first), std::to_string(topFitness.second), std::to_string(bestTopFitness)
+			, std::to_string(MeanDeviation(deathPercentage).first), std::to_string(MeanDeviation(convergenceGeneration).first)
+		});
+		rows.push_back(row);
+	}
+
+	writer.write_rows(rows);
+	stream.close();
+
+	std::cout << title << " exported\n";
+}
+
+/// <summary>
+/// Exports the convergence curve of every configuration.
+/// </summary>
+/// <param name="groups"> Index of the files of every configuration. </param>
+void CSVAggregator::WriteConvergence(const std::map<std::vector<std::string>, std::vector<size_t>>& groups) const {
+	size_t configuration = 1;
+	for (const auto& [configurationValues, indices] : groups) {
+		std::string title(outputFolder + "/Convergence" + std::to_string(configuration++) + ".csv");
+		std::ofstream stream(title);
+		csv2::Writer<csv2::delimiter<','>> writer(stream);
+
+		std::vector<std::vector<std::string>> rows =
+		{
+			{"Generation", "Runs", "Mean average fitness", "Std average fitness", "Mean top fitness", "Std top fitness", "Min top fitness", "Max top fitness"
+			, "Mean min fitness", "Mean death percentage"}
+		};
+
+		size_t generations = 0;
+		for (auto index : indices)
+			generations = std::max(generations, files[index].generations.size());
+
+		// Runs may have different lengths, every generation uses the runs that reached it.
+		std::vector<float> averageFitness;
+		std::vector<float> topFitness;
+		std::vector<float> minFitness;
+		std::vector<float> deathPercentage;
+		for (size_t i = 0; i < generations; ++i) {
+			averageFitness.clear();
+			topFitness.clear();
+			minFitness.clear();
+			deathPercentage.clear();
+			for (auto index : indices) {
+				const auto& runGenerations = files[index].generations;
+				if (i >= runGenerations.size())
+					continue;
+				averageFitness.push_back(runGenerations[i].averageFitness);
+				topFitness.push_back(runGenerations[i].topFitness);
+				minFitness.push_back(runGenerations[i].minFitness);
+				deathPercentage.push_back(runGenerations[i].deathPercentage);
+			}
+
+			auto average = MeanDeviation(averageFitness);
+			auto top = MeanDeviation(topFitness);
+			rows.push_back({
+				std::to_string(i + 1), std::to_string(topFitness.size()), std::to_string(average.first), std::to_string(average.second)
+				, std::to_string(top.first), std::to_string(top.second), std::to_string(*std::min_element(topFitness.begin(), topFitness.end()))
+				, std::to_string(*std::max_element(topFitness.begin(), topFitness.end())), std::to_string(MeanDeviation(minFitness).first)
+				, std::to_string(MeanDeviation(deathPercentage).first)
+			});
+		}
+
+		writer.write_rows(rows);
+		stream.close();
+	}
+
+	std::cout << groups.size() << " convergence curves exported to " << outputFolder << "\n";
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+#include <utility>
+
+/// <summary>
+/// Aggregates the csv files exported by GeneticAlgorithm::WriteCSV.
+/// Every file is memory mapped and parsed in parallel, the runs are grouped by their configuration header
+/// and a summary table and the convergence curve of every configuration are exported.
+/// </summary>
+class CSVAggregator {
+	public:
+		/// <summary>
+		/// CSVAggregator constructor.
+		/// </summary>
+		/// <param name="outputFolder"> Folder where the aggregated csv files are exported. </param>
+		/// <param name="threads"> Number of files parsed at the same time. </param>
+		CSVAggregator(const std::string& outputFolder, unsigned int threads);
+
+		/// <summary>
+		/// CSVAggregator destructor.
+		/// </summary>
+		~CSVAggregator();
+
+		/// <summary>
+		/// Finds every csv file inside a folder and its subfolders.
+		/// </summary>
+		/// <param name="inputFolder"> Folder with the simulations. </param>
+		/// <returns> If any csv file has been found. </returns>
+		bool LoadFolder(const std::string& inputFolder);
+
+		/// <summary>
+		/// Parses all the files and exports the aggregated results.
+		/// </summary>
+		void Run();
+
+	private:
+		/// <summary>
+		/// Population values of one generation.
+		/// </summary>
+		struct GenerationRow {
+			float deathPercentage = 0.0f;
+			float averageFitness = 0.0f;
+			float topFitness = 0.0f;
+			float minFitness = 0.0f;
+		};
+
+		/// <summary>
+		/// Values of one simulation file.
+		/// </summary>
+		struct SimulationFile {
+			bool valid = false;
+			std::vector<std::string> configuration;
+			std::vector<GenerationRow> generations;
+		};
+
+		/// <summary>
+		/// Parses one simulation file.
+		/// </summary>
+		/// <param name="path"> Csv path. </param>
+		/// <returns> File values, not valid if it was not exported by WriteCSV. </returns>
+		static SimulationFile ParseFile(const std::string& path);
+
+		/// <summary>
+		/// Mean and standard deviation of some values.
+		/// </summary>
+		/// <param name="values"> Values. </param>
+		/// <returns> Mean and standard deviation. </returns>
+		static std::pair<float, float> MeanDeviation(const std::vector<float>& values);
+
+		/// <summary>
+		/// Exports the summary table of every configuration.
+		/// </summary>
+		/// <param name="groups"> Index of the files of every configuration. </param>
+		void WriteSummary(const std::map<std::vector<std::string>, std::vector<size_t>>& groups) const;
+
+		/// <summary>
+		/// Exports the convergence curve of every configuration.
+		/// </summary>
+		/// <param name="groups"> Index of the files of every configuration. </param>
+		void WriteConvergence(const std::map<std::vector<std::string>, std::vector<size_t>>& groups) const;
+
+		/// <summary>
+		/// Configuration columns of the WriteCSV header, tournament members is in the third row.
+		/// </summary>
+		inline static const std::vector<std::string> configurationColumns = {
+			"Population size", "Life span (sec)", "Max generations", "New genes probability", "Mutation rate", "Selection function", "Crossover operator"
+			, "Heuristic tries", "Terrain amplitude", "Terrain", "Physics", "Joint integration", "Physics step frames", "Gait extrapolation", "Feasibility screen"
+			, "Environments", "Environment fitness", "Environment slope", "Environment gravity", "Environment phase (sec)", "Tournament members"
+		};
+
+		/// <summary>
+		/// Configuration columns of the files exported before the terrain, physics and environment columns, the missing ones are left empty.
+		/// </summary>
+		static const size_t legacyConfigurationColumns = 7;
+
+		/// <summary>
+		/// Paths of the csv files.
+		/// </summary>
+		std::vector<std::string> paths;
+
+		/// <summary>
+		/// Parsed files, same order as paths.
+		/// </summary>
+		std::vector<SimulationFile> files;
+
+		/// <summary>
+		/// Folder where the aggregated csv files are exported.
+		/// </summary>
+		std::string outputFolder;
+
+		/// <summary>
+		/// Number of files parsed at the same time.
+		/// </summary>
+		unsigned int threads = 1;
+};
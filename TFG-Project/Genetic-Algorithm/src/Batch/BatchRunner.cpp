@@ -0,0 +1,601 @@
+#include "BatchRunner.h"
+#include "GaitDetector.h"
+#include "Environment.h"
+
+#include <GeneticAlgorithm/GeneticAlgorithm.h>
+#include <Physics/PhysicsWorld.h>
+#include <Physics/FeasibilityAnalyzer.h>
+#include <Physics/MeshLibrary.h>
+#include <Entities/Compositions/ESkeleton.h>
+#include <Entities/EMesh.h>
+#include <Utils/Utils.h>
+#include <Utils/Profiler.h>
+#include <Utils/Metrics.h>
+#include <Utils/WorkerPool.h>
+
+#include <CSV/csv2.hpp>
+#include <RANDOM/random.hpp>
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <functional>
+#include <filesystem>
+#include <thread>
+#include <atomic>
+#include <limits>
+#include <chrono>
+#include <cmath>
+#include <map>
+#include <memory>
+
+/// <summary>
+/// BatchRunner constructor.
+/// </summary>
+/// <param name="outputFolder"> Folder where the csv files are exported. </param>
+/// <param name="threads"> Number of simulations running at the same time. </param>
+BatchRunner::BatchRunner(const std::string& outputFolder, unsigned int threads) :
+	outputFolder(outputFolder),
+	threads(std::max(threads, 1u)) {
+}
+
+/// <summary>
+/// BatchRunner destructor.
+/// </summary>
+BatchRunner::~BatchRunner() {
+
+}
+
+/// <summary>
+/// Reads the sweep file and creates every configuration to run.
+/// </summary>
+/// <param name="sweepPath"> Sweep file path. </param>
+/// <returns> If the sweep file is valid. </returns>
+bool BatchRunner::LoadSweep(const std::string& sweepPath) {
+	std::ifstream file(sweepPath);
+	if (!file.is_open()) {
+		std::cout << "Sweep file " << sweepPath << " not found" << std::endl;
+		return false;
+	}
+
+	auto trim = [](std::string value) {
+		value.erase(0, value.find_first_not_of(" \t\r"));
+		value.erase(value.find_last_not_of(" \t\r") + 1);
+		return value;
+	};
+
+	auto toUpper = [](std::string value) {
+		std::transform(value.begin(), value.end(), value.begin(), [](unsigned char c) { return std::toupper(c); });
+		return value;
+	};
+
+	// Every parameter that can be swept and how to assign it.
+	std::vector<std::pair<std::string, std::function<bool(Config::Parameters&, const std::string&)>>> setters = {
+		{"populationSize", [](Config::Parameters& parameters, const std::string& value) { parameters.populationSize = std::stoi(value); return parameters.populationSize >= 2; }},
+		{"generationLifeSpan", [](Config::Parameters& parameters, const std::string& value) { parameters.generationLifeSpan = std::stoi(value); return parameters.generationLifeSpan > 0; }},
+		{"maxGenerations", [](Config::Parameters& parameters, const std::string& value) { parameters.maxGenerations = std::stoi(value); return parameters.maxGenerations > 0; }},
+		{"newGenProbability", [](Config::Parameters& parameters, const std::string& value) { parameters.newGenProbability = std::stof(value); return parameters.newGenProbability >= 0 && parameters.newGenProbability <= 1; }},
+		{"mutationProbability", [](Config::Parameters& parameters, const std::string& value) { parameters.mutationProbability = std::stof(value); return parameters.mutationProbability >= 0 && parameters.mutationProbability <= 1; }},
+		{"selectionFunction", [&toUpper](Config::Parameters& parameters, const std::string& value) {
+			if (toUpper(value) == "ROULETTE") parameters.selectionFunction = Config::SelectionFunction::ROULETTE;
+			else if (toUpper(value) == "TOURNAMENT") parameters.selectionFunction = Config::SelectionFunction::TOURNAMENT;
+			else return false;
+			return true;
+		}},
+		{"tournamentMembers", [](Config::Parameters& parameters, const std::string& value) { parameters.tournamentMembers = std::stoi(value); return parameters.tournamentMembers >= 2; }},
+		{"crossoverType", [&toUpper](Config::Parameters& parameters, const std::string& value) {
+			if (toUpper(value) == "HEURISTIC") parameters.crossoverType = Config::CrossoverType::HEURISTIC;
+			else if (toUpper(value) == "ARITHMETIC") parameters.crossoverType = Config::CrossoverType::ARITHMETIC;
+			else if (toUpper(value) == "AVERAGE") parameters.crossoverType = Config::CrossoverType::AVERAGE;
+			else if (toUpper(value) == "ONEPOINT") parameters.crossoverType = Config::CrossoverType::ONEPOINT;
+			else return false;
+			return true;
+		}},
+		{"heuristicTries", [](Config::Parameters& parameters, const std::string& value) { parameters.heuristicTries = std::stoi(value); return parameters.heuristicTries > 0; }},
+		{"terrainAmplitude", [](Config::Parameters& parameters, const std::string& value) { parameters.terrainAmplitude = std::stof(value); return parameters.terrainAmplitude >= 0; }},
+		{"terrainSeed", [](Config::Parameters& parameters, const std::string& value) { parameters.terrainSeed = std::stoul(value); return true; }},
+		{"terrainImage", [](Config::Parameters& parameters, const std::string& value) { parameters.terrainImage = value; return std::filesystem::exists(value); }},
+		{"physicsBackend", [&toUpper](Config::Parameters& parameters, const std::string& value) {
+			if (toUpper(value) == "KINEMATIC") parameters.physicsBackend = Config::PhysicsBackendType::KINEMATIC;
+			else if (toUpper(value) == "ARTICULATED") parameters.physicsBackend = Config::PhysicsBackendType::ARTICULATED;
+			else return false;
+			return true;
+		}},
+		{"jointIntegration", [&toUpper](Config::Parameters& parameters, const std::string& value) {
+			if (toUpper(value) == "FIXED") parameters.jointIntegration = Config::JointIntegration::FIXED;
+			else if (toUpper(value) == "EVENT") parameters.jointIntegration = Config::JointIntegration::EVENT;
+			else return false;
+			return true;
+		}},
+		{"physicsStepFrames", [](Config::Parameters& parameters, const std::string& value) { parameters.physicsStepFrames = std::stoi(value); return parameters.physicsStepFrames > 0; }},
+		{"gaitExtrapolation", [&toUpper](Config::Parameters& parameters, const std::string& value) {
+			if (toUpper(value) == "OFF") parameters.gaitExtrapolation = Config::GaitExtrapolation::OFF;
+			else if (toUpper(value) == "ON") parameters.gaitExtrapolation = Config::GaitExtrapolation::ON;
+			else if (toUpper(value) == "VERIFY") parameters.gaitExtrapolation = Config::GaitExtrapolation::VERIFY;
+			else return false;
+			return true;
+		}},
+		{"feasibilityScreen", [&toUpper](Config::Parameters& parameters, const std::string& value) {
+			if (toUpper(value) == "NONE") parameters.feasibilityScreen = Config::FeasibilityScreen::NONE;
+			else if (toUpper(value) == "FLAG") parameters.feasibilityScreen = Config::FeasibilityScreen::FLAG;
+			else if (toUpper(value) == "REJECT") parameters.feasibilityScreen = Config::FeasibilityScreen::REJECT;
+			else return false;
+			return true;
+		}},
+		{"environments", [](Config::Parameters& parameters, const std::string& value) { parameters.environments = std::stoi(value); return parameters.environments >= 1; }},
+		{"environmentFitness", [&toUpper](Config::Parameters& parameters, const std::string& value) {
+			if (toUpper(value) == "MEAN") parameters.environmentFitness = Config::EnvironmentFitness::MEAN;
+			else if (toUpper(value) == "MIN") parameters.environmentFitness = Config::EnvironmentFitness::MIN;
+			else if (toUpper(value) == "QUANTILE") parameters.environmentFitness = Config::EnvironmentFitness::QUANTILE;
+			else return false;
+			return true;
+		}},
+		{"environmentQuantile", [](Config::Parameters& parameters, const std::string& value) { parameters.environmentQuantile = std::stof(value); return parameters.environmentQuantile >= 0 && parameters.environmentQuantile <= 1; }},
+		{"environmentSlope", [](Config::Parameters& parameters, const std::string& value) { parameters.environmentSlope = std::stof(value); return parameters.environmentSlope >= 0 && parameters.environmentSlope < 90; }},
+		{"environmentGravity", [](Config::Parameters& parameters, const std::string& value) { parameters.environmentGravity = std::stof(value); return parameters.environmentGravity > -1; }},
+		{"environmentPhase", [](Config::Parameters& parameters, const std::string& value) { parameters.environmentPhase = std::stof(value); return parameters.environmentPhase >= 0; }},
+	};
+
+	// Values of every parameter, the ones not in the file keep the actual configuration.
+	std::map<std::string, std::vector<std::string>> values;
+	std::string line;
+	int lineNumber = 0;
+	while (std::getline(file, line)) {
+		lineNumber++;
+		line = trim(line.substr(0, line.find('#')));
+		if (line.empty())
+			continue;
+
+		auto separator = line.find('=');
+		if (separator == std::string::npos) {
+			std::cout << sweepPath << ":" << lineNumber << " expected \"parameter = value, value...\"" << std::endl;
+			return false;
+		}
+
+		std::string key = trim(line.substr(0, separator));
+		std::vector<std::string> keyValues;
+		std::stringstream stream(line.substr(separator + 1));
+		std::string value;
+		while (std::getline(stream, value, ',')) {
+			if (!trim(value).empty())
+				keyValues.push_back(trim(value));
+		}
+
+		if (keyValues.empty()) {
+			std::cout << sweepPath << ":" << lineNumber << " " << key << " has no values" << std::endl;
+			return false;
+		}
+
+		if (key == "seeds") {
+			seeds.clear();
+			for (const auto& seed : keyValues) {
+				// Digits only, and the seed has to fit in an unsigned int.
+				unsigned long value = 0;
+				bool valid = seed.find_first_not_of("0123456789") == std::string::npos;
+				try {
+					value = valid ? std::stoul(seed) : 0;
+				}
+				catch (const std::exception&) {
+					valid = false;
+				}
+				if (!valid || value > std::numeric_limits<unsigned int>::max()) {
+					std::cout << sweepPath << ":" << lineNumber << " invalid seed " << seed << std::endl;
+					return false;
+				}
+				seeds.push_back(static_cast<unsigned int>(value));
+			}
+			continue;
+		}
+
+		auto setter = std::find_if(setters.begin(), setters.end(), [&key](const auto& setter) { return setter.first == key; });
+		if (setter == setters.end()) {
+			std::cout << sweepPath << ":" << lineNumber << " unknown parameter " << key << std::endl;
+			return false;
+		}
+
+		// Check the values before running anything.
+		for (const auto& keyValue : keyValues) {
+			Config::Parameters parameters = Config::GetParameters();
+			bool valid = false;
+			try {
+				valid = setter->second(parameters, keyValue);
+			}
+			catch (const std::exception&) {
+				valid = false;
+			}
+			if (!valid) {
+				std::cout << sweepPath << ":" << lineNumber << " invalid value " << keyValue << " for " << key << std::endl;
+				return false;
+			}
+		}
+
+		values[key] = keyValues;
+	}
+
+	// Cartesian product of all the values.
+	// Tournament members only matter with tournament selection, tries only with heuristic crossover
+	// the terrain seed and image only with a heightfield and the environment values only with more than one environment, so those repetitions are skipped.
+	auto setterIndex = [&setters](const std::string& key) {
+		return (size_t)std::distance(setters.begin(), std::find_if(setters.begin(), setters.end(), [&key](const auto& setter) { return setter.first == key; }));
+	};
+	size_t tournamentMembersIndex = setterIndex("tournamentMembers");
+	size_t heuristicTriesIndex = setterIndex("heuristicTries");
+	size_t terrainSeedIndex = setterIndex("terrainSeed");
+	size_t terrainImageIndex = setterIndex("terrainImage");
+	size_t environmentFitnessIndex = setterIndex("environmentFitness");
+	size_t environmentQuantileIndex = setterIndex("environmentQuantile");
+	size_t environmentSlopeIndex = setterIndex("environmentSlope");
+	size_t environmentGravityIndex = setterIndex("environmentGravity");
+	size_t environmentPhaseIndex = setterIndex("environmentPhase");
+
+	configurations.clear();
+	std::vector<size_t> indexs(setters.size(), 0);
+	bool finished = false;
+	while (!finished) {
+		Config::Parameters parameters = Config::GetParameters();
+		for (size_t i = 0; i < setters.size(); ++i) {
+			auto keyValues = values.find(setters[i].first);
+			if (keyValues != values.end())
+				setters[i].second(parameters, keyValues->second[indexs[i]]);
+		}
+
+		bool repeated = (indexs[tournamentMembersIndex] > 0 && parameters.selectionFunction != Config::SelectionFunction::TOURNAMENT)
+			|| (indexs[heuristicTriesIndex] > 0 && parameters.crossoverType != Config::CrossoverType::HEURISTIC)
+			|| (indexs[terrainSeedIndex] > 0 && (parameters.terrainAmplitude <= 0.0f || !parameters.terrainImage.empty()))
+			|| (indexs[terrainImageIndex] > 0 && parameters.terrainAmplitude <= 0.0f)
+			|| (indexs[environmentQuantileIndex] > 0 && (parameters.environments <= 1 || parameters.environmentFitness != Config::EnvironmentFitness::QUANTILE))
+			|| ((indexs[environmentFitnessIndex] > 0 || indexs[environmentSlopeIndex] > 0 || indexs[environmentGravityIndex] > 0 || indexs[environmentPhaseIndex] > 0) && parameters.environments <= 1);
+		if (!repeated)
+			configurations.push_back(parameters);
+
+		// Next combination.
+		finished = true;
+		for (size_t i = 0; i < setters.size(); ++i) {
+			auto keyValues = values.find(setters[i].first);
+			if (keyValues == values.end())
+				continue;
+
+			if (++indexs[i] < keyValues->second.size()) {
+				finished = false;
+				break;
+			}
+			indexs[i] = 0;
+		}
+	}
+
+	runs.clear();
+	for (size_t i = 0; i < configurations.size(); ++i) {
+		for (auto seed : seeds) {
+			SimulationRun run;
+			run.configuration = i;
+			run.seed = seed;
+			runs.push_back(run);
+		}
+	}
+
+	std::cout << "Sweep loaded: " << configurations.size() << " configurations x " << seeds.size() << " seeds = " << runs.size() << " runs" << std::endl;
+
+	return !runs.empty();
+}
+
+/// <summary>
+/// Runs all the simulations and exports the results.
+/// </summary>
+void BatchRunner::Run() {
+	std::filesystem::create_directories(outputFolder);
+
+	// The mesh data is loaded once and shared by every simulation.
+	MeshLibrary::GetInstance();
+
+	results.assign(runs.size(), SimulationResult());
+	std::atomic<size_t> nextRun{ 0 };
+	std::atomic<size_t> finishedRuns{ 0 };
+
+	std::atomic<unsigned int> nextWorker{ 0 };
+	auto worker = [&]() {
+		PROFILE_THREAD("Batch worker " + std::to_string(nextWorker++));
+		for (size_t i = nextRun++; i < runs.size(); i = nextRun++) {
+			const auto& run = runs[i];
+			results[i] = Simulate(configurations[run.configuration], run.seed, GetRunPath(run));
+
+			std::lock_guard<std::mutex> lock(outputMutex);
+			std::cout << "[" << ++finishedRuns << "/" << runs.size() << "] Configuration " << run.configuration + 1 << " seed " << run.seed
+				<< ": top fitness " << results[i].finalTopFitness << " (" << results[i].seconds << "s)" << std::endl;
+		}
+	};
+
+	unsigned int workers = std::min<unsigned int>(threads, runs.size());
+	physicsThreads = std::max(threads / std::max(workers, 1u), 1u);
+	std::cout << "Running " << runs.size() << " simulations on " << workers << " threads" << std::endl;
+
+	// The metrics are sampled from this thread while the workers run.
+	auto metrics = Metrics::GetInstance();
+	std::vector<std::thread> pool;
+	for (unsigned int i = 0; i < workers; ++i)
+		pool.emplace_back(worker);
+	while (finishedRuns < runs.size()) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(100));
+		metrics->Update();
+	}
+	for (auto& thread : pool)
+		thread.join();
+	metrics->Update();
+
+	WriteSummary();
+
+#ifdef PROFILER_ENABLED
+	Profiler::GetInstance()->ExportChromeTrace(outputFolder + "/Trace.json");
+#endif
+}
+
+/// <summary>
+/// Runs a complete genetic algorithm without render.
+/// </summary>
+/// <param name="parameters"> Configuration values. </param>
+/// <param name="seed"> Random seed. </param>
+/// <param name="csvPath"> Path of the csv with the generations stats. </param>
+/// <returns> Simulation results. </returns>
+BatchRunner::SimulationResult BatchRunner::Simulate(const Config::Parameters& parameters, unsigned int seed, const std::string& csvPath) const {
+	PROFILE_FUNCTION();
+	auto start = std::chrono::steady_clock::now();
+
+	// Each thread has its own random engine.
+	effolkronium::random_thread_local::seed(seed);
+
+	// Every skeleton is evaluated on every environment, the nominal one moves the genetic algorithm population
+	// and the others a copy of it. The physics threads are shared between the environments.
+	size_t environmentCount = std::max(parameters.environments, 1);
+	unsigned int environmentThreads = std::min<unsigned int>(physicsThreads, environmentCount);
+	unsigned int environmentPhysicsThreads = std::max(physicsThreads / static_cast<unsigned int>(environmentCount), 1u);
+	std::vector<std::unique_ptr<Environment>> environments;
+	environments.push_back(std::make_unique<Environment>(parameters, 0, environmentPhysicsThreads));
+	PhysicsWorld& physicsWorld = environments[0]->GetPhysicsWorld();
+
+	GeneticAlgorithm geneticAlgorithm(parameters);
+	auto population = geneticAlgorithm.GetPopulation();
+	environments[0]->SetPopulation(population);
+	for (size_t i = 1; i < environmentCount; ++i) {
+		environments.push_back(std::make_unique<Environment>(parameters, static_cast<int>(i), environmentPhysicsThreads));
+		environments.back()->CreatePopulation(parameters.populationSize);
+	}
+
+	// Fixed time step, every generation lives the same frames as with render at the target FPS.
+	// Every physics update can advance several frames, the last one of the generation advances the frames left.
+	int framesPerGeneration = parameters.generationLifeSpan * Utils::FPS;
+
+	// The gait cycles only repeat the same displacement with the kinematic model on a flat field sampled every frame.
+	bool extrapolateGaits = parameters.physicsBackend == Config::PhysicsBackendType::KINEMATIC && parameters.terrainAmplitude <= 0.0f && parameters.physicsStepFrames == 1;
+	GaitDetector gaitDetector(extrapolateGaits ? parameters.gaitExtrapolation : Config::GaitExtrapolation::OFF, framesPerGeneration);
+	std::vector<std::shared_ptr<ESkeleton>> active;
+
+	// The joint rotations only follow from the genes with the kinematic fixed step.
+	bool screenGenomes = parameters.physicsBackend == Config::PhysicsBackendType::KINEMATIC && parameters.jointIntegration == Config::JointIntegration::FIXED && parameters.physicsStepFrames == 1;
+	FeasibilityAnalyzer feasibilityAnalyzer(screenGenomes ? parameters.feasibilityScreen : Config::FeasibilityScreen::NONE, framesPerGeneration, Utils::deltaTime, physicsWorld.GetDeathRules());
+
+	// The environment threads are created once and wait between generations.
+	WorkerPool environmentPool(environmentThreads);
+
+	auto metrics = Metrics::GetInstance();
+	while (geneticAlgorithm.GetGeneration() < parameters.maxGenerations + 1) {
+		auto generationStart = std::chrono::steady_clock::now();
+
+		// The rejected skeletons are copied dead, so they are not simulated on any environment.
+		feasibilityAnalyzer.Screen(population);
+		for (size_t i = 1; i < environments.size(); ++i)
+			environments[i]->CopyPopulation(population);
+
+		// The nominal environment runs on this thread and the rest are taken by the pool threads as they finish.
+		environmentPool.Start(environments.size() - 1, [&](size_t i) {
+			environments[i + 1]->Simulate(framesPerGeneration, parameters.physicsStepFrames);
+		});
+
+		active = population;
+		for (int frame = 1; frame <= framesPerGeneration; frame += parameters.physicsStepFrames) {
+			int frames = std::min(parameters.physicsStepFrames, framesPerGeneration - frame + 1);
+			uint64_t evaluations = 0;
+			for (const auto& skeleton : active)
+				evaluations += !skeleton->IsDead();
+			physicsWorld.UpdateSkeletons(active, (frames == 1) ? Utils::deltaTime : static_cast<float>(frames) / Utils::FPS);
+			metrics->AddTicks(frames, evaluations * frames);
+
+			int lastFrame = frame + frames - 1;
+			if (gaitDetector.Update(physicsWorld, active, lastFrame))
+				gaitDetector.GetActiveSkeletons(population, active);
+
+			geneticAlgorithm.Update(((long long)lastFrame * MSTOSECONDS) / Utils::FPS);
+		}
+		gaitDetector.EndGeneration(population);
+		feasibilityAnalyzer.EndGeneration(population);
+
+		environmentPool.Wait();
+
+		// The fitness of every skeleton is aggregated over the environments before breeding.
+		if (environments.size() > 1) {
+			std::vector<float> fitness(environments.size());
+			for (size_t i = 0; i < population.size(); ++i) {
+				for (size_t j = 0; j < environments.size(); ++j)
+					fitness[j] = environments[j]->GetPopulation()[i]->UpdateFitness();
+				population[i]->SetRobustFitness(Environment::AggregateFitness(fitness, parameters.environmentFitness, parameters.environmentQuantile));
+			}
+			geneticAlgorithm.Update(((long long)framesPerGeneration * MSTOSECONDS) / Utils::FPS);
+		}
+
+		auto breedingStart = std::chrono::steady_clock::now();
+		geneticAlgorithm.NewGeneration();
+		auto generationEnd = std::chrono::steady_clock::now();
+		metrics->AddGeneration(std::chrono::duration<double>(generationEnd - generationStart).count(), std::chrono::duration<double>(generationEnd - breedingStart).count());
+	}
+
+	geneticAlgorithm.WriteCSV(csvPath);
+
+	SimulationResult result;
+	const auto& generationsStats = geneticAlgorithm.GetGenerationsStats();
+	if (!generationsStats.empty()) {
+		result.finalAverageFitness = generationsStats.back().averageFitness;
+		result.finalTopFitness = generationsStats.back().topFitness;
+		for (const auto& generation : generationsStats) {
+			result.bestTopFitness = std::max(result.bestTopFitness, generation.topFitness);
+			result.averageDeathPercentage += generation.deathPercentage / generationsStats.size();
+		}
+	}
+	result.extrapolatedPercentage = gaitDetector.GetExtrapolatedPercentage();
+	result.skippedPercentage = gaitDetector.GetSkippedPercentage();
+	result.meanExtrapolationError = gaitDetector.GetMeanFitnessError();
+	result.extrapolationDeathErrors = gaitDetector.GetDeathErrors();
+	result.infeasiblePercentage = feasibilityAnalyzer.GetInfeasiblePercentage();
+	result.rejectedPercentage = feasibilityAnalyzer.GetRejectedPercentage();
+	result.feasibilityMisses = feasibilityAnalyzer.GetMisses();
+	result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	return result;
+}
+
+/// <summary>
+/// Exports the aggregated results of every configuration.
+/// </summary>
+void BatchRunner::WriteSummary() const {
+	std::string title(outputFolder + "/Summary.csv");
+	std::ofstream stream(title);
+	csv2::Writer<csv2::delimiter<','>> writer(stream);
+
+	auto selectionFunctionName = [](Config::SelectionFunction selectionFunction) {
+		return (selectionFunction == Config::SelectionFunction::ROULETTE) ? std::string("Roulette") : std::string("Tournament");
+	};
+
+	auto crossoverTypeName = [](Config::CrossoverType crossoverType) {
+		switch (crossoverType) {
+			case Config::CrossoverType::HEURISTIC: return std::string("Heuristic");
+			case Config::CrossoverType::ARITHMETIC: return std::string("Arithmetic");
+			case Config::CrossoverType::AVERAGE: return std::string("Average");
+			default: return std::string("One point");
+		}
+	};
+
+	auto physicsBackendName = [](Config::PhysicsBackendType physicsBackend) {
+		return (physicsBackend == Config::PhysicsBackendType::KINEMATIC) ? std::string("Kinematic") : std::string("Articulated");
+	};
+
+	auto jointIntegrationName = [](Config::JointIntegration jointIntegration) {
+		return (jointIntegration == Config::JointIntegration::FIXED) ? std::string("Fixed") : std::string("Event");
+	};
+
+	auto gaitExtrapolationName = [](Config::GaitExtrapolation gaitExtrapolation) {
+		switch (gaitExtrapolation) {
+			case Config::GaitExtrapolation::ON: return std::string("On");
+			case Config::GaitExtrapolation::VERIFY: return std::string("Verify");
+			default: return std::string("Off");
+		}
+	};
+
+	auto feasibilityScreenName = [](Config::FeasibilityScreen feasibilityScreen) {
+		switch (feasibilityScreen) {
+			case Config::FeasibilityScreen::FLAG: return std::string("Flag");
+			case Config::FeasibilityScreen::REJECT: return std::string("Reject");
+			default: return std::string("None");
+		}
+	};
+
+	auto environmentFitnessName = [](const Config::Parameters& parameters) {
+		if (parameters.environments <= 1) return std::string("Nominal");
+		switch (parameters.environmentFitness) {
+			case Config::EnvironmentFitness::MIN: return std::string("Min");
+			case Config::EnvironmentFitness::QUANTILE: return std::string("Quantile " + std::to_string(parameters.environmentQuantile));
+			default: return std::string("Mean");
+		}
+	};
+
+	auto terrainName = [](const Config::Parameters& parameters) {
+		if (parameters.terrainAmplitude <= 0.0f) return std::string("Flat");
+		return parameters.terrainImage.empty() ? std::string("Seed " + std::to_string(parameters.terrainSeed)) : parameters.terrainImage;
+	};
+
+	// Mean and standard deviation of a value between the seeds of a configuration.
+	auto meanDeviation = [](const std::vector<float>& values) {
+		float mean = 0.0f;
+		for (auto value : values)
+			mean += value / values.size();
+
+		float variance = 0.0f;
+		for (auto value : values)
+			variance += (value - mean) * (value - mean) / values.size();
+
+		return std::pair<float, float>(mean, std::sqrt(variance));
+	};
+
+	std::vector<std::vector<std::string>> rows =
+	{
+		{"Configuration", "Population size", "Life span (sec)", "Max generations", "New genes probability", "Mutation rate", "Selection function", "Tournament members"
+		, "Crossover operator", "Heuristic tries", "Terrain amplitude", "Terrain", "Physics", "Joint integration", "Physics step frames", "Gait extrapolation", "Feasibility screen"
+		, "Environments", "Environment fitness", "Environment slope", "Environment gravity", "Environment phase (sec)", "Runs", "Mean final average fitness", "Std final average fitness", "Mean final top fitness", "Std final top fitness"
+		, "Best top fitness", "Mean death percentage", "Mean extrapolated skeletons (%)", "Mean skipped frames (%)", "Mean extrapolation error", "Extrapolation death errors"
+		, "Mean infeasible skeletons (%)", "Mean rejected frames (%)", "Feasibility misses", "Mean run time (sec)"}
+	};
+
+	for (size_t i = 0; i < configurations.size(); ++i) {
+		const auto& parameters = configurations[i];
+		std::vector<float> finalAverageFitness;
+		std::vector<float> finalTopFitness;
+		std::vector<float> deathPercentage;
+		std::vector<float> extrapolatedPercentage;
+		std::vector<float> skippedPercentage;
+		std::vector<float> extrapolationError;
+		std::vector<float> infeasiblePercentage;
+		std::vector<float> rejectedPercentage;
+		std::vector<float> seconds;
+		float bestTopFitness = 0.0f;
+		int extrapolationDeathErrors = 0;
+		int feasibilityMisses = 0;
+
+		for (size_t j = 0; j < runs.size(); ++j) {
+			if (runs[j].configuration != i)
+				continue;
+
+			finalAverageFitness.push_back(results[j].finalAverageFitness);
+			finalTopFitness.push_back(results[j].finalTopFitness);
+			deathPercentage.push_back(results[j].averageDeathPercentage);
+			extrapolatedPercentage.push_back(results[j].extrapolatedPercentage);
+			skippedPercentage.push_back(results[j].skippedPercentage);
+			extrapolationError.push_back(results[j].meanExtrapolationError);
+			extrapolationDeathErrors += results[j].extrapolationDeathErrors;
+			infeasiblePercentage.push_back(results[j].infeasiblePercentage);
+			rejectedPercentage.push_back(results[j].rejectedPercentage);
+			feasibilityMisses += results[j].feasibilityMisses;
+			seconds.push_back(results[j].seconds);
+			bestTopFitness = std::max(bestTopFitness, results[j].bestTopFitness);
+		}
+
+		auto averageFitness = meanDeviation(finalAverageFitness);
+		auto topFitness = meanDeviation(finalTopFitness);
+
+		rows.push_back({
+			std::to_string(i + 1), std::to_string(parameters.populationSize), std::to_string(parameters.generationLifeSpan), std::to_string(parameters.maxGenerations)
+			, std::to_string(parameters.newGenProbability), std::to_string(parameters.mutationProbability), selectionFunctionName(parameters.selectionFunction)
+			, std::to_string(parameters.tournamentMembers), crossoverTypeName(parameters.crossoverType), std::to_string(parameters.heuristicTries)
+			, std::to_string(parameters.terrainAmplitude), terrainName(parameters), physicsBackendName(parameters.physicsBackend)
+			, jointIntegrationName(parameters.jointIntegration), std::to_string(parameters.physicsStepFrames), gaitExtrapolationName(parameters.gaitExtrapolation)
+			, feasibilityScreenName(parameters.feasibilityScreen), std::to_string(parameters.environments), environmentFitnessName(parameters)
+			, std::to_string(parameters.environmentSlope), std::to_string(parameters.environmentGravity), std::to_string(parameters.environmentPhase)
+			, std::to_string(finalAverageFitness.size()), std::to_string(averageFitness.first), std::to_string(averageFitness.second)
+			, std::to_string(topFitness.first), std::to_string(topFitness.second), std::to_string(bestTopFitness)
+			, std::to_string(meanDeviation(deathPercentage).first), std::to_string(meanDeviation(extrapolatedPercentage).first)
+			, std::to_string(meanDeviation(skippedPercentage).first), std::to_string(meanDeviation(extrapolationError).first)
+			, std::to_string(extrapolationDeathErrors), std::to_string(meanDeviation(infeasiblePercentage).first)
+			, std::to_string(meanDeviation(rejectedPercentage).first), std::to_string(feasibilityMisses), std::to_string(meanDeviation(seconds).first)
+		});
+	}
+
+	writer.write_rows(rows);
+	stream.close();
+
+	std::cout << title << " exported\n";
+}
+
+/// <summary>
+/// Returns the csv path of a simulation.
+/// </summary>
+/// <param name="run"> Simulation. </param>
+/// <returns> Csv path. </returns>
+std::string BatchRunner::GetRunPath(const SimulationRun& run) const {
+	return outputFolder + "/Configuration" + std::to_string(run.configuration + 1) + "_Seed" + std::to_string(run.seed) + ".csv";
+}
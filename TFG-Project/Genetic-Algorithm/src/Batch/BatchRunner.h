@@ -0,0 +1,130 @@
+#pragma once
+
+#include <Utils/Config.h>
+
+#include <string>
+#include <vector>
+#include <mutex>
+
+/// <summary>
+/// Runs a parameter sweep of the genetic algorithm without render.
+/// Every configuration of the sweep is repeated for every seed and the runs are spread over multiple threads.
+/// Sweep file format (one parameter per line, comma separated values, # for comments):
+///		populationSize = 50, 100
+///		selectionFunction = ROULETTE, TOURNAMENT
+///		seeds = 1, 2, 3
+/// </summary>
+class BatchRunner {
+	public:
+		/// <summary>
+		/// BatchRunner constructor.
+		/// </summary>
+		/// <param name="outputFolder"> Folder where the csv files are exported. </param>
+		/// <param name="threads"> Number of simulations running at the same time. </param>
+		BatchRunner(const std::string& outputFolder, unsigned int threads);
+
+		/// <summary>
+		/// BatchRunner destructor.
+		/// </summary>
+		~BatchRunner();
+
+		/// <summary>
+		/// Reads the sweep file and creates every configuration to run.
+		/// </summary>
+		/// <param name="sweepPath"> Sweep file path. </param>
+		/// <returns> If the sweep file is valid. </returns>
+		bool LoadSweep(const std::string& sweepPath);
+
+		/// <summary>
+		/// Runs all the simulations and exports the results.
+		/// </summary>
+		void Run();
+
+	private:
+		/// <summary>
+		/// Configuration and seed of one simulation.
+		/// </summary>
+		struct SimulationRun {
+			size_t configuration = 0;
+			unsigned int seed = 0;
+		};
+
+		/// <summary>
+		/// Results of one simulation.
+		/// </summary>
+		struct SimulationResult {
+			float finalAverageFitness = 0.0f;
+			float finalTopFitness = 0.0f;
+			float bestTopFitness = 0.0f;
+			float averageDeathPercentage = 0.0f;
+			float extrapolatedPercentage = 0.0f;
+			float skippedPercentage = 0.0f;
+			float meanExtrapolationError = 0.0f;
+			int extrapolationDeathErrors = 0;
+			float infeasiblePercentage = 0.0f;
+			float rejectedPercentage = 0.0f;
+			int feasibilityMisses = 0;
+			double seconds = 0.0;
+		};
+
+		/// <summary>
+		/// Runs a complete genetic algorithm without render.
+		/// </summary>
+		/// <param name="parameters"> Configuration values. </param>
+		/// <param name="seed"> Random seed. </param>
+		/// <param name="csvPath"> Path of the csv with the generations stats. </param>
+		/// <returns> Simulation results. </returns>
+		SimulationResult Simulate(const Config::Parameters& parameters, unsigned int seed, const std::string& csvPath) const;
+
+		/// <summary>
+		/// Exports the aggregated results of every configuration.
+		/// </summary>
+		void WriteSummary() const;
+
+		/// <summary>
+		/// Returns the csv path of a simulation.
+		/// </summary>
+		/// <param name="run"> Simulation. </param>
+		/// <returns> Csv path. </returns>
+		std::string GetRunPath(const SimulationRun& run) const;
+
+		/// <summary>
+		/// Configurations of the sweep.
+		/// </summary>
+		std::vector<Config::Parameters> configurations;
+
+		/// <summary>
+		/// Seeds to repeat every configuration.
+		/// </summary>
+		std::vector<unsigned int> seeds{ 1 };
+
+		/// <summary>
+		/// All the simulations to run.
+		/// </summary>
+		std::vector<SimulationRun> runs;
+
+		/// <summary>
+		/// Results of every simulation, same order as runs.
+		/// </summary>
+		std::vector<SimulationResult> results;
+
+		/// <summary>
+		/// Folder where the csv files are exported.
+		/// </summary>
+		std::string outputFolder;
+
+		/// <summary>
+		/// Number of simulations running at the same time.
+		/// </summary>
+		unsigned int threads = 1;
+
+		/// <summary>
+		/// Threads of the physics of every simulation, the ones left when there are less simulations than threads.
+		/// </summary>
+		unsigned int physicsThreads = 1;
+
+		/// <summary>
+		/// Mutex for the console output.
+		/// </summary>
+		std::mutex outputMutex;
+};
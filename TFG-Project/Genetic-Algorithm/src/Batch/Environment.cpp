@@ -0,0 +1,154 @@
+#include "Environment.h"
+
+#include <GeneticAlgorithm/GeneticAlgorithm.h>
+#include <Entities/Compositions/ESkeleton.h>
+#include <Entities/EMesh.h>
+#include <Entities/EHeightfield.h>
+#include <DataTypes/Transformable.h>
+#include <Utils/Utils.h>
+#include <Utils/Profiler.h>
+#include <Utils/Metrics.h>
+
+#include <algorithm>
+#include <cmath>
+
+/// <summary>
+/// Environment constructor.
+/// </summary>
+/// <param name="parameters"> Configuration values. </param>
+/// <param name="variant"> Environment index, 0 is the nominal one. </param>
+/// <param name="physicsThreads"> Threads of the physics backend. </param>
+Environment::Environment(const Config::Parameters& parameters, int variant, unsigned int physicsThreads) {
+	// Every variation grows evenly from the nominal environment to the last one.
+	float t = (parameters.environments > 1) ? static_cast<float>(variant) / (parameters.environments - 1) : 0.0f;
+	float slope = t * parameters.environmentSlope;
+	phase = t * parameters.environmentPhase;
+
+	// The field is widened when the population does not fit on it, the skeletons are placed in a row along x.
+	float fieldWidth = std::max(2000.0f, Utils::defaultPosition.x + (parameters.populationSize - 1) * Utils::positionOffset.x);
+	field = std::make_unique<EMesh>(Transformable(glm::vec3(500.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(fieldWidth, 10.0f, 2000.0f)), "media/Grass_Block.obj");
+	physicsWorld.SetEntityValues(field.get());
+	physicsWorld.AddCollidingMesh(field.get());
+	physicsWorld.SetPhysicsBackend(parameters.physicsBackend, physicsThreads);
+	physicsWorld.SetJointIntegration(parameters.jointIntegration);
+	physicsWorld.SetGravityScale(1.0f + t * parameters.environmentGravity);
+
+	// Heightfield over the field, a flat field does not need it.
+	if (parameters.terrainAmplitude > 0.0f || slope > 0.0f) {
+		heightfield = std::make_unique<EHeightfield>(field.get());
+		if (parameters.terrainAmplitude > 0.0f && (parameters.terrainImage.empty() || !heightfield->LoadImage(parameters.terrainImage, parameters.terrainAmplitude)))
+			heightfield->Generate(parameters.terrainSeed + variant, parameters.terrainAmplitude);
+		if (slope > 0.0f)
+			heightfield->AddSlope(slope, Utils::defaultPosition.z);
+		physicsWorld.SetHeightfield(heightfield.get());
+	}
+}
+
+/// <summary>
+/// Environment destructor.
+/// </summary>
+Environment::~Environment() {
+
+}
+
+/// <summary>
+/// Sets the skeletons simulated in the environment.
+/// </summary>
+/// <param name="population"> Skeletons. </param>
+void Environment::SetPopulation(const std::vector<std::shared_ptr<ESkeleton>>& population) {
+	this->population = population;
+	for (const auto& skeleton : population) {
+		for (auto joint : skeleton->GetSkeleton())
+			physicsWorld.SetEntityValues(joint);
+	}
+}
+
+/// <summary>
+/// Creates the skeletons of the environment, they take the genes of the population every generation.
+/// </summary>
+/// <param name="populationSize"> Population size. </param>
+void Environment::CreatePopulation(int populationSize) {
+	std::vector<std::shared_ptr<ESkeleton>> skeletons;
+	glm::vec3 offset = Utils::defaultPosition;
+	for (int i = 0; i < populationSize; ++i) {
+		skeletons.push_back(GeneticAlgorithm::CreateSkeleton(offset));
+		offset.x += Utils::positionOffset.x;
+	}
+
+	SetPopulation(skeletons);
+}
+
+/// <summary>
+/// Copies the genes and the state of a population at the start of the generation and advances the joints the initial phase.
+/// </summary>
+/// <param name="population"> Skeletons, same order as the environment ones. </param>
+void Environment::CopyPopulation(const std::vector<std::shared_ptr<ESkeleton>>& population) {
+	PROFILE_FUNCTION();
+	int phaseFrames = static_cast<int>(std::lround(phase * Utils::FPS));
+	for (size_t i = 0; i < this->population.size(); ++i) {
+		auto skeleton = this->population[i].get();
+		skeleton->CopyGenes(*population[i]);
+
+		auto leg1 = skeleton->GetLeg1();
+		auto leg2 = skeleton->GetLeg2();
+		for (int frame = 0; frame < phaseFrames; ++frame) {
+			for (auto joint : { leg1[0], leg1[1], leg2[0], leg2[1] })
+				PhysicsWorld::RotateJoint(joint, Utils::deltaTime);
+		}
+
+		physicsWorld.SetSkeletonValues(skeleton->GetSkeleton());
+	}
+}
+
+/// <summary>
+/// Simulates a whole generation.
+/// </summary>
+/// <param name="framesPerGeneration"> Frames simulated every generation. </param>
+/// <param name="physicsStepFrames"> Frames advanced by every physics update. </param>
+void Environment::Simulate(int framesPerGeneration, int physicsStepFrames) {
+	PROFILE_FUNCTION();
+	auto metrics = Metrics::GetInstance();
+	for (int frame = 1; frame <= framesPerGeneration; frame += physicsStepFrames) {
+		int frames = std::min(physicsStepFrames, framesPerGeneration - frame + 1);
+		uint64_t evaluations = 0;
+		for (const auto& skeleton : population)
+			evaluations += !skeleton->IsDead();
+		physicsWorld.UpdateSkeletons(population, (frames == 1) ? Utils::deltaTime : static_cast<float>(frames) / Utils::FPS);
+
+		// The frames are the ones of the nominal environment, only the skeleton updates are added.
+		metrics->AddTicks(0, evaluations * frames);
+	}
+
+	for (const auto& skeleton : population)
+		skeleton->UpdateFitness();
+}
+
+/// <summary>
+/// Aggregates the fitness of a skeleton over the environments.
+/// </summary>
+/// <param name="fitness"> Fitness on every environment. </param>
+/// <param name="aggregation"> Aggregation. </param>
+/// <param name="quantile"> Quantile with the quantile aggregation, interpolated between the sorted values. </param>
+/// <returns> Aggregated fitness. </returns>
+float Environment::AggregateFitness(std::vector<float> fitness, Config::EnvironmentFitness aggregation, float quantile) {
+	if (fitness.empty())
+		return 0.0f;
+
+	switch (aggregation) {
+		case Config::EnvironmentFitness::MIN:
+			return *std::min_element(fitness.begin(), fitness.end());
+		case Config::EnvironmentFitness::QUANTILE: {
+			std::sort(fitness.begin(), fitness.end());
+			float position = std::clamp(quantile, 0.0f, 1.0f) * (fitness.size() - 1);
+			size_t lower = static_cast<size_t>(position);
+			size_t upper = std::min(lower + 1, fitness.size() - 1);
+			return fitness[lower] + (fitness[upper] - fitness[lower]) * (position - lower);
+		}
+		default: {
+			float mean = 0.0f;
+			for (auto value : fitness)
+				mean += value / fitness.size();
+			return mean;
+		}
+	}
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <Physics/PhysicsWorld.h>
+#include <Utils/Config.h>
+
+#include <vector>
+#include <memory>
+
+class ESkeleton;
+class EMesh;
+class EHeightfield;
+
+/// <summary>
+/// Field and physics world where the skeletons are evaluated without render.
+/// Variant 0 is the nominal environment and the rest spread the variations of the configuration evenly up to their maximum:
+/// terrain seed, slope along the walking direction, gravity and initial phase of the joints.
+/// Every environment owns its physics world and, except the nominal one, a copy of the population, so they can be simulated at the same time.
+/// </summary>
+class Environment {
+	public:
+		/// <summary>
+		/// Environment constructor.
+		/// </summary>
+		/// <param name="parameters"> Configuration values. </param>
+		/// <param name="variant"> Environment index, 0 is the nominal one. </param>
+		/// <param name="physicsThreads"> Threads of the physics backend. </param>
+		Environment(const Config::Parameters& parameters, int variant, unsigned int physicsThreads);
+
+		/// <summary>
+		/// Environment destructor.
+		/// </summary>
+		~Environment();
+
+		/// <summary>
+		/// Sets the skeletons simulated in the environment.
+		/// </summary>
+		/// <param name="population"> Skeletons. </param>
+		void SetPopulation(const std::vector<std::shared_ptr<ESkeleton>>& population);
+
+		/// <summary>
+		/// Creates the skeletons of the environment, they take the genes of the population every generation.
+		/// </summary>
+		/// <param name="populationSize"> Population size. </param>
+		void CreatePopulation(int populationSize);
+
+		/// <summary>
+		/// Copies the genes and the state of a population at the start of the generation and advances the joints the initial phase.
+		/// </summary>
+		/// <param name="population"> Skeletons, same order as the environment ones. </param>
+		void CopyPopulation(const std::vector<std::shared_ptr<ESkeleton>>& population);
+
+		/// <summary>
+		/// Simulates a whole generation.
+		/// </summary>
+		/// <param name="framesPerGeneration"> Frames simulated every generation. </param>
+		/// <param name="physicsStepFrames"> Frames advanced by every physics update. </param>
+		void Simulate(int framesPerGeneration, int physicsStepFrames);
+
+		/// <summary>
+		/// Returns the skeletons simulated in the environment.
+		/// </summary>
+		/// <returns> Skeletons. </returns>
+		const std::vector<std::shared_ptr<ESkeleton>>& GetPopulation() const { return population; }
+
+		/// <summary>
+		/// Returns the physics world.
+		/// </summary>
+		/// <returns> Physics world. </returns>
+		PhysicsWorld& GetPhysicsWorld() { return physicsWorld; }
+
+		/// <summary>
+		/// Aggregates the fitness of a skeleton over the environments.
+		/// </summary>
+		/// <param name="fitness"> Fitness on every environment. </param>
+		/// <param name="aggregation"> Aggregation. </param>
+		/// <param name="quantile"> Quantile with the quantile aggregation, interpolated between the sorted values. </param>
+		/// <returns> Aggregated fitness. </returns>
+		static float AggregateFitness(std::vector<float> fitness, Config::EnvironmentFitness aggregation, float quantile);
+
+	private:
+		/// <summary>
+		/// Physics world of the environment.
+		/// </summary>
+		PhysicsWorld physicsWorld;
+
+		/// <summary>
+		/// Ground mesh.
+		/// </summary>
+		std::unique_ptr<EMesh> field;
+
+		/// <summary>
+		/// Heightfield over the field, only with terrain or slope.
+		/// </summary>
+		std::unique_ptr<EHeightfield> heightfield;
+
+		/// <summary>
+		/// Skeletons simulated in the environment.
+		/// </summary>
+		std::vector<std::shared_ptr<ESkeleton>> population;
+
+		/// <summary>
+		/// Initial phase of the joints in seconds.
+		/// </summary>
+		float phase = 0.0f;
+};
@@ -0,0 +1,202 @@
+#include "GaitDetector.h"
+
+#include <Physics/PhysicsWorld.h>
+#include <Entities/Compositions/ESkeleton.h>
+#include <Entities/EMesh.h>
+
+#include <GLM/geometric.hpp>
+
+#include <cmath>
+#include <limits>
+
+/// <summary>
+/// GaitDetector constructor.
+/// </summary>
+/// <param name="mode"> Detector mode. </param>
+/// <param name="framesPerGeneration"> Frames simulated every generation. </param>
+GaitDetector::GaitDetector(Config::GaitExtrapolation mode, int framesPerGeneration) :
+	mode(mode),
+	framesPerGeneration(framesPerGeneration) {
+}
+
+/// <summary>
+/// GaitDetector destructor.
+/// </summary>
+GaitDetector::~GaitDetector() {
+
+}
+
+/// <summary>
+/// Samples the skeletons after a physics update and extrapolates the ones with a stable cycle.
+/// </summary>
+/// <param name="world"> Physics world, for the ground height. </param>
+/// <param name="population"> Skeletons. </param>
+/// <param name="frame"> Frame of the generation just simulated. </param>
+/// <returns> If any skeleton has stopped being simulated this frame. </returns>
+bool GaitDetector::Update(const PhysicsWorld& world, const std::vector<std::shared_ptr<ESkeleton>>& population, int frame) {
+	if (mode == Config::GaitExtrapolation::OFF)
+		return false;
+
+	bool changed = false;
+	for (const auto& skeleton : population) {
+		if (skeleton->IsDead())
+			continue;
+
+		auto& gait = gaits[skeleton.get()];
+		if (gait.stopped)
+			continue;
+
+		if (gait.stopFrame < 0)
+			DetectCycle(world, skeleton.get(), gait, frame);
+
+		// The cycle is known, the whole periods left are added when only they remain.
+		if (gait.stopFrame < 0 || frame < gait.stopFrame)
+			continue;
+
+		auto core = skeleton->GetCore();
+		gait.predictedPosition = core->GetPosition() + gait.displacement * static_cast<float>(gait.periods);
+		gait.stopped = true;
+		if (mode == Config::GaitExtrapolation::ON) {
+			core->SetPosition(gait.predictedPosition);
+			changed = true;
+		}
+	}
+
+	return changed;
+}
+
+/// <summary>
+/// Samples a skeleton when its first hip starts going backwards and looks for a previous sample of the same state.
+/// </summary>
+/// <param name="world"> Physics world, for the ground height. </param>
+/// <param name="skeleton"> Skeleton. </param>
+/// <param name="gait"> Cycle detection of the skeleton. </param>
+/// <param name="frame"> Frame of the generation just simulated. </param>
+void GaitDetector::DetectCycle(const PhysicsWorld& world, ESkeleton* skeleton, Gait& gait, int frame) const {
+	bool hipForward = skeleton->GetLeg1()[0]->GetRotationVelocity().x > 0;
+	bool section = gait.hipForward && !hipForward;
+	gait.hipForward = hipForward;
+	if (!section)
+		return;
+
+	Sample sample = TakeSample(skeleton, frame);
+	for (auto previous = gait.samples.rbegin(); previous != gait.samples.rend(); ++previous) {
+		if (!Matches(sample, *previous))
+			continue;
+
+		int period = sample.frame - previous->frame;
+		glm::vec3 displacement = sample.position - previous->position;
+
+		// Two consecutive periods with the same length and displacement.
+		float difference = glm::length(displacement - gait.displacement);
+		if (period == gait.period && difference <= displacementTolerance * glm::length(displacement)) {
+			int framesLeft = framesPerGeneration - frame;
+			int periods = framesLeft / period;
+			glm::vec3 finalPosition = sample.position + displacement * static_cast<float>(periods + 1);
+
+			// The ground has to stay under the skeleton until the end, the frames that do not complete a period included.
+			float groundHeight = world.GetGroundHeight(sample.position.x, sample.position.z);
+			if (periods > 0 && groundHeight > std::numeric_limits<float>::lowest() && world.GetGroundHeight(finalPosition.x, finalPosition.z) == groundHeight) {
+				gait.periods = periods;
+				gait.stopFrame = frame + framesLeft - periods * period;
+			}
+		}
+
+		gait.period = period;
+		gait.displacement = displacement;
+		break;
+	}
+
+	gait.samples.push_back(sample);
+	if (gait.samples.size() > maxSamples)
+		gait.samples.erase(gait.samples.begin());
+}
+
+/// <summary>
+/// Compares the extrapolations with the simulation at the end of the generation and forgets every skeleton.
+/// </summary>
+/// <param name="population"> Skeletons. </param>
+void GaitDetector::EndGeneration(const std::vector<std::shared_ptr<ESkeleton>>& population) {
+	if (mode == Config::GaitExtrapolation::OFF)
+		return;
+
+	for (const auto& skeleton : population) {
+		skeletons++;
+		frames += framesPerGeneration;
+
+		auto gait = gaits.find(skeleton.get());
+		if (gait == gaits.end() || !gait->second.stopped)
+			continue;
+
+		extrapolated++;
+		skippedFrames += static_cast<long long>(gait->second.periods) * gait->second.period;
+
+		if (mode == Config::GaitExtrapolation::VERIFY) {
+			verified++;
+			float predictedFitness = glm::distance(gait->second.predictedPosition, skeleton->GetStartingPoint());
+			float simulatedFitness = glm::distance(skeleton->GetCore()->GetPosition(), skeleton->GetStartingPoint());
+			fitnessError += std::abs(predictedFitness - simulatedFitness);
+			deathErrors += skeleton->IsDead();
+		}
+	}
+
+	gaits.clear();
+}
+
+/// <summary>
+/// Returns the skeletons that still have to be simulated.
+/// </summary>
+/// <param name="population"> Skeletons. </param>
+/// <param name="active"> Skeletons to simulate, the vector is reused. </param>
+void GaitDetector::GetActiveSkeletons(const std::vector<std::shared_ptr<ESkeleton>>& population, std::vector<std::shared_ptr<ESkeleton>>& active) const {
+	active.clear();
+	for (const auto& skeleton : population) {
+		auto gait = gaits.find(skeleton.get());
+		if (mode != Config::GaitExtrapolation::ON || gait == gaits.end() || !gait->second.stopped)
+			active.push_back(skeleton);
+	}
+}
+
+/// <summary>
+/// Takes the state of a skeleton.
+/// </summary>
+/// <param name="skeleton"> Skeleton. </param>
+/// <param name="frame"> Frame of the generation. </param>
+/// <returns> Sample. </returns>
+GaitDetector::Sample GaitDetector::TakeSample(ESkeleton* skeleton, int frame) const {
+	auto leg1 = skeleton->GetLeg1();
+	auto leg2 = skeleton->GetLeg2();
+	EMesh* joints[4] = { leg1[0], leg1[1], leg2[0], leg2[1] };
+
+	Sample sample;
+	sample.frame = frame;
+	for (int i = 0; i < 4; ++i) {
+		sample.rotations[i] = joints[i]->GetRotation().x;
+		sample.forward[i] = joints[i]->GetRotationVelocity().x > 0;
+	}
+	sample.onAir[0] = skeleton->GetOnAir();
+	sample.onAir[1] = skeleton->GetLeg1OnAir();
+	sample.onAir[2] = skeleton->GetLeg2OnAir();
+	sample.position = skeleton->GetCore()->GetPosition();
+
+	return sample;
+}
+
+/// <summary>
+/// Returns if two samples are the same state of the cycle.
+/// </summary>
+/// <param name="sample1"> Sample. </param>
+/// <param name="sample2"> Sample. </param>
+/// <returns> If they match. </returns>
+bool GaitDetector::Matches(const Sample& sample1, const Sample& sample2) const {
+	for (int i = 0; i < 4; ++i) {
+		if (sample1.forward[i] != sample2.forward[i] || std::abs(sample1.rotations[i] - sample2.rotations[i]) > rotationTolerance)
+			return false;
+	}
+	for (int i = 0; i < 3; ++i) {
+		if (sample1.onAir[i] != sample2.onAir[i])
+			return false;
+	}
+
+	return std::abs(sample1.position.y - sample2.position.y) <= heightTolerance;
+}
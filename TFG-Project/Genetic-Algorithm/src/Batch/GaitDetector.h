@@ -0,0 +1,178 @@
+#pragma once
+
+#include <Utils/Config.h>
+
+#include <GLM/vec3.hpp>
+
+#include <vector>
+#include <memory>
+#include <unordered_map>
+
+class PhysicsWorld;
+class ESkeleton;
+
+/// <summary>
+/// Detects the skeletons that walk in a stable cycle and extrapolates the rest of their generation.
+/// The state of a skeleton (joint rotations and directions, legs on air and core height) is sampled every time its first hip
+/// starts going backwards. When a sample repeats one of the previous ones twice with the same period and displacement,
+/// the rest of the generation only repeats that cycle: its whole periods are added to the core position at once
+/// and the skeleton is only simulated for the frames that do not complete a period.
+/// The displacement is only valid on a flat ground, the kinematic model does not depend on the position.
+/// </summary>
+class GaitDetector {
+	public:
+		/// <summary>
+		/// GaitDetector constructor.
+		/// </summary>
+		/// <param name="mode"> Detector mode. </param>
+		/// <param name="framesPerGeneration"> Frames simulated every generation. </param>
+		GaitDetector(Config::GaitExtrapolation mode, int framesPerGeneration);
+
+		/// <summary>
+		/// GaitDetector destructor.
+		/// </summary>
+		~GaitDetector();
+
+		/// <summary>
+		/// Samples the skeletons after a physics update and extrapolates the ones with a stable cycle.
+		/// </summary>
+		/// <param name="world"> Physics world, for the ground height. </param>
+		/// <param name="population"> Skeletons. </param>
+		/// <param name="frame"> Frame of the generation just simulated. </param>
+		/// <returns> If any skeleton has stopped being simulated this frame. </returns>
+		bool Update(const PhysicsWorld& world, const std::vector<std::shared_ptr<ESkeleton>>& population, int frame);
+
+		/// <summary>
+		/// Compares the extrapolations with the simulation at the end of the generation and forgets every skeleton.
+		/// </summary>
+		/// <param name="population"> Skeletons. </param>
+		void EndGeneration(const std::vector<std::shared_ptr<ESkeleton>>& population);
+
+		/// <summary>
+		/// Returns the skeletons that still have to be simulated.
+		/// </summary>
+		/// <param name="population"> Skeletons. </param>
+		/// <param name="active"> Skeletons to simulate, the vector is reused. </param>
+		void GetActiveSkeletons(const std::vector<std::shared_ptr<ESkeleton>>& population, std::vector<std::shared_ptr<ESkeleton>>& active) const;
+
+		/// <summary>
+		/// Returns the percentage of the skeletons extrapolated.
+		/// </summary>
+		/// <returns> Extrapolated skeletons percentage. </returns>
+		float GetExtrapolatedPercentage() const { return skeletons ? 100.0f * extrapolated / skeletons : 0.0f; }
+
+		/// <summary>
+		/// Returns the percentage of the frames not simulated.
+		/// </summary>
+		/// <returns> Skipped frames percentage. </returns>
+		float GetSkippedPercentage() const { return frames ? 100.0f * skippedFrames / frames : 0.0f; }
+
+		/// <summary>
+		/// Returns the mean absolute difference between the extrapolated and the simulated fitness, only in VERIFY mode.
+		/// </summary>
+		/// <returns> Mean fitness error. </returns>
+		float GetMeanFitnessError() const { return verified ? fitnessError / verified : 0.0f; }
+
+		/// <summary>
+		/// Returns the extrapolated skeletons that died in the simulation, only in VERIFY mode.
+		/// </summary>
+		/// <returns> Wrong alive predictions. </returns>
+		int GetDeathErrors() const { return deathErrors; }
+
+	private:
+		/// <summary>
+		/// State of a skeleton when its first hip starts going backwards.
+		/// </summary>
+		struct Sample {
+			int frame = 0;
+			float rotations[4] = {};
+			bool forward[4] = {};
+			bool onAir[3] = {};
+			glm::vec3 position{ 0.0f };
+		};
+
+		/// <summary>
+		/// Cycle detection of a skeleton.
+		/// </summary>
+		struct Gait {
+			std::vector<Sample> samples;
+			bool hipForward = false;
+			int period = 0;
+			glm::vec3 displacement{ 0.0f };
+			int periods = 0;
+			int stopFrame = -1;
+			bool stopped = false;
+			glm::vec3 predictedPosition{ 0.0f };
+		};
+
+		/// <summary>
+		/// Samples a skeleton when its first hip starts going backwards and looks for a previous sample of the same state.
+		/// </summary>
+		/// <param name="world"> Physics world, for the ground height. </param>
+		/// <param name="skeleton"> Skeleton. </param>
+		/// <param name="gait"> Cycle detection of the skeleton. </param>
+		/// <param name="frame"> Frame of the generation just simulated. </param>
+		void DetectCycle(const PhysicsWorld& world, ESkeleton* skeleton, Gait& gait, int frame) const;
+
+		/// <summary>
+		/// Takes the state of a skeleton.
+		/// </summary>
+		/// <param name="skeleton"> Skeleton. </param>
+		/// <param name="frame"> Frame of the generation. </param>
+		/// <returns> Sample. </returns>
+		Sample TakeSample(ESkeleton* skeleton, int frame) const;
+
+		/// <summary>
+		/// Returns if two samples are the same state of the cycle.
+		/// </summary>
+		/// <param name="sample1"> Sample. </param>
+		/// <param name="sample2"> Sample. </param>
+		/// <returns> If they match. </returns>
+		bool Matches(const Sample& sample1, const Sample& sample2) const;
+
+		/// <summary>
+		/// Detector mode.
+		/// </summary>
+		Config::GaitExtrapolation mode = Config::GaitExtrapolation::OFF;
+
+		/// <summary>
+		/// Frames simulated every generation.
+		/// </summary>
+		int framesPerGeneration = 0;
+
+		/// <summary>
+		/// Cycle detection of every skeleton of the generation.
+		/// </summary>
+		std::unordered_map<const ESkeleton*, Gait> gaits;
+
+		/// <summary>
+		/// Samples kept of every skeleton, the longest period detected.
+		/// </summary>
+		const size_t maxSamples = 256;
+
+		/// <summary>
+		/// Rotation difference in degrees and core height difference to consider two samples the same state.
+		/// </summary>
+		const float rotationTolerance = 0.5f, heightTolerance = 0.01f;
+
+		/// <summary>
+		/// Relative difference between the displacements of two periods to consider the cycle stable.
+		/// </summary>
+		const float displacementTolerance = 0.01f;
+
+		/// <summary>
+		/// Skeletons evaluated, extrapolated and verified in all the generations.
+		/// </summary>
+		int skeletons = 0, extrapolated = 0, verified = 0;
+
+		/// <summary>
+		/// Frames of all the skeletons and frames not simulated.
+		/// </summary>
+		long long frames = 0, skippedFrames = 0;
+
+		/// <summary>
+		/// Sum of the fitness errors and extrapolated skeletons that died, only in VERIFY mode.
+		/// </summary>
+		float fitnessError = 0.0f;
+		int deathErrors = 0;
+};
@@ -0,0 +1,291 @@
+#include "Benchmark.h"
+
+#include <GeneticAlgorithm/GeneticAlgorithm.h>
+#include <Physics/PhysicsWorld.h>
+#include <Physics/MeshLibrary.h>
+#include <Entities/Compositions/ESkeleton.h>
+#include <Entities/EMesh.h>
+#include <DataTypes/Transformable.h>
+#include <DataTypes/OBBCollider.h>
+#include <DataTypes/OBBBatch.h>
+#include <Utils/Config.h>
+#include <Utils/Utils.h>
+
+#include <RANDOM/random.hpp>
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <filesystem>
+#include <ctime>
+#include <limits>
+#include <memory>
+
+using Random = effolkronium::random_thread_local;
+
+/// <summary>
+/// Benchmark constructor.
+/// </summary>
+/// <param name="outputPath"> Path of the json file with the results. </param>
+/// <param name="populationSizes"> Population sizes to benchmark. </param>
+Benchmark::Benchmark(const std::string& outputPath, const std::vector<int>& populationSizes) :
+	outputPath(outputPath),
+	populationSizes(populationSizes) {
+}
+
+/// <summary>
+/// Benchmark destructor.
+/// </summary>
+Benchmark::~Benchmark() {
+
+}
+
+/// <summary>
+/// Parses a comma separated list of population sizes.
+/// </summary>
+/// <param name="text"> Comma separated sizes. </param>
+/// <param name="populationSizes"> Parsed sizes. </param>
+/// <returns> If every size is valid. </returns>
+bool Benchmark::ParseSizes(const std::string& text, std::vector<int>& populationSizes) {
+	populationSizes.clear();
+	std::stringstream stream(text);
+	std::string value;
+	while (std::getline(stream, value, ',')) {
+		// At least 2 genes are needed to crossover.
+		if (value.empty() || value.find_first_not_of("0123456789") != std::string::npos || value.size() > 9 || std::stoi(value) < 2) {
+			std::cout << "Invalid population size " << value << std::endl;
+			return false;
+		}
+		populationSizes.push_back(std::stoi(value));
+	}
+	return !populationSizes.empty();
+}
+
+/// <summary>
+/// Runs all the benchmarks and exports the results.
+/// </summary>
+void Benchmark::Run() {
+	// The mesh data is loaded from the main thread before anything else.
+	MeshLibrary::GetInstance();
+
+	results.clear();
+	for (auto populationSize : populationSizes) {
+		std::cout << "==============================\n";
+		std::cout << "Population size: " << populationSize << std::endl;
+		RunPopulation(populationSize);
+	}
+
+	WriteJSON();
+}
+
+/// <summary>
+/// Runs all the kernels with one population size.
+/// </summary>
+/// <param name="populationSize"> Population size. </param>
+void Benchmark::RunPopulation(int populationSize) {
+	Random::seed(seed);
+
+	// Same scene as a simulation: the field and the population with its physics values.
+	PhysicsWorld physicsWorld;
+	EMesh field(Transformable(glm::vec3(500.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(2000.0f, 10.0f, 2000.0f)), "media/Grass_Block.obj");
+	physicsWorld.SetEntityValues(&field);
+	physicsWorld.AddCollidingMesh(&field);
+
+	Config::Parameters parameters = Config::GetParameters();
+	parameters.populationSize = populationSize;
+	GeneticAlgorithm geneticAlgorithm(parameters);
+
+	auto population = geneticAlgorithm.GetPopulation();
+	std::vector<EMesh*> joints;
+	for (const auto& skeleton : population) {
+		for (auto joint : skeleton->GetSkeleton()) {
+			physicsWorld.SetEntityValues(joint);
+			joints.push_back(joint);
+		}
+		// Fitness values as if the generation has finished.
+		skeleton->SetRobustFitness(Random::get<float>(0.0f, 200.0f));
+	}
+
+	// Sorted population, fitness stats and best gene as at the end of a generation.
+	geneticAlgorithm.Update(1);
+
+	// OBBCollider::IsColliding, every joint against the field.
+	int collisions = 0;
+	Measure("OBBCollider::IsColliding", populationSize, [&]() {
+		for (auto joint : joints)
+			collisions += joint->GetCollider()->IsColliding(field.GetCollider());
+	});
+
+	// OBBCollider::IsColliding with a batch, the field against every joint.
+	OBBBatch batch;
+	std::vector<uint8_t> colliding;
+	for (auto joint : joints)
+		batch.Add(joint->GetCollider());
+	Measure("OBBCollider::IsColliding (batch)", populationSize, [&]() {
+		collisions += static_cast<int>(field.GetCollider()->IsColliding(batch, colliding));
+	});
+
+	// PhysicsWorld::CalculateOBB, the global transformations and the colliders of every joint in one pass per skeleton.
+	Measure("PhysicsWorld::CalculateOBB", populationSize, [&]() {
+		for (const auto& skeleton : population)
+			physicsWorld.SetSkeletonValues(skeleton->GetSkeleton());
+	});
+
+	// PhysicsWorld::UpdateSkeleton, one frame of the whole population.
+	// Dead skeletons are not updated so they are revived to measure the same work every iteration.
+	Measure("PhysicsWorld::UpdateSkeleton", populationSize, [&]() {
+		for (const auto& skeleton : population) {
+			skeleton->SetIsDead(false);
+			physicsWorld.UpdateSkeleton(skeleton.get(), Utils::deltaTime);
+		}
+	});
+
+	// DeathRules::Evaluate, the death rules of the whole population as masks.
+	Measure("DeathRules::Evaluate", populationSize, [&]() {
+		for (const auto& skeleton : population)
+			skeleton->SetIsDead(false);
+		physicsWorld.GetDeathRules().Evaluate(population);
+	});
+
+	// ArticulatedBackend::Update, one frame of the whole population solved with torques and sub steps.
+	physicsWorld.SetPhysicsBackend(Config::PhysicsBackendType::ARTICULATED);
+	Measure("ArticulatedBackend::Update", populationSize, [&]() {
+		for (const auto& skeleton : population)
+			skeleton->SetIsDead(false);
+		physicsWorld.UpdateSkeletons(population, Utils::deltaTime);
+	});
+	physicsWorld.SetPhysicsBackend(Config::PhysicsBackendType::KINEMATIC);
+
+	// PhysicsWorld::UpdateSkeleton with obstacles spread over the field, every leg only checks the obstacles below it.
+	std::vector<std::unique_ptr<EMesh>> obstacleMeshes;
+	for (int i = 0; i < obstacles; ++i) {
+		glm::vec3 position(Random::get<float>(-500.0f, 1500.0f), 10.0f, Random::get<float>(-1000.0f, 1000.0f));
+		obstacleMeshes.push_back(std::make_unique<EMesh>(Transformable(position, glm::vec3(0.0f), glm::vec3(10.0f, 2.0f, 10.0f)), "media/Grass_Block.obj"));
+		physicsWorld.SetEntityValues(obstacleMeshes.back().get());
+		physicsWorld.AddCollidingMesh(obstacleMeshes.back().get());
+	}
+	Measure("PhysicsWorld::UpdateSkeleton (" + std::to_string(obstacles) + " obstacles)", populationSize, [&]() {
+		for (const auto& skeleton : population) {
+			skeleton->SetIsDead(false);
+			physicsWorld.UpdateSkeleton(skeleton.get(), Utils::deltaTime);
+		}
+	});
+
+	// GeneticAlgorithm::Selection, both selection functions.
+	geneticAlgorithm.SetSelectionFunction(Config::SelectionFunction::ROULETTE);
+	Measure("GeneticAlgorithm::Selection (Roulette)", populationSize, [&]() {
+		geneticAlgorithm.Selection();
+	});
+
+	geneticAlgorithm.SetSelectionFunction(Config::SelectionFunction::TOURNAMENT);
+	Measure("GeneticAlgorithm::Selection (Tournament)", populationSize, [&]() {
+		geneticAlgorithm.Selection();
+	});
+
+	// GeneticAlgorithm::Crossover, every crossover type with the same selection.
+	auto pairPopulation = geneticAlgorithm.Selection();
+	const std::vector<std::pair<Config::CrossoverType, std::string>> crossoverTypes = {
+		{ Config::CrossoverType::HEURISTIC, "Heuristic" },
+		{ Config::CrossoverType::ARITHMETIC, "Arithmetic" },
+		{ Config::CrossoverType::AVERAGE, "Average" },
+		{ Config::CrossoverType::ONEPOINT, "One point" }
+	};
+	for (const auto& [crossoverType, crossoverName] : crossoverTypes) {
+		geneticAlgorithm.SetCrossoverType(crossoverType);
+		Measure("GeneticAlgorithm::Crossover (" + crossoverName + ")", populationSize, [&]() {
+			geneticAlgorithm.Crossover(pairPopulation);
+		});
+	}
+
+	// GeneticAlgorithm::WriteCSV, always with the stats of the default number of generations.
+	// It is measured first because every SaveGenerationStats iteration adds a generation.
+	for (int i = 0; i < parameters.maxGenerations; ++i)
+		geneticAlgorithm.SaveGenerationStats();
+	std::string csvPath = (std::filesystem::path(outputPath).parent_path() / "Benchmark.csv").string();
+	Measure("GeneticAlgorithm::WriteCSV", populationSize, [&]() {
+		// Every export is printed, the console is muted while writing.
+		auto coutBuffer = std::cout.rdbuf(nullptr);
+		geneticAlgorithm.WriteCSV(csvPath);
+		std::cout.rdbuf(coutBuffer);
+	});
+	std::filesystem::remove(csvPath);
+
+	// GeneticAlgorithm::SaveGenerationStats.
+	Measure("GeneticAlgorithm::SaveGenerationStats", populationSize, [&]() {
+		geneticAlgorithm.SaveGenerationStats();
+	});
+
+	// Avoids the collision kernel being optimized away.
+	if (collisions < 0)
+		std::cout << collisions << std::endl;
+}
+
+/// <summary>
+/// Repeats a kernel until the minimum time or the maximum iterations are reached and saves its timings.
+/// </summary>
+/// <param name="name"> Kernel name. </param>
+/// <param name="populationSize"> Population size. </param>
+/// <param name="kernel"> Kernel to measure. </param>
+template<typename Kernel>
+void Benchmark::Measure(const std::string& name, int populationSize, Kernel&& kernel) {
+	BenchmarkResult result;
+	result.name = name;
+	result.populationSize = populationSize;
+	result.minMilliseconds = std::numeric_limits<double>::max();
+
+	std::chrono::nanoseconds totalTime{ 0 };
+	while (totalTime < minimumTime && result.iterations < maximumIterations) {
+		auto start = std::chrono::steady_clock::now();
+		kernel();
+		auto time = std::chrono::steady_clock::now() - start;
+
+		double milliseconds = std::chrono::duration<double, std::milli>(time).count();
+		result.minMilliseconds = std::min(result.minMilliseconds, milliseconds);
+		result.maxMilliseconds = std::max(result.maxMilliseconds, milliseconds);
+		totalTime += time;
+		result.iterations++;
+	}
+	result.meanMilliseconds = std::chrono::duration<double, std::milli>(totalTime).count() / result.iterations;
+
+	std::cout << std::left << std::setw(45) << name << std::right << std::fixed << std::setprecision(4)
+		<< std::setw(14) << result.meanMilliseconds << " ms (" << result.iterations << " iterations)" << std::endl;
+	std::cout.unsetf(std::ios::floatfield);
+
+	results.push_back(result);
+}
+
+/// <summary>
+/// Exports the results to the json file.
+/// </summary>
+void Benchmark::WriteJSON() const {
+	auto folder = std::filesystem::path(outputPath).parent_path();
+	if (!folder.empty())
+		std::filesystem::create_directories(folder);
+
+	std::ofstream stream(outputPath);
+	if (!stream.is_open()) {
+		std::cout << "Benchmark: could not open " << outputPath << std::endl;
+		return;
+	}
+
+	std::time_t now = std::time(nullptr);
+	stream << "{\n";
+	stream << "\t\"date\": \"" << std::put_time(std::localtime(&now), "%Y-%m-%d %H:%M:%S") << "\",\n";
+	stream << "\t\"seed\": " << seed << ",\n";
+	stream << "\t\"benchmarks\": [\n";
+	stream << std::fixed << std::setprecision(6);
+	for (size_t i = 0; i < results.size(); ++i) {
+		const auto& result = results[i];
+		stream << "\t\t{ \"name\": \"" << result.name << "\", \"populationSize\": " << result.populationSize
+			<< ", \"iterations\": " << result.iterations << ", \"meanMs\": " << result.meanMilliseconds
+			<< ", \"minMs\": " << result.minMilliseconds << ", \"maxMs\": " << result.maxMilliseconds << " }"
+			<< ((i + 1 < results.size()) ? "," : "") << "\n";
+	}
+	stream << "\t]\n";
+	stream << "}\n";
+
+	std::cout << "==============================\n";
+	std::cout << outputPath << " exported" << std::endl;
+}
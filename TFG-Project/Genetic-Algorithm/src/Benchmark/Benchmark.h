@@ -0,0 +1,107 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <chrono>
+
+/// <summary>
+/// Microbenchmarks of the simulation and genetic algorithm kernels without render.
+/// It is built on its own without the engine, so it only goes through the physics world and the genetic algorithm.
+/// Every kernel processes the whole population on each iteration and is repeated for every population size.
+/// The results are exported to a json file so they can be compared over time.
+/// </summary>
+class Benchmark {
+	public:
+		/// <summary>
+		/// Benchmark constructor.
+		/// </summary>
+		/// <param name="outputPath"> Path of the json file with the results. </param>
+		/// <param name="populationSizes"> Population sizes to benchmark. </param>
+		Benchmark(const std::string& outputPath, const std::vector<int>& populationSizes);
+
+		/// <summary>
+		/// Benchmark destructor.
+		/// </summary>
+		~Benchmark();
+
+		/// <summary>
+		/// Runs all the benchmarks and exports the results.
+		/// </summary>
+		void Run();
+
+		/// <summary>
+		/// Parses a comma separated list of population sizes.
+		/// </summary>
+		/// <param name="text"> Comma separated sizes. </param>
+		/// <param name="populationSizes"> Parsed sizes. </param>
+		/// <returns> If every size is valid. </returns>
+		static bool ParseSizes(const std::string& text, std::vector<int>& populationSizes);
+
+	private:
+		/// <summary>
+		/// Timings of one kernel with one population size.
+		/// </summary>
+		struct BenchmarkResult {
+			std::string name;
+			int populationSize = 0;
+			int iterations = 0;
+			double meanMilliseconds = 0.0;
+			double minMilliseconds = 0.0;
+			double maxMilliseconds = 0.0;
+		};
+
+		/// <summary>
+		/// Runs all the kernels with one population size.
+		/// </summary>
+		/// <param name="populationSize"> Population size. </param>
+		void RunPopulation(int populationSize);
+
+		/// <summary>
+		/// Repeats a kernel until the minimum time or the maximum iterations are reached and saves its timings.
+		/// </summary>
+		/// <param name="name"> Kernel name. </param>
+		/// <param name="populationSize"> Population size. </param>
+		/// <param name="kernel"> Kernel to measure. </param>
+		template<typename Kernel>
+		void Measure(const std::string& name, int populationSize, Kernel&& kernel);
+
+		/// <summary>
+		/// Exports the results to the json file.
+		/// </summary>
+		void WriteJSON() const;
+
+		/// <summary>
+		/// Path of the json file with the results.
+		/// </summary>
+		std::string outputPath;
+
+		/// <summary>
+		/// Population sizes to benchmark.
+		/// </summary>
+		std::vector<int> populationSizes;
+
+		/// <summary>
+		/// Results of every kernel and population size.
+		/// </summary>
+		std::vector<BenchmarkResult> results;
+
+		/// <summary>
+		/// Minimum time measuring every kernel.
+		/// </summary>
+		const std::chrono::milliseconds minimumTime{ 500 };
+
+		/// <summary>
+		/// Maximum iterations of every kernel.
+		/// </summary>
+		const int maximumIterations = 1000;
+
+		/// <summary>
+		/// Obstacles on the field for the contact queries.
+		/// </summary>
+		const int obstacles = 1000;
+
+		/// <summary>
+		/// Random seed, every run benchmarks the same population.
+		/// </summary>
+		const unsigned int seed = 1;
+};
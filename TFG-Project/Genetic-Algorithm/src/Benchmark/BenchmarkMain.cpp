@@ -0,0 +1,31 @@
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <Benchmark/Benchmark.h>
+
+// Benchmark executable without render: Benchmark [--sizes 50,1000,...] [--output file]
+int main(int argc, char* argv[]) {
+	std::string outputPath = "Simulations/Benchmark.json";
+	std::vector<int> populationSizes = { 50, 100, 1000, 10000, 100000 };
+
+	for (int i = 1; i + 1 < argc; i += 2) {
+		std::string option(argv[i]);
+		if (option == "--sizes") {
+			if (!Benchmark::ParseSizes(argv[i + 1], populationSizes))
+				return EXIT_FAILURE;
+		}
+		else if (option == "--output") {
+			outputPath = argv[i + 1];
+		}
+		else {
+			std::cout << "Unknown option " << option << std::endl;
+			return EXIT_FAILURE;
+		}
+	}
+
+	Benchmark benchmark(outputPath, populationSizes);
+	benchmark.Run();
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,61 @@
+#include "OBBBatch.h"
+
+#include <DataTypes/OBBCollider.h>
+
+/// <summary>
+/// OBBBatch constructor.
+/// </summary>
+OBBBatch::OBBBatch() {
+
+}
+
+/// <summary>
+/// OBBBatch destructor.
+/// </summary>
+OBBBatch::~OBBBatch() {
+
+}
+
+/// <summary>
+/// Reserves memory for some colliders.
+/// </summary>
+/// <param name="capacity"> Number of colliders. </param>
+void OBBBatch::Reserve(size_t capacity) {
+	for (auto& component : centers)
+		component.reserve(capacity);
+	for (auto& component : axes)
+		component.reserve(capacity);
+	for (auto& component : halfExtents)
+		component.reserve(capacity);
+}
+
+/// <summary>
+/// Removes all the colliders.
+/// </summary>
+void OBBBatch::Clear() {
+	for (auto& component : centers)
+		component.clear();
+	for (auto& component : axes)
+		component.clear();
+	for (auto& component : halfExtents)
+		component.clear();
+	size = 0;
+}
+
+/// <summary>
+/// Adds a collider at the end of the batch.
+/// </summary>
+/// <param name="obb"> Collider to add. </param>
+void OBBBatch::Add(const OBBCollider* obb) {
+	const auto& center = obb->GetBoxCenter();
+	const auto& boxAxes = obb->GetBoxAxes();
+	const auto& extents = obb->GetHalfExtents();
+
+	for (int i = 0; i < 3; ++i) {
+		centers[i].push_back(center[i]);
+		halfExtents[i].push_back(extents[i]);
+		for (int j = 0; j < 3; ++j)
+			axes[3 * i + j].push_back(boxAxes[i][j]);
+	}
+	size++;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <array>
+#include <vector>
+
+class OBBCollider;
+
+/// <summary>
+/// OBB colliders stored as structure of arrays so one collider can be tested against all of them with SIMD.
+/// Clear keeps the memory, refilling the batch every frame does not allocate.
+/// </summary>
+class OBBBatch {
+	public:
+		/// <summary>
+		/// OBBBatch constructor.
+		/// </summary>
+		OBBBatch();
+
+		/// <summary>
+		/// OBBBatch destructor.
+		/// </summary>
+		~OBBBatch();
+
+		/// <summary>
+		/// Reserves memory for some colliders.
+		/// </summary>
+		/// <param name="capacity"> Number of colliders. </param>
+		void Reserve(size_t capacity);
+
+		/// <summary>
+		/// Removes all the colliders.
+		/// </summary>
+		void Clear();
+
+		/// <summary>
+		/// Adds a collider at the end of the batch.
+		/// </summary>
+		/// <param name="obb"> Collider to add. </param>
+		void Add(const OBBCollider* obb);
+
+		/// <summary>
+		/// Returns the number of colliders.
+		/// </summary>
+		/// <returns> Number of colliders. </returns>
+		size_t Size() const { return size; }
+
+		/// <summary>
+		/// Center coordinates, one array per component.
+		/// </summary>
+		std::array<std::vector<float>, 3> centers;
+
+		/// <summary>
+		/// Orthonormal axes, axes[3 * i + j] is the component j of the axis i.
+		/// </summary>
+		std::array<std::vector<float>, 9> axes;
+
+		/// <summary>
+		/// Half extents along every axis.
+		/// </summary>
+		std::array<std::vector<float>, 3> halfExtents;
+
+	private:
+		/// <summary>
+		/// Number of colliders.
+		/// </summary>
+		size_t size = 0;
+};
@@ -1,11 +1,97 @@
 #include "OBBCollider.h"
 
+#include <DataTypes/OBBBatch.h>
+
 #include <GLM/glm.hpp>
 
 #include <iostream>
 #include <cmath>
 #include <limits>       // std::numeric_limits
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define OBB_SSE
+	#include <xmmintrin.h>
+#endif
+
+/// <summary>
+/// Added to the rotation terms so almost parallel axes do not create a false separating axis from a null cross product.
+/// </summary>
+static const float parallelEpsilon = 1e-5f;
+
+/// <summary>
+/// Scalar absolute value for the separating axis test.
+/// </summary>
+static inline float Abs(float value) { return std::fabs(value); }
+
+/// <summary>
+/// Scalar comparison for the separating axis test.
+/// </summary>
+static inline bool Greater(float a, float b) { return a > b; }
+
+#ifdef OBB_SSE
+/// <summary>
+/// 4 floats with the operators used by the separating axis test, one lane per collider.
+/// </summary>
+struct Float4 {
+	Float4(float value) : value(_mm_set1_ps(value)) {}
+	Float4(__m128 value) : value(value) {}
+	Float4() : value(_mm_setzero_ps()) {}
+	__m128 value;
+};
+
+static inline Float4 operator+(Float4 a, Float4 b) { return _mm_add_ps(a.value, b.value); }
+static inline Float4 operator-(Float4 a, Float4 b) { return _mm_sub_ps(a.value, b.value); }
+static inline Float4 operator*(Float4 a, Float4 b) { return _mm_mul_ps(a.value, b.value); }
+static inline Float4 operator|(Float4 a, Float4 b) { return _mm_or_ps(a.value, b.value); }
+static inline Float4 Abs(Float4 a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a.value); }
+static inline Float4 Greater(Float4 a, Float4 b) { return _mm_cmpgt_ps(a.value, b.value); }
+#endif
+
+/// <summary>
+/// Separating axis test between two boxes with the 15 axes: 3 of A, 3 of B and the 9 cross products.
+/// T is float for one pair or Float4 for 4 pairs at a time, the same first box is in every lane.
+/// </summary>
+/// <param name="aAxes"> Axes of A, aAxes[3 * i + j] is the component j of the axis i. </param>
+/// <param name="a"> Half extents of A. </param>
+/// <param name="bAxes"> Axes of B, same layout as A. </param>
+/// <param name="b"> Half extents of B. </param>
+/// <param name="distance"> Center of B minus center of A. </param>
+/// <returns> True (or a full lane) if any axis separates the boxes. </returns>
+template<typename T, typename Mask>
+static inline Mask Separated(const T* aAxes, const T* a, const T* bAxes, const T* b, const T* distance) {
+	// Rotation of B in the frame of A and distance in the frame of A.
+	T R[3][3];
+	T absR[3][3];
+	T t[3];
+	for (int i = 0; i < 3; ++i) {
+		for (int j = 0; j < 3; ++j) {
+			R[i][j] = aAxes[3 * i] * bAxes[3 * j] + aAxes[3 * i + 1] * bAxes[3 * j + 1] + aAxes[3 * i + 2] * bAxes[3 * j + 2];
+			absR[i][j] = Abs(R[i][j]) + T(parallelEpsilon);
+		}
+		t[i] = distance[0] * aAxes[3 * i] + distance[1] * aAxes[3 * i + 1] + distance[2] * aAxes[3 * i + 2];
+	}
+
+	// Axes of A and B.
+	Mask separated = Greater(Abs(t[0]), a[0] + b[0] * absR[0][0] + b[1] * absR[0][1] + b[2] * absR[0][2]);
+	separated = separated | Greater(Abs(t[1]), a[1] + b[0] * absR[1][0] + b[1] * absR[1][1] + b[2] * absR[1][2]);
+	separated = separated | Greater(Abs(t[2]), a[2] + b[0] * absR[2][0] + b[1] * absR[2][1] + b[2] * absR[2][2]);
+	for (int j = 0; j < 3; ++j)
+		separated = separated | Greater(Abs(t[0] * R[0][j] + t[1] * R[1][j] + t[2] * R[2][j]), a[0] * absR[0][j] + a[1] * absR[1][j] + a[2] * absR[2][j] + b[j]);
+
+	// Cross products A0 x Bj, A1 x Bj and A2 x Bj.
+	separated = separated | Greater(Abs(t[2] * R[1][0] - t[1] * R[2][0]), a[1] * absR[2][0] + a[2] * absR[1][0] + b[1] * absR[0][2] + b[2] * absR[0][1]);
+	separated = separated | Greater(Abs(t[2] * R[1][1] - t[1] * R[2][1]), a[1] * absR[2][1] + a[2] * absR[1][1] + b[0] * absR[0][2] + b[2] * absR[0][0]);
+	separated = separated | Greater(Abs(t[2] * R[1][2] - t[1] * R[2][2]), a[1] * absR[2][2] + a[2] * absR[1][2] + b[0] * absR[0][1] + b[1] * absR[0][0]);
+	separated = separated | Greater(Abs(t[0] * R[2][0] - t[2] * R[0][0]), a[0] * absR[2][0] + a[2] * absR[0][0] + b[1] * absR[1][2] + b[2] * absR[1][1]);
+	separated = separated | Greater(Abs(t[0] * R[2][1] - t[2] * R[0][1]), a[0] * absR[2][1] + a[2] * absR[0][1] + b[0] * absR[1][2] + b[2] * absR[1][0]);
+	separated = separated | Greater(Abs(t[0] * R[2][2] - t[2] * R[0][2]), a[0] * absR[2][2] + a[2] * absR[0][2] + b[0] * absR[1][1] + b[1] * absR[1][0]);
+	separated = separated | Greater(Abs(t[1] * R[0][0] - t[0] * R[1][0]), a[0] * absR[1][0] + a[1] * absR[0][0] + b[1] * absR[2][2] + b[2] * absR[2][1]);
+	separated = separated | Greater(Abs(t[1] * R[0][1] - t[0] * R[1][1]), a[0] * absR[1][1] + a[1] * absR[0][1] + b[0] * absR[2][2] + b[2] * absR[2][0]);
+	separated = separated | Greater(Abs(t[1] * R[0][2] - t[0] * R[1][2]), a[0] * absR[1][2] + a[1] * absR[0][2] + b[0] * absR[2][1] + b[1] * absR[2][0]);
+
+	return separated;
+}
+
 /// <summary>
 /// OBBCollider constructor.
 /// </summary>
@@ -13,12 +99,12 @@
 /// <param name="vertexs"> OBB vertexs. </param>
 /// <param name="size"> OBB size. </param>
 /// <param name="axes"> OBB axes. </param>
-OBBCollider::OBBCollider(const glm::vec3 center, const std::vector<glm::vec3> vertexs, const glm::vec3 size, const glm::mat3 axes){
+OBBCollider::OBBCollider(const glm::vec3 center, const std::array<glm::vec3, 8>& vertexs, const glm::vec3 size, const glm::mat3 axes){
 	this->center = center;
-	this->vertexs.reserve(8);
 	this->vertexs = vertexs;
 	this->size = size;
 	this->axes = axes;
+	UpdateBox();
 }
 
 /// <summary>
@@ -34,6 +120,7 @@ OBBCollider::~OBBCollider(){
 /// <param name="translation"> Translation. </param>
 void OBBCollider::TranslateOBB(const glm::vec3 translation) {
 	this->center += translation;
+	this->boxCenter += translation;
 	for (uint16_t i = 0; i < 8; i++) {
 		this->vertexs[i] += translation;
 	}
@@ -45,87 +132,134 @@ void OBBCollider::TranslateOBB(const glm::vec3 translation) {
 /// <param name="obb"> OBBCollider to check</param>
 /// <returns> True if colliding, false if not. </returns>
 bool OBBCollider::IsColliding(const OBBCollider* obb)  const {
-	// <href="https://stackoverflow.com/questions/47866571/simple-oriented-bounding-box-obb-collision-detection-explaining">
-	static glm::vec3 rpos;
-	rpos = obb->GetCenter() - this->center;
-
-	return !(GetSeparatingPlane(rpos, this->axes[0], obb) || 
-		GetSeparatingPlane(rpos, this->axes[1], obb) ||
-		GetSeparatingPlane(rpos, this->axes[2], obb) ||
-		GetSeparatingPlane(rpos, obb->GetAxes()[0], obb) || 
-		GetSeparatingPlane(rpos, obb->GetAxes()[1], obb) ||
-		GetSeparatingPlane(rpos, obb->GetAxes()[2], obb) ||
-		GetSeparatingPlane(rpos, glm::cross(this->axes[0], obb->GetAxes()[0]), obb) ||
-		GetSeparatingPlane(rpos, glm::cross(this->axes[0], obb->GetAxes()[1]), obb) ||
-		GetSeparatingPlane(rpos, glm::cross(this->axes[0], obb->GetAxes()[2]), obb) ||
-		GetSeparatingPlane(rpos, glm::cross(this->axes[1], obb->GetAxes()[0]), obb) ||
-		GetSeparatingPlane(rpos, glm::cross(this->axes[1], obb->GetAxes()[1]), obb) ||
-		GetSeparatingPlane(rpos, glm::cross(this->axes[1], obb->GetAxes()[2]), obb) ||
-		GetSeparatingPlane(rpos, glm::cross(this->axes[2], obb->GetAxes()[0]), obb) ||
-		GetSeparatingPlane(rpos, glm::cross(this->axes[2], obb->GetAxes()[1]), obb) ||
-		GetSeparatingPlane(rpos, glm::cross(this->axes[2], obb->GetAxes()[2]), obb));
-}
+	float aAxes[9];
+	float bAxes[9];
+	float a[3];
+	float b[3];
+	float distance[3];
+	for (int i = 0; i < 3; ++i) {
+		for (int j = 0; j < 3; ++j) {
+			aAxes[3 * i + j] = this->boxAxes[i][j];
+			bAxes[3 * i + j] = obb->boxAxes[i][j];
+		}
+		a[i] = this->halfExtents[i];
+		b[i] = obb->halfExtents[i];
+		distance[i] = obb->boxCenter[i] - this->boxCenter[i];
+	}
 
-bool OBBCollider::GetSeparatingPlane(const glm::vec3& rpos, const glm::vec3& plane, const OBBCollider* obb2) const{
-	if (plane.x == 0 && plane.y == 0 && plane.z == 0)
-		return false;
+	return !Separated<float, bool>(aAxes, a, bAxes, b, distance);
+}
 
+/// <summary>
+/// Checks this OBBCollider against every collider of a batch, 4 at a time with SSE when available.
+/// </summary>
+/// <param name="batch"> Colliders to check. </param>
+/// <param name="colliding"> Output, 1 for every colliding collider of the batch and 0 for the rest. </param>
+/// <returns> Number of colliding colliders. </returns>
+size_t OBBCollider::IsColliding(const OBBBatch& batch, std::vector<uint8_t>& colliding) const {
+	const size_t size = batch.Size();
+	colliding.resize(size);
 
-	float aMin = std::numeric_limits<float>::lowest();
-	float aMax = std::numeric_limits<float>::max();
-	float bMin = std::numeric_limits<float>::lowest();
-	float bMax = std::numeric_limits<float>::max();
+	float aAxes[9];
+	float a[3];
+	for (int i = 0; i < 3; ++i) {
+		for (int j = 0; j < 3; ++j)
+			aAxes[3 * i + j] = this->boxAxes[i][j];
+		a[i] = this->halfExtents[i];
+	}
 
-	for (int i = 0; i < 8; i++) {
-		float aDist = glm::dot(this->vertexs[i], plane);
-		aMin = (aDist < aMin) ? aDist : aMin;
-		aMax = (aDist > aMax) ? aDist : aMax;
+	size_t collisions = 0;
+	size_t i = 0;
 
-		float bDist = glm::dot(obb2->GetVertexs()[i], plane);
-		bMin = (bDist < bMin) ? bDist : bMin;
-		bMax = (bDist > bMax) ? bDist : bMax;
+#ifdef OBB_SSE
+	// This collider is the same in every lane.
+	Float4 aAxes4[9];
+	Float4 a4[3];
+	Float4 center4[3];
+	for (int k = 0; k < 9; ++k)
+		aAxes4[k] = Float4(aAxes[k]);
+	for (int k = 0; k < 3; ++k) {
+		a4[k] = Float4(a[k]);
+		center4[k] = Float4(this->boxCenter[k]);
 	}
 
-	float longSpan = std::max(aMax, bMax) - std::min(aMin, bMin);
-	float sumSpan = aMax - aMin + bMax - bMin;
-	return longSpan < sumSpan; // Change this to <= if you want the case were they are touching but not overlapping, to count as an intersection
-
-	/*
-		// Define two intervals, a and b. Calculate their min and max values
-		for( int i = 0; i < 8; i++ ) {
-			float aDist = Vector3.Dot( aCorn[i], axis );
-			aMin = ( aDist < aMin ) ? aDist : aMin;
-			aMax = ( aDist > aMax ) ? aDist : aMax;
-			float bDist = Vector3.Dot( bCorn[i], axis );
-			bMin = ( bDist < bMin ) ? bDist : bMin;
-			bMax = ( bDist > bMax ) ? bDist : bMax;
+	for (; i + 4 <= size; i += 4) {
+		Float4 bAxes4[9];
+		Float4 b4[3];
+		Float4 distance4[3];
+		for (int k = 0; k < 9; ++k)
+			bAxes4[k] = Float4(_mm_loadu_ps(&batch.axes[k][i]));
+		for (int k = 0; k < 3; ++k) {
+			b4[k] = Float4(_mm_loadu_ps(&batch.halfExtents[k][i]));
+			distance4[k] = Float4(_mm_loadu_ps(&batch.centers[k][i])) - center4[k];
 		}
 
-    // One-dimensional intersection test between a and b
-    float longSpan = Mathf.Max( aMax, bMax ) - Mathf.Min( aMin, bMin );
-    float sumSpan = aMax - aMin + bMax - bMin;
-    return longSpan < sumSpan; // Change this to <= if you want the case were they are touching but not overlapping, to count as an intersection
-	*/
+		int separated = _mm_movemask_ps(Separated<Float4, Float4>(aAxes4, a4, bAxes4, b4, distance4).value);
+		for (int lane = 0; lane < 4; ++lane) {
+			colliding[i + lane] = ((separated >> lane) & 1) ? 0 : 1;
+			collisions += colliding[i + lane];
+		}
+	}
+#endif
 
+	for (; i < size; ++i) {
+		float bAxes[9];
+		float b[3];
+		float distance[3];
+		for (int k = 0; k < 9; ++k)
+			bAxes[k] = batch.axes[k][i];
+		for (int k = 0; k < 3; ++k) {
+			b[k] = batch.halfExtents[k][i];
+			distance[k] = batch.centers[k][i] - this->boxCenter[k];
+		}
 
-	/*auto one = std::fabs(glm::dot(rpos, plane));
-	auto two = std::fabs(glm::dot(this->axes[0] * (this->size.x / 2), plane));
-	auto three = std::fabs(glm::dot(this->axes[1] * (this->size.y / 2), plane));
-	auto four = std::fabs(glm::dot(glm::vec3(this->axes[2]) * (this->size.z / 2), plane));
-	auto five = std::fabs(glm::dot(obb2->GetAxes()[0] * (obb2->GetSize().x / 2), plane));
-	auto six = std::fabs(glm::dot(obb2->GetAxes()[1] * (obb2->GetSize().y / 2), plane));
-	auto seven = std::fabs(glm::dot(obb2->GetAxes()[2] * (obb2->GetSize().z / 2), plane));
+		colliding[i] = Separated<float, bool>(aAxes, a, bAxes, b, distance) ? 0 : 1;
+		collisions += colliding[i];
+	}
 
-	return one > (two + three + four + five + six + seven);*/
+	return collisions;
 }
 
+/// <summary>
+/// Calculates the collision box from the vertexs.
+/// </summary>
+void OBBCollider::UpdateBox() {
+	// Edges from the vertex 0: width (0->4), height (0->1) and depth (0->2).
+	glm::vec3 edges[3] = { vertexs[4] - vertexs[0], vertexs[1] - vertexs[0], vertexs[2] - vertexs[0] };
+	boxCenter = (vertexs[0] + vertexs[7]) * 0.5f;
+
+	// Orthonormal axes from the edges, null edges (flat meshes) use the world axes.
+	const float epsilon = std::numeric_limits<float>::epsilon();
+	glm::vec3 axis0 = (glm::length(edges[0]) > epsilon) ? glm::normalize(edges[0]) : glm::vec3(1.0f, 0.0f, 0.0f);
+	glm::vec3 axis1 = edges[1] - glm::dot(edges[1], axis0) * axis0;
+	if (glm::length(axis1) > epsilon) {
+		axis1 = glm::normalize(axis1);
+	}else {
+		axis1 = glm::cross(axis0, glm::vec3(0.0f, 0.0f, 1.0f));
+		if (glm::length(axis1) <= epsilon)
+			axis1 = glm::cross(axis0, glm::vec3(1.0f, 0.0f, 0.0f));
+		axis1 = glm::normalize(axis1);
+	}
+	boxAxes[0] = axis0;
+	boxAxes[1] = axis1;
+	boxAxes[2] = glm::cross(axis0, axis1);
+
+	// With a scale that shears the box the half extents enclose it.
+	for (int i = 0; i < 3; ++i) {
+		halfExtents[i] = 0.5f * (std::fabs(glm::dot(edges[0], boxAxes[i])) + std::fabs(glm::dot(edges[1], boxAxes[i])) + std::fabs(glm::dot(edges[2], boxAxes[i])));
+	}
+}
 
 /// <summary>
 /// Assign operator overload.
 /// </summary>
 /// <param name="in"> OBBCollider to assign. </param>
 void OBBCollider::operator=(const OBBCollider& in) {
-	center = in.GetCenter();
-	vertexs = in.GetVertexs();
-	size = in.GetSize();
-}
\ No newline at end of file
+	center = in.center;
+	vertexs = in.vertexs;
+	size = in.size;
+	axes = in.axes;
+	boxCenter = in.boxCenter;
+	boxAxes = in.boxAxes;
+	halfExtents = in.halfExtents;
+}
@@ -3,7 +3,11 @@
 #include <GLM/vec3.hpp>
 #include <GLM/mat3x3.hpp>
 
+#include <array>
 #include <vector>
+#include <cstdint>
+
+class OBBBatch;
 
 /*
 		IMPORTANT: All pivots are in the bottom center of the mesh.
@@ -39,7 +43,9 @@
 	*/
 
 /// <summary>
-/// Class to manage the OBB collider in the meshes
+/// Class to manage the OBB collider in the meshes.
+/// The collision tests use an orthonormal box (center, axes and half extents) calculated from the vertexs,
+/// they do not allocate and can be called from multiple threads.
 /// </summary>
 class OBBCollider{
 	public:
@@ -50,7 +56,7 @@ class OBBCollider{
 		/// <param name="vertexs"> OBB vertexs. </param>
 		/// <param name="size"> OBB size. </param>
 		/// <param name="axes"> OBB axes. </param>
-		OBBCollider(const glm::vec3 center, const std::vector<glm::vec3> vertexs, const glm::vec3 size, const glm::mat3 axes);
+		OBBCollider(const glm::vec3 center, const std::array<glm::vec3, 8>& vertexs, const glm::vec3 size, const glm::mat3 axes);
 
 		/// <summary>
 		/// OBBCollider Destructor.
@@ -71,13 +77,12 @@ class OBBCollider{
 		bool IsColliding(const OBBCollider* obb) const;
 
 		/// <summary>
-		/// Get the plane for the SAT.
+		/// Checks this OBBCollider against every collider of a batch, 4 at a time with SSE when available.
 		/// </summary>
-		/// <param name="rpos"></param>
-		/// <param name="plane"></param>
-		/// <param name="obb2"></param>
-		/// <returns></returns>
-		bool GetSeparatingPlane(const glm::vec3& rpos, const glm::vec3& plane, const OBBCollider* obb2) const;
+		/// <param name="batch"> Colliders to check. </param>
+		/// <param name="colliding"> Output, 1 for every colliding collider of the batch and 0 for the rest. </param>
+		/// <returns> Number of colliding colliders. </returns>
+		size_t IsColliding(const OBBBatch& batch, std::vector<uint8_t>& colliding) const;
 
 		/// <summary>
 		/// Assign operator overload.
@@ -89,7 +94,7 @@ class OBBCollider{
 		/// Returns OBBCollider vertexs.
 		/// </summary>
 		/// <returns> OBBCollider vertexs. </returns>
-		const std::vector<glm::vec3> GetVertexs() const { return vertexs; }
+		const std::array<glm::vec3, 8>& GetVertexs() const { return vertexs; }
 
 		/// <summary>
 		/// Returns OBBCollider center.
@@ -109,11 +114,29 @@ class OBBCollider{
 		/// <returns> OBBCollider axes. </returns>
 		const glm::mat3 GetAxes() const { return axes; }
 
+		/// <summary>
+		/// Returns the center of the collision box.
+		/// </summary>
+		/// <returns> Collision box center. </returns>
+		const glm::vec3& GetBoxCenter() const { return boxCenter; }
+
+		/// <summary>
+		/// Returns the orthonormal axes of the collision box.
+		/// </summary>
+		/// <returns> Collision box axes. </returns>
+		const glm::mat3& GetBoxAxes() const { return boxAxes; }
+
+		/// <summary>
+		/// Returns the half extents of the collision box along its axes.
+		/// </summary>
+		/// <returns> Collision box half extents. </returns>
+		const glm::vec3& GetHalfExtents() const { return halfExtents; }
+
 		/// <summary>
 		/// Sets OBBCollider vertexs. 
 		/// </summary>
 		/// <param name="vertexs"> OBBCollider vertexs. </param>
-		void SetVertexs(const std::vector<glm::vec3> vertexs) { this->vertexs = vertexs; }
+		void SetVertexs(const std::array<glm::vec3, 8>& vertexs) { this->vertexs = vertexs; UpdateBox(); }
 
 		/// <summary>
 		/// Sets OBBCollider center.
@@ -134,10 +157,15 @@ class OBBCollider{
 		void SetAxes(const glm::mat3 axes) { this->axes = axes; }
 
 	private:
+		/// <summary>
+		/// Calculates the collision box from the vertexs.
+		/// </summary>
+		void UpdateBox();
+
 		/// <summary>
 		/// OBB collider vertexs positions.
 		/// </summary>
-		std::vector<glm::vec3> vertexs;
+		std::array<glm::vec3, 8> vertexs;
 
 		/// <summary>
 		/// OBB collider center.
@@ -156,5 +184,20 @@ class OBBCollider{
 		/// OBB axes.
 		/// </summary>
 		glm::mat3 axes;
+
+		/// <summary>
+		/// Collision box center.
+		/// </summary>
+		glm::vec3 boxCenter{ 0.0f };
+
+		/// <summary>
+		/// Collision box orthonormal axes, one per column.
+		/// </summary>
+		glm::mat3 boxAxes{ 1.0f };
+
+		/// <summary>
+		/// Collision box half extents along its axes.
+		/// </summary>
+		glm::vec3 halfExtents{ 0.0f };
 };
 
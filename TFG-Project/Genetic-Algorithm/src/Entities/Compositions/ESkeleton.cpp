@@ -127,5 +127,34 @@ void ESkeleton::SetFlexibility(const Flexibility flexibility) {
 /// </summary>
 /// <return> New fitness </param>
 float ESkeleton::UpdateFitness() {
-	return fitnessValue = glm::distance(core->GetPosition(), startingPoint);
+	return fitnessValue = robustFitness ? *robustFitness : glm::distance(core->GetPosition(), startingPoint);
+}
+
+/// <summary>
+/// Copies the genes and the state of another skeleton.
+/// Flexibility, legs rotation boundaries, velocities and rotations, position, starting point and legs on air.
+/// </summary>
+/// <param name="skeleton"> Skeleton to copy. </param>
+void ESkeleton::CopyGenes(ESkeleton& skeleton) {
+	flexibility = skeleton.flexibility;
+
+	auto copyJoint = [](EMesh* joint, EMesh* other) {
+		joint->SetRotationBoundaries(other->GetRotationBoundaries());
+		joint->SetRotationVelocity(other->GetRotationVelocity());
+		joint->SetRotation(other->GetRotation());
+	};
+
+	for (int i = 0; i < 2; ++i) {
+		copyJoint(leg1Joints[i], skeleton.leg1Joints[i]);
+		copyJoint(leg2Joints[i], skeleton.leg2Joints[i]);
+	}
+
+	core->SetPosition(skeleton.core->GetPosition());
+	startingPoint = skeleton.startingPoint;
+	onAir = skeleton.onAir;
+	leg1OnAir = skeleton.leg1OnAir;
+	leg2OnAir = skeleton.leg2OnAir;
+	isDead = skeleton.isDead;
+	fitnessValue = skeleton.fitnessValue;
+	robustFitness = std::nullopt;
 }
\ No newline at end of file
@@ -3,6 +3,8 @@
 #include <GLM/vec3.hpp>
 
 #include <vector>
+#include <atomic>
+#include <optional>
 
 class EMesh;
 
@@ -176,6 +178,18 @@ class ESkeleton{
 		/// <param name="startingPoint"> Starting point. </param>
 		void SetStartingPoint(const glm::vec3 startingPoint) { this->startingPoint = startingPoint; }
 
+		/// <summary>
+		/// Returns the starting point.
+		/// </summary>
+		/// <returns> Starting point. </returns>
+		const glm::vec3 GetStartingPoint() const { return startingPoint; }
+
+		/// <summary>
+		/// Sets the fitness aggregated over several environments, it replaces the distance walked until it is reset.
+		/// </summary>
+		/// <param name="robustFitness"> Aggregated fitness, std::nullopt to use the distance walked. </param>
+		void SetRobustFitness(const std::optional<float> robustFitness) { this->robustFitness = robustFitness; }
+
 		/// <summary>
 		/// Returns if the skeleton is dead.
 		/// </summary>
@@ -188,6 +202,13 @@ class ESkeleton{
 		/// <return> New fitness </param>
 		float UpdateFitness();
 
+		/// <summary>
+		/// Copies the genes and the state of another skeleton.
+		/// Flexibility, legs rotation boundaries, velocities and rotations, position, starting point and legs on air.
+		/// </summary>
+		/// <param name="skeleton"> Skeleton to copy. </param>
+		void CopyGenes(ESkeleton& skeleton);
+
 		/// <summary>
 		/// Hip default rotation.
 		/// </summary>
@@ -202,7 +223,7 @@ class ESkeleton{
 		/// <summary>
 		/// Skeleton identifier.
 		/// </summary>
-		uint16_t skeletonId = 0;
+		int skeletonId = 0;
 
 		/// <summary>
 		/// Num of joints.
@@ -273,6 +294,11 @@ class ESkeleton{
 		/// </summary>
 		float fitnessValue{ 0 };
 
+		/// <summary>
+		/// Fitness aggregated over several environments.
+		/// </summary>
+		std::optional<float> robustFitness;
+
 		/// <summary>
 		/// Starting point.
 		/// </summary>
@@ -281,5 +307,5 @@ class ESkeleton{
 		/// <summary>
 		/// Static count for skeleton id's.
 		/// </summary>
-		inline static int skeletonNextId = 0;
+		inline static std::atomic<int> skeletonNextId{ 0 };
 };
@@ -0,0 +1,172 @@
+#include "EHeightfield.h"
+
+#include <Entities/EMesh.h>
+#include <DataTypes/OBBCollider.h>
+
+#include <GLM/common.hpp>
+#include <GLM/trigonometric.hpp>
+#include <RANDOM/random.hpp>
+// The headless build (HEADLESS defined) has no SOIL2 library, the images are decoded with the stb_image it bundles.
+#ifdef HEADLESS
+	#define STB_IMAGE_IMPLEMENTATION
+	#define STBI_NO_PKM
+	#include <SOIL2/stb_image.h>
+#else
+	#include <SOIL2/SOIL2.h>
+#endif
+
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+/// <summary>
+/// EHeightfield constructor, a flat grid over the top face of a mesh.
+/// </summary>
+/// <param name="ground"> Mesh with its collider already calculated. </param>
+/// <param name="cellSize"> Distance between heights. </param>
+EHeightfield::EHeightfield(EMesh* ground, float cellSize) {
+	glm::vec3 min(std::numeric_limits<float>::max());
+	glm::vec3 max(std::numeric_limits<float>::lowest());
+	for (const auto& vertex : ground->GetCollider()->GetVertexs()) {
+		min = glm::min(min, vertex);
+		max = glm::max(max, vertex);
+	}
+
+	SetPosition(glm::vec3(min.x, max.y, min.z));
+	size = glm::vec2(max.x - min.x, max.z - min.z);
+	columns = std::max(static_cast<int>(std::ceil(size.x / cellSize)), 1) + 1;
+	rows = std::max(static_cast<int>(std::ceil(size.y / cellSize)), 1) + 1;
+	this->cellSize = size / glm::vec2(columns - 1, rows - 1);
+	heights.assign(columns * rows, 0.0f);
+}
+
+/// <summary>
+/// EHeightfield destructor.
+/// </summary>
+EHeightfield::~EHeightfield() {
+
+}
+
+/// <summary>
+/// Generates the heights with value noise, same seed same terrain.
+/// </summary>
+/// <param name="seed"> Random seed. </param>
+/// <param name="amplitude"> Maximum height. </param>
+/// <param name="features"> Hills along every side on the first octave. </param>
+/// <param name="octaves"> Number of noise layers, each one with double frequency and half amplitude. </param>
+void EHeightfield::Generate(unsigned int seed, float amplitude, int features, int octaves) {
+	heights.assign(columns * rows, 0.0f);
+	if (amplitude <= 0.0f)
+		return;
+
+	// Own random engine so the terrain does not change the genetic algorithm random numbers.
+	effolkronium::random_local random;
+	random.seed(seed);
+
+	auto smoothstep = [](float t) { return t * t * (3.0f - 2.0f * t); };
+
+	float weight = 1.0f;
+	for (int octave = 0; octave < octaves; ++octave) {
+		int frequency = std::max(features, 1) << octave;
+		std::vector<float> lattice((frequency + 1) * (frequency + 1));
+		for (auto& value : lattice)
+			value = random.get(0.0f, 1.0f);
+
+		for (int row = 0; row < rows; ++row) {
+			float v = static_cast<float>(row) / (rows - 1) * frequency;
+			int z = std::min(static_cast<int>(v), frequency - 1);
+			float tz = smoothstep(v - z);
+			for (int column = 0; column < columns; ++column) {
+				float u = static_cast<float>(column) / (columns - 1) * frequency;
+				int x = std::min(static_cast<int>(u), frequency - 1);
+				float tx = smoothstep(u - x);
+
+				float top = glm::mix(lattice[z * (frequency + 1) + x], lattice[z * (frequency + 1) + x + 1], tx);
+				float bottom = glm::mix(lattice[(z + 1) * (frequency + 1) + x], lattice[(z + 1) * (frequency + 1) + x + 1], tx);
+				heights[row * columns + column] += glm::mix(top, bottom, tz) * weight;
+			}
+		}
+		weight *= 0.5f;
+	}
+
+	// The lowest point stays at the ground level and the highest one at the amplitude.
+	auto bounds = std::minmax_element(heights.begin(), heights.end());
+	float lowest = *bounds.first;
+	float range = std::max(*bounds.second - lowest, std::numeric_limits<float>::epsilon());
+	for (auto& height : heights)
+		height = (height - lowest) / range * amplitude;
+}
+
+/// <summary>
+/// Loads the heights from a grayscale image stretched over the grid, white is the maximum height.
+/// The grid takes the image resolution.
+/// </summary>
+/// <param name="path"> Image path. </param>
+/// <param name="amplitude"> Maximum height. </param>
+/// <returns> If the image has been loaded. </returns>
+bool EHeightfield::LoadImage(const std::string& path, float amplitude) {
+	int width, height, channels;
+#ifdef HEADLESS
+	unsigned char* data = stbi_load(path.c_str(), &width, &height, &channels, 1);
+	auto freeImage = [](unsigned char* data) { stbi_image_free(data); };
+#else
+	unsigned char* data = SOIL_load_image(path.c_str(), &width, &height, &channels, SOIL_LOAD_L);
+	auto freeImage = [](unsigned char* data) { SOIL_free_image_data(data); };
+#endif
+	if (!data || width < 2 || height < 2) {
+		std::cout << "Heightfield image " << path << " could not be loaded" << std::endl;
+		freeImage(data);
+		return false;
+	}
+
+	columns = width;
+	rows = height;
+	cellSize = size / glm::vec2(columns - 1, rows - 1);
+	heights.resize(columns * rows);
+	for (int i = 0; i < columns * rows; ++i)
+		heights[i] = data[i] / 255.0f * amplitude;
+
+	freeImage(data);
+
+	return true;
+}
+
+/// <summary>
+/// Adds a ramp along z to the heights, it starts rising at a z coordinate.
+/// </summary>
+/// <param name="degrees"> Slope angle. </param>
+/// <param name="startZ"> Z coordinate where the ramp starts. </param>
+void EHeightfield::AddSlope(float degrees, float startZ) {
+	float gradient = std::tan(glm::radians(degrees));
+	for (int row = 0; row < rows; ++row) {
+		float z = position.z + row * cellSize.y;
+		float rise = std::max(z - startZ, 0.0f) * gradient;
+		for (int column = 0; column < columns; ++column)
+			heights[row * columns + column] += rise;
+	}
+}
+
+/// <summary>
+/// Returns the bilinear interpolated height at a point of the ground plane.
+/// </summary>
+/// <param name="x"> X coordinate. </param>
+/// <param name="z"> Z coordinate. </param>
+/// <returns> World "y" coordinate, lowest float outside the grid. </returns>
+float EHeightfield::GetHeight(float x, float z) const {
+	float u = (x - position.x) / cellSize.x;
+	float v = (z - position.z) / cellSize.y;
+	if (u < 0.0f || v < 0.0f || u > columns - 1 || v > rows - 1)
+		return std::numeric_limits<float>::lowest();
+
+	int column = std::min(static_cast<int>(u), columns - 2);
+	int row = std::min(static_cast<int>(v), rows - 2);
+	float tx = u - column;
+	float tz = v - row;
+
+	const float* cell = &heights[row * columns + column];
+	float top = glm::mix(cell[0], cell[1], tx);
+	float bottom = glm::mix(cell[columns], cell[columns + 1], tx);
+
+	return position.y + glm::mix(top, bottom, tz);
+}
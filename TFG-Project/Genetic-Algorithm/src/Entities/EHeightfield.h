@@ -0,0 +1,115 @@
+#pragma once
+
+#include "Entity.h"
+
+#include <GLM/vec2.hpp>
+
+#include <string>
+#include <vector>
+
+class EMesh;
+
+/// <summary>
+/// Heightfield terrain, a regular grid of heights over the ground plane.
+/// The entity position is the corner of the grid with the lowest x and z, heights are relative to it.
+/// Heights are generated with seeded noise or loaded from a grayscale image and sampled in O(1) by the physics.
+/// </summary>
+class EHeightfield : public Entity {
+	public:
+		/// <summary>
+		/// EHeightfield constructor, a flat grid over the top face of a mesh.
+		/// </summary>
+		/// <param name="ground"> Mesh with its collider already calculated. </param>
+		/// <param name="cellSize"> Distance between heights. </param>
+		EHeightfield(EMesh* ground, float cellSize = 10.0f);
+
+		/// <summary>
+		/// EHeightfield destructor.
+		/// </summary>
+		~EHeightfield() override;
+
+		/// <summary>
+		/// Generates the heights with value noise, same seed same terrain.
+		/// </summary>
+		/// <param name="seed"> Random seed. </param>
+		/// <param name="amplitude"> Maximum height. </param>
+		/// <param name="features"> Hills along every side on the first octave. </param>
+		/// <param name="octaves"> Number of noise layers, each one with double frequency and half amplitude. </param>
+		void Generate(unsigned int seed, float amplitude, int features = 8, int octaves = 4);
+
+		/// <summary>
+		/// Loads the heights from a grayscale image stretched over the grid, white is the maximum height.
+		/// The grid takes the image resolution.
+		/// </summary>
+		/// <param name="path"> Image path. </param>
+		/// <param name="amplitude"> Maximum height. </param>
+		/// <returns> If the image has been loaded. </returns>
+		bool LoadImage(const std::string& path, float amplitude);
+
+		/// <summary>
+		/// Adds a ramp along z to the heights, it starts rising at a z coordinate.
+		/// </summary>
+		/// <param name="degrees"> Slope angle. </param>
+		/// <param name="startZ"> Z coordinate where the ramp starts. </param>
+		void AddSlope(float degrees, float startZ);
+
+		/// <summary>
+		/// Returns the bilinear interpolated height at a point of the ground plane.
+		/// </summary>
+		/// <param name="x"> X coordinate. </param>
+		/// <param name="z"> Z coordinate. </param>
+		/// <returns> World "y" coordinate, lowest float outside the grid. </returns>
+		float GetHeight(float x, float z) const;
+
+		/// <summary>
+		/// Returns the height of a grid point.
+		/// </summary>
+		/// <param name="column"> Column, along x. </param>
+		/// <param name="row"> Row, along z. </param>
+		/// <returns> Height relative to the entity position. </returns>
+		float GetGridHeight(int column, int row) const { return heights[row * columns + column]; }
+
+		/// <summary>
+		/// Returns the number of grid points along x.
+		/// </summary>
+		/// <returns> Columns. </returns>
+		int GetColumns() const { return columns; }
+
+		/// <summary>
+		/// Returns the number of grid points along z.
+		/// </summary>
+		/// <returns> Rows. </returns>
+		int GetRows() const { return rows; }
+
+		/// <summary>
+		/// Returns the distance between grid points.
+		/// </summary>
+		/// <returns> X and z distance. </returns>
+		const glm::vec2& GetCellSize() const { return cellSize; }
+
+	private:
+		/// <summary>
+		/// Grid points along x.
+		/// </summary>
+		int columns = 2;
+
+		/// <summary>
+		/// Grid points along z.
+		/// </summary>
+		int rows = 2;
+
+		/// <summary>
+		/// Distance between grid points, x and z.
+		/// </summary>
+		glm::vec2 cellSize{ 10.0f };
+
+		/// <summary>
+		/// Size of the grid, x and z.
+		/// </summary>
+		glm::vec2 size{ 0.0f };
+
+		/// <summary>
+		/// Heights row by row.
+		/// </summary>
+		std::vector<float> heights;
+};
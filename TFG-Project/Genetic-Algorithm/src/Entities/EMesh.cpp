@@ -39,11 +39,8 @@ EMesh::~EMesh() {
 /// <param name="collider"> Entity collider. </param>
 void EMesh::SetCollider(OBBCollider collider){
 	if (!this->collider) {
-		this->collider = std::make_unique<OBBCollider>(collider.GetCenter(), collider.GetVertexs(), collider.GetSize(), collider.GetAxes());
+		this->collider = std::make_unique<OBBCollider>(collider);
 	}else{
-		this->collider->SetCenter(collider.GetCenter());
-		this->collider->SetVertexs(collider.GetVertexs());
-		this->collider->SetSize(collider.GetSize());
-		this->collider->SetAxes(collider.GetAxes());
+		*this->collider = collider;
 	}
 }
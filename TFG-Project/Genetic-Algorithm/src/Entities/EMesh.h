@@ -2,6 +2,7 @@
 
 #include "Entity.h"
 
+#include <memory>
 #include <string>
 
 class Transformable;
@@ -50,6 +51,12 @@ class EMesh : public Entity {
 		/// <returns> OBBCollider. </returns>
 		OBBCollider* GetCollider() { return collider.get(); }
 
+		/// <summary>
+		/// Returns OBBCollider.
+		/// </summary>
+		/// <returns> OBBCollider. </returns>
+		const OBBCollider* GetCollider() const { return collider.get(); }
+
 		/// <summary>
 		/// Returns rotation velocity.
 		/// </summary>
@@ -6,8 +6,7 @@
 /// Entity constructor. Increments the static ID field everytime an entity is created.
 /// </summary>
 Entity::Entity() {
-	id = nextId;
-	nextId++;
+	id = nextId++;
 }
 
 /// <summary>
@@ -7,6 +7,7 @@
 #include <DataTypes/Transformable.h>
 
 #include <utility>
+#include <atomic>
 
 /// <summary>
 /// Generic entity class.
@@ -239,6 +240,7 @@ class Entity{
 	private:
 		/// <summary>
 		/// Entity next Id.
+		/// Atomic because entities can be created from multiple simulations at the same time.
 		/// </summary>
-		inline static uint32_t nextId{ 1 };
+		inline static std::atomic<uint32_t> nextId{ 1 };
 };
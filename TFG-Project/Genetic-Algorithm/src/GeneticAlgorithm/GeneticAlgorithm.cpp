@@ -2,6 +2,7 @@
 
 #include <Utils/Config.h>
 #include <Utils/Utils.h>
+#include <Utils/Profiler.h>
 #include <Entities/Compositions/ESkeleton.h>
 #include <Entities/EMesh.h>
 #include <Render/ImGuiManager.h>
@@ -14,71 +15,69 @@
 
 #include <iostream>
 #include <algorithm>
-#include <ctime>
 
-using Random = effolkronium::random_static;
+using Random = effolkronium::random_thread_local;
 
 /// <summary>
 /// GeneticAlgorithm constructor.
 /// </summary>
-GeneticAlgorithm::GeneticAlgorithm() {
-	imGuiManager = ImGuiManager::GetInstance();
+GeneticAlgorithm::GeneticAlgorithm() : GeneticAlgorithm(Config::GetParameters()) {
+	PrintParameters();
+}
 
+/// <summary>
+/// GeneticAlgorithm constructor with its own configuration.
+/// </summary>
+/// <param name="parameters"> Configuration values. </param>
+GeneticAlgorithm::GeneticAlgorithm(const Config::Parameters& parameters) :
+	parameters(parameters) {
 	glm::vec3 offset = Utils::defaultPosition;
 	glm::vec3 offsetIncrese = Utils::positionOffset;
 
 	// Create population
-	for (uint16_t i = 0; i < Config::populationSize; ++i) {
-		// Entities creation.
-		auto core = new EMesh(Transformable(offset, glm::vec3(0.0f, 0.0f, 0), glm::vec3(0.1f)), "media/torso2.obj");
-		core->SetName("Core");
-		auto hip1 = new EMesh(Transformable(glm::vec3(-28.0f, 0.0f, 0.0f), ESkeleton::hipDefaultRotation, glm::vec3(0.75f)), "media/cinturaD2.obj", core);
-		hip1->SetName("Hip1");
-		auto knee1 = new EMesh(Transformable(glm::vec3(23.0f, 200.0f, 0.0f), ESkeleton::kneeDefaultRotation, glm::vec3(1.0f)), "media/rodilla.obj", hip1);
-		knee1->SetName("Knee1");
-		auto hip2 = new EMesh(Transformable(glm::vec3(24.0f, 0.0f, 0.0f), ESkeleton::hipDefaultRotation, glm::vec3(0.75f)), "media/cinturaI2.obj", core);
-		hip2->SetName("Hip2");
-		auto knee2 = new EMesh(Transformable(glm::vec3(-18.0f, 200.0f, 0.0f), ESkeleton::kneeDefaultRotation, glm::vec3(1.0f)), "media/rodilla.obj", hip2);
-		knee2->SetName("Knee2");
-		auto shoulder1 = new EMesh(Transformable(glm::vec3(-50.0f, 150.0f, -20.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(1.0f)), "media/brazo arriba.obj", core);
-		shoulder1->SetName("Shoulder1");
-		auto elbow1 = new EMesh(Transformable(glm::vec3(-80.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(1.0f)), "media/brazo abajo.obj", shoulder1);
-		elbow1->SetName("Elbow1");
-		auto shoulder2 = new EMesh(Transformable(glm::vec3(40.0f, 150.0f, -20.0f), glm::vec3(0.0f, 180.0f, 0.0f), glm::vec3(1.0f)), "media/brazo arriba.obj", core);
-		shoulder2->SetName("Shoulder2");
-		auto elbow2 = new EMesh(Transformable(glm::vec3(-80.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(1.0f)), "media/brazo abajo.obj", shoulder2);
-		elbow2->SetName("Elbow2");
-
-		population.push_back(std::make_unique<ESkeleton>(core, hip1, knee1, hip2, knee2, shoulder1, elbow1, shoulder2, elbow2));
+	for (int i = 0; i < parameters.populationSize; ++i) {
+		population.push_back(CreateSkeleton(offset));
 		
 		GenerateRandomSkeletonValues(population[i].get());
 
 		offset.x += offsetIncrese.x;
 	}
+}
 
+/// <summary>
+/// GeneticAlgorithm destructor.
+/// </summary>
+GeneticAlgorithm::~GeneticAlgorithm() {
+
+}
+
+/// <summary>
+/// Prints the configuration values.
+/// </summary>
+void GeneticAlgorithm::PrintParameters() const {
 	std::cout << "==============================\n";
 
-	std::cout << "Population size: " << Config::populationSize << std::endl;
-	std::cout << "Life span: " << Config::generationLifeSpan << std::endl;
-	std::cout << "Max generations: " << Config::maxGenerations << std::endl;
-	std::cout << "New genes probability: " << Config::newGenProbability * 100 << "%" << std::endl;
-	std::cout << "Mutation rate: " << Config::mutationProbability * 100 << "%" <<std::endl;
+	std::cout << "Population size: " << parameters.populationSize << std::endl;
+	std::cout << "Life span: " << parameters.generationLifeSpan << std::endl;
+	std::cout << "Max generations: " << parameters.maxGenerations << std::endl;
+	std::cout << "New genes probability: " << parameters.newGenProbability * 100 << "%" << std::endl;
+	std::cout << "Mutation rate: " << parameters.mutationProbability * 100 << "%" <<std::endl;
 
 	std::string selectionFunction;
-	switch (Config::selectionFunction) {
+	switch (parameters.selectionFunction) {
 		case Config::SelectionFunction::ROULETTE: {
 			selectionFunction = "Roulette";
 			break;
 		}
 		case Config::SelectionFunction::TOURNAMENT: {
-			selectionFunction = "Tournament-" + std::to_string(Config::tournamentMembers);
+			selectionFunction = "Tournament-" + std::to_string(parameters.tournamentMembers);
 			break;
 		}
 	}
 	std::cout << "Selection function: " << selectionFunction << std::endl;
 	
 	std::string crossoverType;
-	switch (Config::crossoverType) {
+	switch (parameters.crossoverType) {
 		case(Config::CrossoverType::HEURISTIC): {
 			crossoverType = "Heuristic";
 			break;
@@ -102,18 +101,12 @@ GeneticAlgorithm::GeneticAlgorithm() {
 
 }
 
-/// <summary>
-/// GeneticAlgorithm destructor.
-/// </summary>
-GeneticAlgorithm::~GeneticAlgorithm() {
-
-}
-
 /// <summary>
 /// Updates all related to the genetic algorithm
 /// </summary>
 /// <param time="time"> Life of the generation. </param>
 void GeneticAlgorithm::Update(long long time) {
+	PROFILE_FUNCTION();
 	int deads = 0;
 	int totalFitness = 0;
 	float minGeneFitness = std::numeric_limits<float>::max();
@@ -124,11 +117,45 @@ void GeneticAlgorithm::Update(long long time) {
 		return skeleton1->GetFitness() > skeleton2->GetFitness();
 	});
 
+	// Important genetic algorithm flow
+	if (time > 0) {
+		for (auto gene : population) {
+			totalFitness += gene->UpdateFitness();
+
+			if (gene->IsDead()) {
+				deads++;
+			}
+			
+			if (gene->GetFitness() > topGeneFitness) {
+				topGeneFitness = gene->GetFitness();
+				bestGeneId = gene->GetSkeletonId();
+			}
+
+			minGeneFitness = (gene->GetFitness() < minGeneFitness && !gene->IsDead()) ? gene->GetFitness() : minGeneFitness;
+		}
+	}
+
+	deathPercentage = (deads / (float)parameters.populationSize) * 100.0;
+	averageFitness = (totalFitness / (float)parameters.populationSize);
+	minFitness = minGeneFitness;
+	topFitness = topGeneFitness;
+}
+
+/// <summary>
+/// Shows the genetic algorithm debug window.
+/// </summary>
+/// <param time="time"> Life of the generation. </param>
+void GeneticAlgorithm::ShowDebugWindow(long long time) {
+	PROFILE_FUNCTION();
+	if (!imGuiManager) {
+		imGuiManager = ImGuiManager::GetInstance();
+	}
+
 	imGuiManager->Begin("Genetic algorithm debug");
 	imGuiManager->BeginTabBar("Genetic algorithm");
 
 	if (imGuiManager->AddTab("Resume")) {
-		imGuiManager->BulletText(std::string("Generation " + std::to_string(actualGeneration) + " (" + std::to_string(Config::maxGenerations - actualGeneration) + " left)"));
+		imGuiManager->BulletText(std::string("Generation " + std::to_string(actualGeneration) + " (" + std::to_string(parameters.maxGenerations - actualGeneration) + " left)"));
 		imGuiManager->BulletText(std::string("Life time: " + std::to_string(time/1000.0) + "s"));
 		imGuiManager->BulletText(std::string("Deaths percentage: " + std::to_string(deathPercentage) + "%%"));
 		imGuiManager->BulletText(std::string("Average fitness: " + std::to_string(averageFitness)));
@@ -227,7 +254,7 @@ void GeneticAlgorithm::Update(long long time) {
 		imGuiManager->Separator();
 
 		if (imGuiManager->Header("Death percentage")) {
-			ImPlot::SetNextPlotLimits(1, Config::maxGenerations, -10, 100);
+			ImPlot::SetNextPlotLimits(1, parameters.maxGenerations, -10, 100);
 			if (generationsStats.size() > 1 && ImPlot::BeginPlot("Death percentage", "Generations", "Death percentage")) {
 				ImPlot::PlotLine("% Death percentage", xValues, deathValues, size);
 				ImPlot::EndPlot();
@@ -235,7 +262,7 @@ void GeneticAlgorithm::Update(long long time) {
 		}
 
 		if (imGuiManager->Header("Average fitness")) {
-			ImPlot::SetNextPlotLimits(1, Config::maxGenerations, 0, 200);
+			ImPlot::SetNextPlotLimits(1, parameters.maxGenerations, 0, 200);
 			if (generationsStats.size() > 1 && ImPlot::BeginPlot("Average fitness", "Generations", "Fitness")) {
 				ImPlot::PlotLine("Fitness value", xValues, fitnessValues, size);
 				ImPlot::EndPlot();
@@ -243,7 +270,7 @@ void GeneticAlgorithm::Update(long long time) {
 		}
 
 		if (imGuiManager->Header("Top fitness")) {
-			ImPlot::SetNextPlotLimits(1, Config::maxGenerations, 0, 200);
+			ImPlot::SetNextPlotLimits(1, parameters.maxGenerations, 0, 200);
 			if (generationsStats.size() > 1 && ImPlot::BeginPlot("Top fitness", "Generations", "Fitness")) {
 				ImPlot::PlotLine("Top fitness", xValues, topFitness, size);
 				ImPlot::EndPlot();
@@ -251,7 +278,7 @@ void GeneticAlgorithm::Update(long long time) {
 		}
 
 		if (imGuiManager->Header("Min fitness")) {
-			ImPlot::SetNextPlotLimits(1, Config::maxGenerations, 0, 200);
+			ImPlot::SetNextPlotLimits(1, parameters.maxGenerations, 0, 200);
 			if (generationsStats.size() > 1 && ImPlot::BeginPlot("Min fitness", "Generations", "Fitness")) {
 				ImPlot::PlotLine("Min fitness", xValues, minFitness, size);
 				ImPlot::EndPlot();
@@ -259,7 +286,7 @@ void GeneticAlgorithm::Update(long long time) {
 		}
 
 		if (imGuiManager->Header("Hip1 velocity")) {
-			ImPlot::SetNextPlotLimits(0, Config::maxGenerations, Config::rotationVelocityBoundaries.first.x - 20, Config::rotationVelocityBoundaries.second.x + 20);
+			ImPlot::SetNextPlotLimits(0, parameters.maxGenerations, parameters.rotationVelocityBoundaries.first.x - 20, parameters.rotationVelocityBoundaries.second.x + 20);
 			if (generationsStats.size() >= 1 && ImPlot::BeginPlot("Hip1 velocity", "Generations", "Velocity")) {
 				ImPlot::PlotErrorBars("Velocity", xValues, averageHip1Velocity, minHip1Velocity, topHip1Velocity,size);
 				ImPlot::PlotScatter("Velocity", xValues, averageHip1Velocity, size);
@@ -268,7 +295,7 @@ void GeneticAlgorithm::Update(long long time) {
 		}
 
 		if (imGuiManager->Header("Knee1 velocity")) {
-			ImPlot::SetNextPlotLimits(0, Config::maxGenerations, Config::rotationVelocityBoundaries.first.x - 20, Config::rotationVelocityBoundaries.second.x + 20);
+			ImPlot::SetNextPlotLimits(0, parameters.maxGenerations, parameters.rotationVelocityBoundaries.first.x - 20, parameters.rotationVelocityBoundaries.second.x + 20);
 			if (generationsStats.size() >= 1 && ImPlot::BeginPlot("Knee1 velocity", "Generations", "Velocity")) {
 				ImPlot::PlotErrorBars("Velocity", xValues, averageKnee1Velocity, minKnee1Velocity, topKnee1Velocity, size);
 				ImPlot::PlotScatter("Velocity", xValues, averageKnee1Velocity, size);
@@ -277,7 +304,7 @@ void GeneticAlgorithm::Update(long long time) {
 		}
 
 		if (imGuiManager->Header("Hip2 velocity")) {
-			ImPlot::SetNextPlotLimits(0, Config::maxGenerations, Config::rotationVelocityBoundaries.first.x - 20, Config::rotationVelocityBoundaries.second.x + 20);
+			ImPlot::SetNextPlotLimits(0, parameters.maxGenerations, parameters.rotationVelocityBoundaries.first.x - 20, parameters.rotationVelocityBoundaries.second.x + 20);
 			if (generationsStats.size() >= 1 && ImPlot::BeginPlot("Hip2 velocity", "Generations", "Velocity")) {
 				ImPlot::PlotErrorBars("Velocity", xValues, averageHip2Velocity, minHip2Velocity, topHip2Velocity, size);
 				ImPlot::PlotScatter("Velocity", xValues, averageHip2Velocity, size);
@@ -286,7 +313,7 @@ void GeneticAlgorithm::Update(long long time) {
 		}
 
 		if (imGuiManager->Header("Knee2 velocity")) {
-			ImPlot::SetNextPlotLimits(0, Config::maxGenerations, Config::rotationVelocityBoundaries.first.x - 20, Config::rotationVelocityBoundaries.second.x + 20);
+			ImPlot::SetNextPlotLimits(0, parameters.maxGenerations, parameters.rotationVelocityBoundaries.first.x - 20, parameters.rotationVelocityBoundaries.second.x + 20);
 			if (generationsStats.size() >= 1 && ImPlot::BeginPlot("Knee2 velocity", "Generations", "Velocity")) {
 				ImPlot::PlotErrorBars("Velocity", xValues, averageKnee2Velocity, minKnee2Velocity, topKnee2Velocity, size);
 				ImPlot::PlotScatter("Velocity", xValues, averageKnee2Velocity, size);
@@ -296,7 +323,7 @@ void GeneticAlgorithm::Update(long long time) {
 
 		auto rotationsPlots = [&](const std::string title, ImVec2* averageRotation, float* minRotation, float* topRotation) {
 			if (imGuiManager->Header(title.c_str())) {
-				ImPlot::SetNextPlotLimits(0, Config::maxGenerations, -100, 100);
+				ImPlot::SetNextPlotLimits(0, parameters.maxGenerations, -100, 100);
 				if (generationsStats.size() >= 1 && ImPlot::BeginPlot(std::string(title + " (average max & min)").c_str(), "Generations", "Angle(deg)")) {
 					float* centers = new float[size];
 					for (unsigned int j = 0; j < size; j++) {
@@ -358,30 +385,6 @@ void GeneticAlgorithm::Update(long long time) {
 		imGuiManager->EndTab();
 	}
 
-	// Important genetic algorithm flow
-	if (time > 0) {
-		for (auto gene : population) {
-			totalFitness += gene->UpdateFitness();
-
-			if (gene->IsDead()) {
-				deads++;
-			}
-			
-			if (gene->GetFitness() > topGeneFitness) {
-				topGeneFitness = gene->GetFitness();
-				bestGeneId = gene->GetSkeletonId();
-			}
-
-			minGeneFitness = (gene->GetFitness() < minGeneFitness && !gene->IsDead()) ? gene->GetFitness() : minGeneFitness;
-		}
-	}
-
-	deathPercentage = (deads / (float)Config::populationSize) * 100.0;
-	averageFitness = (totalFitness / (float)Config::populationSize);
-	minFitness = minGeneFitness;
-	topFitness = topGeneFitness;
-
-	// ImGui debug
 	if (imGuiManager->AddTab("Population")) {
 		for (auto gene : population) {
 			auto skeleton = gene->GetSkeleton();
@@ -472,6 +475,7 @@ void GeneticAlgorithm::Update(long long time) {
 /// Creates a new generation.
 /// </summary>
 void GeneticAlgorithm::NewGeneration() {
+	PROFILE_FUNCTION();
 	SaveGenerationStats();
 	auto gene = GetBestGene();
 	// Genetic algorithm flow: Selection -> Crossover -> Mutation
@@ -491,12 +495,12 @@ void GeneticAlgorithm::NewGeneration() {
 /// </summary>
 /// <returns> Pair with genes to change and genes that passed to the next generation. </returns>
 std::pair<std::vector<ESkeleton*>, std::vector<ESkeleton*>> GeneticAlgorithm::Selection() {
-	int newGenes = std::ceil(Config::populationSize * Config::newGenProbability); // Number of genes who will be new (from crossover)
+	int newGenes = std::ceil(parameters.populationSize * parameters.newGenProbability); // Number of genes who will be new (from crossover)
 	int genesToNewGeneration = 0;
 	auto populationAux = population;
 	std::vector<ESkeleton*> newPopulation;
 
-	switch (Config::selectionFunction){
+	switch (parameters.selectionFunction){
 		case Config::SelectionFunction::ROULETTE: {
 			// Sort the population based on the gene fitness. Worst = first
 			std::sort(populationAux.begin(), populationAux.end(), [](std::shared_ptr<ESkeleton> skeleton1, std::shared_ptr<ESkeleton> skeleton2) {
@@ -504,7 +508,7 @@ std::pair<std::vector<ESkeleton*>, std::vector<ESkeleton*>> GeneticAlgorithm::Se
 			});
 
 			// We have to recalculate rank table because the population change
-			while (genesToNewGeneration != Config::populationSize - newGenes) {
+			while (genesToNewGeneration != parameters.populationSize - newGenes) {
 				// Calculate the sum of all gene fitness
 				float totalFitness = 0;
 				int j = 0;
@@ -516,7 +520,7 @@ std::pair<std::vector<ESkeleton*>, std::vector<ESkeleton*>> GeneticAlgorithm::Se
 				// Create an array with probabilities from 0 to 1
 				nc::NdArray<float> rankProbabilities = nc::zeros<float>(1, populationAux.size() + 1);
 				float actualTotalFitness = 0;
-				for (uint16_t i = 1; i < rankProbabilities.shape().cols; i++) {
+				for (uint32_t i = 1; i < rankProbabilities.shape().cols; i++) {
 					rankProbabilities[0, i] = (populationAux[i - 1]->GetFitness() / totalFitness) + actualTotalFitness;
 					actualTotalFitness += populationAux[i - 1]->GetFitness() / totalFitness;
 				}
@@ -540,14 +544,14 @@ std::pair<std::vector<ESkeleton*>, std::vector<ESkeleton*>> GeneticAlgorithm::Se
 
 		case Config::SelectionFunction::TOURNAMENT: {
 			// NOTE: Since we have a sorted vector by fitness, the tournament winner will be always the minimum index
-			//		 between all the Config::tournamentMembers but just for scalability we will not have this in count and
+			//		 between all the parameters.tournamentMembers but just for scalability we will not have this in count and
 			//		 we will act as if the vector is not sorted.
-			while (genesToNewGeneration != Config::populationSize - newGenes) {
+			while (genesToNewGeneration != parameters.populationSize - newGenes) {
 				std::vector<int> membersIndexs;
 
 				// If we have enought genes to set a tournament
-				if (Config::tournamentMembers <= populationAux.size()) {
-					while (membersIndexs.size() < Config::tournamentMembers) {
+				if (static_cast<size_t>(parameters.tournamentMembers) <= populationAux.size()) {
+					while (membersIndexs.size() < static_cast<size_t>(parameters.tournamentMembers)) {
 						int indx = Random::get<int>(0, populationAux.size() - 1);
 						bool repeated = false;
 
@@ -565,8 +569,8 @@ std::pair<std::vector<ESkeleton*>, std::vector<ESkeleton*>> GeneticAlgorithm::Se
 				}
 				else {
 					// If we have less genes than members to pick for the tournament just pick all the rest
-					for (uint16_t i = 0; i < populationAux.size(); ++i) {
-						membersIndexs.push_back(i);
+					for (size_t i = 0; i < populationAux.size(); ++i) {
+						membersIndexs.push_back(static_cast<int>(i));
 					}
 				}
 
@@ -666,7 +670,7 @@ void GeneticAlgorithm::Crossover(std::pair<std::vector<ESkeleton*>, std::vector<
 
 		};
 
-		switch (Config::crossoverType) {
+		switch (parameters.crossoverType) {
 			// Select a random point and before this point all the values will be from parent1 and after from parent2
 			case Config::CrossoverType::ONEPOINT: {
 				int point = Random::get<int>(1, numberOfParameters - 1);
@@ -730,10 +734,10 @@ void GeneticAlgorithm::Crossover(std::pair<std::vector<ESkeleton*>, std::vector<
 				auto heuristic = [](float bestValue, float worstValue, float ratio) {
 					return bestValue + (ratio * (bestValue - worstValue));
 				};
-				auto pairHeuristic = [&heuristic](std::pair<float, float> bestPair, std::pair<float, float> worstPair, float min, float max) {
+				auto pairHeuristic = [&heuristic, this](std::pair<float, float> bestPair, std::pair<float, float> worstPair, float min, float max) {
 					auto pair = std::pair<float, float>(worstPair.first,worstPair.second);
 
-					for (uint16_t i = 0; i < Config::heuristicTries; ++i) {
+					for (uint16_t i = 0; i < parameters.heuristicTries; ++i) {
 						float ratio = Random::get<float>(0, 1);
 
 						pair = std::pair<float, float>(heuristic(bestPair.first, worstPair.first,ratio), heuristic(bestPair.second, worstPair.second,ratio));
@@ -745,10 +749,10 @@ void GeneticAlgorithm::Crossover(std::pair<std::vector<ESkeleton*>, std::vector<
 
 					return pair;
 				};
-				auto vec3Heuristic = [&heuristic](glm::vec3 bestVec3, glm::vec3 worstVec3, float min, float max) {
+				auto vec3Heuristic = [&heuristic, this](glm::vec3 bestVec3, glm::vec3 worstVec3, float min, float max) {
 					auto vec3 = glm::vec3(worstVec3.x, worstVec3.y, worstVec3.z);
 
-					for (uint16_t i = 0; i < Config::heuristicTries; i++) {
+					for (uint16_t i = 0; i < parameters.heuristicTries; i++) {
 						float ratio = Random::get<float>(0, 1);
 
 						vec3 = glm::vec3(heuristic(bestVec3.x, worstVec3.x,ratio), heuristic(bestVec3.y, worstVec3.y,ratio), heuristic(bestVec3.z, worstVec3.z,ratio));
@@ -763,8 +767,8 @@ void GeneticAlgorithm::Crossover(std::pair<std::vector<ESkeleton*>, std::vector<
 
 				// TODO: Cambiar esto por un valor n para hacer pruebas y que no se salgan de los valores limites.
 				
-				float rotationVelocityMin = Config::rotationVelocityBoundaries.first.x;
-				float rotationVelocityMax = Config::rotationVelocityBoundaries.second.x;
+				float rotationVelocityMin = parameters.rotationVelocityBoundaries.first.x;
+				float rotationVelocityMax = parameters.rotationVelocityBoundaries.second.x;
 
 				// 0. Hip1 rotation boundaries
 				gene->GetLeg1()[0]->SetRotationBoundaries(pairHeuristic(parent1->GetLeg1()[0]->GetRotationBoundaries(), parent2->GetLeg1()[0]->GetRotationBoundaries(),-160,160));
@@ -796,7 +800,7 @@ void GeneticAlgorithm::Mutation() {
 	for (auto gene : population) {
 		float prob = Random::get<float>(0, 1);
 
-		if (prob <= Config::mutationProbability) {
+		if (prob <= parameters.mutationProbability) {
 			GenerateRandomSkeletonValues(gene.get());
 		}
 	}
@@ -918,6 +922,7 @@ void GeneticAlgorithm::SetDefaultPopulationValues() {
 		gene->GetLeg2()[1]->SetRotation(ESkeleton::kneeDefaultRotation);
 
 		gene->SetStartingPoint(gene->GetCore()->GetPosition());
+		gene->SetRobustFitness(std::nullopt);
 		gene->UpdateFitness();
 		offset.x += offsetIncrese.x;
 	}
@@ -931,6 +936,35 @@ std::vector<std::shared_ptr<ESkeleton>> GeneticAlgorithm::GetPopulation() {
 	return population;
 }
 
+/// <summary>
+/// Creates a skeleton with its entities, every gene with its default value.
+/// </summary>
+/// <param name="position"> Core position. </param>
+/// <returns> Skeleton. </returns>
+std::shared_ptr<ESkeleton> GeneticAlgorithm::CreateSkeleton(const glm::vec3& position) {
+	// Entities creation.
+	auto core = new EMesh(Transformable(position, glm::vec3(0.0f, 0.0f, 0), glm::vec3(0.1f)), "media/torso2.obj");
+	core->SetName("Core");
+	auto hip1 = new EMesh(Transformable(glm::vec3(-28.0f, 0.0f, 0.0f), ESkeleton::hipDefaultRotation, glm::vec3(0.75f)), "media/cinturaD2.obj", core);
+	hip1->SetName("Hip1");
+	auto knee1 = new EMesh(Transformable(glm::vec3(23.0f, 200.0f, 0.0f), ESkeleton::kneeDefaultRotation, glm::vec3(1.0f)), "media/rodilla.obj", hip1);
+	knee1->SetName("Knee1");
+	auto hip2 = new EMesh(Transformable(glm::vec3(24.0f, 0.0f, 0.0f), ESkeleton::hipDefaultRotation, glm::vec3(0.75f)), "media/cinturaI2.obj", core);
+	hip2->SetName("Hip2");
+	auto knee2 = new EMesh(Transformable(glm::vec3(-18.0f, 200.0f, 0.0f), ESkeleton::kneeDefaultRotation, glm::vec3(1.0f)), "media/rodilla.obj", hip2);
+	knee2->SetName("Knee2");
+	auto shoulder1 = new EMesh(Transformable(glm::vec3(-50.0f, 150.0f, -20.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(1.0f)), "media/brazo arriba.obj", core);
+	shoulder1->SetName("Shoulder1");
+	auto elbow1 = new EMesh(Transformable(glm::vec3(-80.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(1.0f)), "media/brazo abajo.obj", shoulder1);
+	elbow1->SetName("Elbow1");
+	auto shoulder2 = new EMesh(Transformable(glm::vec3(40.0f, 150.0f, -20.0f), glm::vec3(0.0f, 180.0f, 0.0f), glm::vec3(1.0f)), "media/brazo arriba.obj", core);
+	shoulder2->SetName("Shoulder2");
+	auto elbow2 = new EMesh(Transformable(glm::vec3(-80.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(1.0f)), "media/brazo abajo.obj", shoulder2);
+	elbow2->SetName("Elbow2");
+
+	return std::make_shared<ESkeleton>(core, hip1, knee1, hip2, knee2, shoulder1, elbow1, shoulder2, elbow2);
+}
+
 /// <summary>
 /// Returns the best gene of the last generation
 /// </summary>
@@ -961,7 +995,7 @@ ESkeleton* GeneticAlgorithm::GetBestGene() {
 /// </summary>
 /// <param name="skeleton"> Skeleton. </param>
 void GeneticAlgorithm::GenerateRandomSkeletonValues(ESkeleton* skeleton) {
-	auto setLegBoundaries = [](std::vector<EMesh*> leg) {
+	auto setLegBoundaries = [this](std::vector<EMesh*> leg) {
 		auto hip = leg[0];
 		auto knee = leg[1];
 
@@ -969,7 +1003,7 @@ void GeneticAlgorithm::GenerateRandomSkeletonValues(ESkeleton* skeleton) {
 		std::pair<float, float> boundaries = { Random::get<float>(knee->GetRotationBoundaries().first, knee->GetRotationBoundaries().second) , Random::get<float>(knee->GetRotationBoundaries().first, knee->GetRotationBoundaries().second) };
 		knee->SetRotationBoundaries(std::pair<float, float>(std::min(boundaries.first, boundaries.second), std::max(boundaries.first, boundaries.second)));
 
-		glm::vec3 kneeVelocity = glm::vec3(Random::get<float>(Config::rotationVelocityBoundaries.first.x, Config::rotationVelocityBoundaries.second.x), 0.0f, 0.0f);
+		glm::vec3 kneeVelocity = glm::vec3(Random::get<float>(parameters.rotationVelocityBoundaries.first.x, parameters.rotationVelocityBoundaries.second.x), 0.0f, 0.0f);
 		knee->SetRotationVelocity(kneeVelocity);
 
 		// Hip boundaries
@@ -979,19 +1013,19 @@ void GeneticAlgorithm::GenerateRandomSkeletonValues(ESkeleton* skeleton) {
 		}
 		hip->SetRotationBoundaries(std::pair<float, float>(std::min(boundaries.first, boundaries.second), std::max(boundaries.first, boundaries.second)));
 
-		glm::vec3 hipVelocity = glm::vec3(Random::get<float>(Config::rotationVelocityBoundaries.first.x, Config::rotationVelocityBoundaries.second.x), 0.0f, 0.0f);
+		glm::vec3 hipVelocity = glm::vec3(Random::get<float>(parameters.rotationVelocityBoundaries.first.x, parameters.rotationVelocityBoundaries.second.x), 0.0f, 0.0f);
 		hip->SetRotationVelocity(hipVelocity);
 	};
 
 	// Set skeleton flexibility
 	float flexibility = Random::get<float>(0, 1);
-	if (flexibility >= 0 && flexibility <= Config::flexibilityProbability.x) {
+	if (flexibility >= 0 && flexibility <= parameters.flexibilityProbability.x) {
 		skeleton->SetFlexibility(ESkeleton::Flexibility::LOW);
 	}
-	else if (flexibility > Config::flexibilityProbability.x && flexibility <= Config::flexibilityProbability.x + Config::flexibilityProbability.y) {
+	else if (flexibility > parameters.flexibilityProbability.x && flexibility <= parameters.flexibilityProbability.x + parameters.flexibilityProbability.y) {
 		skeleton->SetFlexibility(ESkeleton::Flexibility::MEDIUM);
 	}
-	else if (flexibility > Config::flexibilityProbability.x + Config::flexibilityProbability.y) {
+	else if (flexibility > parameters.flexibilityProbability.x + parameters.flexibilityProbability.y) {
 		skeleton->SetFlexibility(ESkeleton::Flexibility::HIGH);
 	}
 	else {
@@ -1009,17 +1043,19 @@ void GeneticAlgorithm::GenerateRandomSkeletonValues(ESkeleton* skeleton) {
 /// </summary>
 void GeneticAlgorithm::WriteCSV() {
 	int randomNumber = Random::get<int>(0, std::numeric_limits<int>::max());
-	// current date/time based on current system
-	std::time_t now = std::time(0);
+	WriteCSV("Simulations/Simulation" + std::to_string(randomNumber) + ".csv");
+}
 
-	// convert now to string form
-	std::string time = std::asctime(std::localtime(&now));
-	std::string title("Simulations/Simulation" + std::to_string(randomNumber) +".csv");
+/// <summary>
+/// Exports the generation's data to a csv.
+/// </summary>
+/// <param name="title"> Path of the csv file. </param>
+void GeneticAlgorithm::WriteCSV(const std::string& title) {
 	std::ofstream stream(title);
 	csv2::Writer<csv2::delimiter<','>> writer(stream);
 
 	std::string selectionFunction;
-	switch (Config::selectionFunction) {
+	switch (parameters.selectionFunction) {
 		case Config::SelectionFunction::ROULETTE: {
 			selectionFunction = "Roulette";
 			break;
@@ -1031,7 +1067,7 @@ void GeneticAlgorithm::WriteCSV() {
 	}
 
 	std::string crossoverType;
-	switch (Config::crossoverType) {
+	switch (parameters.crossoverType) {
 		case(Config::CrossoverType::HEURISTIC): {
 			crossoverType = "Heuristic";
 			break;
@@ -1050,12 +1086,75 @@ void GeneticAlgorithm::WriteCSV() {
 		}
 	}
 
+	std::string terrain = "Flat";
+	if (parameters.terrainAmplitude > 0.0f)
+		terrain = parameters.terrainImage.empty() ? "Seed " + std::to_string(parameters.terrainSeed) : parameters.terrainImage;
+
+	std::string physicsBackend = (parameters.physicsBackend == Config::PhysicsBackendType::KINEMATIC) ? "Kinematic" : "Articulated";
+	std::string jointIntegration = (parameters.jointIntegration == Config::JointIntegration::FIXED) ? "Fixed" : "Event";
+
+	std::string gaitExtrapolation;
+	switch (parameters.gaitExtrapolation) {
+		case Config::GaitExtrapolation::ON: {
+			gaitExtrapolation = "On";
+			break;
+		}
+		case Config::GaitExtrapolation::VERIFY: {
+			gaitExtrapolation = "Verify";
+			break;
+		}
+		default: {
+			gaitExtrapolation = "Off";
+			break;
+		}
+	}
+
+	std::string feasibilityScreen;
+	switch (parameters.feasibilityScreen) {
+		case Config::FeasibilityScreen::FLAG: {
+			feasibilityScreen = "Flag";
+			break;
+		}
+		case Config::FeasibilityScreen::REJECT: {
+			feasibilityScreen = "Reject";
+			break;
+		}
+		default: {
+			feasibilityScreen = "None";
+			break;
+		}
+	}
+
+	std::string environmentFitness = "Nominal";
+	if (parameters.environments > 1) {
+		switch (parameters.environmentFitness) {
+			case Config::EnvironmentFitness::MIN: {
+				environmentFitness = "Min";
+				break;
+			}
+			case Config::EnvironmentFitness::QUANTILE: {
+				environmentFitness = "Quantile " + std::to_string(parameters.environmentQuantile);
+				break;
+			}
+			default: {
+				environmentFitness = "Mean";
+				break;
+			}
+		}
+	}
+
+	// The configuration columns identify the runs of the same configuration when the csv files are aggregated.
 	std::vector<std::vector<std::string>> rows =
 	{
-		{"Population size", "Life span (sec)", "Max generations", "New genes probability", "Mutation rate", "Selection function", "Crossover operator"},
-		{std::to_string(Config::populationSize), std::to_string(Config::generationLifeSpan),std::to_string(Config::maxGenerations)
-		, std::to_string(Config::newGenProbability), std::to_string(Config::mutationProbability), selectionFunction, crossoverType},
-		{"", "", "", "", "Tournament members", std::to_string(Config::tournamentMembers), ""},
+		{"Population size", "Life span (sec)", "Max generations", "New genes probability", "Mutation rate", "Selection function", "Crossover operator"
+		, "Heuristic tries", "Terrain amplitude", "Terrain", "Physics", "Joint integration", "Physics step frames", "Gait extrapolation", "Feasibility screen"
+		, "Environments", "Environment fitness", "Environment slope", "Environment gravity", "Environment phase (sec)"},
+		{std::to_string(parameters.populationSize), std::to_string(parameters.generationLifeSpan),std::to_string(parameters.maxGenerations)
+		, std::to_string(parameters.newGenProbability), std::to_string(parameters.mutationProbability), selectionFunction, crossoverType
+		, std::to_string(parameters.heuristicTries), std::to_string(parameters.terrainAmplitude), terrain, physicsBackend, jointIntegration
+		, std::to_string(parameters.physicsStepFrames), gaitExtrapolation, feasibilityScreen, std::to_string(parameters.environments), environmentFitness
+		, std::to_string(parameters.environmentSlope), std::to_string(parameters.environmentGravity), std::to_string(parameters.environmentPhase)},
+		{"", "", "", "", "Tournament members", std::to_string(parameters.tournamentMembers), ""},
 		{"", "", "", "", "", "", ""},
 
 		{"Generation", "Death percentage", "Average fitness", "Top fitness", "Min fitness"
@@ -1,6 +1,11 @@
 #pragma once
 
+#include <Utils/Config.h>
+
+#include <GLM/vec3.hpp>
+
 #include <memory>
+#include <string>
 #include <vector>
 #include <utility>
 #include <limits>
@@ -18,6 +23,12 @@ class GeneticAlgorithm {
 		/// </summary>
 		GeneticAlgorithm();
 
+		/// <summary>
+		/// GeneticAlgorithm constructor with its own configuration.
+		/// </summary>
+		/// <param name="parameters"> Configuration values. </param>
+		GeneticAlgorithm(const Config::Parameters& parameters);
+
 		/// <summary>
 		/// GeneticAlgorithm destructor.
 		/// </summary>
@@ -29,23 +40,73 @@ class GeneticAlgorithm {
 		/// <param time="time"> Life of the generation. </param>
 		void Update(long long time);
 
+		/// <summary>
+		/// Shows the genetic algorithm debug window.
+		/// </summary>
+		/// <param time="time"> Life of the generation. </param>
+		void ShowDebugWindow(long long time);
+
 		/// <summary>
 		/// Creates a new generation.
 		/// </summary>
 		void NewGeneration();
 
+		/// <summary>
+		/// Selection function.
+		/// pair.first  = vector with genes to be crossovered.
+		/// pair.second = vector with genes that passed to the next generation.
+		/// </summary>
+		/// <returns> Pair with genes to change and genes that passed to the next generation. </returns>
+		std::pair<std::vector<ESkeleton*>, std::vector<ESkeleton*>> Selection();
+
+		/// <summary>
+		/// Crossover function.
+		/// </summary>
+		/// <param name="pairPopulation"> pair.first = genes to be crossovered | pair.second = genes to crossover</param>
+		void Crossover(std::pair<std::vector<ESkeleton*>, std::vector<ESkeleton*>> pairPopulation);
+
+		/// <summary>
+		/// Saves the generation stats.
+		/// </summary>
+		void SaveGenerationStats();
+
 		/// <summary>
 		/// Returns the actual generation.
 		/// </summary>
 		/// <returns> Actual generation. </returns>
 		int GetGeneration() { return actualGeneration; }
 
+		/// <summary>
+		/// Returns the configuration values.
+		/// </summary>
+		/// <returns> Configuration values. </returns>
+		const Config::Parameters& GetParameters() const { return parameters; }
+
+		/// <summary>
+		/// Sets the selection function of the next generations.
+		/// </summary>
+		/// <param name="selectionFunction"> Selection function. </param>
+		void SetSelectionFunction(Config::SelectionFunction selectionFunction) { parameters.selectionFunction = selectionFunction; }
+
+		/// <summary>
+		/// Sets the crossover type of the next generations.
+		/// </summary>
+		/// <param name="crossoverType"> Crossover type. </param>
+		void SetCrossoverType(Config::CrossoverType crossoverType) { parameters.crossoverType = crossoverType; }
+
 		/// <summary>
 		/// Returns the population.
 		/// </summary>
 		/// <returns> Population. </returns>
 		std::vector<std::shared_ptr<ESkeleton>> GetPopulation();
 
+		/// <summary>
+		/// Creates a skeleton with its entities, every gene with its default value.
+		/// </summary>
+		/// <param name="position"> Core position. </param>
+		/// <returns> Skeleton. </returns>
+		static std::shared_ptr<ESkeleton> CreateSkeleton(const glm::vec3& position);
+
 		/// <summary>
 		/// Returns the best gene of the last generation.
 		/// </summary>
@@ -63,7 +124,12 @@ class GeneticAlgorithm {
 		/// </summary>
 		void WriteCSV();
 
-	private:
+		/// <summary>
+		/// Exports the generation's data to a csv.
+		/// </summary>
+		/// <param name="title"> Path of the csv file. </param>
+		void WriteCSV(const std::string& title);
+
 		/// <summary>
 		/// Auxiliar struct to storage multiple data about the generation.
 		/// </summary>
@@ -114,29 +180,22 @@ class GeneticAlgorithm {
 		};
 
 		/// <summary>
-		/// Selection function.
-		/// pair.first  = vector with genes to be crossovered.
-		/// pair.second = vector with genes that passed to the next generation.
+		/// Returns the stats of every finished generation.
 		/// </summary>
-		/// <returns> Pair with genes to change and genes that passed to the next generation. </returns>
-		std::pair<std::vector<ESkeleton*>, std::vector<ESkeleton*>> Selection();
+		/// <returns> Generations stats. </returns>
+		const std::vector<GenerationStats>& GetGenerationsStats() const { return generationsStats; }
 
+	private:
 		/// <summary>
-		/// Crossover function.
+		/// Prints the configuration values.
 		/// </summary>
-		/// <param name="pairPopulation"> pair.first = genes to be crossovered | pair.second = genes to crossover</param>
-		void Crossover(std::pair<std::vector<ESkeleton*>, std::vector<ESkeleton*>> pairPopulation);
+		void PrintParameters() const;
 
 		/// <summary>
 		/// Mutate the population.
 		/// </summary>
 		void Mutation();
 
-		/// <summary>
-		/// Saves the generation stats.
-		/// </summary>
-		void SaveGenerationStats();
-
 		/// <summary>
 		/// Resets all the generation values.
 		/// </summary>
@@ -153,6 +212,11 @@ class GeneticAlgorithm {
 		/// <param name="skeleton"> Skeleton. </param>
 		void GenerateRandomSkeletonValues(ESkeleton* skeleton);
 
+		/// <summary>
+		/// Configuration values.
+		/// </summary>
+		Config::Parameters parameters;
+
 		/// <summary>
 		/// Population.
 		/// </summary>
@@ -0,0 +1,354 @@
+#include "ArticulatedBackend.h"
+
+#include <Physics/PhysicsWorld.h>
+#include <Physics/MeshLibrary.h>
+#include <Entities/Compositions/ESkeleton.h>
+#include <Entities/EMesh.h>
+#include <Utils/Utils.h>
+#include <Utils/Profiler.h>
+
+#include <GLM/geometric.hpp>
+#include <GLM/trigonometric.hpp>
+#include <GLM/mat3x3.hpp>
+#include <GLM/gtx/norm.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+	/// <summary>
+	/// Spatial vectors on the plane are (angular, z, y) and are expressed at the core position.
+	/// Cross product of two motion vectors.
+	/// </summary>
+	/// <param name="v"> Motion vector. </param>
+	/// <param name="m"> Motion vector. </param>
+	/// <returns> v x m. </returns>
+	glm::dvec3 CrossMotion(const glm::dvec3& v, const glm::dvec3& m) {
+		return glm::dvec3(0.0, v.z * m.x - v.x * m.z, v.x * m.y - v.y * m.x);
+	}
+
+	/// <summary>
+	/// Cross product of a motion vector and a force vector.
+	/// </summary>
+	/// <param name="v"> Motion vector. </param>
+	/// <param name="f"> Force vector. </param>
+	/// <returns> v x* f. </returns>
+	glm::dvec3 CrossForce(const glm::dvec3& v, const glm::dvec3& f) {
+		return glm::dvec3(v.y * f.z - v.z * f.y, -v.x * f.z, v.x * f.y);
+	}
+
+	/// <summary>
+	/// Spatial inertia of a body at the origin.
+	/// </summary>
+	/// <param name="mass"> Mass. </param>
+	/// <param name="center"> Center of mass. </param>
+	/// <param name="rotational"> Rotational inertia around the center of mass. </param>
+	/// <returns> Spatial inertia. </returns>
+	glm::dmat3 Inertia(double mass, const glm::dvec2& center, double rotational) {
+		return glm::dmat3(
+			rotational + mass * glm::length2(center), -mass * center.y, mass * center.x,
+			-mass * center.y, mass, 0.0,
+			mass * center.x, 0.0, mass);
+	}
+
+	/// <summary>
+	/// Direction of a segment hanging from a joint, the angle rotates it forward.
+	/// </summary>
+	/// <param name="angle"> Angle from the vertical in radians. </param>
+	/// <returns> Unit direction. </returns>
+	glm::dvec2 Direction(double angle) {
+		return glm::dvec2(std::sin(angle), -std::cos(angle));
+	}
+}
+
+/// <summary>
+/// ArticulatedBackend constructor.
+/// </summary>
+/// <param name="threads"> Threads solving the skeletons at the same time. </param>
+ArticulatedBackend::ArticulatedBackend(unsigned int threads) :
+	pool(std::max(threads, 1u)) {
+
+}
+
+/// <summary>
+/// ArticulatedBackend destructor.
+/// </summary>
+ArticulatedBackend::~ArticulatedBackend() {
+
+}
+
+/// <summary>
+/// Updates one frame of the skeletons.
+/// The skeletons are solved in parallel and their colliders are updated afterwards.
+/// </summary>
+/// <param name="world"> Physics world of the skeletons. </param>
+/// <param name="skeletons"> Skeletons to update, the dead ones are skipped. </param>
+/// <param name="deltaTime"> Time to advance. </param>
+void ArticulatedBackend::Update(PhysicsWorld& world, const std::vector<std::shared_ptr<ESkeleton>>& skeletons, float deltaTime) {
+	PROFILE_FUNCTION();
+	frame++;
+
+	// A skeleton placed somewhere else than where it was left has been reset by the genetic algorithm.
+	alive.clear();
+	for (const auto& skeleton : skeletons) {
+		if (skeleton->IsDead())
+			continue;
+
+		auto& state = states[skeleton.get()];
+		if (state.skeletonId != skeleton->GetSkeletonId() || state.position != skeleton->GetCore()->GetPosition())
+			ResetState(world, skeleton.get(), state);
+		state.frame = frame;
+		alive.emplace_back(skeleton.get(), &state);
+	}
+
+	// The skeletons of the old generations are forgotten.
+	if (states.size() > 2 * skeletons.size()) {
+		for (auto state = states.begin(); state != states.end();)
+			state = (state->second.frame != frame) ? states.erase(state) : std::next(state);
+	}
+
+	// Every skeleton only touches its own entities, so they are solved in parallel.
+	// Longer updates than a frame take more sub steps, the sub step time does not change.
+	int steps = std::max(static_cast<int>(std::lround(deltaTime * Utils::FPS * subSteps)), 1);
+	auto solve = [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i) {
+			auto skeleton = alive[i].first;
+			auto& state = *alive[i].second;
+			float coreX = skeleton->GetCore()->GetPosition().x;
+
+			for (int step = 0; step < steps; ++step) {
+				UpdateTargets(state, static_cast<double>(deltaTime) / steps);
+				Step(world, state, coreX, static_cast<double>(deltaTime) / steps);
+			}
+			WriteState(skeleton, state);
+		}
+	};
+
+	size_t workers = std::min<size_t>(pool.GetThreads(), alive.size());
+	if (workers <= 1) {
+		solve(0, alive.size());
+	}
+	else {
+		size_t chunk = (alive.size() + workers - 1) / workers;
+		pool.Run((alive.size() + chunk - 1) / chunk, [&](size_t i) {
+			solve(i * chunk, std::min((i + 1) * chunk, alive.size()));
+		});
+	}
+
+	// The colliders and the death rules are the same as the kinematic model.
+	for (auto [skeleton, state] : alive) {
+		world.SetSkeletonValues(skeleton->GetSkeleton());
+
+		skeleton->SetLeg1OnAir(!state->contact[0]);
+		skeleton->SetLeg2OnAir(!state->contact[1]);
+		skeleton->SetOnAir(!state->contact[0] && !state->contact[1]);
+
+		// Hips too close to the ground or without ground below means the skeleton has fallen.
+		float coreX = skeleton->GetCore()->GetPosition().x;
+		bool fallen = false;
+		for (int leg = 0; leg < 2; ++leg) {
+			glm::dvec2 hip(state->q[1] + state->hip[leg].x, state->q[0] + state->hip[leg].y);
+			float ground = world.GetGroundHeight(coreX + state->legX[leg], static_cast<float>(hip.x));
+			fallen |= ground == std::numeric_limits<float>::lowest() || hip.y - ground < fallenHeight * (state->thigh + state->shin);
+		}
+
+		skeleton->SetIsDead(fallen || world.SkeletonDead(skeleton));
+	}
+}
+
+/// <summary>
+/// Reads the skeleton geometry and joints and starts the state at rest.
+/// </summary>
+/// <param name="world"> Physics world of the skeleton. </param>
+/// <param name="skeleton"> Skeleton. </param>
+/// <param name="state"> State to reset. </param>
+void ArticulatedBackend::ResetState(const PhysicsWorld& world, ESkeleton* skeleton, SkeletonState& state) const {
+	auto core = skeleton->GetCore();
+	auto meshLibrary = MeshLibrary::GetInstance();
+	glm::vec3 position = core->GetPosition();
+
+	state = SkeletonState();
+	state.skeletonId = skeleton->GetSkeletonId();
+	state.position = position;
+	state.q[0] = position.y;
+	state.q[1] = position.z;
+
+	// Core height to its center of mass.
+	auto coreWorld = world.CalculateWorldTransform(core);
+	state.torso = meshLibrary->GetExtremes(core->GetMeshPath()).second.y * glm::length(glm::vec3(coreWorld.model[1])) / 2.0;
+
+	std::vector<EMesh*> legs[2] = { skeleton->GetLeg1(), skeleton->GetLeg2() };
+	for (int leg = 0; leg < 2; ++leg) {
+		auto hip = legs[leg][0];
+		auto knee = legs[leg][1];
+		auto hipWorld = world.CalculateWorldTransform(hip);
+		auto kneeWorld = world.CalculateWorldTransform(knee, hipWorld);
+		glm::vec3 hipOrigin(hipWorld.model[3]);
+		glm::vec3 kneeOrigin(kneeWorld.model[3]);
+
+		// The thigh goes from the hip to the knee and the shin from the knee to the end of its mesh.
+		state.hip[leg] = glm::dvec2(hipOrigin.z - position.z, hipOrigin.y - position.y);
+		state.legX[leg] = kneeOrigin.x - position.x;
+		state.thigh = glm::length(glm::dvec2(kneeOrigin.z - hipOrigin.z, kneeOrigin.y - hipOrigin.y));
+		state.shin = meshLibrary->GetExtremes(knee->GetMeshPath()).second.y * glm::length(glm::vec3(kneeWorld.model[1]));
+
+		EMesh* joints[2] = { hip, knee };
+		for (int i = 0; i < 2; ++i) {
+			int joint = leg * 2 + i;
+			auto boundaries = joints[i]->GetRotationBoundaries();
+			state.lower[joint] = glm::radians(std::min(boundaries.first, boundaries.second));
+			state.upper[joint] = glm::radians(std::max(boundaries.first, boundaries.second));
+			state.q[2 + joint] = glm::radians(joints[i]->GetRotation().x);
+			state.target[joint] = state.q[2 + joint];
+			state.targetVelocity[joint] = glm::radians(joints[i]->GetRotationVelocity().x);
+		}
+	}
+}
+
+/// <summary>
+/// Moves the joint targets one sub step, they bounce between the rotation boundaries like the kinematic joints.
+/// </summary>
+/// <param name="state"> Skeleton state. </param>
+/// <param name="deltaTime"> Sub step time. </param>
+void ArticulatedBackend::UpdateTargets(SkeletonState& state, double deltaTime) const {
+	for (int joint = 0; joint < 4; ++joint) {
+		state.target[joint] += state.targetVelocity[joint] * deltaTime;
+		if (state.target[joint] >= state.upper[joint]) {
+			state.target[joint] = state.upper[joint];
+			state.targetVelocity[joint] = -std::abs(state.targetVelocity[joint]);
+		}
+		if (state.target[joint] <= state.lower[joint]) {
+			state.target[joint] = state.lower[joint];
+			state.targetVelocity[joint] = std::abs(state.targetVelocity[joint]);
+		}
+	}
+}
+
+/// <summary>
+/// Integrates one sub step with the articulated body algorithm.
+/// </summary>
+/// <param name="world"> Physics world, for the ground height. </param>
+/// <param name="state"> Skeleton state. </param>
+/// <param name="coreX"> World x of the skeleton. </param>
+/// <param name="deltaTime"> Sub step time. </param>
+void ArticulatedBackend::Step(const PhysicsWorld& world, SkeletonState& state, float coreX, double deltaTime) const {
+	// Bodies parents first: core height (massless), core forward with the torso, thigh 1, shin 1, thigh 2, shin 2.
+	const int parents[dofs] = { -1, 0, 1, 2, 1, 4 };
+	glm::dvec3 axis[dofs];
+	glm::dmat3 inertia[dofs];
+	glm::dvec2 knees[2], feet[2];
+
+	axis[0] = glm::dvec3(0.0, 0.0, 1.0);
+	axis[1] = glm::dvec3(0.0, 1.0, 0.0);
+	inertia[0] = glm::dmat3(0.0);
+	inertia[1] = Inertia(torsoMass, glm::dvec2(0.0, state.torso), torsoMass * state.torso * state.torso / 3.0);
+	for (int leg = 0; leg < 2; ++leg) {
+		const auto& hip = state.hip[leg];
+		glm::dvec2 thighDirection = Direction(state.q[2 + leg * 2]);
+		glm::dvec2 shinDirection = Direction(state.q[2 + leg * 2] + state.q[3 + leg * 2]);
+		knees[leg] = hip + thighDirection * state.thigh;
+		feet[leg] = knees[leg] + shinDirection * state.shin;
+
+		axis[2 + leg * 2] = glm::dvec3(1.0, hip.y, -hip.x);
+		axis[3 + leg * 2] = glm::dvec3(1.0, knees[leg].y, -knees[leg].x);
+		inertia[2 + leg * 2] = Inertia(thighMass, hip + thighDirection * (state.thigh / 2.0), thighMass * state.thigh * state.thigh / 12.0);
+		inertia[3 + leg * 2] = Inertia(shinMass, knees[leg] + shinDirection * (state.shin / 2.0), shinMass * state.shin * state.shin / 12.0);
+	}
+
+	// Velocities and velocity product accelerations.
+	glm::dvec3 velocity[dofs], bias[dofs];
+	for (int i = 0; i < dofs; ++i) {
+		glm::dvec3 jointVelocity = axis[i] * state.qd[i];
+		velocity[i] = (parents[i] < 0 ? glm::dvec3(0.0) : velocity[parents[i]]) + jointVelocity;
+		bias[i] = CrossMotion(velocity[i], jointVelocity);
+	}
+
+	// Ground contacts of the knees and the feet.
+	glm::dvec3 external[dofs] = {};
+	for (int leg = 0; leg < 2; ++leg) {
+		int shin = 3 + leg * 2;
+		state.contact[leg] = false;
+		for (const auto& point : { knees[leg], feet[leg] }) {
+			double ground = world.GetGroundHeight(coreX + state.legX[leg], static_cast<float>(state.q[1] + point.x));
+			double penetration = ground - (state.q[0] + point.y);
+			if (penetration <= 0.0)
+				continue;
+
+			glm::dvec2 pointVelocity(velocity[shin].y - velocity[shin].x * point.y, velocity[shin].z + velocity[shin].x * point.x);
+			double normal = std::max(contactStiffness * penetration - contactDamping * pointVelocity.y, 0.0);
+			double tangent = glm::clamp(-frictionDamping * pointVelocity.x, -friction * normal, friction * normal);
+			external[shin] += glm::dvec3(point.x * normal - point.y * tangent, tangent, normal);
+			state.contact[leg] = true;
+		}
+	}
+
+	// Joint torques, the cores are not actuated.
+	double torques[dofs] = {};
+	for (int joint = 0; joint < 4; ++joint) {
+		int dof = 2 + joint;
+		bool hip = (joint % 2) == 0;
+		double torque = (hip ? hipStiffness : kneeStiffness) * (state.target[joint] - state.q[dof])
+			+ (hip ? hipDamping : kneeDamping) * (state.targetVelocity[joint] - state.qd[dof]);
+		torque = glm::clamp(torque, -maxTorque, maxTorque);
+
+		if (state.q[dof] < state.lower[joint])
+			torque += limitStiffness * (state.lower[joint] - state.q[dof]) - limitDamping * std::min(state.qd[dof], 0.0);
+		if (state.q[dof] > state.upper[joint])
+			torque += limitStiffness * (state.upper[joint] - state.q[dof]) - limitDamping * std::max(state.qd[dof], 0.0);
+		torques[dof] = torque;
+	}
+
+	// Articulated inertias and bias forces from the leaves to the root.
+	glm::dmat3 articulatedInertia[dofs];
+	glm::dvec3 articulatedBias[dofs], inertiaAxis[dofs];
+	double invariant[dofs], force[dofs];
+	for (int i = 0; i < dofs; ++i) {
+		articulatedInertia[i] = inertia[i];
+		articulatedBias[i] = CrossForce(velocity[i], inertia[i] * velocity[i]) - external[i];
+	}
+	for (int i = dofs - 1; i >= 0; --i) {
+		inertiaAxis[i] = articulatedInertia[i] * axis[i];
+		invariant[i] = glm::dot(axis[i], inertiaAxis[i]);
+		force[i] = torques[i] - glm::dot(axis[i], articulatedBias[i]);
+		if (parents[i] < 0)
+			continue;
+
+		glm::dmat3 inertiaTransmitted = articulatedInertia[i] - glm::outerProduct(inertiaAxis[i], inertiaAxis[i]) / invariant[i];
+		articulatedInertia[parents[i]] += inertiaTransmitted;
+		articulatedBias[parents[i]] += articulatedBias[i] + inertiaTransmitted * bias[i] + inertiaAxis[i] * (force[i] / invariant[i]);
+	}
+
+	// Accelerations from the root to the leaves, gravity is the acceleration of the ground.
+	double g = world.gravityActivated ? gravity * world.GetGravityScale() : 0.0;
+	glm::dvec3 acceleration[dofs];
+	for (int i = 0; i < dofs; ++i) {
+		glm::dvec3 parentAcceleration = (parents[i] < 0 ? glm::dvec3(0.0, 0.0, g) : acceleration[parents[i]]) + bias[i];
+		double qdd = (force[i] - glm::dot(inertiaAxis[i], parentAcceleration)) / invariant[i];
+		acceleration[i] = parentAcceleration + axis[i] * qdd;
+
+		// Semi implicit Euler.
+		state.qd[i] += qdd * deltaTime;
+	}
+	for (int i = 0; i < dofs; ++i)
+		state.q[i] += state.qd[i] * deltaTime;
+}
+
+/// <summary>
+/// Writes the state on the skeleton entities.
+/// </summary>
+/// <param name="skeleton"> Skeleton. </param>
+/// <param name="state"> Skeleton state. </param>
+void ArticulatedBackend::WriteState(ESkeleton* skeleton, SkeletonState& state) const {
+	auto core = skeleton->GetCore();
+	state.position = glm::vec3(core->GetPosition().x, static_cast<float>(state.q[0]), static_cast<float>(state.q[1]));
+	core->SetPosition(state.position);
+
+	std::vector<EMesh*> legs[2] = { skeleton->GetLeg1(), skeleton->GetLeg2() };
+	for (int leg = 0; leg < 2; ++leg) {
+		for (int i = 0; i < 2; ++i) {
+			auto rotation = legs[leg][i]->GetRotation();
+			legs[leg][i]->SetRotation(glm::vec3(static_cast<float>(glm::degrees(state.q[2 + leg * 2 + i])), rotation.y, rotation.z));
+		}
+	}
+}
@@ -0,0 +1,156 @@
+#pragma once
+
+#include "PhysicsBackend.h"
+
+#include <Utils/WorkerPool.h>
+
+#include <GLM/vec2.hpp>
+#include <GLM/vec3.hpp>
+
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+
+/// <summary>
+/// Articulated rigid body physics model, the joints are moved by torques and the skeleton walks pushing the floor.
+/// The skeleton is solved on its sagittal plane (world z forward, world y up) with the articulated body algorithm:
+/// the core slides on a vertical and a horizontal prismatic joint and stays upright, every hip and knee is a revolute joint.
+/// The feet and knees touch the ground with spring dampers and Coulomb friction.
+/// Every joint follows the oscillation of its genes with a PD controller, the same movement as the kinematic model.
+/// </summary>
+class ArticulatedBackend : public PhysicsBackend {
+	public:
+		/// <summary>
+		/// ArticulatedBackend constructor.
+		/// </summary>
+		/// <param name="threads"> Threads solving the skeletons at the same time. </param>
+		ArticulatedBackend(unsigned int threads = 1);
+
+		/// <summary>
+		/// ArticulatedBackend destructor.
+		/// </summary>
+		~ArticulatedBackend() override;
+
+		/// <summary>
+		/// Updates one frame of the skeletons.
+		/// The skeletons are solved in parallel and their colliders are updated afterwards.
+		/// </summary>
+		/// <param name="world"> Physics world of the skeletons. </param>
+		/// <param name="skeletons"> Skeletons to update, the dead ones are skipped. </param>
+		/// <param name="deltaTime"> Time to advance. </param>
+		void Update(PhysicsWorld& world, const std::vector<std::shared_ptr<ESkeleton>>& skeletons, float deltaTime) override;
+
+	private:
+		/// <summary>
+		/// Degrees of freedom: core height, core forward position, hip 1, knee 1, hip 2, knee 2.
+		/// </summary>
+		static constexpr int dofs = 6;
+
+		/// <summary>
+		/// Dynamic state of a skeleton.
+		/// Positions on the plane are (world z, world y), angles are in radians.
+		/// </summary>
+		struct SkeletonState {
+			int skeletonId = -1;
+			uint64_t frame = 0;
+			glm::vec3 position{ 0.0f };
+			std::array<double, dofs> q{};
+			std::array<double, dofs> qd{};
+			std::array<double, 4> target{};
+			std::array<double, 4> targetVelocity{};
+			std::array<double, 4> lower{};
+			std::array<double, 4> upper{};
+			std::array<glm::dvec2, 2> hip{};
+			std::array<float, 2> legX{};
+			double thigh = 15.0;
+			double shin = 15.0;
+			double torso = 15.0;
+			std::array<bool, 2> contact{};
+		};
+
+		/// <summary>
+		/// Reads the skeleton geometry and joints and starts the state at rest.
+		/// </summary>
+		/// <param name="world"> Physics world of the skeleton. </param>
+		/// <param name="skeleton"> Skeleton. </param>
+		/// <param name="state"> State to reset. </param>
+		void ResetState(const PhysicsWorld& world, ESkeleton* skeleton, SkeletonState& state) const;
+
+		/// <summary>
+		/// Moves the joint targets one sub step, they bounce between the rotation boundaries like the kinematic joints.
+		/// </summary>
+		/// <param name="state"> Skeleton state. </param>
+		/// <param name="deltaTime"> Sub step time. </param>
+		void UpdateTargets(SkeletonState& state, double deltaTime) const;
+
+		/// <summary>
+		/// Integrates one sub step with the articulated body algorithm.
+		/// </summary>
+		/// <param name="world"> Physics world, for the ground height. </param>
+		/// <param name="state"> Skeleton state. </param>
+		/// <param name="coreX"> World x of the skeleton. </param>
+		/// <param name="deltaTime"> Sub step time. </param>
+		void Step(const PhysicsWorld& world, SkeletonState& state, float coreX, double deltaTime) const;
+
+		/// <summary>
+		/// Writes the state on the skeleton entities.
+		/// </summary>
+		/// <param name="skeleton"> Skeleton. </param>
+		/// <param name="state"> Skeleton state. </param>
+		void WriteState(ESkeleton* skeleton, SkeletonState& state) const;
+
+		/// <summary>
+		/// State of every skeleton, the memory is kept between generations.
+		/// </summary>
+		std::unordered_map<const ESkeleton*, SkeletonState> states;
+
+		/// <summary>
+		/// Skeletons solved this frame.
+		/// </summary>
+		std::vector<std::pair<ESkeleton*, SkeletonState*>> alive;
+
+		/// <summary>
+		/// Frames updated.
+		/// </summary>
+		uint64_t frame = 0;
+
+		/// <summary>
+		/// Threads solving the skeletons at the same time, created with the backend and reused every frame.
+		/// </summary>
+		WorkerPool pool;
+
+		/// <summary>
+		/// Sub steps of every frame at the target FPS.
+		/// </summary>
+		const int subSteps = 16;
+
+		/// <summary>
+		/// Gravity, a skeleton unit is about 3 cm.
+		/// </summary>
+		const double gravity = 327.0;
+
+		/// <summary>
+		/// Masses of the torso, every thigh and every shin.
+		/// </summary>
+		const double torsoMass = 40.0, thighMass = 8.0, shinMass = 4.0;
+
+		/// <summary>
+		/// PD controller gains and maximum torque of the hips and the knees.
+		/// </summary>
+		const double hipStiffness = 2.0e6, hipDamping = 1.2e5, kneeStiffness = 1.0e6, kneeDamping = 3.5e4, maxTorque = 6.0e5;
+
+		/// <summary>
+		/// Stiffness and damping of the rotation boundaries.
+		/// </summary>
+		const double limitStiffness = 5.0e6, limitDamping = 5.0e4;
+
+		/// <summary>
+		/// Ground contact stiffness, damping, friction coefficient and tangential damping.
+		/// </summary>
+		const double contactStiffness = 1.0e5, contactDamping = 1.5e3, friction = 0.8, frictionDamping = 2.0e3;
+
+		/// <summary>
+		/// Minimum hip height over the ground relative to the leg length, lower means the skeleton has fallen.
+		/// </summary>
+		const double fallenHeight = 0.25;
+};
@@ -0,0 +1,205 @@
+#include "DeathRules.h"
+
+#include <Entities/Compositions/ESkeleton.h>
+#include <Entities/EMesh.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+/// <summary>
+/// DeathRules constructor, with the default rules.
+/// </summary>
+DeathRules::DeathRules() {
+	/* Cases where the skeleton is should die.
+		- Case 1: Both hips rotations are less -30 degrees.
+		- Case 2: Both hip rotations minus knee rotation are greater 30 degrees.
+		- Case 3: The hip in front minus knee rotation is greater than 90 degrees and the hip behind is lower than -90 degrees.
+			- Case 3.1: Same but with the other leg.
+		- Case 4: The hip in front rotation is greater than 120 degrees and the hip behind is lower than -90 degrees.
+			- Case 4.1: Same but with the other leg.
+		- Case 5: The hip behind rotation lower than -30 degrees and hip in front on air.
+			- Case 5.1: Same but with the other leg.
+	*/
+	AddRule({ "Case 1", { {Feature::HIP1, false, -30.0f}, {Feature::HIP2, false, -30.0f} } });
+	AddRule({ "Case 2", { {Feature::LEG1_BEND, true, 30.0f}, {Feature::LEG2_BEND, true, 30.0f} } });
+	AddRule({ "Case 3", { {Feature::LEG1_BEND, true, 90.0f}, {Feature::HIP2, false, -90.0f} } });
+	AddRule({ "Case 3.1", { {Feature::LEG2_BEND, true, 90.0f}, {Feature::HIP1, false, -90.0f} } });
+	AddRule({ "Case 4", { {Feature::HIP1, true, 120.0f}, {Feature::HIP2, false, -90.0f} } });
+	AddRule({ "Case 4.1", { {Feature::HIP2, true, 120.0f}, {Feature::HIP1, false, -90.0f} } });
+	AddRule({ "Case 5", { {Feature::HIP1, false, -30.0f}, {Feature::LEG2_ON_AIR, true, 0.5f} } });
+	AddRule({ "Case 5.1", { {Feature::HIP2, false, -30.0f}, {Feature::LEG1_ON_AIR, true, 0.5f} } });
+}
+
+/// <summary>
+/// DeathRules destructor.
+/// </summary>
+DeathRules::~DeathRules() {
+
+}
+
+/// <summary>
+/// Adds a rule to the table.
+/// </summary>
+/// <param name="rule"> Rule. </param>
+void DeathRules::AddRule(const Rule& rule) {
+	rules.push_back(rule);
+}
+
+/// <summary>
+/// Returns if a skeleton is dead.
+/// </summary>
+/// <param name="skeleton"> Skeleton. </param>
+/// <returns> If is dead or not. </returns>
+bool DeathRules::IsDead(ESkeleton* skeleton) const {
+	return IsDead(GetFeatures(skeleton), true);
+}
+
+/// <summary>
+/// Returns if the joint rotations kill a skeleton, the rules that depend on the legs on air are skipped.
+/// </summary>
+/// <param name="hip1"> Hip 1 rotation. </param>
+/// <param name="knee1"> Knee 1 rotation. </param>
+/// <param name="hip2"> Hip 2 rotation. </param>
+/// <param name="knee2"> Knee 2 rotation. </param>
+/// <returns> If is dead or not. </returns>
+bool DeathRules::JointRotationsDead(float hip1, float knee1, float hip2, float knee2) const {
+	return IsDead({ hip1, hip2, hip1 - std::abs(knee1), hip2 - std::abs(knee2), 0.0f, 0.0f }, false);
+}
+
+/// <summary>
+/// Returns the first time the joint rotations kill a skeleton while the joints turn at a constant velocity,
+/// the rules that depend on the legs on air are skipped.
+/// No knee can cross 0 degrees before the maximum time, so the bend of every leg also changes linearly.
+/// </summary>
+/// <param name="rotations"> Hip 1, knee 1, hip 2 and knee 2 rotations. </param>
+/// <param name="velocities"> Hip 1, knee 1, hip 2 and knee 2 rotation velocities. </param>
+/// <param name="maxTime"> Time the joints keep their velocities. </param>
+/// <returns> Time of the first death, greater than the maximum time if the skeleton does not die. </returns>
+float DeathRules::TimeToJointRotationsDead(const std::array<float, 4>& rotations, const std::array<float, 4>& velocities, float maxTime) const {
+	// Every feature is value + rate * time, the sign of a knee is taken in the middle of the interval.
+	auto kneeSign = [&](int knee) {
+		return (rotations[knee] + velocities[knee] * maxTime / 2 < 0.0f) ? -1.0f : 1.0f;
+	};
+	float sign1 = kneeSign(1);
+	float sign2 = kneeSign(3);
+	std::array<float, Feature::FEATURES> values = { rotations[0], rotations[2], rotations[0] - sign1 * rotations[1], rotations[2] - sign2 * rotations[3], 0.0f, 0.0f };
+	std::array<float, Feature::FEATURES> rates = { velocities[0], velocities[2], velocities[0] - sign1 * velocities[1], velocities[2] - sign2 * velocities[3], 0.0f, 0.0f };
+
+	// Every condition holds on a half line of time, a rule holds on the intersection of its conditions.
+	float time = std::numeric_limits<float>::max();
+	for (const auto& rule : rules) {
+		if (UsesContacts(rule))
+			continue;
+
+		float begin = 0.0f;
+		float end = maxTime;
+		for (const auto& condition : rule.conditions) {
+			// margin + slope * t > 0 while the condition holds.
+			float margin = condition.greater ? values[condition.feature] - condition.threshold : condition.threshold - values[condition.feature];
+			float slope = condition.greater ? rates[condition.feature] : -rates[condition.feature];
+			if (slope > 0.0f)
+				begin = std::max(begin, -margin / slope);
+			else if (slope < 0.0f)
+				end = std::min(end, -margin / slope);
+			else if (margin <= 0.0f)
+				end = -1.0f;
+		}
+
+		if (begin < end)
+			time = std::min(time, begin);
+	}
+
+	return time;
+}
+
+/// <summary>
+/// Kills the skeletons that meet any rule.
+/// </summary>
+/// <param name="skeletons"> Skeletons, the dead ones stay dead. </param>
+void DeathRules::Evaluate(const std::vector<std::shared_ptr<ESkeleton>>& skeletons) {
+	size_t size = skeletons.size();
+	for (auto& values : features)
+		values.resize(size);
+
+	for (size_t i = 0; i < size; ++i) {
+		auto skeletonFeatures = GetFeatures(skeletons[i].get());
+		for (int feature = 0; feature < Feature::FEATURES; ++feature)
+			features[feature][i] = skeletonFeatures[feature];
+	}
+
+	// Every condition is a comparison over all the skeletons, without branches inside the loops.
+	dead.assign(size, 0);
+	mask.resize(size);
+	for (const auto& rule : rules) {
+		std::fill(mask.begin(), mask.end(), 1);
+		for (const auto& condition : rule.conditions) {
+			const float* values = features[condition.feature].data();
+			float threshold = condition.threshold;
+			if (condition.greater) {
+				for (size_t i = 0; i < size; ++i)
+					mask[i] &= values[i] > threshold;
+			}
+			else {
+				for (size_t i = 0; i < size; ++i)
+					mask[i] &= values[i] < threshold;
+			}
+		}
+
+		for (size_t i = 0; i < size; ++i)
+			dead[i] |= mask[i];
+	}
+
+	for (size_t i = 0; i < size; ++i) {
+		if (dead[i])
+			skeletons[i]->SetIsDead(true);
+	}
+}
+
+/// <summary>
+/// Returns the features of a skeleton.
+/// </summary>
+/// <param name="skeleton"> Skeleton. </param>
+/// <returns> Features. </returns>
+std::array<float, DeathRules::Feature::FEATURES> DeathRules::GetFeatures(ESkeleton* skeleton) {
+	auto leg1 = skeleton->GetLeg1();
+	auto leg2 = skeleton->GetLeg2();
+	float hip1 = leg1[0]->GetRotation().x;
+	float hip2 = leg2[0]->GetRotation().x;
+
+	return { hip1, hip2, hip1 - std::abs(leg1[1]->GetRotation().x), hip2 - std::abs(leg2[1]->GetRotation().x)
+		, skeleton->GetLeg1OnAir() ? 1.0f : 0.0f, skeleton->GetLeg2OnAir() ? 1.0f : 0.0f };
+}
+
+/// <summary>
+/// Returns if the features meet any rule.
+/// </summary>
+/// <param name="features"> Features of a skeleton. </param>
+/// <param name="contacts"> If the rules that depend on the legs on air are evaluated. </param>
+/// <returns> If is dead or not. </returns>
+bool DeathRules::IsDead(const std::array<float, Feature::FEATURES>& features, bool contacts) const {
+	for (const auto& rule : rules) {
+		if (!contacts && UsesContacts(rule))
+			continue;
+
+		bool meets = true;
+		for (const auto& condition : rule.conditions)
+			meets &= condition.greater ? features[condition.feature] > condition.threshold : features[condition.feature] < condition.threshold;
+
+		if (meets)
+			return true;
+	}
+
+	return false;
+}
+
+/// <summary>
+/// Returns if a rule depends on the legs on air.
+/// </summary>
+/// <param name="rule"> Rule. </param>
+/// <returns> If it depends on the legs on air. </returns>
+bool DeathRules::UsesContacts(const Rule& rule) {
+	return std::any_of(rule.conditions.begin(), rule.conditions.end(), [](const Condition& condition) {
+		return condition.feature == Feature::LEG1_ON_AIR || condition.feature == Feature::LEG2_ON_AIR;
+	});
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <string>
+#include <memory>
+#include <cstdint>
+
+class ESkeleton;
+
+/// <summary>
+/// Death rules of the skeletons as a table of predicates.
+/// Every rule kills the skeleton when all its conditions hold and every condition compares a feature of the skeleton with a threshold.
+/// The population is evaluated at once: the features are copied in one array per feature and every condition is a mask over all the skeletons.
+/// </summary>
+class DeathRules {
+	public:
+		/// <summary>
+		/// Features of a skeleton compared by the rules.
+		/// The bend of a leg is its hip rotation minus the absolute knee rotation, the legs on air are 1 or 0.
+		/// </summary>
+		enum Feature {HIP1, HIP2, LEG1_BEND, LEG2_BEND, LEG1_ON_AIR, LEG2_ON_AIR, FEATURES};
+
+		/// <summary>
+		/// Comparison of a feature with a threshold.
+		/// </summary>
+		struct Condition {
+			Feature feature = Feature::HIP1;
+			bool greater = false;
+			float threshold = 0.0f;
+		};
+
+		/// <summary>
+		/// Conditions that kill the skeleton when all of them hold.
+		/// </summary>
+		struct Rule {
+			std::string name;
+			std::vector<Condition> conditions;
+		};
+
+		/// <summary>
+		/// DeathRules constructor, with the default rules.
+		/// </summary>
+		DeathRules();
+
+		/// <summary>
+		/// DeathRules destructor.
+		/// </summary>
+		~DeathRules();
+
+		/// <summary>
+		/// Adds a rule to the table.
+		/// </summary>
+		/// <param name="rule"> Rule. </param>
+		void AddRule(const Rule& rule);
+
+		/// <summary>
+		/// Returns the rules.
+		/// </summary>
+		/// <returns> Rules. </returns>
+		const std::vector<Rule>& GetRules() const { return rules; }
+
+		/// <summary>
+		/// Returns if a skeleton is dead.
+		/// </summary>
+		/// <param name="skeleton"> Skeleton. </param>
+		/// <returns> If is dead or not. </returns>
+		bool IsDead(ESkeleton* skeleton) const;
+
+		/// <summary>
+		/// Returns if the joint rotations kill a skeleton, the rules that depend on the legs on air are skipped.
+		/// </summary>
+		/// <param name="hip1"> Hip 1 rotation. </param>
+		/// <param name="knee1"> Knee 1 rotation. </param>
+		/// <param name="hip2"> Hip 2 rotation. </param>
+		/// <param name="knee2"> Knee 2 rotation. </param>
+		/// <returns> If is dead or not. </returns>
+		bool JointRotationsDead(float hip1, float knee1, float hip2, float knee2) const;
+
+		/// <summary>
+		/// Returns the first time the joint rotations kill a skeleton while the joints turn at a constant velocity,
+		/// the rules that depend on the legs on air are skipped.
+		/// No knee can cross 0 degrees before the maximum time, so the bend of every leg also changes linearly.
+		/// </summary>
+		/// <param name="rotations"> Hip 1, knee 1, hip 2 and knee 2 rotations. </param>
+		/// <param name="velocities"> Hip 1, knee 1, hip 2 and knee 2 rotation velocities. </param>
+		/// <param name="maxTime"> Time the joints keep their velocities. </param>
+		/// <returns> Time of the first death, greater than the maximum time if the skeleton does not die. </returns>
+		float TimeToJointRotationsDead(const std::array<float, 4>& rotations, const std::array<float, 4>& velocities, float maxTime) const;
+
+		/// <summary>
+		/// Kills the skeletons that meet any rule.
+		/// </summary>
+		/// <param name="skeletons"> Skeletons, the dead ones stay dead. </param>
+		void Evaluate(const std::vector<std::shared_ptr<ESkeleton>>& skeletons);
+
+	private:
+		/// <summary>
+		/// Returns the features of a skeleton.
+		/// </summary>
+		/// <param name="skeleton"> Skeleton. </param>
+		/// <returns> Features. </returns>
+		static std::array<float, Feature::FEATURES> GetFeatures(ESkeleton* skeleton);
+
+		/// <summary>
+		/// Returns if the features meet any rule.
+		/// </summary>
+		/// <param name="features"> Features of a skeleton. </param>
+		/// <param name="contacts"> If the rules that depend on the legs on air are evaluated. </param>
+		/// <returns> If is dead or not. </returns>
+		bool IsDead(const std::array<float, Feature::FEATURES>& features, bool contacts) const;
+
+		/// <summary>
+		/// Returns if a rule depends on the legs on air.
+		/// </summary>
+		/// <param name="rule"> Rule. </param>
+		/// <returns> If it depends on the legs on air. </returns>
+		static bool UsesContacts(const Rule& rule);
+
+		/// <summary>
+		/// Rules, any of them kills the skeleton.
+		/// </summary>
+		std::vector<Rule> rules;
+
+		/// <summary>
+		/// Values of every feature of the skeletons being evaluated, the memory is kept between evaluations.
+		/// </summary>
+		std::array<std::vector<float>, Feature::FEATURES> features;
+
+		/// <summary>
+		/// Skeletons that meet the rule being evaluated and skeletons that meet any rule.
+		/// </summary>
+		std::vector<uint8_t> mask, dead;
+};
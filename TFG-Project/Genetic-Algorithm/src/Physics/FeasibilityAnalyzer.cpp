@@ -0,0 +1,107 @@
+#include "FeasibilityAnalyzer.h"
+#include "DeathRules.h"
+
+#include <Entities/Compositions/ESkeleton.h>
+#include <Entities/EMesh.h>
+
+#include <algorithm>
+
+/// <summary>
+/// FeasibilityAnalyzer constructor.
+/// </summary>
+/// <param name="mode"> Screen mode. </param>
+/// <param name="framesPerGeneration"> Frames simulated every generation. </param>
+/// <param name="deltaTime"> Time of every frame. </param>
+/// <param name="deathRules"> Death rules of the simulation. </param>
+FeasibilityAnalyzer::FeasibilityAnalyzer(Config::FeasibilityScreen mode, int framesPerGeneration, float deltaTime, const DeathRules& deathRules) :
+	mode(mode),
+	framesPerGeneration(framesPerGeneration),
+	deltaTime(deltaTime),
+	deathRules(deathRules) {
+}
+
+/// <summary>
+/// FeasibilityAnalyzer destructor.
+/// </summary>
+FeasibilityAnalyzer::~FeasibilityAnalyzer() {
+
+}
+
+/// <summary>
+/// Returns the first frame whose joint rotations kill the skeleton.
+/// </summary>
+/// <param name="skeleton"> Skeleton at the start of the generation. </param>
+/// <returns> Frame of the generation, -1 if it survives the joint rules. </returns>
+int FeasibilityAnalyzer::GetDeathFrame(ESkeleton* skeleton) const {
+	auto leg1 = skeleton->GetLeg1();
+	auto leg2 = skeleton->GetLeg2();
+	EMesh* joints[4] = { leg1[0], leg1[1], leg2[0], leg2[1] };
+
+	float rotations[4], velocities[4], lower[4], upper[4];
+	for (int i = 0; i < 4; ++i) {
+		auto boundaries = joints[i]->GetRotationBoundaries();
+		rotations[i] = joints[i]->GetRotation().x;
+		velocities[i] = joints[i]->GetRotationVelocity().x;
+		lower[i] = std::min(boundaries.first, boundaries.second);
+		upper[i] = std::max(boundaries.first, boundaries.second);
+	}
+
+	// Same step and bounces as PhysicsWorld::ApplySkeletonMovement.
+	for (int frame = 1; frame <= framesPerGeneration; ++frame) {
+		for (int i = 0; i < 4; ++i) {
+			rotations[i] = rotations[i] + velocities[i] * deltaTime;
+			if (rotations[i] >= upper[i]) {
+				rotations[i] = upper[i];
+				velocities[i] = -velocities[i];
+			}
+			if (rotations[i] <= lower[i]) {
+				rotations[i] = lower[i];
+				velocities[i] = -velocities[i];
+			}
+		}
+
+		if (deathRules.JointRotationsDead(rotations[0], rotations[1], rotations[2], rotations[3]))
+			return frame;
+	}
+
+	return -1;
+}
+
+/// <summary>
+/// Screens the skeletons at the start of the generation.
+/// With REJECT the infeasible ones die before moving, their fitness is 0.
+/// </summary>
+/// <param name="population"> Skeletons. </param>
+void FeasibilityAnalyzer::Screen(const std::vector<std::shared_ptr<ESkeleton>>& population) {
+	if (mode == Config::FeasibilityScreen::NONE)
+		return;
+
+	flagged.clear();
+	for (const auto& skeleton : population) {
+		skeletons++;
+		frames += framesPerGeneration;
+
+		int deathFrame = GetDeathFrame(skeleton.get());
+		if (deathFrame < 0)
+			continue;
+
+		infeasible++;
+		rejectedFrames += deathFrame;
+		flagged.insert(skeleton.get());
+
+		if (mode == Config::FeasibilityScreen::REJECT)
+			skeleton->SetIsDead(true);
+	}
+}
+
+/// <summary>
+/// Checks that the flagged skeletons have died at the end of the generation.
+/// </summary>
+/// <param name="population"> Skeletons. </param>
+void FeasibilityAnalyzer::EndGeneration(const std::vector<std::shared_ptr<ESkeleton>>& population) {
+	if (mode != Config::FeasibilityScreen::FLAG)
+		return;
+
+	for (const auto& skeleton : population)
+		misses += flagged.count(skeleton.get()) && !skeleton->IsDead();
+}
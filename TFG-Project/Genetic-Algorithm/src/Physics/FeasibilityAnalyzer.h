@@ -0,0 +1,113 @@
+#pragma once
+
+#include <Utils/Config.h>
+
+#include <vector>
+#include <memory>
+#include <unordered_set>
+
+class ESkeleton;
+class DeathRules;
+
+/// <summary>
+/// Finds the skeletons that must die before they are simulated.
+/// The kinematic joints rotate from boundary to boundary on their own, so the rotations of every frame follow from the genes
+/// and the rotations at the start of the generation. They are swept frame by frame with the same step as the physics
+/// and checked against the death rules that only depend on the rotations.
+/// The death rules that depend on the legs on air can only kill the skeleton earlier.
+/// </summary>
+class FeasibilityAnalyzer {
+	public:
+		/// <summary>
+		/// FeasibilityAnalyzer constructor.
+		/// </summary>
+		/// <param name="mode"> Screen mode. </param>
+		/// <param name="framesPerGeneration"> Frames simulated every generation. </param>
+		/// <param name="deltaTime"> Time of every frame. </param>
+		/// <param name="deathRules"> Death rules of the simulation. </param>
+		FeasibilityAnalyzer(Config::FeasibilityScreen mode, int framesPerGeneration, float deltaTime, const DeathRules& deathRules);
+
+		/// <summary>
+		/// FeasibilityAnalyzer destructor.
+		/// </summary>
+		~FeasibilityAnalyzer();
+
+		/// <summary>
+		/// Returns the first frame whose joint rotations kill the skeleton.
+		/// </summary>
+		/// <param name="skeleton"> Skeleton at the start of the generation. </param>
+		/// <returns> Frame of the generation, -1 if it survives the joint rules. </returns>
+		int GetDeathFrame(ESkeleton* skeleton) const;
+
+		/// <summary>
+		/// Screens the skeletons at the start of the generation.
+		/// With REJECT the infeasible ones die before moving, their fitness is 0.
+		/// </summary>
+		/// <param name="population"> Skeletons. </param>
+		void Screen(const std::vector<std::shared_ptr<ESkeleton>>& population);
+
+		/// <summary>
+		/// Checks that the flagged skeletons have died at the end of the generation.
+		/// </summary>
+		/// <param name="population"> Skeletons. </param>
+		void EndGeneration(const std::vector<std::shared_ptr<ESkeleton>>& population);
+
+		/// <summary>
+		/// Returns the percentage of the skeletons that must die.
+		/// </summary>
+		/// <returns> Infeasible skeletons percentage. </returns>
+		float GetInfeasiblePercentage() const { return skeletons ? 100.0f * infeasible / skeletons : 0.0f; }
+
+		/// <summary>
+		/// Returns the percentage of the frames of all the skeletons before their death frame, not simulated with REJECT.
+		/// </summary>
+		/// <returns> Rejected frames percentage. </returns>
+		float GetRejectedPercentage() const { return frames ? 100.0f * rejectedFrames / frames : 0.0f; }
+
+		/// <summary>
+		/// Returns the flagged skeletons that survived the generation, only in FLAG mode.
+		/// </summary>
+		/// <returns> Wrong death predictions. </returns>
+		int GetMisses() const { return misses; }
+
+	private:
+		/// <summary>
+		/// Screen mode.
+		/// </summary>
+		Config::FeasibilityScreen mode = Config::FeasibilityScreen::NONE;
+
+		/// <summary>
+		/// Frames simulated every generation.
+		/// </summary>
+		int framesPerGeneration = 0;
+
+		/// <summary>
+		/// Time of every frame.
+		/// </summary>
+		float deltaTime = 0.0f;
+
+		/// <summary>
+		/// Death rules of the simulation.
+		/// </summary>
+		const DeathRules& deathRules;
+
+		/// <summary>
+		/// Skeletons that must die this generation.
+		/// </summary>
+		std::unordered_set<const ESkeleton*> flagged;
+
+		/// <summary>
+		/// Skeletons screened and skeletons that must die in all the generations.
+		/// </summary>
+		int skeletons = 0, infeasible = 0;
+
+		/// <summary>
+		/// Frames of all the skeletons and frames before the death of the infeasible ones.
+		/// </summary>
+		long long frames = 0, rejectedFrames = 0;
+
+		/// <summary>
+		/// Flagged skeletons that survived.
+		/// </summary>
+		int misses = 0;
+};
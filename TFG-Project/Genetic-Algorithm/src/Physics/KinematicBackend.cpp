@@ -0,0 +1,32 @@
+#include "KinematicBackend.h"
+
+#include <Physics/PhysicsWorld.h>
+#include <Entities/Compositions/ESkeleton.h>
+
+/// <summary>
+/// KinematicBackend constructor.
+/// </summary>
+KinematicBackend::KinematicBackend() {
+
+}
+
+/// <summary>
+/// KinematicBackend destructor.
+/// </summary>
+KinematicBackend::~KinematicBackend() {
+
+}
+
+/// <summary>
+/// Updates one frame of the skeletons.
+/// The death rules are evaluated for all the skeletons at once after moving them.
+/// </summary>
+/// <param name="world"> Physics world of the skeletons. </param>
+/// <param name="skeletons"> Skeletons to update, the dead ones are skipped. </param>
+/// <param name="deltaTime"> Time to advance. </param>
+void KinematicBackend::Update(PhysicsWorld& world, const std::vector<std::shared_ptr<ESkeleton>>& skeletons, float deltaTime) {
+	for (const auto& skeleton : skeletons)
+		world.MoveSkeleton(skeleton.get(), deltaTime);
+
+	world.GetDeathRules().Evaluate(skeletons);
+}
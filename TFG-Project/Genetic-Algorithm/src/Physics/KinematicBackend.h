@@ -0,0 +1,27 @@
+#pragma once
+
+#include "PhysicsBackend.h"
+
+/// <summary>
+/// Original physics model, the joints rotate at their genes velocity and the core is moved forward while a leg pushes the floor.
+/// </summary>
+class KinematicBackend : public PhysicsBackend {
+	public:
+		/// <summary>
+		/// KinematicBackend constructor.
+		/// </summary>
+		KinematicBackend();
+
+		/// <summary>
+		/// KinematicBackend destructor.
+		/// </summary>
+		~KinematicBackend() override;
+
+		/// <summary>
+		/// Updates one frame of the skeletons.
+		/// </summary>
+		/// <param name="world"> Physics world of the skeletons. </param>
+		/// <param name="skeletons"> Skeletons to update, the dead ones are skipped. </param>
+		/// <param name="deltaTime"> Time to advance. </param>
+		void Update(PhysicsWorld& world, const std::vector<std::shared_ptr<ESkeleton>>& skeletons, float deltaTime) override;
+};
@@ -0,0 +1,97 @@
+#include "MeshLibrary.h"
+
+#include <GLM/common.hpp>
+
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <limits>
+#include <mutex>
+
+/// <summary>
+/// Creates or returns a MeshLibrary instance.
+/// Must be created from the main thread before running simulations in parallel.
+/// </summary>
+/// <returns> Static MeshLibrary instance pointer. </returns>
+MeshLibrary* MeshLibrary::GetInstance() {
+	if (!instance) {
+		instance = new MeshLibrary();
+	}
+	return instance;
+}
+
+/// <summary>
+/// Private constructor.
+/// </summary>
+MeshLibrary::MeshLibrary() {
+
+}
+
+/// <summary>
+/// MeshLibrary destructor.
+/// </summary>
+MeshLibrary::~MeshLibrary() {
+
+}
+
+/// <summary>
+/// Returns the local extremes of a mesh, loading it the first time.
+/// pair.first  = minimum vertex position.
+/// pair.second = maximum vertex position.
+/// </summary>
+/// <param name="meshPath"> Mesh path. </param>
+/// <returns> Minimum and maximum vertex positions. </returns>
+std::pair<glm::vec3, glm::vec3> MeshLibrary::GetExtremes(const std::string& meshPath) {
+	{
+		std::shared_lock<std::shared_mutex> lock(mutex);
+		auto it = extremes.find(meshPath);
+		if (it != extremes.end()) {
+			return it->second;
+		}
+	}
+
+	// Not loaded yet, the file is read outside the lock so other meshes can still be queried.
+	auto meshExtremes = LoadExtremes(meshPath);
+
+	std::unique_lock<std::shared_mutex> lock(mutex);
+	return extremes.emplace(meshPath, meshExtremes).first->second;
+}
+
+/// <summary>
+/// Reads the vertex positions of an obj file and calculates its extremes.
+/// </summary>
+/// <param name="meshPath"> Mesh path. </param>
+/// <returns> Minimum and maximum vertex positions. </returns>
+std::pair<glm::vec3, glm::vec3> MeshLibrary::LoadExtremes(const std::string& meshPath) const {
+	// The physics only need the bounding box, so we avoid the render engine (and its OpenGL context) reading just the "v x y z" lines.
+	glm::vec3 minVertex{ std::numeric_limits<float>::max() };
+	glm::vec3 maxVertex{ std::numeric_limits<float>::lowest() };
+	bool anyVertex = false;
+
+	std::ifstream file(meshPath);
+	if (!file.is_open()) {
+		std::cout << "MeshLibrary: could not open " << meshPath << std::endl;
+		return std::pair<glm::vec3, glm::vec3>(glm::vec3(0.0f), glm::vec3(0.0f));
+	}
+
+	std::string line;
+	while (std::getline(file, line)) {
+		if (line.size() < 2 || line[0] != 'v' || (line[1] != ' ' && line[1] != '\t'))
+			continue;
+
+		std::istringstream stream(line.substr(2));
+		glm::vec3 vertex;
+		if (stream >> vertex.x >> vertex.y >> vertex.z) {
+			minVertex = glm::min(minVertex, vertex);
+			maxVertex = glm::max(maxVertex, vertex);
+			anyVertex = true;
+		}
+	}
+
+	if (!anyVertex) {
+		std::cout << "MeshLibrary: " << meshPath << " has no vertices" << std::endl;
+		return std::pair<glm::vec3, glm::vec3>(glm::vec3(0.0f), glm::vec3(0.0f));
+	}
+
+	return std::pair<glm::vec3, glm::vec3>(minVertex, maxVertex);
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <GLM/vec3.hpp>
+
+#include <string>
+#include <utility>
+#include <unordered_map>
+#include <shared_mutex>
+
+/// <summary>
+/// Storage of the mesh data needed by the physics.
+/// Every mesh is read once and shared between all the simulations.
+/// </summary>
+class MeshLibrary {
+	public:
+		/// <summary>
+		/// Creates or returns a MeshLibrary instance.
+		/// Must be created from the main thread before running simulations in parallel.
+		/// </summary>
+		/// <returns> Static MeshLibrary instance pointer. </returns>
+		static MeshLibrary* GetInstance();
+
+		/// <summary>
+		/// MeshLibrary destructor.
+		/// </summary>
+		~MeshLibrary();
+
+		/// <summary>
+		/// Returns the local extremes of a mesh, loading it the first time.
+		/// pair.first  = minimum vertex position.
+		/// pair.second = maximum vertex position.
+		/// </summary>
+		/// <param name="meshPath"> Mesh path. </param>
+		/// <returns> Minimum and maximum vertex positions. </returns>
+		std::pair<glm::vec3, glm::vec3> GetExtremes(const std::string& meshPath);
+
+	private:
+		/// <summary>
+		/// Private constructor.
+		/// </summary>
+		MeshLibrary();
+
+		/// <summary>
+		/// Reads the vertex positions of an obj file and calculates its extremes.
+		/// </summary>
+		/// <param name="meshPath"> Mesh path. </param>
+		/// <returns> Minimum and maximum vertex positions. </returns>
+		std::pair<glm::vec3, glm::vec3> LoadExtremes(const std::string& meshPath) const;
+
+		/// <summary>
+		/// Extremes of every loaded mesh.
+		/// </summary>
+		std::unordered_map<std::string, std::pair<glm::vec3, glm::vec3>> extremes;
+
+		/// <summary>
+		/// Mutex to read from multiple simulations and load only once.
+		/// </summary>
+		std::shared_mutex mutex;
+
+		/// <summary>
+		/// Static MeshLibrary instance pointer for the singleton <see href="https://en.wikipedia.org/wiki/Singleton_pattern" />
+		/// </summary>
+		inline static MeshLibrary* instance{ nullptr };
+};
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+
+class PhysicsWorld;
+class ESkeleton;
+
+/// <summary>
+/// Interface for the skeleton physics models.
+/// A backend moves the skeletons one frame and the physics world keeps the colliders, the terrain and the death rules.
+/// </summary>
+class PhysicsBackend {
+	public:
+		/// <summary>
+		/// PhysicsBackend constructor.
+		/// </summary>
+		PhysicsBackend() = default;
+
+		/// <summary>
+		/// PhysicsBackend destructor.
+		/// </summary>
+		virtual ~PhysicsBackend() = default;
+
+		/// <summary>
+		/// Updates one frame of the skeletons.
+		/// </summary>
+		/// <param name="world"> Physics world of the skeletons. </param>
+		/// <param name="skeletons"> Skeletons to update, the dead ones are skipped. </param>
+		/// <param name="deltaTime"> Time to advance. </param>
+		virtual void Update(PhysicsWorld& world, const std::vector<std::shared_ptr<ESkeleton>>& skeletons, float deltaTime) = 0;
+};
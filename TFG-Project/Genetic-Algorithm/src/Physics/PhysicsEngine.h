@@ -1,5 +1,7 @@
 #pragma once
 
+#include "PhysicsWorld.h"
+
 #include <CLEngine.h>
 
 class Entity;
@@ -11,8 +13,9 @@ class OBBCollider;
 
 /// <summary>
 /// Physics engine class.
+/// Physics world synchronized with the render engine scene nodes.
 /// </summary>
-class PhysicsEngine{
+class PhysicsEngine : public PhysicsWorld {
 	public:
 		/// <summary>
 		/// Creates or returns a PhysicsEngine instance.
@@ -29,19 +32,13 @@ class PhysicsEngine{
 		/// Set entity physics values.
 		/// </summary>
 		/// <param name="entity"> Entity. </param>
-		void SetEntityValues(Entity* entity);
-
-		/// <summary>
-		/// Updates entity physics values.
-		/// </summary>
-		/// <param name="entity"> Entity. </param>
-		void UpdateEntity(Entity* entity);
+		void SetEntityValues(Entity* entity) override;
 
 		/// <summary>
-		/// Updates skeleton physics values.
+		/// Set the physics values of every skeleton joint from its scene node.
 		/// </summary>
-		/// <param name="skeleton"> skeleton. </param>
-		void UpdateSkeleton(ESkeleton* skeleton);
+		/// <param name="joints"> Skeleton joints. </param>
+		void SetSkeletonValues(const std::vector<EMesh*>& joints) override;
 
 		/// <summary>
 		/// Updates entity camera.
@@ -57,18 +54,11 @@ class PhysicsEngine{
 		void UpdateCamera(Entity* camera, ESkeleton* skeleton);
 
 		/// <summary>
-		/// Adds a colliding object to the physics engine
-		/// </summary>
-		/// <param name="entity"> Colliding object. </param>
-		void AddCollidingMesh(EMesh* entity);
-
-		//////////////////////////// DEBUG ////////////////////////////
-
-		/// <summary>
-		/// Returns a reference to gravityActivated variable.
+		/// Updates camera with a target position.
 		/// </summary>
-		/// <returns></returns>
-		bool& GetGravityActivated() { return gravityActivated; }
+		/// <param name="camera"> Camera entity. </param>
+		/// <param name="targetPosition"> Target position. </param>
+		void UpdateCamera(Entity* camera, const glm::vec3& targetPosition);
 
 	private:
 		/// <summary>
@@ -76,32 +66,6 @@ class PhysicsEngine{
 		/// </summary>
 		PhysicsEngine();
 
-		/// <summary>
-		/// Apply gravity
-		/// </summary>
-		/// <param name="skeleton"> Skeleton to apply gravity. </param>
-		void ApplyGravity(ESkeleton* skeleton) const;
-
-		/// <summary>
-		/// Apply the movement to the skeleton
-		/// </summary>
-		/// <param name="skeleton"> Skeleton to move. </param>
-		void ApplySkeletonMovement(ESkeleton* skeleton) const;
-
-		/// <summary>
-		/// Fix position.
-		/// </summary>
-		/// <param name="skeleton"> Skeleton entity to fix. </param>
-		/// <returns> If the position has been fixed. </return>
-		bool FixPosition(ESkeleton* skeleton) const;
-
-		/// <summary>
-		/// Check if the skeleton has die.
-		/// </summary>
-		/// <param name="skeleton"> Skeleton to check. </param>
-		/// <returns> If is dead or not. </returns>
-		bool SkeletonDead(ESkeleton* skeleton) const;
-
 		/// <summary>
 		/// Calculate and assign OBB collider to the entity
 		/// </summary>
@@ -109,16 +73,6 @@ class PhysicsEngine{
 		/// <param name="node"> Node. </param>
 		OBBCollider CalculateOBB(EMesh* mesh, CLE::CLNode* node);
 
-		/// <summary>
-		/// Constant gravity value.
-		/// </summary>
-		const glm::vec3 gravity{0.0f, -50.0f, 0.0f};
-
-		/// <summary>
-		/// All the colliding meshes.
-		/// </summary>
-		std::vector<EMesh*> collidingMeshes;
-
 		/// <summary>
 		/// Static PhysicsEngine instance pointer for the singleton <see href="https://en.wikipedia.org/wiki/Singleton_pattern" />
 		/// </summary>
@@ -138,10 +92,5 @@ class PhysicsEngine{
 		/// ImGuiManager pointer. 
 		/// </summary>
 		ImGuiManager* imGuiManager{ nullptr };
-
-		/// <summary>
-		/// Debug to toggle gravity.
-		/// </summary>
-		bool gravityActivated = true;
 };
 
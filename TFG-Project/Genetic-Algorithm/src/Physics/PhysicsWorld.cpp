@@ -0,0 +1,548 @@
+#include "PhysicsWorld.h"
+
+#include <Physics/MeshLibrary.h>
+#include <Physics/KinematicBackend.h>
+#include <Physics/ArticulatedBackend.h>
+#include <Entities/Entity.h>
+#include <Entities/Compositions/ESkeleton.h>
+#include <Entities/EMesh.h>
+#include <Entities/EHeightfield.h>
+#include <DataTypes/Transformable.h>
+#include <DataTypes/OBBCollider.h>
+#include <Utils/Utils.h>
+#include <Utils/Profiler.h>
+
+#include <GLM/gtc/matrix_transform.hpp>
+#include <GLM/common.hpp>
+
+#include <limits>       // std::numeric_limits
+#include <algorithm>
+
+/// <summary>
+/// PhysicsWorld constructor.
+/// </summary>
+PhysicsWorld::PhysicsWorld() :
+	backend(std::make_unique<KinematicBackend>()) {
+
+}
+
+/// <summary>
+/// PhysicsWorld destructor.
+/// </summary>
+PhysicsWorld::~PhysicsWorld() {
+
+}
+
+/// <summary>
+/// Set entity physics values.
+/// </summary>
+/// <param name="entity"> Entity. </param>
+void PhysicsWorld::SetEntityValues(Entity* entity) {
+	// Update boundingBox in case the scalation has changed.
+	if (auto mesh = dynamic_cast<EMesh*>(entity)) {
+		SetMeshValues(mesh, CalculateWorldTransform(entity));
+	}
+}
+
+/// <summary>
+/// Set the physics values of every skeleton joint.
+/// The joints are ordered parents first, so every global transformation is calculated once from the one of its parent.
+/// </summary>
+/// <param name="joints"> Skeleton joints. </param>
+void PhysicsWorld::SetSkeletonValues(const std::vector<EMesh*>& joints) {
+	worldTransforms.clear();
+	for (auto joint : joints) {
+		auto parent = std::find_if(worldTransforms.rbegin(), worldTransforms.rend(), [joint](const auto& world) { return world.first == joint->GetParent(); });
+		WorldTransform world = (parent != worldTransforms.rend()) ? CalculateWorldTransform(joint, parent->second) : CalculateWorldTransform(joint);
+		SetMeshValues(joint, world);
+		worldTransforms.emplace_back(joint, world);
+	}
+}
+
+/// <summary>
+/// Calculates the dimensions and the OBB collider of a mesh from its global transformation.
+/// </summary>
+/// <param name="mesh"> Mesh. </param>
+/// <param name="world"> Global transformation. </param>
+void PhysicsWorld::SetMeshValues(EMesh* mesh, const WorldTransform& world) const {
+	auto extremes = MeshLibrary::GetInstance()->GetExtremes(mesh->GetMeshPath());
+	mesh->SetDimensions(glm::abs(extremes.second - extremes.first) * world.scalation);
+	mesh->SetCollider(CalculateOBB(mesh, world.model, world.pivot, world.scalation));
+}
+
+/// <summary>
+/// Updates entity physics values.
+/// </summary>
+/// <param name="entity"> Entity. </param>
+void PhysicsWorld::UpdateEntity(Entity* entity) {
+	SetEntityValues(entity);
+
+	// Moving terrain updates its cells in the broadphase.
+	if (auto mesh = dynamic_cast<EMesh*>(entity))
+		terrainGrid.Update(mesh);
+}
+
+/// <summary>
+/// Updates skeleton physics values.
+/// </summary>
+/// <param name="skeleton"> skeleton. </param>
+/// <param name="deltaTime"> Time to advance. </param>
+void PhysicsWorld::UpdateSkeleton(ESkeleton* skeleton, float deltaTime) {
+	// If the skeleton is dead we do nothing.
+	if (skeleton->IsDead()) return;
+
+	MoveSkeleton(skeleton, deltaTime);
+
+	// At the end we check if the skeleton has die or not.
+	skeleton->SetIsDead(SkeletonDead(skeleton));
+}
+
+/// <summary>
+/// Updates skeleton physics values without checking the death rules.
+/// </summary>
+/// <param name="skeleton"> skeleton. </param>
+/// <param name="deltaTime"> Time to advance. </param>
+void PhysicsWorld::MoveSkeleton(ESkeleton* skeleton, float deltaTime) {
+	PROFILE_FUNCTION();
+
+	// If the skeleton is dead we do nothing.
+	if (skeleton->IsDead()) return;
+
+	auto eSkeleton = skeleton->GetSkeleton();
+
+	if(gravityActivated)
+		ApplyGravity(skeleton, deltaTime);
+
+	if (jointIntegration == Config::JointIntegration::EVENT)
+		ApplySkeletonEvents(skeleton, deltaTime);
+	else
+		ApplySkeletonMovement(skeleton, deltaTime);
+
+	/* --------------------------------------- IMPORTANT ----------------------------------------------
+	* It's possible that the mecanism to check if the leg is on air or not based on the obb field collider
+	* will have to be done more times. For example, if I apply gravity and then rotate and move the skeleton
+	* I wont' be able due to the legsOnAir are updated at the end (FixPosition) and I can't move if both of my legs are
+	* in the field.
+	* -------------------------------------------------------------------------------------------------
+	*/
+
+	// There is a possible that when all is finished I can FixPosition before SetEntityValues.
+	SetSkeletonValues(eSkeleton);
+
+	// Now after all the changes have been done we fix the posible positions errors.
+	FixPosition(skeleton);
+}
+
+/// <summary>
+/// Updates the physics values of every skeleton with the physics backend.
+/// </summary>
+/// <param name="skeletons"> Skeletons. </param>
+/// <param name="deltaTime"> Time to advance. </param>
+void PhysicsWorld::UpdateSkeletons(const std::vector<std::shared_ptr<ESkeleton>>& skeletons, float deltaTime) {
+	backend->Update(*this, skeletons, deltaTime);
+}
+
+/// <summary>
+/// Sets the physics model that moves the skeletons.
+/// </summary>
+/// <param name="type"> Physics backend. </param>
+/// <param name="threads"> Threads solving the skeletons at the same time, if the backend supports it. </param>
+void PhysicsWorld::SetPhysicsBackend(Config::PhysicsBackendType type, unsigned int threads) {
+	if (type == Config::PhysicsBackendType::ARTICULATED)
+		backend = std::make_unique<ArticulatedBackend>(threads);
+	else
+		backend = std::make_unique<KinematicBackend>();
+}
+
+/// <summary>
+/// Returns the ground height at a point, the highest of the heightfield and the colliding meshes.
+/// </summary>
+/// <param name="x"> X coordinate. </param>
+/// <param name="z"> Z coordinate. </param>
+/// <returns> World "y" coordinate, lowest float if there is no ground. </returns>
+float PhysicsWorld::GetGroundHeight(float x, float z) const {
+	float height = terrainGrid.GetMaxHeight(glm::vec2(x, z), glm::vec2(x, z));
+	if (heightfield)
+		height = std::max(height, heightfield->GetHeight(x, z));
+
+	return height;
+}
+
+/// <summary>
+/// Adds a colliding object to the physics engine
+/// </summary>
+/// <param name="entity"> Colliding object. </param>
+void PhysicsWorld::AddCollidingMesh(EMesh* entity) {
+	if (terrainGrid.Contains(entity->GetId())) {
+		return;
+	}
+
+	// The broadphase needs the collider.
+	if (!entity->GetCollider())
+		SetEntityValues(entity);
+
+	collidingMeshes.push_back(entity);
+	terrainGrid.Insert(entity);
+}
+
+/// <summary>
+/// Returns whether to apply gravity or not
+/// </summary>
+/// <param name="skeleton"> Skeleton to apply gravity. </param>
+/// <param name="deltaTime"> Time to advance. </param>
+/// <returns> True if gravity applied, false if not. </returns>
+void PhysicsWorld::ApplyGravity(ESkeleton* skeleton, float deltaTime) const {
+	if (skeleton->GetOnAir()) {
+		auto core = skeleton->GetCore();
+		glm::vec3 movement = gravity * gravityScale * deltaTime;
+		core->SetPosition(core->GetPosition() + movement);
+
+		// TODO: Maybe it's not worth it update de obb just for 1 frame
+		for (auto joint : skeleton->GetSkeleton()) {
+			joint->GetCollider()->TranslateOBB(movement);
+		}
+	}
+
+}
+
+/// <summary>
+/// Apply the movement to the skeleton
+/// </summary>
+/// <param name="skeleton"> Skeleton to move. </param>
+/// <param name="deltaTime"> Time to advance. </param>
+void PhysicsWorld::ApplySkeletonMovement(ESkeleton* skeleton, float deltaTime) const {
+	auto eSkeleton = skeleton->GetSkeleton();
+	auto core = eSkeleton[0];
+	auto hip1 = eSkeleton[1];
+	auto knee1 = eSkeleton[2];
+	auto hip2 = eSkeleton[3];
+	auto knee2 = eSkeleton[4];
+	auto checkCoreMovement = [&core, deltaTime](EMesh* hip, EMesh* knee, bool onAir) {
+		// If (hip going backwards and still above 0 rotation || knee going backwards and hip above 0 rotation) && touching the floor
+		if (((hip->GetRotationVelocity().x < 0 && hip->GetRotation().x > 0) || (knee->GetRotationVelocity().x < 0 && hip->GetRotation().x > 0)) && !onAir) {
+			auto position = core->GetPosition();
+			float newZ = position.z + ((std::abs(hip->GetRotationVelocity().x / 10) + std::abs(knee->GetRotationVelocity().x / 10)) * deltaTime);
+			core->SetPosition(glm::vec3(position.x, position.y, newZ));
+
+			return true;
+		}
+		return false;
+	};
+
+	RotateJoint(hip1, deltaTime);
+	RotateJoint(knee1, deltaTime);
+	RotateJoint(hip2, deltaTime);
+	RotateJoint(knee2, deltaTime);
+
+	// To just apply one leg at a time
+	checkCoreMovement(hip1, knee1, skeleton->GetLeg1OnAir());
+	checkCoreMovement(hip2, knee2, skeleton->GetLeg2OnAir());
+}
+
+/// <summary>
+/// Rotates a kinematic joint, it turns back when it reaches a rotation boundary.
+/// </summary>
+/// <param name="joint"> Joint. </param>
+/// <param name="deltaTime"> Time to advance. </param>
+void PhysicsWorld::RotateJoint(EMesh* joint, float deltaTime) {
+	joint->SetRotation(joint->GetRotation() + (joint->GetRotationVelocity() * deltaTime));
+
+	auto rotationBoundaries = joint->GetRotationBoundaries();
+	auto lowerRotation = (rotationBoundaries.first < rotationBoundaries.second) ? rotationBoundaries.first : rotationBoundaries.second;
+	auto greaterRotation = (rotationBoundaries.first >= rotationBoundaries.second) ? rotationBoundaries.first : rotationBoundaries.second;
+	joint->SetRotationBoundaries(std::pair<float, float>(lowerRotation, greaterRotation));
+
+	if (joint->GetRotation().x >= joint->GetRotationBoundaries().second) {
+		joint->SetRotation(glm::vec3(joint->GetRotationBoundaries().second, joint->GetRotation().y, joint->GetRotation().z));
+		joint->SetRotationVelocity(-joint->GetRotationVelocity());
+	}
+	if (joint->GetRotation().x <= joint->GetRotationBoundaries().first) {
+		joint->SetRotation(glm::vec3(joint->GetRotationBoundaries().first, joint->GetRotation().y, joint->GetRotation().z));
+		joint->SetRotationVelocity(-joint->GetRotationVelocity());
+	}
+}
+
+/// <summary>
+/// Apply the movement to the skeleton from event to event.
+/// The joints only change their velocity when they reach a rotation boundary and the core only starts or stops
+/// moving forward then or when a hip crosses 0, so between two events everything moves at a constant velocity
+/// and is advanced analytically. The result does not depend on the time step.
+/// The death rules of the joint rotations are checked at their exact crossing time, the skeleton dies there.
+/// </summary>
+/// <param name="skeleton"> Skeleton to move. </param>
+/// <param name="deltaTime"> Time to advance. </param>
+void PhysicsWorld::ApplySkeletonEvents(ESkeleton* skeleton, float deltaTime) const {
+	auto core = skeleton->GetCore();
+	auto leg1 = skeleton->GetLeg1();
+	auto leg2 = skeleton->GetLeg2();
+	std::array<EMesh*, 4> joints = { leg1[0], leg1[1], leg2[0], leg2[1] };
+	bool legsOnAir[2] = { skeleton->GetLeg1OnAir(), skeleton->GetLeg2OnAir() };
+
+	for (auto joint : joints) {
+		auto rotationBoundaries = joint->GetRotationBoundaries();
+		joint->SetRotationBoundaries(std::pair<float, float>(std::min(rotationBoundaries.first, rotationBoundaries.second), std::max(rotationBoundaries.first, rotationBoundaries.second)));
+	}
+
+	// Same rule as the fixed integration: a leg touching the floor with the hip in front and the hip or the knee going backwards.
+	auto coreVelocity = [](EMesh* hip, EMesh* knee, bool onAir, float hipRotation) {
+		if ((hip->GetRotationVelocity().x < 0 || knee->GetRotationVelocity().x < 0) && hipRotation > 0 && !onAir)
+			return std::abs(hip->GetRotationVelocity().x / 10) + std::abs(knee->GetRotationVelocity().x / 10);
+		return 0.0f;
+	};
+
+	float remainingTime = deltaTime;
+	for (int event = 0; remainingTime > 0.0f; ++event) {
+		// Only a joint with both boundaries equal has that many events, the rest of the time is advanced at once.
+		float step = (event < maxJointEvents) ? std::min(TimeToJointEvent(joints), remainingTime) : remainingTime;
+
+		// The bends of the legs change linearly until the next event, so the joint death rules are crossed at a known time.
+		std::array<float, 4> rotations, velocities;
+		for (size_t i = 0; i < joints.size(); ++i) {
+			rotations[i] = joints[i]->GetRotation().x;
+			velocities[i] = joints[i]->GetRotationVelocity().x;
+		}
+		float deathTime = deathRules.TimeToJointRotationsDead(rotations, velocities, step);
+		bool dies = deathTime <= step;
+		if (dies)
+			step = deathTime;
+
+		// The hips are checked in the middle of the step, where none of them is at 0.
+		float velocity = 0.0f;
+		for (int leg = 0; leg < 2; ++leg) {
+			auto hip = joints[leg * 2];
+			float hipRotation = hip->GetRotation().x + hip->GetRotationVelocity().x * step / 2;
+			velocity += coreVelocity(hip, joints[leg * 2 + 1], legsOnAir[leg], hipRotation);
+		}
+		auto position = core->GetPosition();
+		core->SetPosition(glm::vec3(position.x, position.y, position.z + velocity * step));
+
+		// The joints that reach a boundary bounce.
+		for (auto joint : joints) {
+			auto rotation = joint->GetRotation();
+			auto rotationVelocity = joint->GetRotationVelocity();
+			auto rotationBoundaries = joint->GetRotationBoundaries();
+			rotation.x += rotationVelocity.x * step;
+			if (rotationVelocity.x > 0 && rotation.x >= rotationBoundaries.second - eventTolerance) {
+				rotation.x = rotationBoundaries.second;
+				joint->SetRotationVelocity(-rotationVelocity);
+			}
+			else if (rotationVelocity.x < 0 && rotation.x <= rotationBoundaries.first + eventTolerance) {
+				rotation.x = rotationBoundaries.first;
+				joint->SetRotationVelocity(-rotationVelocity);
+			}
+			joint->SetRotation(rotation);
+		}
+
+		remainingTime -= step;
+		if (dies) {
+			skeleton->SetIsDead(true);
+			break;
+		}
+	}
+}
+
+/// <summary>
+/// Returns the time until the next joint event of a skeleton: a joint reaching a rotation boundary or crossing 0.
+/// </summary>
+/// <param name="joints"> Hip 1, knee 1, hip 2 and knee 2. </param>
+/// <returns> Time until the next event. </returns>
+float PhysicsWorld::TimeToJointEvent(const std::array<EMesh*, 4>& joints) const {
+	float time = std::numeric_limits<float>::max();
+	for (size_t i = 0; i < joints.size(); ++i) {
+		float rotation = joints[i]->GetRotation().x;
+		float rotationVelocity = joints[i]->GetRotationVelocity().x;
+		auto rotationBoundaries = joints[i]->GetRotationBoundaries();
+		if (rotationVelocity > 0)
+			time = std::min(time, (rotationBoundaries.second - rotation) / rotationVelocity);
+		else if (rotationVelocity < 0)
+			time = std::min(time, (rotationBoundaries.first - rotation) / rotationVelocity);
+
+		// Joints going to 0: the hips start or stop pushing the core and the knees change how the leg bend moves.
+		if (std::abs(rotation) > eventTolerance && rotation * rotationVelocity < 0)
+			time = std::min(time, -rotation / rotationVelocity);
+	}
+
+	return std::max(time, 0.0f);
+}
+
+/// <summary>
+/// Fix position.
+/// </summary>
+/// <param name="skeleton"> Skeleton entity to fix. </param>
+/// <returns> If the position has been fixed. </return>
+bool PhysicsWorld::FixPosition(ESkeleton* skeleton) const {
+	auto core = skeleton->GetCore();
+	auto leg1 = skeleton->GetLeg1()[1];
+	auto leg2 = skeleton->GetLeg2()[1];
+
+	// We look for the lowest leg OBB "y" coordinate in order to know the lowest point in the legs and the area below them.
+	// The lowest vertex is the foot.
+	auto legBounds = [](const EMesh* leg, glm::vec2& min, glm::vec2& max, glm::vec2& foot) {
+		float minY = std::numeric_limits<float>::max();
+		min = glm::vec2(std::numeric_limits<float>::max());
+		max = glm::vec2(std::numeric_limits<float>::lowest());
+		foot = glm::vec2(0.0f);
+		for (const auto& vertex : leg->GetCollider()->GetVertexs()) {
+			if (vertex.y < minY) {
+				minY = vertex.y;
+				foot = glm::vec2(vertex.x, vertex.z);
+			}
+			min = glm::min(min, glm::vec2(vertex.x, vertex.z));
+			max = glm::max(max, glm::vec2(vertex.x, vertex.z));
+		}
+		return minY;
+	};
+	glm::vec2 leg1Min, leg1Max, leg1Foot, leg2Min, leg2Max, leg2Foot;
+	float skeletonMinYLeg1 = legBounds(leg1, leg1Min, leg1Max, leg1Foot);
+	float skeletonMinYLeg2 = legBounds(leg2, leg2Min, leg2Max, leg2Foot);
+
+	// Now we look for the highest terrain collider OBB "y" coordinate below every leg, only the nearby colliders are checked.
+	float terrainMaxYLeg1 = terrainGrid.GetMaxHeight(leg1Min, leg1Max);
+	float terrainMaxYLeg2 = terrainGrid.GetMaxHeight(leg2Min, leg2Max);
+
+	// The heightfield is sampled below every foot.
+	if (heightfield) {
+		terrainMaxYLeg1 = std::max(terrainMaxYLeg1, heightfield->GetHeight(leg1Foot.x, leg1Foot.y));
+		terrainMaxYLeg2 = std::max(terrainMaxYLeg2, heightfield->GetHeight(leg2Foot.x, leg2Foot.y));
+	}
+
+	// Update if any leg is touching the floor or not
+	skeleton->SetLeg1OnAir((skeletonMinYLeg1 <= terrainMaxYLeg1) ? false : true);
+	skeleton->SetLeg2OnAir((skeletonMinYLeg2 <= terrainMaxYLeg2) ? false : true);
+
+	// The deepest leg sets how much the skeleton has to go up.
+	bool leg1Deepest = (terrainMaxYLeg1 - skeletonMinYLeg1) >= (terrainMaxYLeg2 - skeletonMinYLeg2);
+	float skeletonMinY = leg1Deepest ? skeletonMinYLeg1 : skeletonMinYLeg2;
+	float terrainMaxY = leg1Deepest ? terrainMaxYLeg1 : terrainMaxYLeg2;
+	if (skeletonMinY <= terrainMaxY) {
+		// Fix position to set the skeleton above the terrain
+		//TODO: Be carefull with this "17". It is because I have to place the model below the terrain but not to much. 
+		float positionToPlace = ((core->GetCollider()->GetCenter().y - skeletonMinY) + terrainMaxY) - 17;
+		core->SetPosition(glm::vec3(core->GetPosition().x, positionToPlace, core->GetPosition().z));
+		skeleton->SetOnAir(false);
+
+		return true;
+	}else {
+		skeleton->SetOnAir(true);
+
+		return false;
+	}
+}
+
+
+/// <summary>
+/// Check if the skeleton has die.
+/// </summary>
+/// <param name="skeleton"> Skeleton to check. </param>
+/// <returns> If is dead or not. </returns>
+bool PhysicsWorld::SkeletonDead(ESkeleton* skeleton) const {
+	return deathRules.IsDead(skeleton);
+}
+
+/// <summary>
+/// Calculate the OBB collider of a mesh with its dimensions already updated.
+/// </summary>
+/// <param name="mesh"> Mesh. </param>
+/// <param name="model"> Global transformation matrix. </param>
+/// <param name="pivot"> Global translation. </param>
+/// <param name="globalScalation"> Global scalation. </param>
+/// <returns> OBB collider. </returns>
+OBBCollider PhysicsWorld::CalculateOBB(EMesh* mesh, const glm::mat4& model, const glm::vec3& pivot, const glm::vec3& globalScalation) const {
+	/*
+		IMPORTANT: All pivots are in the bottom center of the mesh.
+		We have to change every measure to LOCAL space. (EMesh dimensions are in WORLD space)
+
+		^  +height
+		|
+		|   / -depth
+		|  /
+		| /
+		|/------> +width
+
+		   /3-------- 7
+		  / |       / |
+		 /  |      /  |
+		1---------5   |
+		|  /2- - -|- -6
+		| /       |  /
+		|/        | /
+		0---------4
+		a1  = 0->1
+		a2  = 0->2
+		a3  = 0->4
+		a4  = 1->3
+		a5  = 1->5
+		a6  = 2->3
+		a7  = 2->6
+		a8  = 3->7
+		a9  = 4->5
+		a10 = 4->6
+		a11 = 5->7
+		a12 = 6->7
+	*/
+
+	auto localWidth = mesh->GetDimensions().x / globalScalation.x;
+	auto localHeight = mesh->GetDimensions().y / globalScalation.y;
+	auto localDepth = mesh->GetDimensions().z / globalScalation.z;
+
+	glm::vec3 center = model * glm::vec4(pivot.x, localHeight / 2, pivot.z, 1);
+	glm::vec3 p0 = model * glm::vec4(-(localWidth / 2), 0, +(localDepth / 2), 1);
+	glm::vec3 p1 = model * glm::vec4(-(localWidth / 2), localHeight, +(localDepth / 2), 1);
+	glm::vec3 p2 = model * glm::vec4(-(localWidth / 2), 0, -(localDepth / 2), 1);
+	glm::vec3 p3 = model * glm::vec4(-(localWidth / 2), localHeight, -(localDepth / 2), 1);
+	glm::vec3 p4 = model * glm::vec4(+(localWidth / 2), 0, +(localDepth / 2), 1);
+	glm::vec3 p5 = model * glm::vec4(+(localWidth / 2), localHeight, +(localDepth / 2), 1);
+	glm::vec3 p6 = model * glm::vec4(+(localWidth / 2), 0, -(localDepth / 2), 1);
+	glm::vec3 p7 = model * glm::vec4(+(localWidth / 2), localHeight, -(localDepth / 2), 1);
+
+	/*glm::vec3 p0 = glm::vec3(0);
+	glm::vec3 p1 = glm::vec3(0);
+	glm::vec3 p2 = glm::vec3(0);
+	glm::vec3 p3 = glm::vec3(0);
+	glm::vec3 p4 = glm::vec3(0);
+	glm::vec3 p5 = glm::vec3(0);
+	glm::vec3 p6 = glm::vec3(0);
+	glm::vec3 p7 = glm::vec3(0);*/
+
+	std::array<glm::vec3, 8> vertexs = { p0,p1,p2,p3,p4,p5,p6,p7 };
+
+	glm::mat3 axes;
+	axes[0] = glm::vec3(glm::distance(p0.x, p4.x) > 0 ? 1 : -1, 0, 0);
+	axes[1] = glm::vec3(0, glm::distance(p0.y, p1.y) > 0 ? 1 : -1, 0);
+	axes[2] = glm::vec3(0, 0, glm::distance(p0.z, p2.z) > 0 ? 1 : -1);
+
+	return OBBCollider(center, vertexs, mesh->GetDimensions(), axes);
+
+}
+
+/// <summary>
+/// Calculates the global transformation of an entity walking through all its parents.
+/// </summary>
+/// <param name="entity"> Entity. </param>
+/// <returns> Global transformation. </returns>
+PhysicsWorld::WorldTransform PhysicsWorld::CalculateWorldTransform(const Entity* entity) const {
+	// The root node has a scalation of 1.
+	return CalculateWorldTransform(entity, entity->GetParent() ? CalculateWorldTransform(entity->GetParent()) : WorldTransform());
+}
+
+/// <summary>
+/// Calculates the global transformation of an entity from the one of its parent.
+/// Translations and scalations are added through the parents like the scene nodes do.
+/// </summary>
+/// <param name="entity"> Entity. </param>
+/// <param name="parent"> Global transformation of the parent. </param>
+/// <returns> Global transformation. </returns>
+PhysicsWorld::WorldTransform PhysicsWorld::CalculateWorldTransform(const Entity* entity, const WorldTransform& parent) const {
+	glm::mat4 transformationMat = glm::translate(glm::mat4(1.0f), entity->GetPosition());
+	transformationMat = glm::rotate(transformationMat, glm::radians(entity->GetRotation().y), glm::vec3(0, 1, 0));
+	transformationMat = glm::rotate(transformationMat, glm::radians(entity->GetRotation().z), glm::vec3(0, 0, 1));
+	transformationMat = glm::rotate(transformationMat, glm::radians(entity->GetRotation().x), glm::vec3(1, 0, 0));
+	transformationMat = glm::scale(transformationMat, entity->GetScalation());
+
+	WorldTransform world;
+	world.model = parent.model * transformationMat;
+	world.pivot = entity->GetPosition() + parent.pivot;
+	world.scalation = entity->GetScalation() + parent.scalation;
+
+	return world;
+}
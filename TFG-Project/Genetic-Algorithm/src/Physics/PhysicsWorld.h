@@ -0,0 +1,306 @@
+#pragma once
+
+#include <GLM/vec3.hpp>
+#include <GLM/mat4x4.hpp>
+
+#include <Physics/TerrainGrid.h>
+#include <Physics/DeathRules.h>
+#include <Utils/Config.h>
+
+#include <vector>
+#include <array>
+#include <utility>
+#include <memory>
+
+class Entity;
+class ESkeleton;
+class EMesh;
+class OBBCollider;
+class EHeightfield;
+class PhysicsBackend;
+
+/// <summary>
+/// Physics world without render dependencies.
+/// Every simulation owns one so multiple genetic algorithms can run at the same time.
+/// Transformations are calculated from the entities instead of the scene nodes.
+/// </summary>
+class PhysicsWorld {
+	public:
+		/// <summary>
+		/// PhysicsWorld constructor.
+		/// </summary>
+		PhysicsWorld();
+
+		/// <summary>
+		/// PhysicsWorld destructor.
+		/// </summary>
+		virtual ~PhysicsWorld();
+
+		/// <summary>
+		/// Set entity physics values.
+		/// </summary>
+		/// <param name="entity"> Entity. </param>
+		virtual void SetEntityValues(Entity* entity);
+
+		/// <summary>
+		/// Set the physics values of every skeleton joint.
+		/// The joints are ordered parents first, so every global transformation is calculated once from the one of its parent.
+		/// </summary>
+		/// <param name="joints"> Skeleton joints. </param>
+		virtual void SetSkeletonValues(const std::vector<EMesh*>& joints);
+
+		/// <summary>
+		/// Updates entity physics values.
+		/// </summary>
+		/// <param name="entity"> Entity. </param>
+		void UpdateEntity(Entity* entity);
+
+		/// <summary>
+		/// Updates skeleton physics values.
+		/// </summary>
+		/// <param name="skeleton"> skeleton. </param>
+		/// <param name="deltaTime"> Time to advance. </param>
+		void UpdateSkeleton(ESkeleton* skeleton, float deltaTime);
+
+		/// <summary>
+		/// Updates skeleton physics values without checking the death rules.
+		/// </summary>
+		/// <param name="skeleton"> skeleton. </param>
+		/// <param name="deltaTime"> Time to advance. </param>
+		void MoveSkeleton(ESkeleton* skeleton, float deltaTime);
+
+		/// <summary>
+		/// Updates the physics values of every skeleton with the physics backend.
+		/// </summary>
+		/// <param name="skeletons"> Skeletons. </param>
+		/// <param name="deltaTime"> Time to advance. </param>
+		void UpdateSkeletons(const std::vector<std::shared_ptr<ESkeleton>>& skeletons, float deltaTime);
+
+		/// <summary>
+		/// Sets the physics model that moves the skeletons.
+		/// </summary>
+		/// <param name="type"> Physics backend. </param>
+		/// <param name="threads"> Threads solving the skeletons at the same time, if the backend supports it. </param>
+		void SetPhysicsBackend(Config::PhysicsBackendType type, unsigned int threads = 1);
+
+		/// <summary>
+		/// Sets how the kinematic joints are integrated.
+		/// </summary>
+		/// <param name="jointIntegration"> Joint integration. </param>
+		void SetJointIntegration(Config::JointIntegration jointIntegration) { this->jointIntegration = jointIntegration; }
+
+		/// <summary>
+		/// Scales the gravity of the skeletons.
+		/// </summary>
+		/// <param name="gravityScale"> Gravity relative to the constant value. </param>
+		void SetGravityScale(float gravityScale) { this->gravityScale = gravityScale; }
+
+		/// <summary>
+		/// Returns the gravity scale.
+		/// </summary>
+		/// <returns> Gravity relative to the constant value. </returns>
+		float GetGravityScale() const { return gravityScale; }
+
+		/// <summary>
+		/// Rotates a kinematic joint, it turns back when it reaches a rotation boundary.
+		/// </summary>
+		/// <param name="joint"> Joint. </param>
+		/// <param name="deltaTime"> Time to advance. </param>
+		static void RotateJoint(EMesh* joint, float deltaTime);
+
+		/// <summary>
+		/// Returns the ground height at a point, the highest of the heightfield and the colliding meshes.
+		/// </summary>
+		/// <param name="x"> X coordinate. </param>
+		/// <param name="z"> Z coordinate. </param>
+		/// <returns> World "y" coordinate, lowest float if there is no ground. </returns>
+		float GetGroundHeight(float x, float z) const;
+
+		/// <summary>
+		/// Returns the death rules of the skeletons.
+		/// </summary>
+		/// <returns> Death rules. </returns>
+		DeathRules& GetDeathRules() { return deathRules; }
+
+		/// <summary>
+		/// Adds a colliding object to the physics engine
+		/// </summary>
+		/// <param name="entity"> Colliding object. </param>
+		void AddCollidingMesh(EMesh* entity);
+
+		/// <summary>
+		/// Sets the heightfield terrain, the skeletons stand on the highest of the heightfield and the colliding meshes.
+		/// </summary>
+		/// <param name="heightfield"> Heightfield, nullptr to remove it. </param>
+		void SetHeightfield(const EHeightfield* heightfield) { this->heightfield = heightfield; }
+
+		//////////////////////////// DEBUG ////////////////////////////
+
+		/// <summary>
+		/// Returns a reference to gravityActivated variable.
+		/// </summary>
+		/// <returns></returns>
+		bool& GetGravityActivated() { return gravityActivated; }
+
+	protected:
+		/// <summary>
+		/// The articulated backend uses the skeleton transformations and the death rules.
+		/// </summary>
+		friend class ArticulatedBackend;
+
+		/// <summary>
+		/// Apply gravity
+		/// </summary>
+		/// <param name="skeleton"> Skeleton to apply gravity. </param>
+		/// <param name="deltaTime"> Time to advance. </param>
+		void ApplyGravity(ESkeleton* skeleton, float deltaTime) const;
+
+		/// <summary>
+		/// Apply the movement to the skeleton
+		/// </summary>
+		/// <param name="skeleton"> Skeleton to move. </param>
+		/// <param name="deltaTime"> Time to advance. </param>
+		void ApplySkeletonMovement(ESkeleton* skeleton, float deltaTime) const;
+
+		/// <summary>
+		/// Apply the movement to the skeleton from event to event.
+		/// The joints only change their velocity when they reach a rotation boundary and the core only starts or stops
+		/// moving forward then or when a hip crosses 0, so between two events everything moves at a constant velocity
+		/// and is advanced analytically. The result does not depend on the time step.
+		/// The death rules of the joint rotations are checked at their exact crossing time, the skeleton dies there.
+		/// </summary>
+		/// <param name="skeleton"> Skeleton to move. </param>
+		/// <param name="deltaTime"> Time to advance. </param>
+		void ApplySkeletonEvents(ESkeleton* skeleton, float deltaTime) const;
+
+		/// <summary>
+		/// Returns the time until the next joint event of a skeleton: a joint reaching a rotation boundary or crossing 0.
+		/// </summary>
+		/// <param name="joints"> Hip 1, knee 1, hip 2 and knee 2. </param>
+		/// <returns> Time until the next event. </returns>
+		float TimeToJointEvent(const std::array<EMesh*, 4>& joints) const;
+
+		/// <summary>
+		/// Fix position.
+		/// </summary>
+		/// <param name="skeleton"> Skeleton entity to fix. </param>
+		/// <returns> If the position has been fixed. </return>
+		bool FixPosition(ESkeleton* skeleton) const;
+
+		/// <summary>
+		/// Check if the skeleton has die.
+		/// </summary>
+		/// <param name="skeleton"> Skeleton to check. </param>
+		/// <returns> If is dead or not. </returns>
+		bool SkeletonDead(ESkeleton* skeleton) const;
+
+		/// <summary>
+		/// Calculate the OBB collider of a mesh with its dimensions already updated.
+		/// </summary>
+		/// <param name="mesh"> Mesh. </param>
+		/// <param name="model"> Global transformation matrix. </param>
+		/// <param name="pivot"> Global translation. </param>
+		/// <param name="globalScalation"> Global scalation. </param>
+		/// <returns> OBB collider. </returns>
+		OBBCollider CalculateOBB(EMesh* mesh, const glm::mat4& model, const glm::vec3& pivot, const glm::vec3& globalScalation) const;
+
+		/// <summary>
+		/// Global transformation of an entity, same values as the scene nodes.
+		/// </summary>
+		struct WorldTransform {
+			glm::mat4 model{ 1.0f };
+			glm::vec3 pivot{ 0.0f };
+			glm::vec3 scalation{ 1.0f };
+		};
+
+		/// <summary>
+		/// Calculates the dimensions and the OBB collider of a mesh from its global transformation.
+		/// </summary>
+		/// <param name="mesh"> Mesh. </param>
+		/// <param name="world"> Global transformation. </param>
+		void SetMeshValues(EMesh* mesh, const WorldTransform& world) const;
+
+		/// <summary>
+		/// Calculates the global transformation of an entity walking through all its parents.
+		/// </summary>
+		/// <param name="entity"> Entity. </param>
+		/// <returns> Global transformation. </returns>
+		WorldTransform CalculateWorldTransform(const Entity* entity) const;
+
+		/// <summary>
+		/// Calculates the global transformation of an entity from the one of its parent.
+		/// Translations and scalations are added through the parents like the scene nodes do.
+		/// </summary>
+		/// <param name="entity"> Entity. </param>
+		/// <param name="parent"> Global transformation of the parent. </param>
+		/// <returns> Global transformation. </returns>
+		WorldTransform CalculateWorldTransform(const Entity* entity, const WorldTransform& parent) const;
+
+		/// <summary>
+		/// Calculates the global transformation matrix of an entity like the scene nodes do.
+		/// </summary>
+		/// <param name="entity"> Entity. </param>
+		/// <returns> Global transformation matrix. </returns>
+		glm::mat4 CalculateTransformationMat(const Entity* entity) const { return CalculateWorldTransform(entity).model; }
+
+		/// <summary>
+		/// Constant gravity value.
+		/// </summary>
+		const glm::vec3 gravity{0.0f, -50.0f, 0.0f};
+
+		/// <summary>
+		/// Gravity relative to the constant value.
+		/// </summary>
+		float gravityScale = 1.0f;
+
+		/// <summary>
+		/// All the colliding meshes.
+		/// </summary>
+		std::vector<EMesh*> collidingMeshes;
+
+		/// <summary>
+		/// Broadphase of the colliding meshes.
+		/// </summary>
+		TerrainGrid terrainGrid;
+
+		/// <summary>
+		/// Heightfield terrain, sampled below every foot.
+		/// </summary>
+		const EHeightfield* heightfield{ nullptr };
+
+		/// <summary>
+		/// Physics model that moves the skeletons.
+		/// </summary>
+		std::unique_ptr<PhysicsBackend> backend;
+
+		/// <summary>
+		/// Death rules of the skeletons.
+		/// </summary>
+		DeathRules deathRules;
+
+		/// <summary>
+		/// Global transformations of the skeleton being updated, the memory is kept between skeletons.
+		/// </summary>
+		std::vector<std::pair<const Entity*, WorldTransform>> worldTransforms;
+
+		/// <summary>
+		/// How the kinematic joints are integrated.
+		/// </summary>
+		Config::JointIntegration jointIntegration = Config::JointIntegration::FIXED;
+
+		/// <summary>
+		/// Maximum events of a skeleton in one update, the rest of the time is advanced without events.
+		/// Enough for several seconds of the fastest joints with narrow boundaries.
+		/// </summary>
+		const int maxJointEvents = 4096;
+
+		/// <summary>
+		/// Rotation distance in degrees to consider that a joint is at an event.
+		/// </summary>
+		const float eventTolerance = 1e-4f;
+
+		/// <summary>
+		/// Debug to toggle gravity.
+		/// </summary>
+		bool gravityActivated = true;
+};
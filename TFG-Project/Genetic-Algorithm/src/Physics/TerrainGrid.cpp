@@ -0,0 +1,184 @@
+#include "TerrainGrid.h"
+
+#include <Entities/EMesh.h>
+#include <DataTypes/OBBCollider.h>
+
+#include <GLM/common.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+/// <summary>
+/// TerrainGrid constructor.
+/// </summary>
+/// <param name="cellSize"> Width and depth of every cell. </param>
+TerrainGrid::TerrainGrid(float cellSize) : cellSize(cellSize) {
+
+}
+
+/// <summary>
+/// TerrainGrid destructor.
+/// </summary>
+TerrainGrid::~TerrainGrid() {
+
+}
+
+/// <summary>
+/// Adds a mesh with its collider already calculated.
+/// </summary>
+/// <param name="mesh"> Terrain mesh. </param>
+void TerrainGrid::Insert(const EMesh* mesh) {
+	if (Contains(mesh->GetId()))
+		return;
+
+	TerrainCollider collider;
+	collider.mesh = mesh;
+	CalculateBounds(collider);
+
+	uint32_t index = static_cast<uint32_t>(colliders.size());
+	colliders.push_back(collider);
+	indices[mesh->GetId()] = index;
+	AddToCells(index);
+}
+
+/// <summary>
+/// Updates the cells of a mesh after its collider has changed, does nothing if the mesh is not in the grid.
+/// Only the cells that have changed are updated.
+/// </summary>
+/// <param name="mesh"> Terrain mesh. </param>
+void TerrainGrid::Update(const EMesh* mesh) {
+	auto it = indices.find(mesh->GetId());
+	if (it == indices.end())
+		return;
+
+	auto& collider = colliders[it->second];
+	TerrainCollider updated = collider;
+	CalculateBounds(updated);
+
+	// Same cells, only the bounds are updated.
+	if (updated.cellMin == collider.cellMin && updated.cellMax == collider.cellMax && updated.large == collider.large) {
+		collider = updated;
+		return;
+	}
+
+	RemoveFromCells(it->second);
+	collider = updated;
+	AddToCells(it->second);
+}
+
+/// <summary>
+/// Returns the highest collider point over an area of the ground plane.
+/// </summary>
+/// <param name="min"> Minimum x and z of the area. </param>
+/// <param name="max"> Maximum x and z of the area. </param>
+/// <returns> Highest "y" coordinate, lowest float if there is no collider. </returns>
+float TerrainGrid::GetMaxHeight(const glm::vec2& min, const glm::vec2& max) const {
+	float height = std::numeric_limits<float>::lowest();
+
+	auto checkCollider = [&](uint32_t index) {
+		const auto& collider = colliders[index];
+		if (collider.min.x <= max.x && collider.max.x >= min.x && collider.min.y <= max.y && collider.max.y >= min.y)
+			height = std::max(height, collider.top);
+	};
+
+	for (auto index : largeColliders)
+		checkCollider(index);
+
+	// A collider covering several of the cells is checked more than once, it does not change the result.
+	glm::ivec2 cellMin = GetCell(min);
+	glm::ivec2 cellMax = GetCell(max);
+	for (int x = cellMin.x; x <= cellMax.x; ++x) {
+		for (int z = cellMin.y; z <= cellMax.y; ++z) {
+			auto cell = cells.find(GetCellKey(glm::ivec2(x, z)));
+			if (cell == cells.end())
+				continue;
+			for (auto index : cell->second)
+				checkCollider(index);
+		}
+	}
+
+	return height;
+}
+
+/// <summary>
+/// Calculates the bounds and cells of a collider from its mesh.
+/// </summary>
+/// <param name="collider"> Terrain collider. </param>
+void TerrainGrid::CalculateBounds(TerrainCollider& collider) const {
+	collider.min = glm::vec2(std::numeric_limits<float>::max());
+	collider.max = glm::vec2(std::numeric_limits<float>::lowest());
+	collider.top = std::numeric_limits<float>::lowest();
+	for (const auto& vertex : collider.mesh->GetCollider()->GetVertexs()) {
+		collider.min = glm::min(collider.min, glm::vec2(vertex.x, vertex.z));
+		collider.max = glm::max(collider.max, glm::vec2(vertex.x, vertex.z));
+		collider.top = std::max(collider.top, vertex.y);
+	}
+
+	collider.cellMin = GetCell(collider.min);
+	collider.cellMax = GetCell(collider.max);
+	int64_t cellCount = int64_t(collider.cellMax.x - collider.cellMin.x + 1) * int64_t(collider.cellMax.y - collider.cellMin.y + 1);
+	collider.large = cellCount > maxCellsPerCollider;
+}
+
+/// <summary>
+/// Adds a collider to its cells.
+/// </summary>
+/// <param name="index"> Collider index. </param>
+void TerrainGrid::AddToCells(uint32_t index) {
+	const auto& collider = colliders[index];
+	if (collider.large) {
+		largeColliders.push_back(index);
+		return;
+	}
+
+	for (int x = collider.cellMin.x; x <= collider.cellMax.x; ++x) {
+		for (int z = collider.cellMin.y; z <= collider.cellMax.y; ++z)
+			cells[GetCellKey(glm::ivec2(x, z))].push_back(index);
+	}
+}
+
+/// <summary>
+/// Removes a collider from its cells.
+/// </summary>
+/// <param name="index"> Collider index. </param>
+void TerrainGrid::RemoveFromCells(uint32_t index) {
+	auto removeIndex = [index](std::vector<uint32_t>& indexes) {
+		indexes.erase(std::remove(indexes.begin(), indexes.end(), index), indexes.end());
+	};
+
+	const auto& collider = colliders[index];
+	if (collider.large) {
+		removeIndex(largeColliders);
+		return;
+	}
+
+	for (int x = collider.cellMin.x; x <= collider.cellMax.x; ++x) {
+		for (int z = collider.cellMin.y; z <= collider.cellMax.y; ++z) {
+			auto cell = cells.find(GetCellKey(glm::ivec2(x, z)));
+			if (cell == cells.end())
+				continue;
+			removeIndex(cell->second);
+			if (cell->second.empty())
+				cells.erase(cell);
+		}
+	}
+}
+
+/// <summary>
+/// Returns the cell of a point.
+/// </summary>
+/// <param name="point"> X and z coordinates. </param>
+/// <returns> Cell coordinates. </returns>
+glm::ivec2 TerrainGrid::GetCell(const glm::vec2& point) const {
+	return glm::ivec2(static_cast<int>(std::floor(point.x / cellSize)), static_cast<int>(std::floor(point.y / cellSize)));
+}
+
+/// <summary>
+/// Returns the key of a cell.
+/// </summary>
+/// <param name="cell"> Cell coordinates. </param>
+/// <returns> Cell key. </returns>
+int64_t TerrainGrid::GetCellKey(const glm::ivec2& cell) {
+	return (static_cast<int64_t>(cell.x) << 32) | static_cast<uint32_t>(cell.y);
+}
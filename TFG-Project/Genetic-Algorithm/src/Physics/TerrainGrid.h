@@ -0,0 +1,138 @@
+#pragma once
+
+#include <GLM/vec2.hpp>
+
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+class EMesh;
+
+/// <summary>
+/// Broadphase for the terrain colliders, a uniform grid over the ground plane (x, z).
+/// Every collider is stored in the cells its OBB covers so a leg only checks the colliders below it.
+/// Colliders covering too many cells are kept apart and always checked.
+/// </summary>
+class TerrainGrid {
+	public:
+		/// <summary>
+		/// TerrainGrid constructor.
+		/// </summary>
+		/// <param name="cellSize"> Width and depth of every cell. </param>
+		TerrainGrid(float cellSize = 100.0f);
+
+		/// <summary>
+		/// TerrainGrid destructor.
+		/// </summary>
+		~TerrainGrid();
+
+		/// <summary>
+		/// Adds a mesh with its collider already calculated.
+		/// </summary>
+		/// <param name="mesh"> Terrain mesh. </param>
+		void Insert(const EMesh* mesh);
+
+		/// <summary>
+		/// Updates the cells of a mesh after its collider has changed, does nothing if the mesh is not in the grid.
+		/// Only the cells that have changed are updated.
+		/// </summary>
+		/// <param name="mesh"> Terrain mesh. </param>
+		void Update(const EMesh* mesh);
+
+		/// <summary>
+		/// Returns if a mesh is in the grid.
+		/// </summary>
+		/// <param name="id"> Entity id. </param>
+		/// <returns> If the mesh is in the grid. </returns>
+		bool Contains(uint32_t id) const { return indices.find(id) != indices.end(); }
+
+		/// <summary>
+		/// Returns the highest collider point over an area of the ground plane.
+		/// </summary>
+		/// <param name="min"> Minimum x and z of the area. </param>
+		/// <param name="max"> Maximum x and z of the area. </param>
+		/// <returns> Highest "y" coordinate, lowest float if there is no collider. </returns>
+		float GetMaxHeight(const glm::vec2& min, const glm::vec2& max) const;
+
+		/// <summary>
+		/// Returns the number of colliders.
+		/// </summary>
+		/// <returns> Number of colliders. </returns>
+		size_t Size() const { return colliders.size(); }
+
+	private:
+		/// <summary>
+		/// Bounds of a terrain collider on the grid.
+		/// </summary>
+		struct TerrainCollider {
+			const EMesh* mesh = nullptr;
+			glm::vec2 min{ 0.0f };
+			glm::vec2 max{ 0.0f };
+			float top = 0.0f;
+			glm::ivec2 cellMin{ 0 };
+			glm::ivec2 cellMax{ 0 };
+			bool large = false;
+		};
+
+		/// <summary>
+		/// Calculates the bounds and cells of a collider from its mesh.
+		/// </summary>
+		/// <param name="collider"> Terrain collider. </param>
+		void CalculateBounds(TerrainCollider& collider) const;
+
+		/// <summary>
+		/// Adds a collider to its cells.
+		/// </summary>
+		/// <param name="index"> Collider index. </param>
+		void AddToCells(uint32_t index);
+
+		/// <summary>
+		/// Removes a collider from its cells.
+		/// </summary>
+		/// <param name="index"> Collider index. </param>
+		void RemoveFromCells(uint32_t index);
+
+		/// <summary>
+		/// Returns the cell of a point.
+		/// </summary>
+		/// <param name="point"> X and z coordinates. </param>
+		/// <returns> Cell coordinates. </returns>
+		glm::ivec2 GetCell(const glm::vec2& point) const;
+
+		/// <summary>
+		/// Returns the key of a cell.
+		/// </summary>
+		/// <param name="cell"> Cell coordinates. </param>
+		/// <returns> Cell key. </returns>
+		static int64_t GetCellKey(const glm::ivec2& cell);
+
+		/// <summary>
+		/// Width and depth of every cell.
+		/// </summary>
+		float cellSize = 100.0f;
+
+		/// <summary>
+		/// Maximum cells of a collider, bigger colliders are always checked.
+		/// </summary>
+		const int maxCellsPerCollider = 4096;
+
+		/// <summary>
+		/// All the colliders.
+		/// </summary>
+		std::vector<TerrainCollider> colliders;
+
+		/// <summary>
+		/// Collider index of every entity id.
+		/// </summary>
+		std::unordered_map<uint32_t, uint32_t> indices;
+
+		/// <summary>
+		/// Colliders of every cell.
+		/// </summary>
+		std::unordered_map<int64_t, std::vector<uint32_t>> cells;
+
+		/// <summary>
+		/// Colliders covering more than maxCellsPerCollider cells.
+		/// </summary>
+		std::vector<uint32_t> largeColliders;
+};
@@ -3,8 +3,11 @@
 #include <Render/RenderEngine.h>
 #include <State/StateExecution.h>
 #include <Utils/Utils.h>
+#include <Utils/Profiler.h>
+#include <Utils/Metrics.h>
 
 #include <iostream>
+#include <chrono>
 
 /// <summary>
 /// Creates or returns a Program instance.
@@ -45,22 +48,27 @@ void Program::SetState(State::States newState) {
 void Program::Start() {
 	int frameCount = 0;
 	int lastFPS = renderEngine->GetTime();
+	auto metrics = Metrics::GetInstance();
 
 	while (renderEngine->IsOpen()) {
 		state->InitFrame();
 		state->Update();
+
+		auto renderStart = std::chrono::steady_clock::now();
 		state->Render();
+		metrics->AddRenderTime(std::chrono::duration<double>(std::chrono::steady_clock::now() - renderStart).count());
+		metrics->Update();
 
 		int currentTime = renderEngine->GetTime();
 		frameCount++;
 		if (currentTime - lastFPS >= 1.0) {
 			std::string title = std::string(renderEngine->GetTitle() + " " + std::to_string(frameCount));
 			renderEngine->SetTitle(title);
-			Utils::FPS = frameCount;
-			Utils::deltaTime = 1.0 / Utils::FPS;
 			frameCount = 0;
 			lastFPS = currentTime;
 		}
+
+		PROFILE_FRAME();
 	}
 
 }
\ No newline at end of file
@@ -1,11 +1,14 @@
 #include "ImGuiManager.h"
 
 #include <Entities/Entity.h>
+#include <Utils/Profiler.h>
 #include <GLM/glm.hpp>
 #include <GLM/gtc/constants.hpp>
 
 #include <IMGUI/implot.h>
 
+// The headless build (HEADLESS defined) has no window, the GLFW and OpenGL backends are left out.
+
 /// <summary>
 /// Creates or returns a ImGuiManager instance.
 /// </summary>
@@ -36,8 +39,10 @@ void ImGuiManager::SetContext(GLFWwindow* window) {
 	ImGuiIO& io = ImGui::GetIO(); (void)io;
 	io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard;
 
+#ifndef HEADLESS
 	ImGui_ImplGlfw_InitForOpenGL(window, true);
 	ImGui_ImplOpenGL3_Init("#version 450");
+#endif
 	ImGui::StyleColorsDark();
 }
 
@@ -45,8 +50,10 @@ void ImGuiManager::SetContext(GLFWwindow* window) {
 /// Call at the begining of every frame.
 /// </summary>
 void ImGuiManager::FrameInit() {
+#ifndef HEADLESS
 	ImGui_ImplOpenGL3_NewFrame();
 	ImGui_ImplGlfw_NewFrame();
+#endif
 	ImGui::NewFrame();
 }
 
@@ -54,8 +61,11 @@ void ImGuiManager::FrameInit() {
 /// Render all the ImGui stuff.
 /// </summary>
 void ImGuiManager::Render() {
+	PROFILE_ZONE("ImGui render");
 	ImGui::Render();
+#ifndef HEADLESS
 	ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+#endif
 }
 
 /// <summary>
@@ -1,8 +1,10 @@
 #pragma once
 
 #include <IMGUI/imgui.h>
-#include <IMGUI/imgui_impl_glfw.h>
-#include <IMGUI/imgui_impl_opengl3.h>
+#ifndef HEADLESS
+	#include <IMGUI/imgui_impl_glfw.h>
+	#include <IMGUI/imgui_impl_opengl3.h>
+#endif
 #include <IMGUI/imgui_internal.h>
 //#include <IMGUI/implot.h>
 //#include <IMGUI/implot_internal.h>
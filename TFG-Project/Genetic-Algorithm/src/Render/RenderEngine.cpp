@@ -3,6 +3,7 @@
 #include <Entities/ECamera.h>
 #include <Entities/Entity.h>
 #include <Entities/EMesh.h>
+#include <Entities/EHeightfield.h>
 #include <Render/ImGuiManager.h>
 #include <DataTypes/OBBCollider.h>
 #include <Utils/Config.h>
@@ -10,6 +11,7 @@
 #include <GLM/gtx/string_cast.hpp>
 
 #include <cmath>
+#include <algorithm>
 
 /// <summary>
 /// Creates or returns a RenderEngine instance.
@@ -70,6 +72,78 @@ void RenderEngine::AddMesh(EMesh* mesh) {
 	mesh->SetDimensions(glm::vec3(dimensions.x, dimensions.y, dimensions.z));
 }
 
+/// <summary>
+/// Starts loading a mesh file in the background, AddMesh waits for it if it has not finished.
+/// </summary>
+/// <param name="path"> Mesh file. </param>
+void RenderEngine::PreloadMesh(const std::string& path) {
+	resourceManager->LoadResourceMeshAsync(path, true);
+}
+
+/// <summary>
+/// Add a heightfield terrain to the scene as one mesh split in chunks.
+/// </summary>
+/// <param name="heightfield"> Heightfield. </param>
+void RenderEngine::AddHeightfield(EHeightfield* heightfield) {
+	if (device->GetNodeByID(heightfield->GetId())) {
+		return;
+	}
+
+	const int chunkCells = 64;
+	const float textureTile = 100.0f;
+	const int columns = heightfield->GetColumns();
+	const int rows = heightfield->GetRows();
+	const glm::vec2 cellSize = heightfield->GetCellSize();
+
+	auto height = [&](int column, int row) {
+		return heightfield->GetGridHeight(std::clamp(column, 0, columns - 1), std::clamp(row, 0, rows - 1));
+	};
+
+	// Every chunk has its own vertices so the index buffers stay small, the borders are repeated.
+	auto resourceMesh = resourceManager->AddResourceMesh("Heightfield" + std::to_string(heightfield->GetId()));
+	for (int chunkRow = 0; chunkRow < rows - 1; chunkRow += chunkCells) {
+		for (int chunkColumn = 0; chunkColumn < columns - 1; chunkColumn += chunkCells) {
+			int chunkColumns = std::min(chunkCells, columns - 1 - chunkColumn) + 1;
+			int chunkRows = std::min(chunkCells, rows - 1 - chunkRow) + 1;
+
+			std::vector<Vertex> vertices;
+			vertices.reserve(chunkColumns * chunkRows);
+			for (int row = chunkRow; row < chunkRow + chunkRows; ++row) {
+				for (int column = chunkColumn; column < chunkColumn + chunkColumns; ++column) {
+					Vertex vertex;
+					vertex.position = glm::vec3(column * cellSize.x, height(column, row), row * cellSize.y);
+					vertex.normal = glm::normalize(glm::vec3((height(column - 1, row) - height(column + 1, row)) / (2.0f * cellSize.x)
+						, 1.0f
+						, (height(column, row - 1) - height(column, row + 1)) / (2.0f * cellSize.y)));
+					vertex.texCoords = glm::vec2(vertex.position.x, vertex.position.z) / textureTile;
+					vertices.push_back(vertex);
+				}
+			}
+
+			std::vector<unsigned int> indices;
+			indices.reserve((chunkColumns - 1) * (chunkRows - 1) * 6);
+			for (int row = 0; row < chunkRows - 1; ++row) {
+				for (int column = 0; column < chunkColumns - 1; ++column) {
+					unsigned int a = row * chunkColumns + column;
+					unsigned int b = a + 1;
+					unsigned int c = a + chunkColumns;
+					unsigned int d = c + 1;
+					indices.insert(indices.end(), { a, c, b, b, c, d });
+				}
+			}
+
+			resourceMesh->LoadMesh(vertices, indices, "Grass_Block_TEX.png");
+		}
+	}
+
+	CLE::CLNode* node = device->AddMesh(smgr, heightfield->GetId());
+	static_cast<CLE::CLMesh*>(node->GetEntity())->SetMesh(resourceMesh);
+	node->SetTranslation(heightfield->GetPosition());
+	node->SetRotation(glm::vec3(0.0f));
+	node->SetScalation(glm::vec3(1.0f));
+	node->SetStatic(true);
+}
+
 /// <summary>
 /// Add camera to the scene
 /// </summary>
@@ -238,6 +312,71 @@ void RenderEngine::SetVisible(EMesh* entity, bool visiblity) {
 	node->SetVisible(visiblity);
 }
 
+/// <summary>
+/// Sets the transformations and the visibility of a node, only the changed values are set.
+/// </summary>
+/// <param name="id"> Entity id. </param>
+/// <param name="position"> Position. </param>
+/// <param name="rotation"> Rotation. </param>
+/// <param name="scalation"> Scalation. </param>
+/// <param name="visible"> Visibility. </param>
+void RenderEngine::UpdateNode(uint32_t id, const glm::vec3& position, const glm::vec3& rotation, const glm::vec3& scalation, bool visible) {
+	auto node = device->GetNodeByID(id);
+	if (!node)
+		return;
+
+	// Setting a transformation marks the node and its children to recalculate, and invalidates the static shadows.
+	if (node->GetTranslation() != position)
+		node->SetTranslation(position);
+	if (node->GetRotation() != rotation)
+		node->SetRotation(rotation);
+	if (node->GetScalation() != scalation)
+		node->SetScalation(scalation);
+	node->SetVisible(visible);
+}
+
+/// <summary>
+/// Marks an entity as static, its shadow is cached and only drawn again when it changes.
+/// </summary>
+/// <param name="entity"> Entity. </param>
+/// <param name="isStatic"> If the entity does not move. </param>
+void RenderEngine::SetStatic(EMesh* entity, bool isStatic) {
+	auto node = device->GetNodeByID(entity->GetId());
+	node->SetStatic(isStatic);
+}
+
+/// <summary>
+/// Enables or disables the frustum culling of the camera and the shadows.
+/// </summary>
+/// <param name="frustumCulling"> If the nodes outside the frustums are not drawn. </param>
+void RenderEngine::SetFrustumCulling(bool frustumCulling) {
+	device->SetFrustumCulling(frustumCulling);
+}
+
+/// <summary>
+/// Returns the nodes drawn and culled in the last frame.
+/// </summary>
+/// <returns> Culling counters of the main and shadow passes. </returns>
+const CLE::CLCullingStats& RenderEngine::GetCullingStats() const {
+	return device->GetCullingStats();
+}
+
+/// <summary>
+/// Returns the draws and the state changes of the main pass in the last frame.
+/// </summary>
+/// <returns> Render queue counters. </returns>
+const CLE::CLRenderQueueStats& RenderEngine::GetRenderQueueStats() const {
+	return device->GetRenderQueueStats();
+}
+
+/// <summary>
+/// Returns the resources loaded and the GPU memory they use.
+/// </summary>
+/// <returns> Resource counters by type. </returns>
+CLE::CLResourceStats RenderEngine::GetResourceStats() const {
+	return resourceManager->GetResourceStats();
+}
+
 /// <summary>
 /// Draw 3D line.
 /// </summary>
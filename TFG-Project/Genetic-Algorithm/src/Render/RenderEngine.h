@@ -4,6 +4,7 @@
 
 class ECamera;
 class EMesh;
+class EHeightfield;
 
 /// <summary>
 /// RenderEngine to use the CLEngine library.
@@ -39,6 +40,18 @@ class RenderEngine{
 		/// <param name="mesh"> Mesh. </param>
 		void AddMesh(EMesh* mesh);
 
+		/// <summary>
+		/// Starts loading a mesh file in the background, AddMesh waits for it if it has not finished.
+		/// </summary>
+		/// <param name="path"> Mesh file. </param>
+		void PreloadMesh(const std::string& path);
+
+		/// <summary>
+		/// Add a heightfield terrain to the scene as one mesh split in chunks.
+		/// </summary>
+		/// <param name="heightfield"> Heightfield. </param>
+		void AddHeightfield(EHeightfield* heightfield);
+
 		/// <summary>
 		/// Add camera to the scene.
 		/// </summary>
@@ -122,6 +135,47 @@ class RenderEngine{
 		/// <param name="entity"> Entity. </param>
 		/// <param name="visiblity"> Visibility. </param>
 		void SetVisible(EMesh* entity, bool visiblity);
+
+		/// <summary>
+		/// Sets the transformations and the visibility of a node, only the changed values are set.
+		/// </summary>
+		/// <param name="id"> Entity id. </param>
+		/// <param name="position"> Position. </param>
+		/// <param name="rotation"> Rotation. </param>
+		/// <param name="scalation"> Scalation. </param>
+		/// <param name="visible"> Visibility. </param>
+		void UpdateNode(uint32_t id, const glm::vec3& position, const glm::vec3& rotation, const glm::vec3& scalation, bool visible);
+
+		/// <summary>
+		/// Marks an entity as static, its shadow is cached and only drawn again when it changes.
+		/// </summary>
+		/// <param name="entity"> Entity. </param>
+		/// <param name="isStatic"> If the entity does not move. </param>
+		void SetStatic(EMesh* entity, bool isStatic);
+
+		/// <summary>
+		/// Enables or disables the frustum culling of the camera and the shadows.
+		/// </summary>
+		/// <param name="frustumCulling"> If the nodes outside the frustums are not drawn. </param>
+		void SetFrustumCulling(bool frustumCulling);
+
+		/// <summary>
+		/// Returns the nodes drawn and culled in the last frame.
+		/// </summary>
+		/// <returns> Culling counters of the main and shadow passes. </returns>
+		const CLE::CLCullingStats& GetCullingStats() const;
+
+		/// <summary>
+		/// Returns the draws and the state changes of the main pass in the last frame.
+		/// </summary>
+		/// <returns> Render queue counters. </returns>
+		const CLE::CLRenderQueueStats& GetRenderQueueStats() const;
+
+		/// <summary>
+		/// Returns the resources loaded and the GPU memory they use.
+		/// </summary>
+		/// <returns> Resource counters by type. </returns>
+		CLE::CLResourceStats GetResourceStats() const;
 	
 	private:
 		/// <summary>
@@ -0,0 +1,205 @@
+#include "SimulationThread.h"
+
+#include <GeneticAlgorithm/GeneticAlgorithm.h>
+#include <Entities/Compositions/ESkeleton.h>
+#include <Entities/EMesh.h>
+#include <Entities/EHeightfield.h>
+#include <Utils/Config.h>
+#include <Utils/Utils.h>
+#include <Utils/Profiler.h>
+#include <Utils/Metrics.h>
+
+#include <algorithm>
+#include <chrono>
+
+/// <summary>
+/// SimulationThread constructor.
+/// </summary>
+/// <param name="geneticAlgorithm"> Genetic algorithm, its population is the one simulated. </param>
+/// <param name="terrain"> Meshes the skeletons collide with. </param>
+/// <param name="heightfield"> Heightfield over the field, nullptr with a flat field. </param>
+/// <param name="timeToStart"> Milliseconds every generation waits before moving. </param>
+SimulationThread::SimulationThread(GeneticAlgorithm* geneticAlgorithm, const std::vector<EMesh*>& terrain, EHeightfield* heightfield, long long timeToStart) :
+	geneticAlgorithm(geneticAlgorithm),
+	skeletons(geneticAlgorithm->GetPopulation()),
+	terrain(terrain),
+	timeToStart(timeToStart) {
+	for (auto mesh : terrain) {
+		physicsWorld.SetEntityValues(mesh);
+		physicsWorld.AddCollidingMesh(mesh);
+	}
+	physicsWorld.SetHeightfield(heightfield);
+
+	// One core is left for the render thread.
+	physicsWorld.SetPhysicsBackend(Config::physicsBackend, std::max(std::thread::hardware_concurrency(), 2u) - 1);
+	physicsWorld.SetJointIntegration(Config::jointIntegration);
+
+	for (const auto& skeleton : skeletons) {
+		for (auto joint : skeleton->GetSkeleton())
+			physicsWorld.SetEntityValues(joint);
+	}
+
+	// The render thread has a snapshot before the first frame.
+	PublishSnapshot();
+	snapshots.Update();
+}
+
+/// <summary>
+/// SimulationThread destructor, stops the thread.
+/// </summary>
+SimulationThread::~SimulationThread() {
+	Stop();
+}
+
+/// <summary>
+/// Starts the simulation thread.
+/// </summary>
+void SimulationThread::Start() {
+	if (running)
+		return;
+
+	running = true;
+	thread = std::thread(&SimulationThread::Run, this);
+}
+
+/// <summary>
+/// Stops the simulation thread and waits for it.
+/// </summary>
+void SimulationThread::Stop() {
+	running = false;
+	if (thread.joinable())
+		thread.join();
+}
+
+/// <summary>
+/// Locks the genetic algorithm and the skeletons between two frames of the simulation.
+/// </summary>
+/// <param name="wait"> If it also waits for the new generation to be bred. </param>
+/// <returns> Lock, without waiting it does not own the mutex while a new generation is bred. </returns>
+std::unique_lock<std::mutex> SimulationThread::LockGeneticAlgorithm(bool wait) {
+	// The simulation thread waits after every frame until the lock is taken, so it can not take it again first.
+	std::unique_lock<std::mutex> lock(mutex, std::defer_lock);
+	waiting = true;
+	while ((wait || !breeding) && !lock.try_lock())
+		std::this_thread::yield();
+	waiting = false;
+
+	return lock;
+}
+
+/// <summary>
+/// Simulation loop.
+/// </summary>
+void SimulationThread::Run() {
+	PROFILE_THREAD("Simulation thread");
+	using clock = std::chrono::steady_clock;
+	auto clockStart = clock::now();
+	long long clockFrames = 0;
+	float lastSpeed = speed;
+
+	while (running) {
+		auto now = clock::now();
+		float actualSpeed = speed;
+		if (actualSpeed != lastSpeed) {
+			clockStart = now;
+			clockFrames = 0;
+			lastSpeed = actualSpeed;
+		}
+
+		// With a speed the frames follow the clock, the thread sleeps while it goes ahead of it.
+		// If it falls far behind the clock starts again instead of catching up.
+		if (actualSpeed > 0.0f) {
+			auto frameTime = clockStart + std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(clockFrames * Utils::deltaTime / actualSpeed));
+			if (frameTime > now) {
+				std::this_thread::sleep_for(std::min<clock::duration>(frameTime - now, std::chrono::milliseconds(10)));
+				continue;
+			}
+			if (now - frameTime > std::chrono::milliseconds(250)) {
+				clockStart = now;
+				clockFrames = 0;
+			}
+		}
+
+		bool finished = false;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			Step();
+			PublishSnapshot();
+			finished = geneticAlgorithm->GetGeneration() >= Config::maxGenerations + 1;
+		}
+		clockFrames++;
+
+		// Every simulated frame is a frame of this thread in the profiler, apart from the render frames.
+		PROFILE_FRAME();
+
+		while (waiting && running)
+			std::this_thread::yield();
+
+		if (finished)
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+}
+
+/// <summary>
+/// Simulates a frame and breeds a new generation at the end of its life span.
+/// </summary>
+void SimulationThread::Step() {
+	PROFILE_FUNCTION();
+	auto metrics = Metrics::GetInstance();
+	long long time = (frame * MSTOSECONDS) / Utils::FPS - timeToStart;
+	bool simulating = geneticAlgorithm->GetGeneration() < Config::maxGenerations + 1;
+
+	// The generation time is measured from the first frame the skeletons move.
+	if (time <= 0)
+		generationStart = std::chrono::steady_clock::now();
+
+	if (time >= 0 && simulating) {
+		uint64_t evaluations = 0;
+		for (const auto& skeleton : skeletons)
+			evaluations += !skeleton->IsDead();
+		physicsWorld.GetGravityActivated() = gravityActivated;
+		physicsWorld.UpdateSkeletons(skeletons, Utils::deltaTime);
+		metrics->AddTicks(1, evaluations);
+
+		for (auto mesh : terrain)
+			physicsWorld.UpdateEntity(mesh);
+	}
+
+	geneticAlgorithm->Update(time);
+	frame++;
+
+	if (time >= Config::generationLifeSpan * MSTOSECONDS && simulating) {
+		breeding = true;
+		auto breedingStart = std::chrono::steady_clock::now();
+		geneticAlgorithm->NewGeneration();
+		auto breedingEnd = std::chrono::steady_clock::now();
+		metrics->AddGeneration(std::chrono::duration<double>(breedingEnd - generationStart).count(), std::chrono::duration<double>(breedingEnd - breedingStart).count());
+		frame = 0;
+		breeding = false;
+	}
+}
+
+/// <summary>
+/// Copies the state to the write snapshot and publishes it.
+/// </summary>
+void SimulationThread::PublishSnapshot() {
+	auto& snapshot = snapshots.GetWriteBuffer();
+	snapshot.joints.clear();
+	for (const auto& skeleton : skeletons) {
+		for (auto joint : skeleton->GetSkeleton())
+			snapshot.joints.push_back({ joint->GetId(), skeleton->GetSkeletonId(), joint->GetPosition(), joint->GetRotation(), joint->GetScalation() });
+	}
+
+	snapshot.generation = geneticAlgorithm->GetGeneration();
+	snapshot.time = (frame * MSTOSECONDS) / Utils::FPS - timeToStart;
+	snapshot.finished = snapshot.generation >= Config::maxGenerations + 1;
+
+	auto bestGene = geneticAlgorithm->GetBestGene();
+	snapshot.bestGeneId = bestGene ? bestGene->GetSkeletonId() : -1;
+	snapshot.bestGenePosition = bestGene ? std::optional<glm::vec3>(bestGene->GetCore()->GetPosition()) : std::nullopt;
+	auto bestLastGeneration = geneticAlgorithm->GetBestGeneLastGeneration();
+	snapshot.bestLastGenerationId = bestLastGeneration ? bestLastGeneration->GetSkeletonId() : -1;
+	snapshot.bestLastGenerationPosition = bestLastGeneration ? std::optional<glm::vec3>(bestLastGeneration->GetCore()->GetPosition()) : std::nullopt;
+
+	snapshots.Publish();
+}
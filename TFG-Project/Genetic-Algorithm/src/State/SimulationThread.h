@@ -0,0 +1,221 @@
+#pragma once
+
+#include <Physics/PhysicsWorld.h>
+#include <Utils/TripleBuffer.h>
+
+#include <GLM/vec3.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+class GeneticAlgorithm;
+class ESkeleton;
+class EMesh;
+class EHeightfield;
+
+/// <summary>
+/// State of the simulation after a frame, what the render thread needs to draw it.
+/// </summary>
+struct SimulationSnapshot {
+	/// <summary>
+	/// Transformations of a joint, local to its parent like the entity ones.
+	/// </summary>
+	struct Joint {
+		uint32_t id = 0;
+		int skeletonId = 0;
+		glm::vec3 position{ 0.0f };
+		glm::vec3 rotation{ 0.0f };
+		glm::vec3 scalation{ 1.0f };
+	};
+
+	/// <summary>
+	/// Joints of all the skeletons.
+	/// </summary>
+	std::vector<Joint> joints;
+
+	/// <summary>
+	/// Actual generation.
+	/// </summary>
+	int generation = 0;
+
+	/// <summary>
+	/// Life of the generation in milliseconds, negative before the skeletons start moving.
+	/// </summary>
+	long long time = 0;
+
+	/// <summary>
+	/// Best skeleton and best skeleton of the last generation, -1 if there is none.
+	/// </summary>
+	int bestGeneId = -1, bestLastGenerationId = -1;
+
+	/// <summary>
+	/// Core positions of the best skeleton and the best skeleton of the last generation.
+	/// </summary>
+	std::optional<glm::vec3> bestGenePosition, bestLastGenerationPosition;
+
+	/// <summary>
+	/// If all the generations have been simulated.
+	/// </summary>
+	bool finished = false;
+};
+
+/// <summary>
+/// Runs the physics and the genetic algorithm of the execution state on its own thread.
+/// The skeletons are simulated on a physics world without render with the fixed time step of the batch runs, so the
+/// simulation speed does not depend on the frame rate. Every frame the state is copied to a snapshot that the render
+/// thread takes from a triple buffer. The genetic algorithm and the skeletons can only be read or edited from other
+/// threads while holding the lock, that is not given while a new generation is bred so the interface does not wait.
+/// </summary>
+class SimulationThread {
+	public:
+		/// <summary>
+		/// SimulationThread constructor.
+		/// </summary>
+		/// <param name="geneticAlgorithm"> Genetic algorithm, its population is the one simulated. </param>
+		/// <param name="terrain"> Meshes the skeletons collide with. </param>
+		/// <param name="heightfield"> Heightfield over the field, nullptr with a flat field. </param>
+		/// <param name="timeToStart"> Milliseconds every generation waits before moving. </param>
+		SimulationThread(GeneticAlgorithm* geneticAlgorithm, const std::vector<EMesh*>& terrain, EHeightfield* heightfield, long long timeToStart);
+
+		/// <summary>
+		/// SimulationThread destructor, stops the thread.
+		/// </summary>
+		~SimulationThread();
+
+		/// <summary>
+		/// Starts the simulation thread.
+		/// </summary>
+		void Start();
+
+		/// <summary>
+		/// Stops the simulation thread and waits for it.
+		/// </summary>
+		void Stop();
+
+		/// <summary>
+		/// Sets the simulation speed.
+		/// </summary>
+		/// <param name="speed"> Simulated seconds every real second, 0 runs as fast as possible. </param>
+		void SetSpeed(float speed) { this->speed = speed; }
+
+		/// <summary>
+		/// Enables or disables the gravity.
+		/// </summary>
+		/// <param name="gravityActivated"> If the gravity is applied. </param>
+		void SetGravityActivated(bool gravityActivated) { this->gravityActivated = gravityActivated; }
+
+		/// <summary>
+		/// Takes the last snapshot published, only from the render thread.
+		/// </summary>
+		/// <returns> If there is a new snapshot. </returns>
+		bool UpdateSnapshot() { return snapshots.Update(); }
+
+		/// <summary>
+		/// Returns the last snapshot taken, only from the render thread.
+		/// </summary>
+		/// <returns> Snapshot. </returns>
+		const SimulationSnapshot& GetSnapshot() const { return snapshots.GetReadBuffer(); }
+
+		/// <summary>
+		/// Locks the genetic algorithm and the skeletons between two frames of the simulation.
+		/// </summary>
+		/// <param name="wait"> If it also waits for the new generation to be bred. </param>
+		/// <returns> Lock, without waiting it does not own the mutex while a new generation is bred. </returns>
+		std::unique_lock<std::mutex> LockGeneticAlgorithm(bool wait = false);
+
+	private:
+		/// <summary>
+		/// Simulation loop.
+		/// </summary>
+		void Run();
+
+		/// <summary>
+		/// Simulates a frame and breeds a new generation at the end of its life span.
+		/// </summary>
+		void Step();
+
+		/// <summary>
+		/// Copies the state to the write snapshot and publishes it.
+		/// </summary>
+		void PublishSnapshot();
+
+		/// <summary>
+		/// Genetic algorithm.
+		/// </summary>
+		GeneticAlgorithm* geneticAlgorithm{ nullptr };
+
+		/// <summary>
+		/// Skeletons simulated, the order does not change with the sorts of the genetic algorithm.
+		/// </summary>
+		std::vector<std::shared_ptr<ESkeleton>> skeletons;
+
+		/// <summary>
+		/// Meshes the skeletons collide with.
+		/// </summary>
+		std::vector<EMesh*> terrain;
+
+		/// <summary>
+		/// Physics world without render.
+		/// </summary>
+		PhysicsWorld physicsWorld;
+
+		/// <summary>
+		/// Milliseconds every generation waits before moving.
+		/// </summary>
+		long long timeToStart = 0;
+
+		/// <summary>
+		/// Frames simulated in the actual generation, counting the wait.
+		/// </summary>
+		long long frame = 0;
+
+		/// <summary>
+		/// Time when the skeletons of the actual generation started moving.
+		/// </summary>
+		std::chrono::steady_clock::time_point generationStart = std::chrono::steady_clock::now();
+
+		/// <summary>
+		/// Snapshots for the render thread.
+		/// </summary>
+		TripleBuffer<SimulationSnapshot> snapshots;
+
+		/// <summary>
+		/// Simulation thread.
+		/// </summary>
+		std::thread thread;
+
+		/// <summary>
+		/// Mutex of the genetic algorithm and the skeletons.
+		/// </summary>
+		std::mutex mutex;
+
+		/// <summary>
+		/// If the thread keeps simulating.
+		/// </summary>
+		std::atomic<bool> running{ false };
+
+		/// <summary>
+		/// If a new generation is being bred.
+		/// </summary>
+		std::atomic<bool> breeding{ false };
+
+		/// <summary>
+		/// If other thread is waiting for the lock.
+		/// </summary>
+		std::atomic<bool> waiting{ false };
+
+		/// <summary>
+		/// Simulated seconds every real second, 0 runs as fast as possible.
+		/// </summary>
+		std::atomic<float> speed{ 1.0f };
+
+		/// <summary>
+		/// If the gravity is applied.
+		/// </summary>
+		std::atomic<bool> gravityActivated{ true };
+};
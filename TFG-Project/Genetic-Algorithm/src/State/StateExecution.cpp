@@ -1,21 +1,27 @@
 #include "StateExecution.h"
+#include "SimulationThread.h"
 
 #include <Render/RenderEngine.h>
 #include <Physics/PhysicsEngine.h>
 #include <Render/ImGuiManager.h>
 #include <Entities/ECamera.h>
 #include <Entities/EMesh.h>
+#include <Entities/EHeightfield.h>
 #include <Entities/Compositions/ESkeleton.h>
 #include <Entities/Entity.h>
 #include <DataTypes/Transformable.h>
 #include <GeneticAlgorithm/GeneticAlgorithm.h>
 #include <Utils/Config.h>
 #include <Utils/Utils.h>
+#include <Utils/Profiler.h>
+#include <Utils/Metrics.h>
 
 #include <IMGUI/imgui.h>
 #include <IMGUI/implot.h>
 #include <GLM/gtc/type_ptr.hpp>
 
+#include <thread>
+
 /// <summary>
 /// StateExecution constructor.
 /// </summary>
@@ -26,6 +32,13 @@ StateExecution::StateExecution() {
 	camera = make_unique<ECamera>(Transformable(glm::vec3(-150.0f, 100.0f, 150.0f), glm::vec3(0.0f), glm::vec3(1.0f)), glm::vec3(-30.0f, 45, 0));
 	camera->SetName("Camera");
 	camera->SetPositionBoundaries(std::pair<float, float>(-200,1000));
+
+	// Every mesh is read at the same time while the skybox is decoded, the skeleton is only created to know its meshes.
+	renderEngine->PreloadMesh("media/Grass_Block.obj");
+	auto skeleton = GeneticAlgorithm::CreateSkeleton(glm::vec3(0.0f));
+	for (auto joint : skeleton->GetSkeleton())
+		renderEngine->PreloadMesh(joint->GetMeshPath());
+
 	renderEngine->AddSkybox("media/skybox/right.jpg"
 		, "media/skybox/left.jpg"
 		, "media/skybox/top.jpg"
@@ -65,52 +78,39 @@ void StateExecution::InitFrame() {
 /// StateExecution update.
 /// </summary>
 void StateExecution::Update() {
+	PROFILE_FUNCTION();
 	if (executionStarted) {
-		auto setVisible = [&](ESkeleton* skeleton, bool visible) {
-			for (auto joint : skeleton->GetSkeleton())
-				renderEngine->SetVisible(joint, visible);
-		};
+		// The scene shows the last frame simulated, the simulation thread does not wait for the render.
+		simulation->UpdateSnapshot();
+		const auto& snapshot = simulation->GetSnapshot();
 
-		auto time = duration_cast<milliseconds>(std::chrono::system_clock::now() - timeStart).count() - timeToStart.count();
-		ImGuiDebug();
-
-		ESkeleton* target = nullptr;
+		int target = -1;
 		if (onlyTarget) {
 			switch (camera->cameraType) {
 				case ECamera::CameraType::BESTGENE: {
-					target = geneticAlgorithm->GetBestGene();
+					target = snapshot.bestGeneId;
 					break;
 				}
 				case ECamera::CameraType::BESTLASTGENE: {
-					target = geneticAlgorithm->GetBestGeneLastGeneration();
+					target = snapshot.bestLastGenerationId;
 					break;
 				}
 			}
-			if (target) {
-				for (const auto skeleton : skeletons) {
-					(skeleton->GetSkeletonId() != target->GetSkeletonId()) ? setVisible(skeleton.get(), false) : setVisible(skeleton.get(), true);
-				}
-			}
-		}else {
-			for (const auto skeleton : skeletons)
-				setVisible(skeleton.get(), true);
 		}
 
-		if (time >= std::chrono::milliseconds(0).count() && geneticAlgorithm->GetGeneration() < Config::maxGenerations + 1) {
-			for (const auto& skeleton : skeletons) {
-				physicsEngine->UpdateSkeleton(skeleton.get());
-			}
+		for (const auto& joint : snapshot.joints)
+			renderEngine->UpdateNode(joint.id, joint.position, joint.rotation, joint.scalation, target < 0 || joint.skeletonId == target);
 
-			for (const auto& mesh : terrain) {
-				physicsEngine->UpdateEntity(mesh.get());
-			}
+		// The windows that read or edit the genetic algorithm are only shown between two simulation frames.
+		auto lock = simulation->LockGeneticAlgorithm();
+		ImGuiDebug(lock.owns_lock());
+		if (lock.owns_lock()) {
+			geneticAlgorithm->ShowDebugWindow(snapshot.time);
 		}
-
-		geneticAlgorithm->Update(time);
-
-		if (time >= Config::generationLifeSpan * MSTOSECONDS && geneticAlgorithm->GetGeneration() < Config::maxGenerations + 1) {
-			timeStart = std::chrono::system_clock::now();
-			geneticAlgorithm->NewGeneration();
+		else {
+			imGuiManager->Begin("Genetic algorithm debug");
+			imGuiManager->BulletText("Breeding generation " + std::to_string(snapshot.generation + 1));
+			imGuiManager->End();
 		}
 
 	}else {
@@ -118,25 +118,32 @@ void StateExecution::Update() {
 		ShowConfigurationWindow();
 		imGuiManager->End();
 	}
-	
+
+	Metrics::GetInstance()->ShowWindow();
+
+#ifdef PROFILER_ENABLED
+	Profiler::GetInstance()->ShowWindow();
+#endif
 }
 
 /// <summary>
 /// StateExecution render.
 /// </summary>
 void StateExecution::Render() {
+	PROFILE_FUNCTION();
 	renderEngine->BeginScene();
 	renderEngine->DrawAll();
 
 	// Now we can render primiteves like lines
 	if (executionStarted) {
+		const auto& snapshot = simulation->GetSnapshot();
 		imGuiManager->Begin("Debug");
 
 		imGuiManager->BulletText("Camera type");
-		if (geneticAlgorithm->GetBestGene()) {
+		if (snapshot.bestGenePosition) {
 			imGuiManager->RadioButton("Best", (int*)&camera->cameraType, 0); imGuiManager->SameLine();
 		}
-		if (geneticAlgorithm->GetBestGeneLastGeneration()) {
+		if (snapshot.bestLastGenerationPosition) {
 			imGuiManager->RadioButton("Last generation best", (int*)&camera->cameraType, 1); imGuiManager->SameLine();
 		}
 		imGuiManager->RadioButton("Free", (int*)&camera->cameraType, 2);
@@ -151,7 +158,8 @@ void StateExecution::Render() {
 		imGuiManager->Separator();
 
 		imGuiManager->Checkbox("Show bounding boxes", &showBoundingBoxes);
-		if (showBoundingBoxes) {
+		auto lock = simulation->LockGeneticAlgorithm();
+		if (showBoundingBoxes && lock.owns_lock()) {
 			for (const auto& skeleton : skeletons) {
 				for (const auto& joint : skeleton->GetSkeleton()) {
 					renderEngine->DrawBoundingBox(joint);
@@ -162,16 +170,42 @@ void StateExecution::Render() {
 				renderEngine->DrawBoundingBox(mesh.get());
 			}
 		}
-		imGuiManager->Checkbox("Gravity", &physicsEngine->GetGravityActivated());
+		lock.unlock();
+		imGuiManager->Checkbox("Gravity", &gravityActivated);
+		simulation->SetGravityActivated(gravityActivated);
+		imGuiManager->FloatSlider("Simulation speed", &simulationSpeed, 0, 10);
+		if (imGuiManager->IsHovered()) {
+			imGuiManager->BeginTooltip();
+			imGuiManager->Text("Simulated seconds every second, 0 simulates as fast as possible");
+			imGuiManager->EndTooltip();
+		}
+		simulation->SetSpeed(simulationSpeed);
+
+		imGuiManager->Separator();
+
+		imGuiManager->Checkbox("Frustum culling", &frustumCulling);
+		renderEngine->SetFrustumCulling(frustumCulling);
+		const auto& cullingStats = renderEngine->GetCullingStats();
+		imGuiManager->Text("Drawn nodes: " + std::to_string(cullingStats.drawn) + " (culled " + std::to_string(cullingStats.culled) + ")");
+		imGuiManager->Text("Shadow nodes: " + std::to_string(cullingStats.shadowDrawn) + " (culled " + std::to_string(cullingStats.shadowCulled) + ")");
+		const auto& queueStats = renderEngine->GetRenderQueueStats();
+		imGuiManager->Text("Draws: " + std::to_string(queueStats.packets) + " (programs " + std::to_string(queueStats.programChanges)
+			+ ", textures " + std::to_string(queueStats.textureChanges) + ", VAOs " + std::to_string(queueStats.vaoChanges) + ")");
+		const auto resourceStats = renderEngine->GetResourceStats();
+		auto megabytes = [](size_t bytes) { return std::to_string(bytes / (1024 * 1024)) + " MB"; };
+		imGuiManager->Text("Meshes: " + std::to_string(resourceStats.meshes.count) + " (" + megabytes(resourceStats.meshes.bytes) + ")"
+			+ ", textures: " + std::to_string(resourceStats.textures.count) + " (" + megabytes(resourceStats.textures.bytes) + ")"
+			+ ", shaders: " + std::to_string(resourceStats.shaders.count));
 
 		if (imGuiManager->Button("Export dataset")) {
+			auto exportLock = simulation->LockGeneticAlgorithm(true);
 			geneticAlgorithm->WriteCSV();
 		}
 		imGuiManager->End();
 		
 		renderEngine->DrawDistanceLines();
-		if (auto gene = geneticAlgorithm->GetBestGene()) {
-			renderEngine->DrawFirstPlaceLine(gene->GetCore()->GetPosition());
+		if (snapshot.bestGenePosition) {
+			renderEngine->DrawFirstPlaceLine(*snapshot.bestGenePosition);
 		}
 	}
 	
@@ -193,24 +227,33 @@ void StateExecution::AddEntities() {
 
 	for (const auto& mesh : terrain) {
 		renderEngine->AddMesh(mesh.get());
-		physicsEngine->AddCollidingMesh(mesh.get());
+		renderEngine->SetStatic(mesh.get(), true);
 		physicsEngine->SetEntityValues(mesh.get());
 	}
 
+	if (heightfield) {
+		renderEngine->AddHeightfield(heightfield.get());
+	}
+
 }
 
 /// <summary>
 /// Refactor imGui debug.
 /// </summary>
-void StateExecution::ImGuiDebug() {
+/// <param name="locked"> If the simulation is locked and the entities can be edited. </param>
+void StateExecution::ImGuiDebug(bool locked) {
+	PROFILE_FUNCTION();
+	const auto& snapshot = simulation->GetSnapshot();
 	imGuiManager->Begin("Entities transformables");
 	switch (camera->GetCameraType()) {
 		case ECamera::CameraType::BESTGENE: {
-			physicsEngine->UpdateCamera(camera.get(), geneticAlgorithm->GetBestGene());
+			if (snapshot.bestGenePosition)
+				physicsEngine->UpdateCamera(camera.get(), *snapshot.bestGenePosition);
 			break;
 		}
 		case ECamera::CameraType::BESTLASTGENE: {
-			physicsEngine->UpdateCamera(camera.get(), geneticAlgorithm->GetBestGeneLastGeneration());
+			if (snapshot.bestLastGenerationPosition)
+				physicsEngine->UpdateCamera(camera.get(), *snapshot.bestLastGenerationPosition);
 			break;
 		}
 		case ECamera::CameraType::FREE: {
@@ -219,6 +262,11 @@ void StateExecution::ImGuiDebug() {
 		}
 	}
 
+	if (!locked) {
+		imGuiManager->End();
+		return;
+	}
+
 	for (const auto& skeleton : skeletons) {
 		if (imGuiManager->Header(std::string("Skeleton " + std::to_string(skeleton->GetSkeletonId())))) {
 			for (auto joint : skeleton->GetSkeleton()) {
@@ -232,6 +280,7 @@ void StateExecution::ImGuiDebug() {
 		if (imGuiManager->Header(std::string(std::to_string(mesh->GetId()) + ". " + mesh->GetName()))) {
 			imGuiManager->EntityTransformable(mesh.get(), std::string(mesh->GetName()));
 		}
+		renderEngine->UpdateNode(mesh->GetId(), mesh->GetPosition(), mesh->GetRotation(), mesh->GetScalation(), true);
 	}
 	imGuiManager->End();
 }
@@ -291,11 +340,46 @@ void StateExecution::ShowConfigurationWindow() {
 
 	imGuiManager->Separator();
 
+	imGuiManager->BulletText("Terrain");
+	imGuiManager->FloatSlider("Terrain height", &Config::terrainAmplitude, 0, 30);
+	if (imGuiManager->IsHovered()) {
+		imGuiManager->BeginTooltip();
+		imGuiManager->Text("0 for a flat field");
+		imGuiManager->EndTooltip();
+	}
+	if (Config::terrainAmplitude > 0) {
+		// Shows terrain seed.
+		imGuiManager->IntSlider("Terrain seed", (int*)&Config::terrainSeed, 1, 100);
+	}
+
+	imGuiManager->Separator();
+
+	imGuiManager->BulletText("Physics");
+	imGuiManager->RadioButton("Kinematic", (int*)&Config::physicsBackend, 0); imGuiManager->SameLine();
+	imGuiManager->RadioButton("Articulated", (int*)&Config::physicsBackend, 1);
+	if (imGuiManager->IsHovered()) {
+		imGuiManager->BeginTooltip();
+		imGuiManager->Text("Joints moved by torques, the skeletons walk pushing the floor");
+		imGuiManager->EndTooltip();
+	}
+
+	imGuiManager->Separator();
+
 	if (imGuiManager->Button("Start simulation")) {
 		executionStarted = true;
-		timeStart = std::chrono::system_clock::now();
+		if (Config::terrainAmplitude > 0) {
+			heightfield = make_unique<EHeightfield>(terrain[0].get());
+			if (Config::terrainImage.empty() || !heightfield->LoadImage(Config::terrainImage, Config::terrainAmplitude))
+				heightfield->Generate(Config::terrainSeed, Config::terrainAmplitude);
+		}
 		geneticAlgorithm = make_unique<GeneticAlgorithm>();
 		skeletons = geneticAlgorithm->GetPopulation();
 		AddEntities();
+
+		std::vector<EMesh*> colliding;
+		for (const auto& mesh : terrain)
+			colliding.push_back(mesh.get());
+		simulation = make_unique<SimulationThread>(geneticAlgorithm.get(), colliding, heightfield.get(), timeToStart.count());
+		simulation->Start();
 	}
 }
\ No newline at end of file
@@ -12,8 +12,10 @@ class ImGuiManager;
 class ECamera;
 class ESkeleton;
 class EMesh;
+class EHeightfield;
 class Entity;
 class GeneticAlgorithm;
+class SimulationThread;
 
 using namespace std::chrono_literals;
 
@@ -58,7 +60,8 @@ class StateExecution : public State {
 		/// <summary>
 		/// Refactor imGui debug.
 		/// </summary>
-		void ImGuiDebug();
+		/// <param name="locked"> If the simulation is locked and the entities can be edited. </param>
+		void ImGuiDebug(bool locked);
 
 		/// <summary>
 		/// Shows configaration window, refactor method.
@@ -100,11 +103,21 @@ class StateExecution : public State {
 		/// </summary>
 		std::vector<std::unique_ptr<EMesh>> terrain;
 
+		/// <summary>
+		/// Heightfield over the field, nullptr with a flat field.
+		/// </summary>
+		std::unique_ptr<EHeightfield> heightfield{ nullptr };
+
 		/// <summary>
 		/// Boolean to activate the bounding boxes render.
 		/// </summary>
 		bool showBoundingBoxes = false;
 
+		/// <summary>
+		/// Boolean to activate the frustum culling.
+		/// </summary>
+		bool frustumCulling = true;
+
 		/// <summary>
 		/// Only target render.
 		/// </summary>
@@ -116,13 +129,23 @@ class StateExecution : public State {
 		std::chrono::milliseconds timeToStart = 3 * 1000ms;
 
 		/// <summary>
-		/// Clock.
+		/// Simulated seconds every second, 0 simulates as fast as possible.
 		/// </summary>
-		std::chrono::system_clock::time_point timeStart = std::chrono::system_clock::now();
+		float simulationSpeed = 1.0f;
+
+		/// <summary>
+		/// If the gravity is applied.
+		/// </summary>
+		bool gravityActivated = true;
 
 		/// <summary>
 		/// If the execution has started.
 		/// </summary>
 		bool executionStarted = false;
 
+		/// <summary>
+		/// Simulation thread, the last member so it stops before the rest are destroyed.
+		/// </summary>
+		std::unique_ptr<SimulationThread> simulation{ nullptr };
+
 };
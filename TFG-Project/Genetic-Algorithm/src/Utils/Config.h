@@ -3,6 +3,8 @@
 #include <GLM/vec3.hpp>
 
 #include <chrono>
+#include <utility>
+#include <string>
 
 using namespace std::chrono_literals;
 
@@ -23,6 +25,77 @@ class Config {
 		/// </summary>
 		enum CrossoverType {HEURISTIC, ARITHMETIC, AVERAGE, ONEPOINT};
 
+		/// <summary>
+		/// Enumeration of the physics models.
+		/// </summary>
+		enum PhysicsBackendType {KINEMATIC, ARTICULATED};
+
+		/// <summary>
+		/// Enumeration of the kinematic joints integration, a fixed step or from boundary to boundary.
+		/// </summary>
+		enum JointIntegration {FIXED, EVENT};
+
+		/// <summary>
+		/// Enumeration of the gait extrapolation modes.
+		/// ON stops simulating the skeletons with a stable cycle, VERIFY keeps simulating them to measure the extrapolation error.
+		/// </summary>
+		enum GaitExtrapolation {OFF, ON, VERIFY};
+
+		/// <summary>
+		/// Enumeration of the feasibility screen modes.
+		/// FLAG only counts the skeletons whose joints must kill them, REJECT kills them before the simulation.
+		/// </summary>
+		enum FeasibilityScreen {NONE, FLAG, REJECT};
+
+		/// <summary>
+		/// Enumeration of the aggregations of the fitness over the environments.
+		/// </summary>
+		enum EnvironmentFitness {MEAN, MIN, QUANTILE};
+
+		/// <summary>
+		/// Copy of the configuration values used by one genetic algorithm.
+		/// Allows to run multiple genetic algorithms with different configurations at the same time.
+		/// </summary>
+		struct Parameters {
+			int populationSize;
+			glm::vec3 flexibilityProbability;
+			int maxGenerations;
+			float newGenProbability;
+			float mutationProbability;
+			SelectionFunction selectionFunction;
+			CrossoverType crossoverType;
+			int tournamentMembers;
+			std::pair<glm::vec3, glm::vec3> rotationVelocityBoundaries;
+			int generationLifeSpan;
+			int heuristicTries;
+			float terrainAmplitude;
+			unsigned int terrainSeed;
+			std::string terrainImage;
+			PhysicsBackendType physicsBackend;
+			JointIntegration jointIntegration;
+			int physicsStepFrames;
+			GaitExtrapolation gaitExtrapolation;
+			FeasibilityScreen feasibilityScreen;
+			int environments;
+			EnvironmentFitness environmentFitness;
+			float environmentQuantile;
+			float environmentSlope;
+			float environmentGravity;
+			float environmentPhase;
+		};
+
+		/// <summary>
+		/// Returns the actual configuration values.
+		/// </summary>
+		/// <returns> Actual configuration values. </returns>
+		static Parameters GetParameters() {
+			return Parameters{ populationSize, flexibilityProbability, maxGenerations, newGenProbability, mutationProbability
+				, selectionFunction, crossoverType, tournamentMembers, rotationVelocityBoundaries, generationLifeSpan, heuristicTries
+				, terrainAmplitude, terrainSeed, terrainImage, physicsBackend
+				, jointIntegration, physicsStepFrames, gaitExtrapolation, feasibilityScreen
+				, environments, environmentFitness, environmentQuantile, environmentSlope, environmentGravity, environmentPhase };
+		}
+
 		/// <summary>
 		/// Population size.
 		/// </summary>
@@ -79,4 +152,78 @@ class Config {
 		/// Number of tries before assing the worse parent value.
 		/// </summary>
 		inline static int heuristicTries = 50;
+
+		/// <summary>
+		/// Maximum height of the heightfield terrain, 0 for a flat field.
+		/// </summary>
+		inline static float terrainAmplitude = 0.0f;
+
+		/// <summary>
+		/// Seed of the generated heightfield terrain.
+		/// </summary>
+		inline static unsigned int terrainSeed = 1;
+
+		/// <summary>
+		/// Grayscale image of the heightfield terrain, empty to generate it from the seed.
+		/// </summary>
+		inline static std::string terrainImage = "";
+
+		/// <summary>
+		/// Physics model of the skeletons.
+		/// </summary>
+		inline static PhysicsBackendType physicsBackend = PhysicsBackendType::KINEMATIC;
+
+		/// <summary>
+		/// Integration of the kinematic joints.
+		/// </summary>
+		inline static JointIntegration jointIntegration = JointIntegration::FIXED;
+
+		/// <summary>
+		/// Frames advanced by every physics update without render.
+		/// More than 1 should be used with the event joint integration, which does not depend on the time step.
+		/// </summary>
+		inline static int physicsStepFrames = 1;
+
+		/// <summary>
+		/// Extrapolation of the skeletons that walk in a stable cycle, only without render.
+		/// Only used with the kinematic model on a flat field and one frame physics steps.
+		/// </summary>
+		inline static GaitExtrapolation gaitExtrapolation = GaitExtrapolation::OFF;
+
+		/// <summary>
+		/// Screen of the skeletons whose joint rotations reach a death rule during the generation, only without render.
+		/// Only used with the kinematic model, fixed joint integration and one frame physics steps.
+		/// </summary>
+		inline static FeasibilityScreen feasibilityScreen = FeasibilityScreen::NONE;
+
+		/// <summary>
+		/// Environments where every skeleton is evaluated, only without render.
+		/// The first one is the nominal field and the rest spread the terrain seed, slope, gravity and initial phase up to their maximum.
+		/// </summary>
+		inline static int environments = 1;
+
+		/// <summary>
+		/// Aggregation of the fitness of every skeleton over the environments.
+		/// </summary>
+		inline static EnvironmentFitness environmentFitness = EnvironmentFitness::MEAN;
+
+		/// <summary>
+		/// Quantile of the fitness over the environments with the quantile aggregation, 0 is the minimum.
+		/// </summary>
+		inline static float environmentQuantile = 0.25f;
+
+		/// <summary>
+		/// Maximum slope of the field along the walking direction in degrees.
+		/// </summary>
+		inline static float environmentSlope = 0.0f;
+
+		/// <summary>
+		/// Maximum gravity variation relative to the nominal one, 0.2 goes up to 1.2 times the gravity.
+		/// </summary>
+		inline static float environmentGravity = 0.0f;
+
+		/// <summary>
+		/// Maximum initial phase of the joints in seconds, the joints are advanced that time before the generation starts.
+		/// </summary>
+		inline static float environmentPhase = 0.0f;
 };
\ No newline at end of file
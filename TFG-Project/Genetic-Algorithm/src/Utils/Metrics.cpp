@@ -0,0 +1,283 @@
+#include "Metrics.h"
+
+#include <Utils/MetricsServer.h>
+
+#include <IMGUI/imgui.h>
+#include <CSV/csv2.hpp>
+
+#include <cfloat>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#ifdef _WIN32
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+	#include <windows.h>
+	#include <psapi.h>
+	#pragma comment(lib, "psapi.lib")
+#else
+	#include <unistd.h>
+#endif
+
+/// <summary>
+/// Creates or returns a Metrics instance.
+/// Must be created from the main thread before starting other threads.
+/// </summary>
+/// <returns> Static Metrics instance pointer. </returns>
+Metrics* Metrics::GetInstance() {
+	if (!instance) {
+		instance = new Metrics();
+	}
+	return instance;
+}
+
+/// <summary>
+/// Private constructor.
+/// </summary>
+Metrics::Metrics() {
+	start = std::chrono::steady_clock::now();
+	lastSampleTime = start;
+	lastDumpTime = start;
+}
+
+/// <summary>
+/// Metrics destructor.
+/// </summary>
+Metrics::~Metrics() {
+
+}
+
+/// <summary>
+/// Adds simulated frames and the skeletons evaluated on them.
+/// </summary>
+/// <param name="ticks"> Simulated frames. </param>
+/// <param name="evaluations"> Skeleton updates. </param>
+void Metrics::AddTicks(uint64_t ticks, uint64_t evaluations) {
+	this->ticks.fetch_add(ticks, std::memory_order_relaxed);
+	this->evaluations.fetch_add(evaluations, std::memory_order_relaxed);
+}
+
+/// <summary>
+/// Adds a finished generation.
+/// </summary>
+/// <param name="generationSeconds"> Wall time of the generation. </param>
+/// <param name="breedingSeconds"> Time creating the new generation. </param>
+void Metrics::AddGeneration(double generationSeconds, double breedingSeconds) {
+	std::lock_guard<std::mutex> lock(mutex);
+	this->generationSeconds += generationSeconds;
+	this->breedingSeconds += breedingSeconds;
+	sampleGenerations++;
+	generations++;
+}
+
+/// <summary>
+/// Adds the time of a rendered frame.
+/// </summary>
+/// <param name="renderSeconds"> Render time. </param>
+void Metrics::AddRenderTime(double renderSeconds) {
+	std::lock_guard<std::mutex> lock(mutex);
+	this->renderSeconds += renderSeconds;
+	renderFrames++;
+}
+
+/// <summary>
+/// Calculates the rates since the last sample and dumps them when needed.
+/// Does nothing until the sample interval has passed, so it can be called every frame.
+/// </summary>
+void Metrics::Update() {
+	auto now = std::chrono::steady_clock::now();
+	if (now - lastSampleTime < sampleInterval)
+		return;
+
+	double elapsed = std::chrono::duration<double>(now - lastSampleTime).count();
+	uint64_t currentTicks = ticks.load(std::memory_order_relaxed);
+	uint64_t currentEvaluations = evaluations.load(std::memory_order_relaxed);
+	double memory = GetMemoryUsage();
+
+	Sample sample;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		sample.seconds = std::chrono::duration<double>(now - start).count();
+		sample.ticksPerSecond = (currentTicks - lastTicks) / elapsed;
+		sample.evaluationsPerSecond = (currentEvaluations - lastEvaluations) / elapsed;
+		sample.ticks = currentTicks;
+		sample.evaluations = currentEvaluations;
+		sample.generations = generations;
+		sample.memoryMegabytes = memory;
+
+		// Generations last longer than a sample, the last values are kept until another one finishes.
+		if (sampleGenerations > 0) {
+			sample.generationSeconds = generationSeconds / sampleGenerations;
+			sample.breedingMilliseconds = breedingSeconds * 1000.0 / sampleGenerations;
+		}
+		else {
+			sample.generationSeconds = lastSample.generationSeconds;
+			sample.breedingMilliseconds = lastSample.breedingMilliseconds;
+		}
+		sample.renderMilliseconds = (renderFrames > 0) ? renderSeconds * 1000.0 / renderFrames : 0.0;
+
+		generationSeconds = 0.0;
+		breedingSeconds = 0.0;
+		sampleGenerations = 0;
+		renderSeconds = 0.0;
+		renderFrames = 0;
+
+		lastSample = sample;
+		history.push_back(sample);
+		if (history.size() > historySize)
+			history.pop_front();
+	}
+
+	lastTicks = currentTicks;
+	lastEvaluations = currentEvaluations;
+	lastSampleTime = now;
+
+	if (!dumpPath.empty() && now - lastDumpTime >= std::chrono::seconds(dumpInterval)) {
+		Dump(sample);
+		lastDumpTime = now;
+	}
+}
+
+/// <summary>
+/// Appends every sample to a csv file.
+/// </summary>
+/// <param name="path"> Path of the csv file. </param>
+/// <param name="interval"> Seconds between dumps. </param>
+void Metrics::SetDumpFile(const std::string& path, int interval) {
+	dumpPath = path;
+	dumpInterval = interval;
+
+	auto folder = std::filesystem::path(path).parent_path();
+	if (!folder.empty())
+		std::filesystem::create_directories(folder);
+
+	std::ofstream stream(dumpPath);
+	csv2::Writer<csv2::delimiter<','>> writer(stream);
+	writer.write_row(std::vector<std::string>{ "Seconds", "Ticks per second", "Evaluations per second", "Generation time (sec)", "Breeding time (ms)"
+		, "Render time (ms)", "Memory (MB)", "Ticks", "Evaluations", "Generations" });
+}
+
+/// <summary>
+/// Serves the last sample in Prometheus text format at http://localhost:port/metrics.
+/// </summary>
+/// <param name="port"> Local port. </param>
+/// <returns> If the server has started. </returns>
+bool Metrics::StartServer(int port) {
+	server = std::make_unique<MetricsServer>([this]() { return GetPrometheusText(); });
+	if (!server->Start(port)) {
+		server.reset();
+		return false;
+	}
+
+	std::cout << "Metrics available at http://localhost:" << port << "/metrics" << std::endl;
+	return true;
+}
+
+/// <summary>
+/// Returns the last sample in Prometheus text format.
+/// </summary>
+/// <returns> Metrics text. </returns>
+std::string Metrics::GetPrometheusText() const {
+	Sample sample = GetLastSample();
+	std::ostringstream text;
+
+	auto metric = [&text](const std::string& name, const std::string& type, const std::string& help, double value) {
+		text << "# HELP " << name << " " << help << "\n";
+		text << "# TYPE " << name << " " << type << "\n";
+		text << name << " " << value << "\n";
+	};
+
+	metric("ga_ticks_total", "counter", "Simulated frames.", static_cast<double>(sample.ticks));
+	metric("ga_evaluations_total", "counter", "Skeleton updates.", static_cast<double>(sample.evaluations));
+	metric("ga_generations_total", "counter", "Finished generations.", static_cast<double>(sample.generations));
+	metric("ga_ticks_per_second", "gauge", "Simulated frames per second.", sample.ticksPerSecond);
+	metric("ga_evaluations_per_second", "gauge", "Skeleton updates per second.", sample.evaluationsPerSecond);
+	metric("ga_generation_seconds", "gauge", "Wall time of the last generations.", sample.generationSeconds);
+	metric("ga_breeding_milliseconds", "gauge", "Time creating the last generations.", sample.breedingMilliseconds);
+	metric("ga_render_milliseconds", "gauge", "Render time per frame.", sample.renderMilliseconds);
+	metric("ga_memory_megabytes", "gauge", "Resident memory of the process.", sample.memoryMegabytes);
+
+	return text.str();
+}
+
+/// <summary>
+/// Returns the last sample.
+/// </summary>
+/// <returns> Last sample. </returns>
+Metrics::Sample Metrics::GetLastSample() const {
+	std::lock_guard<std::mutex> lock(mutex);
+	return lastSample;
+}
+
+/// <summary>
+/// Shows the metrics panel.
+/// </summary>
+void Metrics::ShowWindow() {
+	std::vector<float> ticksPerSecond;
+	std::vector<float> evaluationsPerSecond;
+	Sample sample;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		sample = lastSample;
+		for (const auto& historySample : history) {
+			ticksPerSecond.push_back(static_cast<float>(historySample.ticksPerSecond));
+			evaluationsPerSecond.push_back(static_cast<float>(historySample.evaluationsPerSecond));
+		}
+	}
+
+	ImGui::Begin("Metrics");
+	ImGui::Text("Ticks/s: %.1f", sample.ticksPerSecond);
+	ImGui::PlotLines("##Ticks", ticksPerSecond.data(), static_cast<int>(ticksPerSecond.size()), 0, nullptr, 0.0f, FLT_MAX, ImVec2(0, 40));
+	ImGui::Text("Evaluations/s: %.1f", sample.evaluationsPerSecond);
+	ImGui::PlotLines("##Evaluations", evaluationsPerSecond.data(), static_cast<int>(evaluationsPerSecond.size()), 0, nullptr, 0.0f, FLT_MAX, ImVec2(0, 40));
+	ImGui::Separator();
+	ImGui::Text("Generation time: %.2f s", sample.generationSeconds);
+	ImGui::Text("Breeding time: %.3f ms", sample.breedingMilliseconds);
+	ImGui::Text("Render time: %.3f ms", sample.renderMilliseconds);
+	ImGui::Text("Memory: %.1f MB", sample.memoryMegabytes);
+	ImGui::Separator();
+	ImGui::Text("Ticks: %llu", static_cast<unsigned long long>(sample.ticks));
+	ImGui::Text("Evaluations: %llu", static_cast<unsigned long long>(sample.evaluations));
+	ImGui::Text("Generations: %llu", static_cast<unsigned long long>(sample.generations));
+	ImGui::End();
+}
+
+/// <summary>
+/// Appends a sample to the dump file.
+/// </summary>
+/// <param name="sample"> Sample to write. </param>
+void Metrics::Dump(const Sample& sample) {
+	std::ofstream stream(dumpPath, std::ios::app);
+	if (!stream.is_open()) {
+		std::cout << "Metrics: could not open " << dumpPath << std::endl;
+		return;
+	}
+
+	csv2::Writer<csv2::delimiter<','>> writer(stream);
+	writer.write_row(std::vector<std::string>{ std::to_string(sample.seconds), std::to_string(sample.ticksPerSecond), std::to_string(sample.evaluationsPerSecond)
+		, std::to_string(sample.generationSeconds), std::to_string(sample.breedingMilliseconds), std::to_string(sample.renderMilliseconds)
+		, std::to_string(sample.memoryMegabytes), std::to_string(sample.ticks), std::to_string(sample.evaluations), std::to_string(sample.generations) });
+}
+
+/// <summary>
+/// Returns the memory used by the process.
+/// </summary>
+/// <returns> Resident memory in megabytes. </returns>
+double Metrics::GetMemoryUsage() {
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS counters;
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+		return counters.WorkingSetSize / (1024.0 * 1024.0);
+	return 0.0;
+#else
+	std::ifstream statm("/proc/self/statm");
+	long size = 0;
+	long resident = 0;
+	if (statm >> size >> resident)
+		return resident * static_cast<double>(sysconf(_SC_PAGESIZE)) / (1024.0 * 1024.0);
+	return 0.0;
+#endif
+}
@@ -0,0 +1,231 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+
+class MetricsServer;
+
+/// <summary>
+/// Throughput metrics of the simulations, shared by the interactive and the batch mode.
+/// The counters can be increased from any thread, Update must be called periodically from one thread.
+/// </summary>
+class Metrics {
+	public:
+		/// <summary>
+		/// Values of one sample.
+		/// </summary>
+		struct Sample {
+			double seconds = 0.0;
+			double ticksPerSecond = 0.0;
+			double evaluationsPerSecond = 0.0;
+			double generationSeconds = 0.0;
+			double breedingMilliseconds = 0.0;
+			double renderMilliseconds = 0.0;
+			double memoryMegabytes = 0.0;
+			uint64_t ticks = 0;
+			uint64_t evaluations = 0;
+			uint64_t generations = 0;
+		};
+
+		/// <summary>
+		/// Creates or returns a Metrics instance.
+		/// Must be created from the main thread before starting other threads.
+		/// </summary>
+		/// <returns> Static Metrics instance pointer. </returns>
+		static Metrics* GetInstance();
+
+		/// <summary>
+		/// Metrics destructor.
+		/// </summary>
+		~Metrics();
+
+		/// <summary>
+		/// Adds simulated frames and the skeletons evaluated on them.
+		/// </summary>
+		/// <param name="ticks"> Simulated frames. </param>
+		/// <param name="evaluations"> Skeleton updates. </param>
+		void AddTicks(uint64_t ticks, uint64_t evaluations);
+
+		/// <summary>
+		/// Adds a finished generation.
+		/// </summary>
+		/// <param name="generationSeconds"> Wall time of the generation. </param>
+		/// <param name="breedingSeconds"> Time creating the new generation. </param>
+		void AddGeneration(double generationSeconds, double breedingSeconds);
+
+		/// <summary>
+		/// Adds the time of a rendered frame.
+		/// </summary>
+		/// <param name="renderSeconds"> Render time. </param>
+		void AddRenderTime(double renderSeconds);
+
+		/// <summary>
+		/// Calculates the rates since the last sample and dumps them when needed.
+		/// Does nothing until the sample interval has passed, so it can be called every frame.
+		/// </summary>
+		void Update();
+
+		/// <summary>
+		/// Appends every sample to a csv file.
+		/// </summary>
+		/// <param name="path"> Path of the csv file. </param>
+		/// <param name="interval"> Seconds between dumps. </param>
+		void SetDumpFile(const std::string& path, int interval);
+
+		/// <summary>
+		/// Serves the last sample in Prometheus text format at http://localhost:port/metrics.
+		/// </summary>
+		/// <param name="port"> Local port. </param>
+		/// <returns> If the server has started. </returns>
+		bool StartServer(int port);
+
+		/// <summary>
+		/// Returns the last sample in Prometheus text format.
+		/// </summary>
+		/// <returns> Metrics text. </returns>
+		std::string GetPrometheusText() const;
+
+		/// <summary>
+		/// Returns the last sample.
+		/// </summary>
+		/// <returns> Last sample. </returns>
+		Sample GetLastSample() const;
+
+		/// <summary>
+		/// Shows the metrics panel.
+		/// </summary>
+		void ShowWindow();
+
+	private:
+		/// <summary>
+		/// Private constructor.
+		/// </summary>
+		Metrics();
+
+		/// <summary>
+		/// Appends a sample to the dump file.
+		/// </summary>
+		/// <param name="sample"> Sample to write. </param>
+		void Dump(const Sample& sample);
+
+		/// <summary>
+		/// Returns the memory used by the process.
+		/// </summary>
+		/// <returns> Resident memory in megabytes. </returns>
+		static double GetMemoryUsage();
+
+		/// <summary>
+		/// Static metrics instance.
+		/// </summary>
+		inline static Metrics* instance{ nullptr };
+
+		/// <summary>
+		/// Simulated frames.
+		/// </summary>
+		std::atomic<uint64_t> ticks{ 0 };
+
+		/// <summary>
+		/// Skeleton updates.
+		/// </summary>
+		std::atomic<uint64_t> evaluations{ 0 };
+
+		/// <summary>
+		/// Finished generations.
+		/// </summary>
+		std::atomic<uint64_t> generations{ 0 };
+
+		/// <summary>
+		/// Wall time of the generations finished since the last sample.
+		/// </summary>
+		double generationSeconds = 0.0;
+
+		/// <summary>
+		/// Breeding time of the generations finished since the last sample.
+		/// </summary>
+		double breedingSeconds = 0.0;
+
+		/// <summary>
+		/// Generations finished since the last sample.
+		/// </summary>
+		uint64_t sampleGenerations = 0;
+
+		/// <summary>
+		/// Render time of the frames since the last sample.
+		/// </summary>
+		double renderSeconds = 0.0;
+
+		/// <summary>
+		/// Frames rendered since the last sample.
+		/// </summary>
+		uint64_t renderFrames = 0;
+
+		/// <summary>
+		/// Mutex for the times and the samples.
+		/// </summary>
+		mutable std::mutex mutex;
+
+		/// <summary>
+		/// Last sample.
+		/// </summary>
+		Sample lastSample;
+
+		/// <summary>
+		/// Last samples for the panel plots.
+		/// </summary>
+		std::deque<Sample> history;
+
+		/// <summary>
+		/// Maximum samples kept for the plots.
+		/// </summary>
+		const size_t historySize = 120;
+
+		/// <summary>
+		/// Time between samples.
+		/// </summary>
+		const std::chrono::milliseconds sampleInterval{ 1000 };
+
+		/// <summary>
+		/// Time point where the metrics were created.
+		/// </summary>
+		std::chrono::steady_clock::time_point start;
+
+		/// <summary>
+		/// Time point of the last sample.
+		/// </summary>
+		std::chrono::steady_clock::time_point lastSampleTime;
+
+		/// <summary>
+		/// Ticks when the last sample was taken.
+		/// </summary>
+		uint64_t lastTicks = 0;
+
+		/// <summary>
+		/// Evaluations when the last sample was taken.
+		/// </summary>
+		uint64_t lastEvaluations = 0;
+
+		/// <summary>
+		/// Path of the dump file, empty when disabled.
+		/// </summary>
+		std::string dumpPath;
+
+		/// <summary>
+		/// Seconds between dumps.
+		/// </summary>
+		int dumpInterval = 5;
+
+		/// <summary>
+		/// Time point of the last dump.
+		/// </summary>
+		std::chrono::steady_clock::time_point lastDumpTime;
+
+		/// <summary>
+		/// Prometheus text endpoint.
+		/// </summary>
+		std::unique_ptr<MetricsServer> server{ nullptr };
+};
@@ -0,0 +1,154 @@
+#include "MetricsServer.h"
+
+#include <iostream>
+
+#ifdef _WIN32
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+	#include <winsock2.h>
+	#include <ws2tcpip.h>
+	#pragma comment(lib, "Ws2_32.lib")
+	using Socket = SOCKET;
+	#define CloseSocket closesocket
+	#define SendFlags 0
+#else
+	#include <sys/socket.h>
+	#include <sys/select.h>
+	#include <netinet/in.h>
+	#include <arpa/inet.h>
+	#include <unistd.h>
+	using Socket = int;
+	#define INVALID_SOCKET -1
+	#define CloseSocket close
+	// Writing to a client that has closed returns an error instead of raising SIGPIPE.
+	#ifdef MSG_NOSIGNAL
+		#define SendFlags MSG_NOSIGNAL
+	#else
+		#define SendFlags 0
+	#endif
+#endif
+
+/// <summary>
+/// MetricsServer constructor.
+/// </summary>
+/// <param name="getText"> Returns the body of every response. </param>
+MetricsServer::MetricsServer(std::function<std::string()> getText) : getText(getText) {
+
+}
+
+/// <summary>
+/// MetricsServer destructor, stops the server.
+/// </summary>
+MetricsServer::~MetricsServer() {
+	Stop();
+}
+
+/// <summary>
+/// Starts listening on 127.0.0.1.
+/// </summary>
+/// <param name="port"> Local port. </param>
+/// <returns> If the socket is listening. </returns>
+bool MetricsServer::Start(int port) {
+#ifdef _WIN32
+	WSADATA wsaData;
+	if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
+		std::cout << "Metrics server: could not initialize Winsock" << std::endl;
+		return false;
+	}
+#endif
+
+	Socket listener = socket(AF_INET, SOCK_STREAM, 0);
+	if (listener == INVALID_SOCKET) {
+		std::cout << "Metrics server: could not create the socket" << std::endl;
+		return false;
+	}
+
+	int reuse = 1;
+	setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+
+	// Only reachable from this machine.
+	sockaddr_in address{};
+	address.sin_family = AF_INET;
+	address.sin_port = htons(static_cast<uint16_t>(port));
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+	if (bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(listener, 4) != 0) {
+		std::cout << "Metrics server: could not listen on port " << port << std::endl;
+		CloseSocket(listener);
+		return false;
+	}
+
+	listenSocket = static_cast<intptr_t>(listener);
+	running = true;
+	thread = std::thread(&MetricsServer::Listen, this);
+	return true;
+}
+
+/// <summary>
+/// Stops the server and waits for its thread.
+/// </summary>
+void MetricsServer::Stop() {
+	if (!running)
+		return;
+
+	running = false;
+	if (thread.joinable())
+		thread.join();
+
+	CloseSocket(static_cast<Socket>(listenSocket));
+	listenSocket = -1;
+#ifdef _WIN32
+	WSACleanup();
+#endif
+}
+
+/// <summary>
+/// Accepts connections until the server is stopped.
+/// </summary>
+void MetricsServer::Listen() {
+	Socket listener = static_cast<Socket>(listenSocket);
+
+	while (running) {
+		// Waits with a timeout so the server can be stopped.
+		fd_set sockets;
+		FD_ZERO(&sockets);
+		FD_SET(listener, &sockets);
+		timeval timeout{ 0, 200000 };
+		if (select(static_cast<int>(listener) + 1, &sockets, nullptr, nullptr, &timeout) <= 0)
+			continue;
+
+		Socket client = accept(listener, nullptr, nullptr);
+		if (client == INVALID_SOCKET)
+			continue;
+
+		// A client that does not send its request or read the response can not keep the server from stopping.
+#ifdef _WIN32
+		DWORD clientTimeout = 200;
+#else
+		timeval clientTimeout{ 0, 200000 };
+#endif
+		setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char*>(&clientTimeout), sizeof(clientTimeout));
+		setsockopt(client, SOL_SOCKET, SO_SNDTIMEO, reinterpret_cast<const char*>(&clientTimeout), sizeof(clientTimeout));
+#ifdef SO_NOSIGPIPE
+		int noSignal = 1;
+		setsockopt(client, SOL_SOCKET, SO_NOSIGPIPE, &noSignal, sizeof(noSignal));
+#endif
+
+		// The request is read but ignored, every path returns the metrics.
+		char request[1024];
+		recv(client, request, sizeof(request), 0);
+
+		std::string body = getText();
+		std::string response = "HTTP/1.1 200 OK\r\n"
+			"Content-Type: text/plain; version=0.0.4\r\n"
+			"Content-Length: " + std::to_string(body.size()) + "\r\n"
+			"Connection: close\r\n\r\n" + body;
+		for (size_t sent = 0; sent < response.size() && running;) {
+			auto bytes = send(client, response.c_str() + sent, static_cast<int>(response.size() - sent), SendFlags);
+			if (bytes <= 0)
+				break;
+			sent += static_cast<size_t>(bytes);
+		}
+		CloseSocket(client);
+	}
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <thread>
+
+/// <summary>
+/// Minimal HTTP server on localhost answering every request with a text body.
+/// Used to expose the metrics to a Prometheus scraper.
+/// </summary>
+class MetricsServer {
+	public:
+		/// <summary>
+		/// MetricsServer constructor.
+		/// </summary>
+		/// <param name="getText"> Returns the body of every response. </param>
+		explicit MetricsServer(std::function<std::string()> getText);
+
+		/// <summary>
+		/// MetricsServer destructor, stops the server.
+		/// </summary>
+		~MetricsServer();
+
+		/// <summary>
+		/// Starts listening on 127.0.0.1.
+		/// </summary>
+		/// <param name="port"> Local port. </param>
+		/// <returns> If the socket is listening. </returns>
+		bool Start(int port);
+
+		/// <summary>
+		/// Stops the server and waits for its thread.
+		/// </summary>
+		void Stop();
+
+	private:
+		/// <summary>
+		/// Accepts connections until the server is stopped.
+		/// </summary>
+		void Listen();
+
+		/// <summary>
+		/// Returns the body of every response.
+		/// </summary>
+		std::function<std::string()> getText;
+
+		/// <summary>
+		/// Listening socket.
+		/// </summary>
+		intptr_t listenSocket = -1;
+
+		/// <summary>
+		/// If the server is running.
+		/// </summary>
+		std::atomic<bool> running{ false };
+
+		/// <summary>
+		/// Thread accepting the connections.
+		/// </summary>
+		std::thread thread;
+};
@@ -0,0 +1,397 @@
+#include "Profiler.h"
+
+#include <IMGUI/imgui.h>
+// The headless build (HEADLESS defined) has no render engine to hook.
+#ifndef HEADLESS
+	#include <CLProfiler.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <new>
+#include <string_view>
+
+#ifdef PROFILER_ENABLED
+// Global allocation hooks, every allocation is counted in the zones of its thread.
+void* operator new(std::size_t size) {
+	Profiler::CountAllocation();
+	if (void* pointer = std::malloc(size ? size : 1))
+		return pointer;
+	throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+	Profiler::CountAllocation();
+	if (void* pointer = std::malloc(size ? size : 1))
+		return pointer;
+	throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+	Profiler::CountAllocation();
+	return std::malloc(size ? size : 1);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+	Profiler::CountAllocation();
+	return std::malloc(size ? size : 1);
+}
+
+void operator delete(void* pointer) noexcept { std::free(pointer); }
+void operator delete[](void* pointer) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::size_t) noexcept { std::free(pointer); }
+void operator delete[](void* pointer, std::size_t) noexcept { std::free(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { std::free(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { std::free(pointer); }
+#endif
+
+/// <summary>
+/// Creates or returns a Profiler instance.
+/// Must be created from the main thread before starting other threads.
+/// </summary>
+/// <returns> Static Profiler instance pointer. </returns>
+Profiler* Profiler::GetInstance() {
+	if (!instance) {
+		instance = new Profiler();
+	}
+	return instance;
+}
+
+/// <summary>
+/// Private constructor.
+/// </summary>
+Profiler::Profiler() {
+	epoch = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+
+#ifndef HEADLESS
+	// The render engine zones are recorded in the same buffers.
+	CLE::CLProfiler::SetCallbacks(&Profiler::BeginZone, &Profiler::EndZone);
+#endif
+}
+
+/// <summary>
+/// Profiler destructor.
+/// </summary>
+Profiler::~Profiler() {
+
+}
+
+/// <summary>
+/// Opens a zone in the calling thread.
+/// </summary>
+/// <param name="name"> Zone name, must be a string literal. </param>
+void Profiler::BeginZone(const char* name) {
+	ThreadBuffer* buffer = threadBuffer ? threadBuffer : GetInstance()->GetThreadBuffer();
+
+	// Too deep zones are ignored but still counted to keep the stack balanced.
+	if (buffer->depth < std::size(buffer->openZones)) {
+		Zone& zone = buffer->openZones[buffer->depth];
+		zone.name = name;
+		zone.depth = buffer->depth;
+		zone.allocations = static_cast<uint32_t>(allocations);
+		zone.start = instance->Now();
+	}
+	++buffer->depth;
+}
+
+/// <summary>
+/// Closes the last zone opened in the calling thread.
+/// </summary>
+void Profiler::EndZone() {
+	ThreadBuffer* buffer = threadBuffer;
+	if (!buffer || buffer->depth == 0)
+		return;
+
+	--buffer->depth;
+	if (buffer->depth >= std::size(buffer->openZones) || !instance->capturing.load(std::memory_order_relaxed))
+		return;
+
+	Zone zone = buffer->openZones[buffer->depth];
+	zone.end = instance->Now();
+	zone.allocations = static_cast<uint32_t>(allocations) - zone.allocations;
+
+	// Only this thread writes the buffer, the count is published after the zone is stored.
+	// The readers check the count again after copying, so a slot overwritten during a copy is dropped.
+	uint64_t count = buffer->count.load(std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	buffer->zones[count % bufferCapacity] = zone;
+	buffer->count.store(count + 1, std::memory_order_release);
+}
+
+/// <summary>
+/// Counts an allocation of the calling thread.
+/// </summary>
+void Profiler::CountAllocation() {
+	++allocations;
+}
+
+/// <summary>
+/// Marks the end of a frame of the calling thread, the zones of its last frame can be shown in the flame view.
+/// </summary>
+void Profiler::FrameMark() {
+	ThreadBuffer* buffer = GetThreadBuffer();
+	int64_t now = Now();
+	uint64_t count = buffer->count.load(std::memory_order_relaxed);
+
+	// Only the bounds are published, the flame view copies the zones from the ring buffer.
+	{
+		std::lock_guard<std::mutex> lock(buffer->frameMutex);
+		buffer->marksFrames = true;
+		buffer->lastFrameBeginCount = buffer->frameBeginCount;
+		buffer->lastFrameEndCount = count;
+		buffer->lastFrameStart = buffer->frameBeginTime;
+		buffer->lastFrameEnd = now;
+	}
+
+	buffer->frameBeginCount = count;
+	buffer->frameBeginTime = now;
+}
+
+/// <summary>
+/// Sets the name of the calling thread in the trace.
+/// </summary>
+/// <param name="name"> Thread name. </param>
+void Profiler::SetThreadName(const std::string& name) {
+	ThreadBuffer* buffer = GetThreadBuffer();
+	std::lock_guard<std::mutex> lock(buffersMutex);
+	buffer->name = name;
+}
+
+/// <summary>
+/// Exports the recorded zones of every thread to a Chrome trace json (chrome://tracing or Perfetto).
+/// The other threads can keep recording, every buffer is copied before writing the file.
+/// </summary>
+/// <param name="path"> Path of the json file. </param>
+/// <returns> If the file has been written. </returns>
+bool Profiler::ExportChromeTrace(const std::string& path) const {
+	std::ofstream stream(path);
+	if (!stream.is_open()) {
+		std::cout << "Profiler: could not open " << path << std::endl;
+		return false;
+	}
+
+	auto escape = [](const std::string& text) {
+		std::string escaped;
+		for (char c : text) {
+			if (c == '"' || c == '\\')
+				escaped += '\\';
+			escaped += c;
+		}
+		return escaped;
+	};
+
+	// The zones are copied first without stopping the recording threads, the file is written afterwards.
+	struct ThreadZones {
+		uint32_t threadId = 0;
+		std::string name;
+		std::vector<Zone> zones;
+	};
+	std::vector<ThreadZones> threads;
+	{
+		std::lock_guard<std::mutex> lock(buffersMutex);
+		for (const auto& buffer : buffers) {
+			auto& thread = threads.emplace_back();
+			thread.threadId = buffer->threadId;
+			thread.name = buffer->name;
+			thread.zones = CopyZones(*buffer, 0, std::numeric_limits<uint64_t>::max());
+		}
+	}
+
+	stream << std::fixed << std::setprecision(3);
+	stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+	bool first = true;
+	for (const auto& thread : threads) {
+		stream << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << thread.threadId
+			<< ",\"args\":{\"name\":\"" << escape(thread.name) << "\"}}";
+		first = false;
+
+		for (const auto& zone : thread.zones) {
+			stream << ",\n{\"name\":\"" << escape(zone.name) << "\",\"cat\":\"zone\",\"ph\":\"X\",\"pid\":1,\"tid\":" << thread.threadId
+				<< ",\"ts\":" << zone.start / 1000.0 << ",\"dur\":" << (zone.end - zone.start) / 1000.0
+				<< ",\"args\":{\"allocations\":" << zone.allocations << "}}";
+		}
+	}
+	stream << "\n]}\n";
+
+	std::cout << "Profiler: trace exported to " << path << std::endl;
+	return true;
+}
+
+/// <summary>
+/// Shows the flame view of the last frame and the zones summary.
+/// </summary>
+void Profiler::ShowWindow() {
+	ImGui::Begin("Profiler");
+
+	bool capture = capturing;
+	if (ImGui::Checkbox("Capture", &capture))
+		capturing = capture;
+	ImGui::SameLine();
+	ImGui::Checkbox("Freeze frame", &freezeFrame);
+	ImGui::SameLine();
+	if (ImGui::Button("Export Chrome trace")) {
+		ExportChromeTrace("Simulations/Trace" + std::to_string(std::time(nullptr)) + ".json");
+	}
+
+	// Only the threads that mark frames can be shown, their last frame is copied from the ring buffer.
+	{
+		std::lock_guard<std::mutex> lock(buffersMutex);
+		std::string preview = (frameThread < buffers.size()) ? buffers[frameThread]->name : "";
+		if (ImGui::BeginCombo("Thread", preview.c_str())) {
+			for (const auto& buffer : buffers) {
+				bool marksFrames = false;
+				{
+					std::lock_guard<std::mutex> frameLock(buffer->frameMutex);
+					marksFrames = buffer->marksFrames;
+				}
+				if (marksFrames && ImGui::Selectable(buffer->name.c_str(), buffer->threadId == frameThread))
+					frameThread = buffer->threadId;
+			}
+			ImGui::EndCombo();
+		}
+
+		if (!freezeFrame && frameThread < buffers.size()) {
+			auto& buffer = *buffers[frameThread];
+			uint64_t first = 0, last = 0;
+			{
+				std::lock_guard<std::mutex> frameLock(buffer.frameMutex);
+				first = buffer.lastFrameBeginCount;
+				last = buffer.lastFrameEndCount;
+				lastFrameStart = buffer.lastFrameStart;
+				lastFrameEnd = buffer.lastFrameEnd;
+			}
+			lastFrame = CopyZones(buffer, first, last);
+		}
+	}
+
+	double frameTime = (lastFrameEnd - lastFrameStart) / 1000000.0;
+	ImGui::Text("Frame: %.3f ms, %d zones", frameTime, static_cast<int>(lastFrame.size()));
+
+	// Flame view, the x axis is the frame time and the y axis the zone depth.
+	uint32_t maxDepth = 0;
+	for (const auto& zone : lastFrame)
+		maxDepth = std::max(maxDepth, zone.depth);
+
+	const float rowHeight = ImGui::GetTextLineHeightWithSpacing();
+	ImVec2 origin = ImGui::GetCursorScreenPos();
+	ImVec2 size(std::max(ImGui::GetContentRegionAvail().x, 100.0f), rowHeight * (maxDepth + 1));
+	ImGui::InvisibleButton("Flame view", size);
+	bool hovered = ImGui::IsItemHovered();
+	ImVec2 mouse = ImGui::GetIO().MousePos;
+
+	ImDrawList* drawList = ImGui::GetWindowDrawList();
+	float scale = lastFrameEnd > lastFrameStart ? size.x / static_cast<float>(lastFrameEnd - lastFrameStart) : 0.0f;
+	for (const auto& zone : lastFrame) {
+		ImVec2 min(origin.x + (zone.start - lastFrameStart) * scale, origin.y + zone.depth * rowHeight);
+		ImVec2 max(origin.x + (zone.end - lastFrameStart) * scale, min.y + rowHeight - 1.0f);
+		min.x = std::max(min.x, origin.x);
+		max.x = std::max(max.x, min.x + 1.0f);
+
+		// Same color for the same zone name.
+		size_t hash = std::hash<std::string_view>()(zone.name);
+		ImU32 color = IM_COL32(100 + hash % 120, 100 + (hash >> 8) % 120, 100 + (hash >> 16) % 120, 255);
+		drawList->AddRectFilled(min, max, color);
+		drawList->PushClipRect(min, max, true);
+		drawList->AddText(ImVec2(min.x + 2.0f, min.y), IM_COL32(0, 0, 0, 255), zone.name);
+		drawList->PopClipRect();
+
+		if (hovered && mouse.x >= min.x && mouse.x < max.x && mouse.y >= min.y && mouse.y < max.y) {
+			ImGui::SetTooltip("%s\n%.3f ms\n%u allocations", zone.name, (zone.end - zone.start) / 1000000.0, zone.allocations);
+		}
+	}
+
+	// Summary of the frame grouped by zone name.
+	struct ZoneSummary {
+		int calls = 0;
+		double milliseconds = 0.0;
+		uint64_t allocations = 0;
+	};
+	std::map<std::string, ZoneSummary> summary;
+	for (const auto& zone : lastFrame) {
+		auto& zoneSummary = summary[zone.name];
+		zoneSummary.calls++;
+		zoneSummary.milliseconds += (zone.end - zone.start) / 1000000.0;
+		zoneSummary.allocations += zone.allocations;
+	}
+
+	ImGui::Separator();
+	ImGui::Columns(4, "Zones summary");
+	ImGui::Text("Zone"); ImGui::NextColumn();
+	ImGui::Text("Calls"); ImGui::NextColumn();
+	ImGui::Text("Time (ms)"); ImGui::NextColumn();
+	ImGui::Text("Allocations"); ImGui::NextColumn();
+	ImGui::Separator();
+	for (const auto& [name, zoneSummary] : summary) {
+		ImGui::Text("%s", name.c_str()); ImGui::NextColumn();
+		ImGui::Text("%d", zoneSummary.calls); ImGui::NextColumn();
+		ImGui::Text("%.3f", zoneSummary.milliseconds); ImGui::NextColumn();
+		ImGui::Text("%llu", static_cast<unsigned long long>(zoneSummary.allocations)); ImGui::NextColumn();
+	}
+	ImGui::Columns(1);
+
+	ImGui::End();
+}
+
+/// <summary>
+/// Returns the buffer of the calling thread, creating it the first time.
+/// </summary>
+/// <returns> Thread buffer. </returns>
+Profiler::ThreadBuffer* Profiler::GetThreadBuffer() {
+	if (!threadBuffer) {
+		auto buffer = std::make_unique<ThreadBuffer>();
+		buffer->zones.resize(bufferCapacity);
+
+		std::lock_guard<std::mutex> lock(buffersMutex);
+		buffer->threadId = static_cast<uint32_t>(buffers.size());
+		buffer->name = "Thread " + std::to_string(buffer->threadId);
+		threadBuffer = buffer.get();
+		buffers.push_back(std::move(buffer));
+	}
+	return threadBuffer;
+}
+
+/// <summary>
+/// Copies the zones of a buffer that can still be recording.
+/// The count is read again after the copy and the zones overwritten meanwhile are dropped.
+/// </summary>
+/// <param name="buffer"> Thread buffer. </param>
+/// <param name="first"> First zone index. </param>
+/// <param name="last"> Zone index after the last one. </param>
+/// <returns> Zones still in the buffer after the copy. </returns>
+std::vector<Profiler::Zone> Profiler::CopyZones(const ThreadBuffer& buffer, uint64_t first, uint64_t last) {
+	uint64_t count = buffer.count.load(std::memory_order_acquire);
+	last = std::min(last, count);
+	first = std::max(first, count > bufferCapacity ? count - bufferCapacity : 0);
+
+	std::vector<Zone> zones;
+	if (first >= last)
+		return zones;
+	zones.reserve(last - first);
+	for (uint64_t i = first; i < last; ++i)
+		zones.push_back(buffer.zones[i % bufferCapacity]);
+
+	// The zone being written when the count was read again takes the slot of the zone bufferCapacity before it.
+	std::atomic_thread_fence(std::memory_order_acquire);
+	uint64_t recorded = buffer.count.load(std::memory_order_relaxed);
+	uint64_t valid = recorded >= bufferCapacity ? recorded - bufferCapacity + 1 : 0;
+	if (valid > first)
+		zones.erase(zones.begin(), zones.begin() + static_cast<ptrdiff_t>(std::min(valid, last) - first));
+
+	return zones;
+}
+
+/// <summary>
+/// Returns the nanoseconds since the profiler was created.
+/// </summary>
+/// <returns> Nanoseconds. </returns>
+int64_t Profiler::Now() const {
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count() - epoch;
+}
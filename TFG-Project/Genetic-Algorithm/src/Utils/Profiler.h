@@ -0,0 +1,244 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// The profiler is only compiled with PROFILER_ENABLED defined, without it every macro is empty.
+#ifdef PROFILER_ENABLED
+	#define PROFILER_CONCAT_IMPL(a, b) a##b
+	#define PROFILER_CONCAT(a, b) PROFILER_CONCAT_IMPL(a, b)
+	#define PROFILE_ZONE(name) Profiler::ScopedZone PROFILER_CONCAT(profilerZone, __LINE__)(name)
+	#define PROFILE_FUNCTION() PROFILE_ZONE(__FUNCTION__)
+	#define PROFILE_FRAME() Profiler::GetInstance()->FrameMark()
+	#define PROFILE_THREAD(name) Profiler::GetInstance()->SetThreadName(name)
+#else
+	#define PROFILE_ZONE(name)
+	#define PROFILE_FUNCTION()
+	#define PROFILE_FRAME()
+	#define PROFILE_THREAD(name)
+#endif
+
+/// <summary>
+/// Scoped zones profiler.
+/// Every thread records its zones in its own ring buffer without locks, the zone names must be string literals.
+/// The other threads copy the zones while they are recorded and drop the ones overwritten during the copy.
+/// Zones also count the allocations done inside them (operator new is replaced while the profiler is enabled).
+/// </summary>
+class Profiler {
+	public:
+		/// <summary>
+		/// Zone recorded by a thread.
+		/// </summary>
+		struct Zone {
+			const char* name = nullptr;
+			int64_t start = 0;
+			int64_t end = 0;
+			uint32_t depth = 0;
+			uint32_t allocations = 0;
+		};
+
+		/// <summary>
+		/// Records a zone from its construction to its destruction.
+		/// </summary>
+		class ScopedZone {
+			public:
+				/// <summary>
+				/// Starts the zone.
+				/// </summary>
+				/// <param name="name"> Zone name, must be a string literal. </param>
+				explicit ScopedZone(const char* name) { Profiler::BeginZone(name); }
+
+				/// <summary>
+				/// Ends the zone.
+				/// </summary>
+				~ScopedZone() { Profiler::EndZone(); }
+
+				ScopedZone(const ScopedZone&) = delete;
+				ScopedZone& operator=(const ScopedZone&) = delete;
+		};
+
+		/// <summary>
+		/// Creates or returns a Profiler instance.
+		/// </summary>
+		/// <returns> Static Profiler instance pointer. </returns>
+		static Profiler* GetInstance();
+
+		/// <summary>
+		/// Profiler destructor.
+		/// </summary>
+		~Profiler();
+
+		/// <summary>
+		/// Opens a zone in the calling thread.
+		/// </summary>
+		/// <param name="name"> Zone name, must be a string literal. </param>
+		static void BeginZone(const char* name);
+
+		/// <summary>
+		/// Closes the last zone opened in the calling thread.
+		/// </summary>
+		static void EndZone();
+
+		/// <summary>
+		/// Counts an allocation of the calling thread.
+		/// </summary>
+		static void CountAllocation();
+
+		/// <summary>
+		/// Marks the end of a frame of the calling thread, the zones of its last frame can be shown in the flame view.
+		/// </summary>
+		void FrameMark();
+
+		/// <summary>
+		/// Sets the name of the calling thread in the trace.
+		/// </summary>
+		/// <param name="name"> Thread name. </param>
+		void SetThreadName(const std::string& name);
+
+		/// <summary>
+		/// Pauses or resumes the capture of zones.
+		/// </summary>
+		/// <param name="capture"> If the zones are recorded. </param>
+		void SetCapturing(bool capture) { capturing = capture; }
+
+		/// <summary>
+		/// Returns if the zones are being recorded.
+		/// </summary>
+		/// <returns> If the zones are recorded. </returns>
+		bool IsCapturing() const { return capturing; }
+
+		/// <summary>
+		/// Exports the recorded zones of every thread to a Chrome trace json (chrome://tracing or Perfetto).
+		/// The other threads can keep recording, every buffer is copied before writing the file.
+		/// </summary>
+		/// <param name="path"> Path of the json file. </param>
+		/// <returns> If the file has been written. </returns>
+		bool ExportChromeTrace(const std::string& path) const;
+
+		/// <summary>
+		/// Shows the flame view of the last frame and the zones summary.
+		/// </summary>
+		void ShowWindow();
+
+	private:
+		/// <summary>
+		/// Zones recorded by one thread.
+		/// Only its thread writes, the published count is read by the others.
+		/// The bounds of the last frame are published under the frame mutex, once per frame.
+		/// </summary>
+		struct ThreadBuffer {
+			std::vector<Zone> zones;
+			std::atomic<uint64_t> count{ 0 };
+			uint32_t threadId = 0;
+			std::string name;
+
+			Zone openZones[64];
+			uint32_t depth = 0;
+
+			uint64_t frameBeginCount = 0;
+			int64_t frameBeginTime = 0;
+
+			std::mutex frameMutex;
+			bool marksFrames = false;
+			uint64_t lastFrameBeginCount = 0;
+			uint64_t lastFrameEndCount = 0;
+			int64_t lastFrameStart = 0;
+			int64_t lastFrameEnd = 0;
+		};
+
+		/// <summary>
+		/// Private constructor.
+		/// </summary>
+		Profiler();
+
+		/// <summary>
+		/// Returns the buffer of the calling thread, creating it the first time.
+		/// </summary>
+		/// <returns> Thread buffer. </returns>
+		ThreadBuffer* GetThreadBuffer();
+
+		/// <summary>
+		/// Copies the zones of a buffer that can still be recording.
+		/// The count is read again after the copy and the zones overwritten meanwhile are dropped.
+		/// </summary>
+		/// <param name="buffer"> Thread buffer. </param>
+		/// <param name="first"> First zone index. </param>
+		/// <param name="last"> Zone index after the last one. </param>
+		/// <returns> Zones still in the buffer after the copy. </returns>
+		static std::vector<Zone> CopyZones(const ThreadBuffer& buffer, uint64_t first, uint64_t last);
+
+		/// <summary>
+		/// Returns the nanoseconds since the profiler was created.
+		/// </summary>
+		/// <returns> Nanoseconds. </returns>
+		int64_t Now() const;
+
+		/// <summary>
+		/// Static profiler instance.
+		/// </summary>
+		inline static Profiler* instance{ nullptr };
+
+		/// <summary>
+		/// Zones of every ring buffer.
+		/// </summary>
+		static constexpr size_t bufferCapacity = 1 << 16;
+
+		/// <summary>
+		/// Allocations of the calling thread.
+		/// </summary>
+		inline static thread_local uint64_t allocations = 0;
+
+		/// <summary>
+		/// Buffer of the calling thread.
+		/// </summary>
+		inline static thread_local ThreadBuffer* threadBuffer = nullptr;
+
+		/// <summary>
+		/// Buffers of every thread, they are kept after the thread ends to export them.
+		/// </summary>
+		std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+
+		/// <summary>
+		/// Mutex to register new threads.
+		/// </summary>
+		mutable std::mutex buffersMutex;
+
+		/// <summary>
+		/// If the zones are recorded.
+		/// </summary>
+		std::atomic<bool> capturing{ true };
+
+		/// <summary>
+		/// Thread whose last frame is shown in the flame view.
+		/// </summary>
+		uint32_t frameThread = 0;
+
+		/// <summary>
+		/// Zones of the last frame shown in the flame view.
+		/// </summary>
+		std::vector<Zone> lastFrame;
+
+		/// <summary>
+		/// Start of the last frame shown.
+		/// </summary>
+		int64_t lastFrameStart = 0;
+
+		/// <summary>
+		/// End of the last frame shown.
+		/// </summary>
+		int64_t lastFrameEnd = 0;
+
+		/// <summary>
+		/// Keeps showing the same frame in the flame view.
+		/// </summary>
+		bool freezeFrame = false;
+
+		/// <summary>
+		/// Time point where the profiler was created.
+		/// </summary>
+		int64_t epoch = 0;
+};
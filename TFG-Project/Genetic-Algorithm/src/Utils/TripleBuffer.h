@@ -0,0 +1,75 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+
+/// <summary>
+/// Passes the last value written by one thread to another one without locks.
+/// The writer always owns a buffer to fill and the reader a buffer to read, the third one holds the last published value.
+/// The writer never waits and the reader always takes the newest complete value, the values in between are dropped.
+/// </summary>
+template <typename T>
+class TripleBuffer {
+	public:
+		/// <summary>
+		/// Returns the buffer owned by the writer, it keeps an old value and has to be filled completely.
+		/// </summary>
+		/// <returns> Write buffer. </returns>
+		T& GetWriteBuffer() { return buffers[writeIndex]; }
+
+		/// <summary>
+		/// Publishes the write buffer, the writer takes the previous middle buffer.
+		/// </summary>
+		void Publish() {
+			writeIndex = middle.exchange(writeIndex | freshBit, std::memory_order_acq_rel) & indexMask;
+		}
+
+		/// <summary>
+		/// Takes the last published value if there is a new one.
+		/// </summary>
+		/// <returns> If the read buffer has changed. </returns>
+		bool Update() {
+			if (!(middle.load(std::memory_order_acquire) & freshBit))
+				return false;
+
+			readIndex = middle.exchange(readIndex, std::memory_order_acq_rel) & indexMask;
+			return true;
+		}
+
+		/// <summary>
+		/// Returns the buffer owned by the reader.
+		/// </summary>
+		/// <returns> Read buffer. </returns>
+		const T& GetReadBuffer() const { return buffers[readIndex]; }
+
+	private:
+		/// <summary>
+		/// Flag of the middle index when it has not been read yet.
+		/// </summary>
+		static constexpr int freshBit = 4;
+
+		/// <summary>
+		/// Mask of the buffer index.
+		/// </summary>
+		static constexpr int indexMask = 3;
+
+		/// <summary>
+		/// Buffers.
+		/// </summary>
+		std::array<T, 3> buffers;
+
+		/// <summary>
+		/// Buffer of the writer.
+		/// </summary>
+		int writeIndex = 0;
+
+		/// <summary>
+		/// Buffer of the reader.
+		/// </summary>
+		int readIndex = 1;
+
+		/// <summary>
+		/// Last published buffer and if it is new.
+		/// </summary>
+		std::atomic<int> middle{ 2 };
+};
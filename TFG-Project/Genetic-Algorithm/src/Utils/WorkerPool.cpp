@@ -0,0 +1,112 @@
+#include "WorkerPool.h"
+
+#include <algorithm>
+
+/// <summary>
+/// WorkerPool constructor.
+/// </summary>
+/// <param name="threads"> Threads running the tasks, including the one that starts them. </param>
+WorkerPool::WorkerPool(unsigned int threads) {
+	for (unsigned int i = 1; i < threads; ++i)
+		workers.emplace_back(&WorkerPool::Work, this);
+}
+
+/// <summary>
+/// WorkerPool destructor, waits for the batch running and stops the threads.
+/// </summary>
+WorkerPool::~WorkerPool() {
+	Wait();
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stop = true;
+	}
+	batchStarted.notify_all();
+	for (auto& worker : workers)
+		worker.join();
+}
+
+/// <summary>
+/// Starts running the tasks on the pool threads and returns without waiting for them.
+/// </summary>
+/// <param name="tasks"> Number of tasks. </param>
+/// <param name="task"> Function called once with every task index. </param>
+void WorkerPool::Start(size_t tasks, std::function<void(size_t)> task) {
+	Wait();
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		this->task = std::move(task);
+		this->tasks = tasks;
+		nextTask = 0;
+		running = true;
+
+		// Without pool threads everything runs on the waiting thread, a single task still goes to a pool thread
+		// so it runs at the same time as the work the caller does before waiting.
+		if (workers.empty() || tasks == 0)
+			return;
+		busyWorkers = workers.size();
+		batch++;
+	}
+	batchStarted.notify_all();
+}
+
+/// <summary>
+/// Runs the tasks left on this thread and waits for the pool threads to finish the batch.
+/// </summary>
+void WorkerPool::Wait() {
+	if (!running)
+		return;
+
+	RunTasks();
+	std::unique_lock<std::mutex> lock(mutex);
+	batchFinished.wait(lock, [this]() { return busyWorkers == 0; });
+	task = nullptr;
+	running = false;
+}
+
+/// <summary>
+/// Runs the tasks on the pool threads and this thread and waits for all of them.
+/// </summary>
+/// <param name="tasks"> Number of tasks. </param>
+/// <param name="task"> Function called once with every task index. </param>
+void WorkerPool::Run(size_t tasks, std::function<void(size_t)> task) {
+	Start(tasks, std::move(task));
+	Wait();
+}
+
+/// <summary>
+/// Returns the threads running the tasks, including the one that starts them.
+/// </summary>
+/// <returns> Threads. </returns>
+unsigned int WorkerPool::GetThreads() const {
+	return static_cast<unsigned int>(workers.size()) + 1;
+}
+
+/// <summary>
+/// Loop of the pool threads, waits for a batch and takes its tasks.
+/// </summary>
+void WorkerPool::Work() {
+	uint64_t lastBatch = 0;
+	while (true) {
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			batchStarted.wait(lock, [&]() { return stop || batch != lastBatch; });
+			if (stop)
+				return;
+			lastBatch = batch;
+		}
+
+		RunTasks();
+
+		std::lock_guard<std::mutex> lock(mutex);
+		if (--busyWorkers == 0)
+			batchFinished.notify_one();
+	}
+}
+
+/// <summary>
+/// Takes tasks of the batch until there are no more.
+/// </summary>
+void WorkerPool::RunTasks() {
+	for (size_t i = nextTask++; i < tasks; i = nextTask++)
+		task(i);
+}
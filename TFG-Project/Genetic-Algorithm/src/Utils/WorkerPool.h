@@ -0,0 +1,119 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// <summary>
+/// Threads created once and reused for every batch of tasks.
+/// The thread that starts a batch also takes tasks while it waits, so the pool has one thread less than its size.
+/// Only one thread can start batches.
+/// </summary>
+class WorkerPool {
+	public:
+		/// <summary>
+		/// WorkerPool constructor.
+		/// </summary>
+		/// <param name="threads"> Threads running the tasks, including the one that starts them. </param>
+		WorkerPool(unsigned int threads);
+
+		/// <summary>
+		/// WorkerPool destructor, waits for the batch running and stops the threads.
+		/// </summary>
+		~WorkerPool();
+
+		/// <summary>
+		/// Starts running the tasks on the pool threads and returns without waiting for them.
+		/// </summary>
+		/// <param name="tasks"> Number of tasks. </param>
+		/// <param name="task"> Function called once with every task index. </param>
+		void Start(size_t tasks, std::function<void(size_t)> task);
+
+		/// <summary>
+		/// Runs the tasks left on this thread and waits for the pool threads to finish the batch.
+		/// </summary>
+		void Wait();
+
+		/// <summary>
+		/// Runs the tasks on the pool threads and this thread and waits for all of them.
+		/// </summary>
+		/// <param name="tasks"> Number of tasks. </param>
+		/// <param name="task"> Function called once with every task index. </param>
+		void Run(size_t tasks, std::function<void(size_t)> task);
+
+		/// <summary>
+		/// Returns the threads running the tasks, including the one that starts them.
+		/// </summary>
+		/// <returns> Threads. </returns>
+		unsigned int GetThreads() const;
+
+	private:
+		/// <summary>
+		/// Loop of the pool threads, waits for a batch and takes its tasks.
+		/// </summary>
+		void Work();
+
+		/// <summary>
+		/// Takes tasks of the batch until there are no more.
+		/// </summary>
+		void RunTasks();
+
+		/// <summary>
+		/// Pool threads.
+		/// </summary>
+		std::vector<std::thread> workers;
+
+		/// <summary>
+		/// Protects the batch and the finished threads.
+		/// </summary>
+		std::mutex mutex;
+
+		/// <summary>
+		/// Wakes the pool threads when a batch starts or the pool stops.
+		/// </summary>
+		std::condition_variable batchStarted;
+
+		/// <summary>
+		/// Wakes the waiting thread when the last pool thread finishes the batch.
+		/// </summary>
+		std::condition_variable batchFinished;
+
+		/// <summary>
+		/// Task function of the batch.
+		/// </summary>
+		std::function<void(size_t)> task;
+
+		/// <summary>
+		/// Number of tasks of the batch.
+		/// </summary>
+		size_t tasks = 0;
+
+		/// <summary>
+		/// Next task to take.
+		/// </summary>
+		std::atomic<size_t> nextTask{ 0 };
+
+		/// <summary>
+		/// Pool threads still running the batch.
+		/// </summary>
+		size_t busyWorkers = 0;
+
+		/// <summary>
+		/// Batches started, the pool threads compare it with the last one they ran.
+		/// </summary>
+		uint64_t batch = 0;
+
+		/// <summary>
+		/// The batch started has not been waited yet.
+		/// </summary>
+		bool running = false;
+
+		/// <summary>
+		/// The pool threads have to finish.
+		/// </summary>
+		bool stop = false;
+};
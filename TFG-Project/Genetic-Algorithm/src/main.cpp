@@ -1,11 +1,101 @@
 #include <iostream>
+#include <string>
+#include <thread>
 
 #include <Program.h>
+#include <Batch/BatchRunner.h>
+#include <Analysis/CSVAggregator.h>
+#include <Utils/Profiler.h>
+#include <Utils/Metrics.h>
+#include <Utils/Config.h>
+
+int main(int argc, char* argv[]) {
+	PROFILE_THREAD("Main thread");
+
+	// Metrics options shared by the batch and the render mode: [--metrics file] [--metrics-port port]
+	auto metricsOption = [](const std::string& option, const std::string& value) {
+		if (option == "--metrics") {
+			Metrics::GetInstance()->SetDumpFile(value, 5);
+			return true;
+		}
+		if (option == "--metrics-port") {
+			Metrics::GetInstance()->StartServer(std::stoi(value));
+			return true;
+		}
+		return false;
+	};
+
+	// Batch mode without render: Genetic-Algorithm --batch <sweep file> [--threads N] [--output folder]
+	if (argc > 2 && std::string(argv[1]) == "--batch") {
+		std::string outputFolder = "Simulations/Batch";
+		unsigned int threads = std::thread::hardware_concurrency();
+
+		for (int i = 3; i + 1 < argc; i += 2) {
+			std::string option(argv[i]);
+			if (option == "--threads") {
+				threads = std::stoi(argv[i + 1]);
+			}
+			else if (option == "--output") {
+				outputFolder = argv[i + 1];
+			}
+			else if (!metricsOption(option, argv[i + 1])) {
+				std::cout << "Unknown option " << option << std::endl;
+				return EXIT_FAILURE;
+			}
+		}
+
+		BatchRunner batchRunner(outputFolder, threads);
+		if (!batchRunner.LoadSweep(argv[2])) {
+			return EXIT_FAILURE;
+		}
+		batchRunner.Run();
+
+		return EXIT_SUCCESS;
+	}
+
+	// Aggregation of exported simulations: Genetic-Algorithm --aggregate <folder> [--threads N] [--output folder]
+	if (argc > 2 && std::string(argv[1]) == "--aggregate") {
+		std::string outputFolder = std::string(argv[2]) + "/Aggregate";
+		unsigned int threads = std::thread::hardware_concurrency();
+
+		for (int i = 3; i + 1 < argc; i += 2) {
+			std::string option(argv[i]);
+			if (option == "--threads") {
+				threads = std::stoi(argv[i + 1]);
+			}
+			else if (option == "--output") {
+				outputFolder = argv[i + 1];
+			}
+			else {
+				std::cout << "Unknown option " << option << std::endl;
+				return EXIT_FAILURE;
+			}
+		}
+
+		CSVAggregator aggregator(outputFolder, threads);
+		if (!aggregator.LoadFolder(argv[2])) {
+			return EXIT_FAILURE;
+		}
+		aggregator.Run();
+
+		return EXIT_SUCCESS;
+	}
+
+	// Render mode options: [--terrain-image image] and the metrics options.
+	for (int i = 1; i + 1 < argc; i += 2) {
+		if (std::string(argv[i]) == "--terrain-image") {
+			Config::terrainImage = argv[i + 1];
+			continue;
+		}
+		if (!metricsOption(argv[i], argv[i + 1])) {
+			std::cout << "Unknown option " << argv[i] << std::endl;
+			return EXIT_FAILURE;
+		}
+	}
 
-int main() {
 	Program* program = Program::GetInstance();
 	program->SetState(State::States::EXECUTION);
 	program->Start();
 
 	return EXIT_SUCCESS;
-}
\ No newline at end of file
+}
@@ -4,7 +4,19 @@ out vec4 FragColor;
 in vec2 TexCoords; //Coordenadas de textura
 in vec3 Normal;    //La normal ya reajustada con escalado
 in vec3 FragPos;   //Posicion
-uniform vec3 viewPos;     //Posición de la camara
+//Datos de la camara y de las sombras, compartidos por todos los shaders (binding 0, CLEngine::CameraBlock)
+#define MAX_CASCADES 4
+layout (std140, binding = 0) uniform Camera {
+    mat4 view;
+    mat4 projection;
+    mat4 VPMatrix;
+    vec3 viewPos;       //Posición de la camara
+    bool activeShadows;
+    vec3 lightShadowDir;
+    int numCascades;
+    mat4 lightSpaceMatrices[MAX_CASCADES];
+    vec4 cascadeFar;    //Distancia a la camara donde acaba cada cascada
+};
 
 
 
@@ -11,10 +11,22 @@ out vec3 FragPos;
 uniform mat4 transform;
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
 uniform mat4 MVP;
 
+//Datos de la camara y de las sombras, compartidos por todos los shaders (binding 0, CLEngine::CameraBlock)
+#define MAX_CASCADES 4
+layout (std140, binding = 0) uniform Camera {
+    mat4 view;
+    mat4 projection;
+    mat4 VPMatrix;
+    vec3 viewPos;       //Posición de la camara
+    bool activeShadows;
+    vec3 lightShadowDir;
+    int numCascades;
+    mat4 lightSpaceMatrices[MAX_CASCADES];
+    vec4 cascadeFar;    //Distancia a la camara donde acaba cada cascada
+};
+
 
 // A = (0,0) kf1
 // A = (1,1)
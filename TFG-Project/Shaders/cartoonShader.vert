@@ -7,22 +7,31 @@ layout (location = 2) in vec2 aTexCoord;
 out vec2 TexCoords;
 out vec3 Normal;
 out vec3 FragPos;
-out vec4 FragPosLightSpace;
 
 uniform mat4 transform;
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
 uniform mat4 MVP;
-uniform mat4 lightSpaceMatrix;
+
+//Datos de la camara y de las sombras, compartidos por todos los shaders (binding 0, CLEngine::CameraBlock)
+#define MAX_CASCADES 4
+layout (std140, binding = 0) uniform Camera {
+    mat4 view;
+    mat4 projection;
+    mat4 VPMatrix;
+    vec3 viewPos;       //Posición de la camara
+    bool activeShadows;
+    vec3 lightShadowDir;
+    int numCascades;
+    mat4 lightSpaceMatrices[MAX_CASCADES];
+    vec4 cascadeFar;    //Distancia a la camara donde acaba cada cascada
+};
 
 void main()
 {
     //gl_Position = projection * view * model * vec4(aPos, 1.0);
     gl_Position = MVP * vec4(aPos,1.0);
     FragPos = vec3(model * vec4(aPos,1.0));
-    FragPosLightSpace = lightSpaceMatrix * vec4(FragPos, 1.0);
 
     // Hacemos esto para ajustar las normales en caso de escalar las mallas
     //Source: http://www.lighthouse3d.com/tutorials/glsl-12-tutorial/the-normal-matrix/
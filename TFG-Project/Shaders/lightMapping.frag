@@ -5,14 +5,24 @@ out vec4 FragColor;
 in vec2 TexCoords; //Coordenadas de textura
 in vec3 Normal;    //La normal ya reajustada con escalado
 in vec3 FragPos;   //Posicion
-uniform vec3 viewPos;     //Posición de la camara
 
 //uniform samplerCube depthMap;
 //uniform float far_plane;
-uniform bool activeShadows;
-uniform vec3 lightShadowDir;
-uniform sampler2D depthMap;
-in vec4 FragPosLightSpace;
+uniform sampler2DArray depthMap; //Una capa por cascada
+
+//Datos de la camara y de las sombras, compartidos por todos los shaders (binding 0, CLEngine::CameraBlock)
+#define MAX_CASCADES 4
+layout (std140, binding = 0) uniform Camera {
+    mat4 view;
+    mat4 projection;
+    mat4 VPMatrix;
+    vec3 viewPos;       //Posición de la camara
+    bool activeShadows;
+    vec3 lightShadowDir;
+    int numCascades;
+    mat4 lightSpaceMatrices[MAX_CASCADES];
+    vec4 cascadeFar;    //Distancia a la camara donde acaba cada cascada
+};
 
 struct Material {
     vec3 ambient;
@@ -24,21 +34,23 @@ struct Material {
 }; 
 uniform Material material;
 
-//Luces puntuales
+//Luces puntuales, compartidas por todos los shaders (binding 1, CLEngine::LightsBlock)
+//Los campos estan intercalados para que el struct ocupe 64 bytes en std140
 struct PointLight {
     vec3 position;
-  
-    vec3 ambient;
-    vec3 diffuse;
-    vec3 specular;
-  
     float constant;
+    vec3 ambient;
     float linear;
+    vec3 diffuse;
     float quadratic;
+    vec3 specular;
 };
-uniform int num_Point_Lights;
 #define NUM_POINT_LIGHTS 25
-uniform PointLight pointLights[NUM_POINT_LIGHTS]; 
+layout (std140, binding = 1) uniform Lights {
+    int num_Point_Lights;
+    int id_luz_shadowMapping; //El numero en el array  de luces puntuales para aplicar shadowmapping
+    PointLight pointLights[NUM_POINT_LIGHTS];
+};
 
 //Luces dirigidas
 struct DirectLight {
@@ -79,17 +91,27 @@ uniform SpotLight spotLights[NUM_SPOT_LIGHTS];
 uniform int cartoonParts = 8;
 //const float scaleFactor = 1.0 / cartoonParts;
 
-uniform int id_luz_shadowMapping; //El numero en el array  de luces puntuales para aplicar shadowmapping
 
 bool LUZ_ON = true;        //A 0 desactiva las luces
 
 float ShadowCalculation(){
+    // select the cascade by the distance to the camera, farther than the last one has no shadow
+    float depthValue = abs((view * vec4(FragPos, 1.0)).z);
+    int layer = -1;
+    for(int c = numCascades - 1; c >= 0; --c){
+        if(depthValue < cascadeFar[c])
+            layer = c;
+    }
+    if(layer < 0)
+        return 0.0;
+
+    vec4 fragPosLightSpace = lightSpaceMatrices[layer] * vec4(FragPos, 1.0);
     // perform perspective divide
-    vec3 projCoords = FragPosLightSpace.xyz / FragPosLightSpace.w;
+    vec3 projCoords = fragPosLightSpace.xyz / fragPosLightSpace.w;
     // transform to [0,1] range
     projCoords = projCoords * 0.5 + 0.5;
     // get closest depth value from light's perspective (using [0,1] range fragPosLight as coords)
-    /*float closestDepth = texture(depthMap, projCoords.xy).r;*/ 
+    /*float closestDepth = texture(depthMap, vec3(projCoords.xy, layer)).r;*/ 
     // get depth of current fragment from light's perspective
     float currentDepth = projCoords.z;
     // check whether current frag pos is in shadow
@@ -98,10 +120,10 @@ float ShadowCalculation(){
     /*float shadow = currentDepth - bias > closestDepth  ? 1.0 : 0.0;*/  
 
     float shadow = 0.0;
-    vec2 texelSize = 1.0 / textureSize(depthMap, 0);
+    vec2 texelSize = 1.0 / textureSize(depthMap, 0).xy;
     for(int x = -1; x <= 1; ++x){
         for(int y = -1; y <= 1; ++y){
-            float pcfDepth = texture(depthMap, projCoords.xy + vec2(x, y) * texelSize).r; 
+            float pcfDepth = texture(depthMap, vec3(projCoords.xy + vec2(x, y) * texelSize, layer)).r; 
             shadow += currentDepth - bias > pcfDepth ? 1.0 : 0.0;        
         }    
     }
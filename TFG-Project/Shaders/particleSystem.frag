@@ -1,7 +1,7 @@
 #version 450 core
 
 uniform sampler2D ourTexture;
-uniform float alpha;
+in float Alpha;
 in vec2 TexCoords;
 out vec4 FragColor;
 
@@ -18,8 +18,8 @@ void main()
     {
         discard;
     }else{
-        if(alpha<=1.0){
-            float trasp = max(FragColor.a - alpha,0.0);
+        if(Alpha<=1.0){
+            float trasp = max(FragColor.a - Alpha,0.0);
             FragColor.a = trasp;
         }
     }
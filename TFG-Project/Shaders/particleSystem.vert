@@ -1,9 +1,13 @@
 #version 450 core
 layout (location = 0) in vec3 aPos;
+layout (location = 1) in float aAlpha;
+
+out float vAlpha;
 
 void main()
 {
     gl_Position = vec4(aPos, 1.0);
+    vAlpha = aAlpha;
 }
 
 //http://ogldev.atspace.co.uk/www/tutorial27/tutorial27.html
\ No newline at end of file
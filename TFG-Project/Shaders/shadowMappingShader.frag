@@ -10,7 +10,6 @@ in vec3 FragPos;   //Posicion
 //uniform vec3 objectColor; //Color del objeto
 //uniform vec3 lightColor;  //Color de la luz
 uniform vec3 lightPos;    //Posición de la luz
-uniform vec3 viewPos;     //Posición de la camara
 
 uniform float attenuationValue; //Atenuación
 
@@ -26,24 +25,41 @@ struct Material {
     float shininess;
 }; 
 
+
+  
+uniform Material material;
+
+//Datos de la camara y de las sombras, compartidos por todos los shaders (binding 0, CLEngine::CameraBlock)
+#define MAX_CASCADES 4
+layout (std140, binding = 0) uniform Camera {
+    mat4 view;
+    mat4 projection;
+    mat4 VPMatrix;
+    vec3 viewPos;       //Posición de la camara
+    bool activeShadows;
+    vec3 lightShadowDir;
+    int numCascades;
+    mat4 lightSpaceMatrices[MAX_CASCADES];
+    vec4 cascadeFar;    //Distancia a la camara donde acaba cada cascada
+};
+
+//Luces puntuales, compartidas por todos los shaders (binding 1, CLEngine::LightsBlock)
+//Los campos estan intercalados para que el struct ocupe 64 bytes en std140
 struct PointLight {
     vec3 position;
-  
-    vec3 ambient;
-    vec3 diffuse;
-    vec3 specular;
-	
     float constant;
+    vec3 ambient;
     float linear;
+    vec3 diffuse;
     float quadratic;
+    vec3 specular;
 };
-
-  
-uniform Material material;
-
-uniform int num_Point_Lights;
 #define NUM_POINT_LIGHTS 25
-uniform PointLight pointLights[NUM_POINT_LIGHTS]; 
+layout (std140, binding = 1) uniform Lights {
+    int num_Point_Lights;
+    int id_luz_shadowMapping; //El numero en el array  de luces puntuales para aplicar shadowmapping
+    PointLight pointLights[NUM_POINT_LIGHTS];
+};
 //uniform sampler2D texture_diffuse1;
 
 
@@ -16,6 +16,10 @@
  
  
  #include "CLEngine.h"
+#include "CLProfiler.h"
+
+#include <algorithm>
+#include <cstddef>
 
 using namespace std;
 using namespace CLE;
@@ -50,12 +54,15 @@ CLEngine::CLEngine (const unsigned int w, const unsigned int h, const string tit
     shaders.emplace_back(resourceManager->GetResourceShader("../Shaders/lightMapping.vert", "../Shaders/lightMapping.frag")->GetProgramID());
     shaders.emplace_back(resourceManager->GetResourceShader("../Shaders/basicShader.vert", "../Shaders/basicShader.frag")->GetProgramID());
 
+    CreateUniformBuffers();
 }
 
 /**
  * Destruye la ventana de GLFW y libera la informacion.
  */
 CLEngine::~CLEngine() {
+    glDeleteBuffers(1, &cameraUBO);
+    glDeleteBuffers(1, &lightsUBO);
     glfwDestroyWindow(window);
     glfwTerminate();
     //cout << ">>>>> GLFW OFF" << endl;
@@ -146,17 +153,21 @@ void CLEngine::PollEvents(){
  * Limpia la pantalla pintandola de un color.
  */
 void CLEngine::BeginScene(){
+    // Las mallas que se han leido en segundo plano se suben al empezar el frame y se liberan los recursos que nadie usa
+    auto resourceManager = CLResourceManager::GetResourceManager();
+    resourceManager->ProcessUploads();
+    resourceManager->CollectReleased();
     glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 }
 
 
-void CLEngine::DrawDepthMap(const glm::mat4& lightSpaceMatrix){
+void CLEngine::DrawDepthMap(){
     //auto light = GetNodeByID(GetShadowMapping()->GetID());
 
     // 1. Se renderiza con el shadowMap
     glCullFace(GL_FRONT);
-    RenderDepthMap(*GetShadowMapping(), GetDepthShader(), lightSpaceMatrix);
+    RenderDepthMap(*GetShadowMapping(), GetDepthShader());
     glCullFace(GL_BACK);
 
     // 2. then render scene as normal with shadow mapping (using depth map)
@@ -166,22 +177,21 @@ void CLEngine::DrawDepthMap(const glm::mat4& lightSpaceMatrix){
 }
 
 void CLEngine::DrawObjects(){
-    glm::mat4 lightSpaceMatrix;
+    CLE_PROFILE_ZONE("CLEngine::DrawObjects");
+    // Una sola actualizacion de las transformaciones por frame, las dos pasadas las leen ya calculadas
+    smgr->UpdateTransforms();
+    // Las cascadas de las sombras se ajustan a la camara, asi que sus matrices se calculan antes de la pasada de profundidad
+    CalculateViewProjMatrix();
     if(shadowMapping && shadowsActivate){
-        auto light = GetNodeByID(GetShadowMapping()->GetID());
-        glm::mat4 lightProjection, lightView;
-        float near_plane = 1.0f, far_plane = 5000.0f;
-        lightProjection = glm::ortho(-float(1500), float(1500),  -float(1500), float(1500), near_plane, far_plane);
-        lightView = glm::lookAt(light->GetGlobalTranslation(), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0, 1.0, 0.0));
-        lightSpaceMatrix = lightProjection * lightView;
-        DrawDepthMap(lightSpaceMatrix);
+        CLE_PROFILE_ZONE("Depth pass");
+        DrawDepthMap();
     }
 
+    CLE_PROFILE_ZONE("Main pass");
     DrawSkybox();
-    CalculateViewProjMatrix(lightSpaceMatrix);
     CalculateLights();
     glm::mat4 VPmatrix = projection*view;
-    smgr->DFSTree(glm::mat4(1.0f),GetActiveCamera(), VPmatrix);
+    smgr->DFSTree(VPmatrix);
 }
 
 /**
@@ -269,16 +279,40 @@ void CLEngine::TerminateImGui(){
 ///  SOMBRAS
 /// --------------------------------
 
-// Renderiza el depth map
-void CLEngine::RenderDepthMap(CLShadowMapping& shadowMap, CLResourceShader* depthShader, const glm::mat4& lightSpaceMatrix){
-    glUseProgram(depthShader->GetProgramID());
+// Renderiza el depth map de cada cascada
+void CLEngine::RenderDepthMap(CLShadowMapping& shadowMap, CLResourceShader* depthShader){
+    GLuint depthProgram = depthShader->GetProgramID();
+    glUseProgram(depthProgram);
 
-    // renderizar escena para el depth cubemap
+    // renderizar escena para el depth map
     glViewport(0, 0, shadowMap.SHADOW_WIDTH,  shadowMap.SHADOW_HEIGHT);
-    glBindFramebuffer(GL_FRAMEBUFFER,  shadowMap.depthMapFBO);
-    glClear(GL_DEPTH_BUFFER_BIT);
+    smgr->ResetShadowStats();
+    if(CLNode::ConsumeStaticChanged()){
+        shadowMap.InvalidateStaticCache();
+    }
+
+    for(unsigned int i = 0; i < shadowMap.GetNumCascades(); ++i){
+        const glm::mat4& lightSpaceMatrix = shadowMap.GetLightSpaceMatrix(i);
+        if(!shadowMap.GetStaticCache()){
+            glBindFramebuffer(GL_FRAMEBUFFER, shadowMap.depthMapFBO[i]);
+            glClear(GL_DEPTH_BUFFER_BIT);
+            smgr->DFSTree(depthProgram, lightSpaceMatrix);
+            continue;
+        }
 
-    smgr->DFSTree(glm::mat4(1.0f), GetActiveCamera(), depthShader->GetProgramID(), lightSpaceMatrix);
+        // Los estaticos solo se vuelven a renderizar si han cambiado ellos o la matriz de la cascada
+        if(!shadowMap.IsStaticCacheValid(i)){
+            glBindFramebuffer(GL_FRAMEBUFFER, shadowMap.staticMapFBO[i]);
+            glClear(GL_DEPTH_BUFFER_BIT);
+            smgr->DFSTree(depthProgram, lightSpaceMatrix, STATIC_CASTERS);
+            shadowMap.ValidateStaticCache(i);
+        }
+
+        // La cache hace de clear, encima solo se dibujan los dinamicos
+        shadowMap.CopyStaticCache(i);
+        glBindFramebuffer(GL_FRAMEBUFFER, shadowMap.depthMapFBO[i]);
+        smgr->DFSTree(depthProgram, lightSpaceMatrix, DYNAMIC_CASTERS);
+    }
 
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
 }
@@ -462,7 +496,7 @@ void CLEngine::AddShadowMapping(GLuint lightId){
         shaders.push_back(simpleDepthShader);
         
     }
-    shadowMapping = make_unique<CLShadowMapping>(lightId);
+    shadowMapping = make_unique<CLShadowMapping>(lightId, shadowQuality);
 }
 
 CLNode* CLEngine::AddBillBoard(CLNode* parent,unsigned int id,string& file, bool vertically, float width_, float height_){
@@ -692,34 +726,52 @@ const void CLEngine::Draw3DLineLocal(CLNode* node, float x1, float y1, float z1,
 //
 //}
 
-// Mi idea ahora es pasarle todas las luces a todos los shaders que las vayan a usar
+// Todas las luces van en un solo bloque uniform que comparten todos los shaders
 void CLEngine::CalculateLights(){
-    GLuint i = 0;
-
-    for(auto shader : shaders){
-        glUseProgram(shader);
-        for(auto pointLight : pointLights){
-            auto pointLightEntity = static_cast<CLPointLight*>(pointLight->GetEntity());
-            
-            string number = to_string(i); 
-            //Tenemos que mirar que luz es la del shadowmapping
-            if(shadowMapping && pointLight->GetEntity()->GetID() == shadowMapping->GetID()){
-                glUniform1i(glGetUniformLocation(shader,"id_luz_shadowMapping"),i);    
-
-            }
-            glUniform1i(glGetUniformLocation(shader,"num_Point_Lights"),pointLights.size());    
-            glUniform3fv(glGetUniformLocation(shader, ("pointLights[" + number + "].position").c_str()),1,glm::value_ptr(pointLight->GetGlobalTranslation()));
-            glUniform3fv(glGetUniformLocation(shader, ("pointLights[" + number + "].ambient").c_str()), 1,glm::value_ptr(pointLightEntity->GetAmbient()));
-            glUniform3fv(glGetUniformLocation(shader, ("pointLights[" + number + "].diffuse").c_str()), 1, glm::value_ptr(pointLightEntity->GetDiffuse()));
-            glUniform3fv(glGetUniformLocation(shader, ("pointLights[" + number + "].specular").c_str()), 1, glm::value_ptr(pointLightEntity->GetSpecular()));
-            glUniform1f(glGetUniformLocation(shader, ("pointLights[" + number + "].constant").c_str()), pointLightEntity->GetConstant());
-            glUniform1f(glGetUniformLocation(shader, ("pointLights[" + number + "].linear").c_str()), pointLightEntity->GetLinear());
-            glUniform1f(glGetUniformLocation(shader, ("pointLights[" + number + "].quadratic").c_str()), pointLightEntity->GetQuadratic());
+    lightsBlock.numPointLights = std::min<size_t>(pointLights.size(), MAX_POINT_LIGHTS);
+    lightsBlock.shadowMappingLight = -1;
 
+    for(GLint i = 0; i < lightsBlock.numPointLights; ++i){
+        auto pointLight = pointLights[i];
+        auto pointLightEntity = static_cast<CLPointLight*>(pointLight->GetEntity());
 
-            i++;
+        //Tenemos que mirar que luz es la del shadowmapping
+        if(shadowMapping && pointLight->GetEntity()->GetID() == shadowMapping->GetID()){
+            lightsBlock.shadowMappingLight = i;
         }
+        auto& light     = lightsBlock.pointLights[i];
+        light.position  = pointLight->GetGlobalTranslation();
+        light.ambient   = pointLightEntity->GetAmbient();
+        light.diffuse   = pointLightEntity->GetDiffuse();
+        light.specular  = pointLightEntity->GetSpecular();
+        light.constant  = pointLightEntity->GetConstant();
+        light.linear    = pointLightEntity->GetLinear();
+        light.quadratic = pointLightEntity->GetQuadratic();
     }
+
+    // Solo se sube la parte del array con luces
+    glBindBuffer(GL_UNIFORM_BUFFER, lightsUBO);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, offsetof(LightsBlock, pointLights) + lightsBlock.numPointLights * sizeof(PointLightStd140), &lightsBlock);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+// Los bloques tienen binding fijo en los shaders, asi que basta con enlazar los buffers una vez
+void CLEngine::CreateUniformBuffers(){
+    static_assert(sizeof(CameraBlock) == 496, "CameraBlock no coincide con el layout std140 del bloque Camera");
+    static_assert(sizeof(PointLightStd140) == 64, "PointLightStd140 no coincide con el layout std140 de PointLight");
+    static_assert(offsetof(LightsBlock, pointLights) == 16, "LightsBlock no coincide con el layout std140 del bloque Lights");
+
+    glGenBuffers(1, &cameraUBO);
+    glBindBuffer(GL_UNIFORM_BUFFER, cameraUBO);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(CameraBlock), nullptr, GL_DYNAMIC_DRAW);
+    glBindBufferBase(GL_UNIFORM_BUFFER, CAMERA_BINDING, cameraUBO);
+
+    glGenBuffers(1, &lightsUBO);
+    glBindBuffer(GL_UNIFORM_BUFFER, lightsUBO);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(LightsBlock), nullptr, GL_DYNAMIC_DRAW);
+    glBindBufferBase(GL_UNIFORM_BUFFER, LIGHTS_BINDING, lightsUBO);
+
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
 }
 
 void CLEngine::RemoveLightsAndCameras() {
@@ -729,7 +781,7 @@ void CLEngine::RemoveLightsAndCameras() {
     skybox = nullptr;
 }
 
-void CLEngine::CalculateViewProjMatrix(const glm::mat4& lightSpaceMatrix){
+void CLEngine::CalculateViewProjMatrix(){
     auto cam = GetActiveCameraNode();
     auto entityCamera = GetActiveCamera();
 
@@ -742,18 +794,27 @@ void CLEngine::CalculateViewProjMatrix(const glm::mat4& lightSpaceMatrix){
     if(shadowMapping && shadowsActivate){
         auto light = GetNodeByID(GetShadowMapping()->GetID());
         directionShadowLight = glm::normalize(light->GetGlobalTranslation() - glm::vec3(0.0));
+        // La luz mira hacia el origen
+        shadowMapping->UpdateCascades(view, projection, entityCamera->GetNear(), entityCamera->GetFar(), -directionShadowLight);
     }
 
-    for(auto shader : shaders){
-        glUseProgram(shader);
-
-        glUniform3fv(glGetUniformLocation(shader,"viewPos"),1,glm::value_ptr(cam->GetGlobalTranslation()));
-        glUniformMatrix4fv(glGetUniformLocation(shader, "VPMatrix"), 1, GL_FALSE, glm::value_ptr(viewProjection));
-        glUniformMatrix4fv(glGetUniformLocation(shader, "view"), 1, GL_FALSE, glm::value_ptr(view));
-        glUniformMatrix4fv(glGetUniformLocation(shader, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
-        glUniform3fv(glGetUniformLocation(shader, "cameraPosition"), 1, glm::value_ptr(camPos));
-        glUniform1i(glGetUniformLocation(shader, "activeShadows"), shadowsActivate); 
-        glUniformMatrix4fv(glGetUniformLocation(shader, "lightSpaceMatrix"), 1, GL_FALSE, glm::value_ptr(lightSpaceMatrix));
-        glUniform3fv(glGetUniformLocation(shader, "lightShadowDir"), 1, glm::value_ptr(directionShadowLight));
+    CameraBlock cameraBlock {};
+    cameraBlock.view           = view;
+    cameraBlock.projection     = projection;
+    cameraBlock.viewProjection = viewProjection;
+    cameraBlock.viewPos        = camPos;
+    cameraBlock.activeShadows  = shadowsActivate;
+    cameraBlock.lightShadowDir = directionShadowLight;
+    if(shadowMapping && shadowsActivate){
+        cameraBlock.numCascades = shadowMapping->GetNumCascades();
+        for(unsigned int i = 0; i < shadowMapping->GetNumCascades(); ++i){
+            cameraBlock.lightSpaceMatrices[i] = shadowMapping->GetLightSpaceMatrix(i);
+            cameraBlock.cascadeFar[i]         = shadowMapping->GetCascadeFar(i);
+        }
     }
+
+    // Un solo update por frame para todos los shaders
+    glBindBuffer(GL_UNIFORM_BUFFER, cameraUBO);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(CameraBlock), &cameraBlock);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
 }
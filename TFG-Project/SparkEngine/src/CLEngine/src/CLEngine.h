@@ -100,9 +100,9 @@ class CLEngine {
 
         void PollEvents();
 
-        void DrawDepthMap(const glm::mat4& lightSpaceMatrix);
+        void DrawDepthMap();
 
-        void RenderDepthMap(CLShadowMapping& shadowMap, CLResourceShader* depthShader, const glm::mat4& lightSpaceMatrix);
+        void RenderDepthMap(CLShadowMapping& shadowMap, CLResourceShader* depthShader);
 
         void Clear();
 
@@ -394,6 +394,26 @@ class CLEngine {
         
         void SetShadowsActivate(bool mode) { shadowsActivate = mode; };
         
+        //! Cambia la calidad de las sombras, numero de cascadas y resolucion
+        //! @param quality Calidad de las sombras
+        void SetShadowQuality(CLShadowQuality quality) { shadowQuality = quality; if (shadowMapping) shadowMapping->SetQuality(quality); };
+        
+        //! Activa o desactiva la cache de sombras de los nodos estaticos
+        //! @param mode Booleano para cambiar el modo
+        void SetShadowStaticCache(bool mode) { if (shadowMapping) shadowMapping->SetStaticCache(mode); };
+        
+        //! Activa o desactiva el frustum culling de la camara y de las sombras
+        //! @param mode Booleano para cambiar el modo
+        void SetFrustumCulling(bool mode) { smgr->SetFrustumCulling(mode); };
+        
+        //! Devuelve los nodos dibujados y descartados por el frustum en el ultimo frame
+        //! @returns CLCullingStats contadores de la pasada principal y de sombras
+        const CLCullingStats& GetCullingStats() const { return smgr->GetCullingStats(); };
+        
+        //! Devuelve los paquetes dibujados y los cambios de estado de OpenGL de la pasada principal del ultimo frame
+        //! @returns CLRenderQueueStats contadores de la cola de dibujado
+        const CLRenderQueueStats& GetRenderQueueStats() const { return smgr->GetRenderQueueStats(); };
+        
         void ImGuiInit();
         
         void TerminateImGui();
@@ -403,12 +423,54 @@ class CLEngine {
         
         CLNode* GetNodeByIDAux(unsigned int id, CLNode* node, CLNode* root);
         
-        //! Calcula las matriecs view y projection
-        void CalculateViewProjMatrix(const glm::mat4& lightSpaceMatrix);
+        //! Calcula las matriecs view y projection y las cascadas de las sombras
+        void CalculateViewProjMatrix();
         
         //! Calcula las luces de la escena
         void CalculateLights();
 
+        //! Crea los uniform buffers de la camara y las luces y los enlaza a sus binding points
+        void CreateUniformBuffers();
+
+        //! Binding points de los bloques uniform, los mismos que el layout(binding) de los shaders
+        static const GLuint CAMERA_BINDING = 0;
+        static const GLuint LIGHTS_BINDING = 1;
+        //! Maximo de luces puntuales, NUM_POINT_LIGHTS en los shaders
+        static const unsigned int MAX_POINT_LIGHTS = 25;
+
+        //! Bloque Camera de los shaders con layout std140
+        struct CameraBlock {
+            glm::mat4 view;
+            glm::mat4 projection;
+            glm::mat4 viewProjection;
+            glm::vec3 viewPos;
+            GLint activeShadows;
+            glm::vec3 lightShadowDir;
+            GLint numCascades;
+            glm::mat4 lightSpaceMatrices[CLShadowMapping::MAX_CASCADES];
+            glm::vec4 cascadeFar;
+        };
+
+        //! Struct PointLight de los shaders con layout std140, cada vec3 se completa con un float
+        struct PointLightStd140 {
+            glm::vec3 position;
+            float constant;
+            glm::vec3 ambient;
+            float linear;
+            glm::vec3 diffuse;
+            float quadratic;
+            glm::vec3 specular;
+            float padding;
+        };
+
+        //! Bloque Lights de los shaders con layout std140
+        struct LightsBlock {
+            GLint numPointLights;
+            GLint shadowMappingLight;
+            GLint padding[2];
+            PointLightStd140 pointLights[MAX_POINT_LIGHTS];
+        };
+
         int width{};
         int height{};
         const string shaderVersion = "#version 450";
@@ -421,6 +483,7 @@ class CLEngine {
         GLuint VAOText, VBOText;
         bool grassActivate { true };
         bool shadowsActivate { false };
+        CLShadowQuality shadowQuality { SHADOW_MEDIUM };
         inline static glm::mat4 projection;             // matriz proyeccion del modelo
         inline static glm::mat4 view;                   // matriz view del modelo
         GLuint shaderProgramID;
@@ -435,6 +498,9 @@ class CLEngine {
         inline static GLuint simpleDepthShader = 0;
         inline static CLResourceShader* depthShadder = nullptr;
         inline static GLuint particleSystemShader = 0;
+        GLuint cameraUBO { 0 };
+        GLuint lightsUBO { 0 };
+        LightsBlock lightsBlock {};
 };
 }
 
@@ -0,0 +1,68 @@
+/**
+ * Beast Brawl
+ * Game created as a final project of the Multimedia Engineering Degree in the University of Alicante.
+ * Made by Clover Games Studio, with members 
+ * Carlos de la Fuente Torres delafuentetorresc@gmail.com,
+ * Antonio Jose Martinez Garcia https://www.linkedin.com/in/antonio-jose-martinez-garcia/,
+ * Jesús Mas Carretero jmasc03@gmail.com, 
+ * Judith Mula Molina https://www.linkedin.com/in/judith-mm-18099215a/, 
+ * Rubén Rubio Martínez https://www.linkedin.com/in/rub%C3%A9n-rubio-mart%C3%ADnez-938700131/, 
+ * and Jose Valdés Sirvent https://www.linkedin.com/in/jose-f-valdés-sirvent-6058b5a5/ github -> josefrvaldes
+ * 
+ * 
+ * @author Clover Games Studio
+ * 
+ */
+ 
+ 
+#pragma once
+
+//! El profiler lo implementa la aplicacion, el motor solo avisa al empezar y acabar cada zona.
+//! Sin PROFILER_ENABLED las macros quedan vacias y no tienen ningun coste.
+#ifdef PROFILER_ENABLED
+    #define CLE_PROFILE_CONCAT_IMPL(a, b) a##b
+    #define CLE_PROFILE_CONCAT(a, b) CLE_PROFILE_CONCAT_IMPL(a, b)
+    #define CLE_PROFILE_ZONE(name) CLE::CLProfiler::Zone CLE_PROFILE_CONCAT(cleProfilerZone, __LINE__)(name)
+#else
+    #define CLE_PROFILE_ZONE(name)
+#endif
+
+namespace CLE {
+
+//! Clase con los callbacks del profiler de la aplicacion
+class CLProfiler {
+    public:
+        //! Callback al empezar una zona, el nombre debe ser un literal.
+        inline static void (*beginZone)(const char*) = nullptr;
+
+        //! Callback al acabar la ultima zona abierta.
+        inline static void (*endZone)() = nullptr;
+
+        //! Asigna los callbacks del profiler
+        //! @param begin Callback al empezar una zona
+        //! @param end Callback al acabar una zona
+        static void SetCallbacks(void (*begin)(const char*), void (*end)()) {
+            beginZone = begin;
+            endZone = end;
+        }
+
+        //! Zona que dura lo mismo que su ambito
+        class Zone {
+            public:
+                explicit Zone(const char* name) : active(beginZone != nullptr) {
+                    if (active) beginZone(name);
+                }
+
+                ~Zone() {
+                    if (active) endZone();
+                }
+
+                Zone(const Zone&) = delete;
+                Zone& operator=(const Zone&) = delete;
+
+            private:
+                bool active;
+        };
+};
+
+}
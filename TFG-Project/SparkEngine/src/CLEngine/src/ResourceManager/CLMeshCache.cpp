@@ -0,0 +1,288 @@
+/**
+ * Beast Brawl
+ * Game created as a final project of the Multimedia Engineering Degree in the University of Alicante.
+ * Made by Clover Games Studio, with members 
+ * Carlos de la Fuente Torres delafuentetorresc@gmail.com,
+ * Antonio Jose Martinez Garcia https://www.linkedin.com/in/antonio-jose-martinez-garcia/,
+ * Jesús Mas Carretero jmasc03@gmail.com, 
+ * Judith Mula Molina https://www.linkedin.com/in/judith-mm-18099215a/, 
+ * Rubén Rubio Martínez https://www.linkedin.com/in/rub%C3%A9n-rubio-mart%C3%ADnez-938700131/, 
+ * and Jose Valdés Sirvent https://www.linkedin.com/in/jose-f-valdés-sirvent-6058b5a5/ github -> josefrvaldes
+ * 
+ * 
+ * @author Clover Games Studio
+ * 
+ */
+ 
+#include "CLMeshCache.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <type_traits>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace CLE;
+
+namespace {
+    //! Cabecera del fichero de cache
+    struct CacheHeader {
+        char magic[4] { 'C', 'L', 'M', 'C' };
+        uint32_t version { CLMeshCache::version };
+        uint32_t flags { 0 };
+        uint32_t numMeshes { 0 };
+        uint64_t sourceHash { 0 };
+        uint32_t vertexSize { sizeof(Vertex) };
+        uint32_t hasBounds { 0 };
+        float minBounds[3] { 0.f, 0.f, 0.f };
+        float maxBounds[3] { 0.f, 0.f, 0.f };
+    };
+
+    //! Cabecera de cada submalla, detras van sus texturas, sus vertices y sus indices
+    struct CacheMeshHeader {
+        uint32_t numVertices { 0 };
+        uint32_t numIndices { 0 };
+        uint32_t numTextures { 0 };
+    };
+
+    static_assert(std::is_trivially_copyable<Vertex>::value, "Vertex se copia tal cual a la cache");
+
+    //! Lee el fichero mapeado comprobando que no se sale de el
+    class CacheReader {
+        public:
+            CacheReader(const unsigned char* data, size_t size) : data(data), size(size) {};
+
+            bool Read(void* destination, size_t bytes) {
+                if (bytes > size - offset)
+                    return false;
+                if (bytes)
+                    std::memcpy(destination, data + offset, bytes);
+                offset += bytes;
+                return true;
+            }
+
+            bool ReadString(string& text) {
+                uint32_t length = 0;
+                if (!Read(&length, sizeof(length)) || length > size - offset)
+                    return false;
+                text.assign(reinterpret_cast<const char*>(data + offset), length);
+                offset += length;
+                return true;
+            }
+
+            bool AtEnd() const { return offset == size; }
+
+            //! Bytes que quedan por leer
+            size_t Remaining() const { return size - offset; }
+        private:
+            const unsigned char* data;
+            size_t size;
+            size_t offset { 0 };
+    };
+
+    void WriteString(std::ofstream& out, const string& text) {
+        uint32_t length = static_cast<uint32_t>(text.size());
+        out.write(reinterpret_cast<const char*>(&length), sizeof(length));
+        out.write(text.data(), length);
+    }
+}
+
+// -----------------------------------------
+// -----------Clase CLMappedFile------------
+// -----------------------------------------
+
+CLMappedFile::~CLMappedFile() {
+    Close();
+}
+
+bool CLMappedFile::Open(const std::string& file) {
+    Close();
+#ifdef _WIN32
+    HANDLE handle = CreateFileA(file.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (handle == INVALID_HANDLE_VALUE)
+        return false;
+    fileHandle = handle;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(handle, &fileSize) || fileSize.QuadPart == 0) {
+        Close();
+        return false;
+    }
+
+    mappingHandle = CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mappingHandle) {
+        Close();
+        return false;
+    }
+
+    data = static_cast<const unsigned char*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+    if (!data) {
+        Close();
+        return false;
+    }
+    size = static_cast<size_t>(fileSize.QuadPart);
+#else
+    int descriptor = open(file.c_str(), O_RDONLY);
+    if (descriptor < 0)
+        return false;
+
+    struct stat fileStat;
+    if (fstat(descriptor, &fileStat) != 0 || fileStat.st_size == 0) {
+        close(descriptor);
+        return false;
+    }
+
+    // El mapeo sigue siendo valido despues de cerrar el descriptor
+    void* mapped = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, descriptor, 0);
+    close(descriptor);
+    if (mapped == MAP_FAILED)
+        return false;
+
+    data = static_cast<const unsigned char*>(mapped);
+    size = static_cast<size_t>(fileStat.st_size);
+#endif
+    return true;
+}
+
+void CLMappedFile::Close() {
+#ifdef _WIN32
+    if (data)
+        UnmapViewOfFile(data);
+    if (mappingHandle)
+        CloseHandle(mappingHandle);
+    if (fileHandle)
+        CloseHandle(fileHandle);
+    mappingHandle = nullptr;
+    fileHandle = nullptr;
+#else
+    if (data)
+        munmap(const_cast<unsigned char*>(data), size);
+#endif
+    data = nullptr;
+    size = 0;
+}
+
+// -----------------------------------------
+// -----------Clase CLMeshCache-------------
+// -----------------------------------------
+
+bool CLMeshCache::HashFile(const std::string& file, uint64_t& hash) {
+    CLMappedFile source;
+    if (!source.Open(file))
+        return false;
+
+    hash = 14695981039346656037ull;
+    const unsigned char* data = source.GetData();
+    for (size_t i = 0; i < source.GetSize(); ++i) {
+        hash ^= data[i];
+        hash *= 1099511628211ull;
+    }
+    return true;
+}
+
+bool CLMeshCache::Load(const std::string& file, uint64_t sourceHash, uint32_t flags, std::vector<Mesh>& meshes, glm::vec3& minBounds, glm::vec3& maxBounds, bool& hasBounds) {
+    CLMappedFile cache;
+    if (!cache.Open(GetCachePath(file)))
+        return false;
+
+    CacheReader reader(cache.GetData(), cache.GetSize());
+    CacheHeader header, expected;
+    if (!reader.Read(&header, sizeof(header)) || std::memcmp(header.magic, expected.magic, sizeof(header.magic)) != 0 ||
+        header.version != version || header.vertexSize != sizeof(Vertex) || header.flags != flags || header.sourceHash != sourceHash)
+        return false;
+
+    // Se comprueba el tamano antes de reservar para que una cache corrupta no pida memoria de mas,
+    // cada submalla ocupa al menos su cabecera y cada textura las longitudes de sus dos cadenas
+    if (header.numMeshes > reader.Remaining() / sizeof(CacheMeshHeader))
+        return false;
+
+    // Se lee en un vector aparte para no dejar la malla a medias si la cache esta truncada
+    std::vector<Mesh> cached(header.numMeshes);
+    for (auto& mesh : cached) {
+        CacheMeshHeader meshHeader;
+        if (!reader.Read(&meshHeader, sizeof(meshHeader)))
+            return false;
+
+        if (meshHeader.numTextures > reader.Remaining() / (2 * sizeof(uint32_t)))
+            return false;
+        mesh.textures.resize(meshHeader.numTextures);
+        for (auto& texture : mesh.textures) {
+            texture.id = 0;
+            if (!reader.ReadString(texture.type) || !reader.ReadString(texture.path))
+                return false;
+        }
+
+        if (meshHeader.numVertices > reader.Remaining() / sizeof(Vertex) || meshHeader.numIndices > reader.Remaining() / sizeof(unsigned int))
+            return false;
+        mesh.vertices.resize(meshHeader.numVertices);
+        mesh.indices.resize(meshHeader.numIndices);
+        if (!reader.Read(mesh.vertices.data(), mesh.vertices.size() * sizeof(Vertex)) ||
+            !reader.Read(mesh.indices.data(), mesh.indices.size() * sizeof(unsigned int)))
+            return false;
+    }
+    if (!reader.AtEnd())
+        return false;
+
+    meshes.insert(meshes.end(), std::make_move_iterator(cached.begin()), std::make_move_iterator(cached.end()));
+    minBounds = glm::vec3(header.minBounds[0], header.minBounds[1], header.minBounds[2]);
+    maxBounds = glm::vec3(header.maxBounds[0], header.maxBounds[1], header.maxBounds[2]);
+    hasBounds = header.hasBounds != 0;
+    return true;
+}
+
+bool CLMeshCache::Save(const std::string& file, uint64_t sourceHash, uint32_t flags, const std::vector<Mesh>& meshes, const glm::vec3& minBounds, const glm::vec3& maxBounds, bool hasBounds) {
+    // Se escribe en un temporal y se renombra, asi nunca se lee una cache a medio escribir
+    string path = GetCachePath(file);
+    string temporal = path + ".tmp";
+    bool written = false;
+    {
+        std::ofstream out(temporal, std::ios::binary | std::ios::trunc);
+        if (!out)
+            return false;
+
+        CacheHeader header;
+        header.flags = flags;
+        header.numMeshes = static_cast<uint32_t>(meshes.size());
+        header.sourceHash = sourceHash;
+        header.hasBounds = hasBounds;
+        for (int i = 0; i < 3; ++i) {
+            header.minBounds[i] = minBounds[i];
+            header.maxBounds[i] = maxBounds[i];
+        }
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+        for (const auto& mesh : meshes) {
+            CacheMeshHeader meshHeader;
+            meshHeader.numVertices = static_cast<uint32_t>(mesh.vertices.size());
+            meshHeader.numIndices = static_cast<uint32_t>(mesh.indices.size());
+            meshHeader.numTextures = static_cast<uint32_t>(mesh.textures.size());
+            out.write(reinterpret_cast<const char*>(&meshHeader), sizeof(meshHeader));
+
+            for (const auto& texture : mesh.textures) {
+                WriteString(out, texture.type);
+                WriteString(out, texture.path);
+            }
+            out.write(reinterpret_cast<const char*>(mesh.vertices.data()), mesh.vertices.size() * sizeof(Vertex));
+            out.write(reinterpret_cast<const char*>(mesh.indices.data()), mesh.indices.size() * sizeof(unsigned int));
+        }
+
+        written = static_cast<bool>(out);
+    }
+    if (!written) {
+        std::remove(temporal.c_str());
+        return false;
+    }
+
+    std::remove(path.c_str());
+    return std::rename(temporal.c_str(), path.c_str()) == 0;
+}
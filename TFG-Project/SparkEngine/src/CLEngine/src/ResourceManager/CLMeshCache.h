@@ -0,0 +1,97 @@
+/**
+ * Beast Brawl
+ * Game created as a final project of the Multimedia Engineering Degree in the University of Alicante.
+ * Made by Clover Games Studio, with members 
+ * Carlos de la Fuente Torres delafuentetorresc@gmail.com,
+ * Antonio Jose Martinez Garcia https://www.linkedin.com/in/antonio-jose-martinez-garcia/,
+ * Jesús Mas Carretero jmasc03@gmail.com, 
+ * Judith Mula Molina https://www.linkedin.com/in/judith-mm-18099215a/, 
+ * Rubén Rubio Martínez https://www.linkedin.com/in/rub%C3%A9n-rubio-mart%C3%ADnez-938700131/, 
+ * and Jose Valdés Sirvent https://www.linkedin.com/in/jose-f-valdés-sirvent-6058b5a5/ github -> josefrvaldes
+ * 
+ * 
+ * @author Clover Games Studio
+ * 
+ */
+ 
+ 
+#pragma once
+
+#include "CLResourceMesh.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace CLE {
+
+    //! Fichero mapeado en memoria de solo lectura
+    //! Se deja de mapear al destruirlo
+    class CLMappedFile {
+        public:
+            CLMappedFile() {};
+            ~CLMappedFile();
+            CLMappedFile(const CLMappedFile&) = delete;
+            CLMappedFile& operator=(const CLMappedFile&) = delete;
+
+            //! Mapea un fichero entero
+            //! @param file Ruta al fichero
+            //! @returns Si se ha podido mapear, un fichero vacio no se mapea
+            bool Open(const std::string& file);
+            //! Deja de mapear el fichero
+            void Close();
+
+            const unsigned char* GetData() const { return data; }
+            size_t GetSize() const { return size; }
+        private:
+            const unsigned char* data { nullptr };
+            size_t size { 0 };
+#ifdef _WIN32
+            void* fileHandle { nullptr };
+            void* mappingHandle { nullptr };
+#endif
+    };
+
+    //! Cache binaria de las mallas leidas con assimp
+    //! Guarda junto al fichero original los vertices ya intercalados, los indices, las texturas de cada submalla
+    //! y la caja de la malla. La cabecera lleva la version del formato, los flags de assimp y un hash del fichero
+    //! original, si alguno no coincide la cache no se usa y se vuelve a generar.
+    class CLMeshCache {
+        public:
+            //! Version del formato, se sube al cambiar el fichero o la estructura Vertex
+            static constexpr uint32_t version = 1;
+
+            //! @param file Ruta a la malla original
+            //! @returns Ruta de su cache
+            static std::string GetCachePath(const std::string& file) { return file + ".clmesh"; }
+
+            //! Calcula el hash FNV-1a de un fichero
+            //! @param file Ruta al fichero
+            //! @param hash Hash del contenido
+            //! @returns Si se ha podido leer
+            static bool HashFile(const std::string& file, uint64_t& hash);
+
+            //! Lee la cache de una malla si es valida
+            //! @param file Ruta a la malla original
+            //! @param sourceHash Hash del fichero original
+            //! @param flags Flags de assimp con los que se leeria
+            //! @param meshes Submallas leidas, sin subir a OpenGL
+            //! @param minBounds Vertice menor de la caja
+            //! @param maxBounds Vertice mayor de la caja
+            //! @param hasBounds Si la malla tiene vertices
+            //! @returns Si la cache existe y es de este fichero con estos flags
+            static bool Load(const std::string& file, uint64_t sourceHash, uint32_t flags, std::vector<Mesh>& meshes, glm::vec3& minBounds, glm::vec3& maxBounds, bool& hasBounds);
+
+            //! Escribe la cache de una malla
+            //! @param file Ruta a la malla original
+            //! @param sourceHash Hash del fichero original
+            //! @param flags Flags de assimp con los que se ha leido
+            //! @param meshes Submallas leidas
+            //! @param minBounds Vertice menor de la caja
+            //! @param maxBounds Vertice mayor de la caja
+            //! @param hasBounds Si la malla tiene vertices
+            //! @returns Si se ha podido escribir
+            static bool Save(const std::string& file, uint64_t sourceHash, uint32_t flags, const std::vector<Mesh>& meshes, const glm::vec3& minBounds, const glm::vec3& maxBounds, bool hasBounds);
+    };
+}
@@ -39,7 +39,23 @@ namespace CLE {
             void SetName(string n)  { name = n; }
             //! @returns El nombre del fichero leido
             const string GetName()       const   { return name; }
+            //! Asigna la clave con la que lo guarda el CLResourceManager
+            void SetKey(const string& k)         { key = k; }
+            //! @returns La clave del recurso en el CLResourceManager, la ruta de todos sus ficheros y sus flags
+            const string& GetKey()       const   { return key; }
+            //! Memoria que ocupa el recurso en la grafica
+            //! @returns Bytes aproximados
+            virtual size_t GetMemoryUsage() const { return 0; }
+            //! Suma una referencia, solo desde el hilo de render
+            void AddReference()                  { ++references; }
+            //! Quita una referencia, solo desde el hilo de render
+            //! @returns Referencias que quedan
+            unsigned int RemoveReference()       { return references ? --references : 0; }
+            //! @returns Referencias de CLResourceHandle al recurso
+            unsigned int GetReferences()  const  { return references; }
         private:
             string name;
+            string key;
+            unsigned int references { 0 };
     };
 }
\ No newline at end of file
@@ -0,0 +1,71 @@
+/**
+ * Beast Brawl
+ * Game created as a final project of the Multimedia Engineering Degree in the University of Alicante.
+ * Made by Clover Games Studio, with members 
+ * Carlos de la Fuente Torres delafuentetorresc@gmail.com,
+ * Antonio Jose Martinez Garcia https://www.linkedin.com/in/antonio-jose-martinez-garcia/,
+ * Jesús Mas Carretero jmasc03@gmail.com, 
+ * Judith Mula Molina https://www.linkedin.com/in/judith-mm-18099215a/, 
+ * Rubén Rubio Martínez https://www.linkedin.com/in/rub%C3%A9n-rubio-mart%C3%ADnez-938700131/, 
+ * and Jose Valdés Sirvent https://www.linkedin.com/in/jose-f-valdés-sirvent-6058b5a5/ github -> josefrvaldes
+ * 
+ * 
+ * @author Clover Games Studio
+ * 
+ */
+ 
+ 
+#pragma once
+
+#include "CLResourceManager.h"
+
+namespace CLE {
+
+    //! Referencia a un recurso del CLResourceManager
+    //! Mientras haya algun handle el recurso no se libera, al destruirse el ultimo el gestor lo libera unos frames
+    //! despues. Los punteros que devuelven los Get del gestor no cuentan, los recursos que nadie suelta se quedan
+    //! para siempre como hasta ahora. Solo desde el hilo de render.
+    template<typename T>
+    class CLResourceHandle {
+        public:
+            CLResourceHandle() {};
+            CLResourceHandle(T* r) : resource(r) { Acquire(); }
+            CLResourceHandle(const CLResourceHandle& other) : resource(other.resource) { Acquire(); }
+            CLResourceHandle(CLResourceHandle&& other) noexcept : resource(other.resource) { other.resource = nullptr; }
+            ~CLResourceHandle() { Release(); }
+
+            CLResourceHandle& operator=(const CLResourceHandle& other) {
+                if (resource != other.resource) {
+                    Release();
+                    resource = other.resource;
+                    Acquire();
+                }
+                return *this;
+            }
+            CLResourceHandle& operator=(CLResourceHandle&& other) noexcept {
+                if (this != &other) {
+                    Release();
+                    resource = other.resource;
+                    other.resource = nullptr;
+                }
+                return *this;
+            }
+
+            //! @returns El recurso o nullptr
+            T* Get()                        const { return resource; }
+            T* operator->()                 const { return resource; }
+            explicit operator bool()        const { return resource != nullptr; }
+        private:
+            void Acquire() {
+                if (resource)
+                    resource->AddReference();
+            }
+            void Release() {
+                if (resource)
+                    CLResourceManager::GetResourceManager()->ReleaseResource(resource);
+                resource = nullptr;
+            }
+
+            T* resource { nullptr };
+    };
+}
@@ -0,0 +1,112 @@
+/**
+ * Beast Brawl
+ * Game created as a final project of the Multimedia Engineering Degree in the University of Alicante.
+ * Made by Clover Games Studio, with members 
+ * Carlos de la Fuente Torres delafuentetorresc@gmail.com,
+ * Antonio Jose Martinez Garcia https://www.linkedin.com/in/antonio-jose-martinez-garcia/,
+ * Jesús Mas Carretero jmasc03@gmail.com, 
+ * Judith Mula Molina https://www.linkedin.com/in/judith-mm-18099215a/, 
+ * Rubén Rubio Martínez https://www.linkedin.com/in/rub%C3%A9n-rubio-mart%C3%ADnez-938700131/, 
+ * and Jose Valdés Sirvent https://www.linkedin.com/in/jose-f-valdés-sirvent-6058b5a5/ github -> josefrvaldes
+ * 
+ * 
+ * @author Clover Games Studio
+ * 
+ */
+ 
+#include "CLResourceLoader.h"
+
+#include <SOIL2/SOIL2.h>
+
+#include <algorithm>
+
+using namespace CLE;
+
+// -----------------------------------------
+// ------------Struct CLImageData-----------
+// -----------------------------------------
+
+CLImageData::~CLImageData() {
+    if (data)
+        SOIL_free_image_data(data);
+}
+
+std::unique_ptr<CLImageData> CLImageData::Decode(const std::string& file) {
+    auto image = std::make_unique<CLImageData>();
+    image->data = SOIL_load_image(file.c_str(), &image->width, &image->height, &image->components, 0);
+    if (!image->data)
+        return nullptr;
+
+    return image;
+}
+
+GLenum CLImageData::GetFormat() const {
+    switch (components) {
+        case 1: return GL_RED;
+        case 3: return GL_RGB;
+        case 4: return GL_RGBA;
+        default: return 0;
+    }
+}
+
+// -----------------------------------------
+// ---------Clase CLResourceLoader----------
+// -----------------------------------------
+
+CLResourceLoader::CLResourceLoader(unsigned int numWorkers) {
+    numWorkers = std::max(numWorkers, 1u);
+    for (unsigned int i = 0; i < numWorkers; ++i)
+        workers.emplace_back(&CLResourceLoader::WorkerLoop, this);
+}
+
+CLResourceLoader::~CLResourceLoader() {
+    {
+        std::lock_guard<std::mutex> lock(tasksMutex);
+        stopping = true;
+    }
+    tasksCondition.notify_all();
+    for (auto& worker : workers)
+        worker.join();
+}
+
+void CLResourceLoader::QueueUpload(std::function<void()> upload) {
+    {
+        std::lock_guard<std::mutex> lock(uploadsMutex);
+        uploads.push_back(std::move(upload));
+    }
+    uploadsCondition.notify_all();
+}
+
+bool CLResourceLoader::ProcessUploads() {
+    // Se sacan todas de golpe para no tener el mutex mientras se sube, las subidas pueden encolar otras
+    std::vector<std::function<void()>> pending;
+    {
+        std::lock_guard<std::mutex> lock(uploadsMutex);
+        pending.swap(uploads);
+    }
+    for (auto& upload : pending)
+        upload();
+
+    return !pending.empty();
+}
+
+void CLResourceLoader::WaitUploads(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(uploadsMutex);
+    uploadsCondition.wait_for(lock, timeout, [this]() { return !uploads.empty(); });
+}
+
+void CLResourceLoader::WorkerLoop() {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(tasksMutex);
+            tasksCondition.wait(lock, [this]() { return stopping || !tasks.empty(); });
+            if (stopping && tasks.empty())
+                return;
+
+            task = std::move(tasks.front());
+            tasks.pop();
+        }
+        task();
+    }
+}
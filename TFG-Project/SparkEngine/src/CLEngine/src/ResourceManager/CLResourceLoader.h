@@ -0,0 +1,104 @@
+/**
+ * Beast Brawl
+ * Game created as a final project of the Multimedia Engineering Degree in the University of Alicante.
+ * Made by Clover Games Studio, with members 
+ * Carlos de la Fuente Torres delafuentetorresc@gmail.com,
+ * Antonio Jose Martinez Garcia https://www.linkedin.com/in/antonio-jose-martinez-garcia/,
+ * Jesús Mas Carretero jmasc03@gmail.com, 
+ * Judith Mula Molina https://www.linkedin.com/in/judith-mm-18099215a/, 
+ * Rubén Rubio Martínez https://www.linkedin.com/in/rub%C3%A9n-rubio-mart%C3%ADnez-938700131/, 
+ * and Jose Valdés Sirvent https://www.linkedin.com/in/jose-f-valdés-sirvent-6058b5a5/ github -> josefrvaldes
+ * 
+ * 
+ * @author Clover Games Studio
+ * 
+ */
+ 
+ 
+#pragma once
+
+#include <GL/glew.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace CLE {
+
+    //! Imagen decodificada en memoria, lista para subirla a OpenGL
+    struct CLImageData {
+        ~CLImageData();
+
+        //! Decodifica una imagen con SOIL, se puede llamar desde cualquier hilo
+        //! @param file Ruta al fichero
+        //! @returns La imagen, nullptr si no se ha podido leer
+        static std::unique_ptr<CLImageData> Decode(const std::string& file);
+
+        //! Devuelve el formato de OpenGL segun el numero de canales, 0 si no se soporta
+        GLenum GetFormat() const;
+
+        int width { 0 };
+        int height { 0 };
+        int components { 0 };
+        unsigned char* data { nullptr };
+    };
+
+    //! Carga de recursos en segundo plano
+    //! Un pool de hilos lee y decodifica los ficheros sin tocar OpenGL, lo que necesita el contexto se encola
+    //! y lo ejecuta el hilo de render en ProcessUploads, que es el unico que tiene el contexto activo.
+    class CLResourceLoader {
+        public:
+            //! @param numWorkers Hilos del pool, al menos uno
+            CLResourceLoader(unsigned int numWorkers);
+            //! Espera a que acaben las tareas en curso y para los hilos
+            ~CLResourceLoader();
+
+            //! Ejecuta una tarea en el pool
+            //! @param task Tarea, no puede usar OpenGL
+            //! @returns future con el resultado de la tarea
+            template<typename F>
+            auto Submit(F task) -> std::future<decltype(task())> {
+                using Result = decltype(task());
+                auto packaged = std::make_shared<std::packaged_task<Result()>>(std::move(task));
+                auto future = packaged->get_future();
+                {
+                    std::lock_guard<std::mutex> lock(tasksMutex);
+                    tasks.emplace([packaged]() { (*packaged)(); });
+                }
+                tasksCondition.notify_one();
+                return future;
+            }
+
+            //! Encola una subida a OpenGL para el hilo de render
+            //! @param upload Funcion que se ejecuta con el contexto activo
+            void QueueUpload(std::function<void()> upload);
+
+            //! Ejecuta las subidas pendientes, solo desde el hilo de render
+            //! @returns Si se ha ejecutado alguna
+            bool ProcessUploads();
+
+            //! Espera a que se encole alguna subida o a que pase el timeout
+            //! @param timeout Tiempo maximo de espera
+            void WaitUploads(std::chrono::milliseconds timeout);
+
+        private:
+            //! Bucle de cada hilo del pool
+            void WorkerLoop();
+
+            std::vector<std::thread> workers;
+            std::queue<std::function<void()>> tasks;
+            std::mutex tasksMutex;
+            std::condition_variable tasksCondition;
+            std::vector<std::function<void()>> uploads;
+            std::mutex uploadsMutex;
+            std::condition_variable uploadsCondition;
+            bool stopping { false };
+    };
+}
@@ -24,27 +24,102 @@ CLResourceManager::CLResourceManager() {
     textures.reserve(300);
 }
 
+string CLResourceManager::MeshKey(const string& file, bool flipUV) {
+    return file + (flipUV ? "|flipUV" : "");
+}
+
+string CLResourceManager::TextureKey(const string& file, bool vertically) {
+    return file + (vertically ? "|vertically" : "");
+}
+
+string CLResourceManager::ShaderKey(const string& vertex, const string& fragment, const string& geometry) {
+    return vertex + "|" + fragment + "|" + geometry;
+}
+
 CLResourceMesh* CLResourceManager::GetResourceMesh(const std::string file){
     return GetResourceMesh(file,false);
 }
 
 CLResourceMesh* CLResourceManager::GetResourceMesh(const std::string file, bool flipUV) {
-    shared_ptr<CLResourceMesh> resource = nullptr;
-    bool search = true;
-    for (unsigned int i=0; i<meshes.size() && search; ++ i) {
-        if (!file.compare(meshes[i]->GetName())) {
-            resource = meshes[i];
-            search = false;
+    string key = MeshKey(file, flipUV);
+
+    // Si se esta leyendo en segundo plano se espera a que acabe y se sube aqui mismo
+    auto pending = pendingMeshes.find(key);
+    if (pending != pendingMeshes.end()) {
+        auto future = pending->second;
+        while (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            if (!loader.ProcessUploads())
+                loader.WaitUploads(std::chrono::milliseconds(10));
         }
+        return future.get();
     }
-    if (!resource) {
-        resource = make_shared<CLResourceMesh>();
-        resource->SetName(file);
-        if (resource->LoadFile(file, flipUV)) {
-            meshes.push_back(resource);
-        }
+
+    auto found = meshes.find(key);
+    if (found != meshes.end()) {
+        return found->second.get();
     }
 
+    auto resource = make_shared<CLResourceMesh>();
+    resource->SetName(file);
+    resource->SetKey(key);
+    if (!resource->LoadFile(file, flipUV)) {
+        return nullptr;
+    }
+    meshes[key] = resource;
+
+    return resource.get();
+}
+
+std::shared_future<CLResourceMesh*> CLResourceManager::LoadResourceMeshAsync(const std::string file, bool flipUV) {
+    string key = MeshKey(file, flipUV);
+
+    auto found = meshes.find(key);
+    if (found != meshes.end()) {
+        std::promise<CLResourceMesh*> loaded;
+        loaded.set_value(found->second.get());
+        return loaded.get_future().share();
+    }
+
+    auto pending = pendingMeshes.find(key);
+    if (pending != pendingMeshes.end()) {
+        return pending->second;
+    }
+
+    auto resource = make_shared<CLResourceMesh>();
+    resource->SetName(file);
+    resource->SetKey(key);
+    auto promise = make_shared<std::promise<CLResourceMesh*>>();
+    auto future = promise->get_future().share();
+    pendingMeshes[key] = future;
+
+    // La lectura va en el pool y la subida se encola para el hilo de render, que es donde se toca meshes
+    loader.Submit([this, resource, file, key, flipUV, promise]() {
+        bool parsed = resource->Parse(file, flipUV);
+        loader.QueueUpload([this, resource, key, parsed, promise]() {
+            if (parsed) {
+                resource->Upload();
+                meshes[key] = resource;
+            }
+            pendingMeshes.erase(key);
+            promise->set_value(parsed ? resource.get() : nullptr);
+        });
+    });
+
+    return future;
+}
+
+CLResourceMesh* CLResourceManager::AddResourceMesh(const std::string name) {
+    string key = MeshKey(name, false);
+    auto found = meshes.find(key);
+    if (found != meshes.end()) {
+        return found->second.get();
+    }
+
+    auto resource = make_shared<CLResourceMesh>();
+    resource->SetName(name);
+    resource->SetKey(key);
+    meshes[key] = resource;
+
     return resource.get();
 }
 
@@ -53,92 +128,170 @@ CLResourceTexture* CLResourceManager::GetResourceTexture(const std::string file)
 }
 
 CLResourceTexture* CLResourceManager::GetResourceTexture(const std::string file, bool vertically) {
-    shared_ptr<CLResourceTexture> resource = nullptr;
-    bool search = true;
-    for (unsigned int i=0; i<textures.size() && search; ++ i) {
-        if (!file.compare(textures[i]->GetName())) {
-            resource = textures[i];
-            search = false;
-        }
-    }
-    if (!resource) {
-        resource = make_shared<CLResourceTexture>();
-        resource->SetName(file);
-        if (resource->LoadFile(file, vertically)) {
-            textures.push_back(resource);
-        }
+    string key = TextureKey(file, vertically);
+    auto found = textures.find(key);
+    if (found != textures.end()) {
+        return found->second.get();
     }
 
-    
+    auto resource = make_shared<CLResourceTexture>();
+    resource->SetName(file);
+    resource->SetKey(key);
+    if (!resource->LoadFile(file, vertically)) {
+        return nullptr;
+    }
+    textures[key] = resource;
 
     return resource.get();
 }
 
 CLResourceShader* CLResourceManager::GetResourceShader(const std::string vertex, const std::string fragment) {
-    shared_ptr<CLResourceShader> resource = NULL;
-    bool search = true;
-    for (unsigned int i=0; i<shaders.size() && search; ++ i) {
-        if (!vertex.compare(shaders[i]->GetName())) {
-            resource = shaders[i];
-            search = false;
-        }
+    string key = ShaderKey(vertex, fragment, "");
+    auto found = shaders.find(key);
+    if (found != shaders.end()) {
+        return found->second.get();
     }
-    if (!resource) {
-        //cout << "Creo el shader: " << vertex <<endl;
-        resource = make_shared<CLResourceShader>();
-        resource->SetName(vertex);
-        //resource->SetShaderType(type);
-        if (resource->LoadFile(vertex,fragment)) {
-            shaders.push_back(resource);
-        }
+
+    //cout << "Creo el shader: " << vertex <<endl;
+    auto resource = make_shared<CLResourceShader>();
+    resource->SetName(vertex);
+    resource->SetKey(key);
+    if (!resource->LoadFile(vertex,fragment)) {
+        return nullptr;
     }
+    shaders[key] = resource;
 
     return resource.get();
 }
 
 CLResourceShader* CLResourceManager::GetResourceShader(const std::string vertex, const std::string fragment, const std::string geometry) {
-    shared_ptr<CLResourceShader> resource = NULL;
-    bool search = true;
-    for (unsigned int i=0; i<shaders.size() && search; ++ i) {
-        if (!vertex.compare(shaders[i]->GetName())) {
-            resource = shaders[i];
-            search = false;
-        }
+    string key = ShaderKey(vertex, fragment, geometry);
+    auto found = shaders.find(key);
+    if (found != shaders.end()) {
+        return found->second.get();
     }
-    if (!resource) {
-        //cout << "Creo el shader: " << vertex <<endl;
-        resource = make_shared<CLResourceShader>();
-        resource->SetName(vertex);
-        //resource->SetShaderType(type);
-        if (resource->LoadFile(vertex,fragment,geometry)) {
-            shaders.push_back(resource);
-        }
+
+    //cout << "Creo el shader: " << vertex <<endl;
+    auto resource = make_shared<CLResourceShader>();
+    resource->SetName(vertex);
+    resource->SetKey(key);
+    if (!resource->LoadFile(vertex,fragment,geometry)) {
+        return nullptr;
     }
+    shaders[key] = resource;
 
     return resource.get();
 }
 
-bool CLResourceManager::DeleteResourceTexture(const std::string file){
+void CLResourceManager::ReleaseResource(CLResource* resource) {
+    if (resource->RemoveReference() > 0) {
+        return;
+    }
 
-    for (unsigned int i=0; i<textures.size(); ++ i) {
-        if (!file.compare(textures[i]->GetName())) {
-            textures.erase(textures.begin()+i);
-            return true;
+    // Cada recurso esta una vez en la cola, si se vuelve a soltar antes de liberarse se cuenta desde ahora
+    auto queued = std::find_if(releaseQueue.begin(), releaseQueue.end(), [resource](const ReleasedResource& r) { return r.resource == resource; });
+    if (queued != releaseQueue.end()) {
+        queued->frame = frame;
+    } else {
+        releaseQueue.push_back({ resource, frame });
+    }
+}
+
+void CLResourceManager::CollectReleased() {
+    ++frame;
+    for (size_t i = 0; i < releaseQueue.size();) {
+        auto released = releaseQueue[i];
+        if (frame - released.frame < releaseDelay) {
+            ++i;
+            continue;
         }
+
+        // Si alguien lo ha vuelto a coger mientras esperaba se queda
+        if (!released.resource->GetReferences()) {
+            EraseResource(released.resource);
+        }
+        releaseQueue[i] = releaseQueue.back();
+        releaseQueue.pop_back();
     }
+}
 
+bool CLResourceManager::EraseResource(CLResource* resource) {
+    const string& key = resource->GetKey();
+    auto mesh = meshes.find(key);
+    if (mesh != meshes.end() && mesh->second.get() == resource) {
+        meshes.erase(mesh);
+        return true;
+    }
+    auto texture = textures.find(key);
+    if (texture != textures.end() && texture->second.get() == resource) {
+        textures.erase(texture);
+        return true;
+    }
+    auto shader = shaders.find(key);
+    if (shader != shaders.end() && shader->second.get() == resource) {
+        shaders.erase(shader);
+        return true;
+    }
     return false;
 }
 
-bool CLResourceManager::DeleteResourceMesh(const std::string file){
-    // cout << meshes.size() << endl;
-    for (unsigned int i=0; i<meshes.size(); ++ i) {
-        if (!file.compare(meshes[i]->GetName())) {
-            meshes.erase(meshes.begin()+i);
-            // cout << meshes.size() << endl;
+void CLResourceManager::ForgetReleased(CLResource* resource) {
+    releaseQueue.erase(std::remove_if(releaseQueue.begin(), releaseQueue.end(), [resource](const ReleasedResource& r) { return r.resource == resource; }), releaseQueue.end());
+}
 
-            return true;
+CLResourceStats CLResourceManager::GetResourceStats() const {
+    CLResourceStats stats;
+    for (const auto& mesh : meshes) {
+        stats.meshes.count++;
+        stats.meshes.bytes += mesh.second->GetMemoryUsage();
+    }
+    for (const auto& texture : textures) {
+        stats.textures.count++;
+        stats.textures.bytes += texture.second->GetMemoryUsage();
+    }
+    for (const auto& shader : shaders) {
+        stats.shaders.count++;
+        stats.shaders.bytes += shader.second->GetMemoryUsage();
+    }
+    stats.pendingRelease = releaseQueue.size();
+    return stats;
+}
+
+vector<shared_ptr<CLResourceMesh>> CLResourceManager::GetMeshes() {
+    vector<shared_ptr<CLResourceMesh>> result;
+    result.reserve(meshes.size());
+    for (const auto& mesh : meshes) {
+        result.push_back(mesh.second);
+    }
+    return result;
+}
+
+bool CLResourceManager::DeleteResourceTexture(const std::string file){
+    bool deleted = false;
+    for (auto texture = textures.begin(); texture != textures.end();) {
+        if (!file.compare(texture->second->GetName()) && !texture->second->GetReferences()) {
+            ForgetReleased(texture->second.get());
+            texture = textures.erase(texture);
+            deleted = true;
+        } else {
+            ++texture;
         }
     }
-    return false;
+
+    return deleted;
+}
+
+bool CLResourceManager::DeleteResourceMesh(const std::string file){
+    bool deleted = false;
+    for (auto mesh = meshes.begin(); mesh != meshes.end();) {
+        if (!file.compare(mesh->second->GetName()) && !mesh->second->GetReferences()) {
+            ForgetReleased(mesh->second.get());
+            mesh = meshes.erase(mesh);
+            deleted = true;
+        } else {
+            ++mesh;
+        }
+    }
+
+    return deleted;
 }
@@ -21,7 +21,11 @@
 #include <string>
 #include <memory>
 #include <iostream>
+#include <future>
+#include <algorithm>
+#include <unordered_map>
 
+#include "CLResourceLoader.h"
 #include "CLResourceMesh.h"
 #include "CLResourceShader.h"
 #include "CLResourceTexture.h"
@@ -29,8 +33,26 @@
 using namespace std;
 namespace CLE {
 
+    //! Recursos de un tipo y la memoria que ocupan en la grafica
+    struct CLResourceMemory {
+        size_t count { 0 };
+        size_t bytes { 0 };
+    };
+
+    //! Memoria de los recursos cargados por tipo
+    struct CLResourceStats {
+        CLResourceMemory meshes;
+        CLResourceMemory textures;
+        CLResourceMemory shaders;
+        //! Recursos sin referencias esperando a liberarse
+        size_t pendingRelease { 0 };
+    };
+
     //! Clase para gestionar la lectura de recursos
     //! Esta clase engloba todos los metodos para leer diferentes tipos de archivos
+    //! Los recursos se guardan en tablas hash por su clave, que lleva las rutas de todos los ficheros y los flags de
+    //! lectura, asi dos programas con el mismo vertex shader o una malla leida con y sin flipUV no se confunden.
+    //! Los que se guardan en un CLResourceHandle se liberan unos frames despues de soltar el ultimo.
     //! @note Es singleton
     class CLResourceManager {
         public:
@@ -52,6 +74,21 @@ namespace CLE {
             //! @param file Ruta al fichero
             //! @returns Puntero a un CLE::CLResource::CLResourceMesh
             CLResourceMesh* GetResourceMesh(const std::string file);
+            //! Empieza a leer una malla en segundo plano, la lectura y las texturas van en el pool y la subida a OpenGL
+            //! en ProcessUploads. Si ya esta leida o pedida devuelve la misma
+            //! @param file Ruta al fichero
+            //! @param flipUV Bool para invertir los UV's al leer la textura
+            //! @returns future con la malla ya subida o nullptr si no se ha podido leer
+            std::shared_future<CLResourceMesh*> LoadResourceMeshAsync(const std::string file, bool flipUV);
+            //! Sube a OpenGL los recursos que ya se han leido, solo desde el hilo de render
+            void ProcessUploads() { loader.ProcessUploads(); }
+            //! Devuelve el pool de carga para decodificar otros recursos en segundo plano
+            //! @returns loader
+            CLResourceLoader& GetLoader() { return loader; }
+            //! Metodo para crear mallas generadas por codigo
+            //! @param name Nombre con el que se guarda la malla
+            //! @returns Puntero a un CLE::CLResource::CLResourceMesh vacio o al ya creado con ese nombre
+            CLResourceMesh* AddResourceMesh(const std::string name);
             //! Metodo para leer texturas
             //! @param file Ruta al fichero
             //! @param vertically Bool para poner en vertical la textura
@@ -72,23 +109,54 @@ namespace CLE {
             //! @param geometry Ruta al geometry shader
             //! @returns Puntero a un CLE::CLResource::CLResourceShader
             CLResourceShader* GetResourceShader(const std::string vertex, const std::string fragment, const std::string geometry);
-            //! Libera la memoria de una textura
+            //! Suelta una referencia de un CLResourceHandle, sin referencias el recurso se libera en CollectReleased
+            //! @param resource Recurso
+            void ReleaseResource(CLResource* resource);
+            //! Libera los recursos que llevan releaseDelay frames sin referencias, una vez por frame desde el hilo de render
+            //! Se espera para no borrar nada que use algun frame que la grafica aun no ha terminado
+            void CollectReleased();
+            //! Devuelve cuantos recursos hay cargados de cada tipo y la memoria que ocupan
+            //! @returns Estadisticas de memoria
+            CLResourceStats GetResourceStats() const;
+            //! Libera la memoria de una textura, con todos sus flags, si ningun CLResourceHandle la tiene
             //! @param file
             //! @returns bool
             bool DeleteResourceTexture(const std::string file);
-            //! Libera la memoria de una malla
+            //! Libera la memoria de una malla, con todos sus flags, si ningun CLResourceHandle la tiene
             //! @param file
             //! @returns bool
             bool DeleteResourceMesh(const std::string file);
             //! Devuelve las mallas
             //! @returns mallas
-            vector<shared_ptr<CLResourceMesh>> GetMeshes() {return meshes;}
+            vector<shared_ptr<CLResourceMesh>> GetMeshes();
+            //! Frames que espera un recurso sin referencias antes de liberarse, los que puede tener la grafica en cola
+            static constexpr unsigned int releaseDelay = 3;
         private:
             CLResourceManager();
+            //! Claves de cada tipo de recurso con todo lo que cambia el resultado de leerlo
+            static string MeshKey(const string& file, bool flipUV);
+            static string TextureKey(const string& file, bool vertically);
+            static string ShaderKey(const string& vertex, const string& fragment, const string& geometry);
+            //! Quita un recurso de las tablas si sigue guardado con su clave
+            //! @returns Si estaba
+            bool EraseResource(CLResource* resource);
+            //! Quita de la cola de liberacion los recursos que se borran a mano
+            void ForgetReleased(CLResource* resource);
             inline static CLResourceManager* instance { nullptr };
-            vector<shared_ptr<CLResourceMesh>> meshes;
-            vector<shared_ptr<CLResourceTexture>> textures;
-            vector<shared_ptr<CLResourceShader>> shaders;
+            unordered_map<string, shared_ptr<CLResourceMesh>> meshes;
+            unordered_map<string, shared_ptr<CLResourceTexture>> textures;
+            unordered_map<string, shared_ptr<CLResourceShader>> shaders;
+            //! Recurso sin referencias y frame en el que se solto
+            struct ReleasedResource {
+                CLResource* resource;
+                unsigned long long frame;
+            };
+            vector<ReleasedResource> releaseQueue;
+            unsigned long long frame { 0 };
+            //! Mallas pedidas con LoadResourceMeshAsync que aun no se han subido
+            unordered_map<string, std::shared_future<CLResourceMesh*>> pendingMeshes;
+            //! Un hilo se queda libre para el de render
+            CLResourceLoader loader { std::max(std::thread::hardware_concurrency(), 2u) - 1 };
     };
 
 }
\ No newline at end of file
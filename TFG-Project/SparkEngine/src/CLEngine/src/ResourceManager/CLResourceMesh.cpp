@@ -15,8 +15,9 @@
  */
  
 #include "CLResourceMesh.h"
+#include "CLMeshCache.h"
 
-#include <SOIL2/SOIL2.h>
+#include <algorithm>
 
 // MESH -----------------------------------------------------------------------------
 
@@ -24,7 +25,9 @@ Mesh::Mesh(vector<Vertex> vertices, vector<unsigned int> indices, vector<Texture
     this->vertices = vertices;
     this->indices = indices;
     this->textures = textures;
+}
 
+void Mesh::Upload() {
     glGenVertexArrays(1, &VAO);
     glGenBuffers(1, &VBO);
     glGenBuffers(1, &EBO);
@@ -60,11 +63,38 @@ Mesh::Mesh(vector<Vertex> vertices, vector<unsigned int> indices, vector<Texture
 using namespace CLE;
 
 bool CLResourceMesh::LoadFile(std::string file, bool flipUV) {
-    Assimp::Importer importer;
+    if (!Parse(file, flipUV))
+        return false;
+
+    Upload();
+    return true;
+}
+
+bool CLResourceMesh::Parse(const std::string& file, bool flipUV) {
     auto assimpFlags = aiProcess_Triangulate | /*aiProcess_FlipUVs | */ aiProcess_GenNormals | aiProcess_CalcTangentSpace | aiProcess_OptimizeMeshes | aiProcess_TransformUVCoords | aiProcess_JoinIdenticalVertices | aiProcess_ImproveCacheLocality | aiProcess_GenUVCoords;
 
     if (flipUV)
         assimpFlags |= aiProcess_FlipUVs;
+
+    // Si hay cache de este fichero con estos flags no se pasa por assimp, solo se decodifican las texturas
+    uint64_t sourceHash = 0;
+    bool hashed = CLMeshCache::HashFile(file, sourceHash);
+    if (hashed && CLMeshCache::Load(file, sourceHash, assimpFlags, vecMesh, minBounds, maxBounds, hasBounds)) {
+        for (const auto& mesh : vecMesh) {
+            for (const auto& texture : mesh.textures) {
+                auto loaded = std::find_if(textures_loaded.begin(), textures_loaded.end(), [&texture](const Texture& t) { return t.path == texture.path; });
+                if (loaded == textures_loaded.end()) {
+                    decodedTextures[texture.path] = DecodeTexture(texture.path.c_str());
+                    textures_loaded.push_back(texture);
+                }
+            }
+        }
+        cout << "Leida la malla de cache: " << file << endl;
+        return true;
+    }
+
+    // Cada hilo usa su propio importer, assimp no comparte estado entre ellos
+    Assimp::Importer importer;
     // Importamos el fichero.
     const aiScene* scene = importer.ReadFile(file, assimpFlags);
 
@@ -75,9 +105,65 @@ bool CLResourceMesh::LoadFile(std::string file, bool flipUV) {
     }
     cout << "Leida la malla: " << file << endl;
     processNode(scene->mRootNode, scene);
+    for (const auto& mesh : vecMesh) {
+        AddBounds(mesh.vertices);
+    }
+    if (hashed && !CLMeshCache::Save(file, sourceHash, assimpFlags, vecMesh, minBounds, maxBounds, hasBounds))
+        cout << "No se ha podido escribir la cache de la malla: " << file << endl;
     return true;
 }
 
+void CLResourceMesh::Upload() {
+    for (auto& texture : textures_loaded) {
+        auto decoded = decodedTextures.find(texture.path);
+        const CLTextureData* image = decoded != decodedTextures.end() ? decoded->second.get() : nullptr;
+        texture.id = UploadTexture(image);
+        textureMemory += TextureMemory(image);
+    }
+    decodedTextures.clear();
+
+    for (auto& mesh : vecMesh) {
+        for (auto& texture : mesh.textures) {
+            auto loaded = std::find_if(textures_loaded.begin(), textures_loaded.end(), [&texture](const Texture& t) { return t.path == texture.path; });
+            texture.id = loaded->id;
+        }
+        mesh.Upload();
+    }
+}
+
+void CLResourceMesh::LoadMesh(const vector<Vertex>& vertices, const vector<unsigned int>& indices, const string& texture) {
+    // Todas las submallas comparten la textura, solo se lee la primera vez
+    vector<Texture> textures;
+    auto loaded = std::find_if(textures_loaded.begin(), textures_loaded.end(), [&texture](const Texture& t) { return t.path == texture; });
+    if (loaded == textures_loaded.end()) {
+        Texture diffuse;
+        diffuse.id = TextureFromFile(texture.c_str(), this->directory);
+        diffuse.type = "texture_diffuse";
+        diffuse.path = texture;
+        textures_loaded.push_back(diffuse);
+        textures.push_back(diffuse);
+    } else {
+        textures.push_back(*loaded);
+    }
+
+    vecMesh.push_back(Mesh(vertices, indices, textures));
+    vecMesh.back().Upload();
+    AddBounds(vertices);
+}
+
+void CLResourceMesh::AddBounds(const vector<Vertex>& vertices) {
+    for (const auto& vertex : vertices) {
+        if (!hasBounds) {
+            minBounds = vertex.position;
+            maxBounds = vertex.position;
+            hasBounds = true;
+        } else {
+            minBounds = glm::min(minBounds, vertex.position);
+            maxBounds = glm::max(maxBounds, vertex.position);
+        }
+    }
+}
+
 void CLResourceMesh::processNode(aiNode *node, const aiScene *scene) {
     // process all the node's meshes (if any)
     for (unsigned int i = 0; i < node->mNumMeshes; i++) {
@@ -176,8 +262,10 @@ vector<Texture> CLResourceMesh::loadMaterialTextures(aiMaterial *mat, aiTextureT
             }
         }
         if (!skip) {  // if texture hasn't been loaded already, load it
+            // Aqui solo se decodifica, la textura de OpenGL se crea en Upload
             Texture texture;
-            texture.id = TextureFromFile(str.C_Str(), this->directory);
+            texture.id = 0;
+            decodedTextures[str.C_Str()] = DecodeTexture(str.C_Str());
             texture.type = typeName;
             texture.path = str.C_Str();
             textures.push_back(texture);
@@ -188,6 +276,12 @@ vector<Texture> CLResourceMesh::loadMaterialTextures(aiMaterial *mat, aiTextureT
 }
 
 unsigned int CLResourceMesh::TextureFromFile(const char *path, const string &directory, bool gamma) {
+    auto image = DecodeTexture(path);
+    textureMemory += TextureMemory(image.get());
+    return UploadTexture(image.get());
+}
+
+std::unique_ptr<CLTextureData> CLResourceMesh::DecodeTexture(const char *path) {
     string filename = string(path);
 
     //Eliminamos las rutas por si en windows hemos modelado dentro de una carpeta
@@ -203,38 +297,44 @@ unsigned int CLResourceMesh::TextureFromFile(const char *path, const string &dir
 
     filename = "media/" + filename;
 
+    // Se lee de la cache con los mipmaps ya generados, la primera vez se convierte
+    auto image = CLTextureData::Load(filename);
+    if (!image) {
+        std::cout << "Texture failed to load at path: " << filename << std::endl;
+    }
+    return image;
+}
+
+unsigned int CLResourceMesh::UploadTexture(const CLTextureData* image) {
     unsigned int textureID;
     glGenTextures(1, &textureID);
 
-    int width, height, nrComponents;
-    unsigned char *data = SOIL_load_image(filename.c_str(), &width, &height, &nrComponents, 0);
-    if (data) {
-        GLenum format = 0;
-        if (nrComponents == 1)
-            format = GL_RED;
-        else if (nrComponents == 3)
-            format = GL_RGB;
-        else if (nrComponents == 4)
-            format = GL_RGBA;
-
+    if (image) {
         glBindTexture(GL_TEXTURE_2D, textureID);
-        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
+        image->Upload(GL_TEXTURE_2D);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, image->GetLevels() - 1);
 
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-        SOIL_free_image_data(data);
-    } else {
-        std::cout << "Texture failed to load at path: " << filename << std::endl;
-        SOIL_free_image_data(data);
     }
 
     return textureID;
 }
 
+size_t CLResourceMesh::TextureMemory(const CLTextureData* image) {
+    return image ? image->GetMemoryUsage() : 0;
+}
+
+size_t CLResourceMesh::GetMemoryUsage() const {
+    size_t bytes = textureMemory;
+    for (const auto& mesh : vecMesh) {
+        bytes += mesh.vertices.size() * sizeof(Vertex) + mesh.indices.size() * sizeof(unsigned int);
+    }
+    return bytes;
+}
+
 void CLResourceMesh::Draw(GLuint shaderID) {
     for (auto &mesh : vecMesh) {
 
@@ -262,7 +362,7 @@ void CLResourceMesh::Draw(GLuint shaderID) {
         //glBindTexture(GL_TEXTURE_CUBE_MAP, CLShadowMapping::depthCubemap);
         glActiveTexture(GL_TEXTURE1);
         glUniform1i(glGetUniformLocation(shaderID, "depthMap"), 1);
-        glBindTexture(GL_TEXTURE_2D, CLShadowMapping::depthMap);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, CLShadowMapping::depthMap);
 
         glBindVertexArray(mesh.VAO);
         glDrawElements(GL_TRIANGLES, mesh.indices.size(), GL_UNSIGNED_INT, 0);
@@ -17,10 +17,13 @@
 #pragma once
 
 #include "CLResource.h"
+#include "CLResourceLoader.h"
+#include "CLTextureCache.h"
 
 #include <ASSIMP/Importer.hpp>
 #include <ASSIMP/scene.h>
 #include <ASSIMP/postprocess.h>
+#include <map>
 #include <vector>
 #include <stddef.h>     /* offsetof */
 
@@ -44,11 +47,14 @@ struct Texture {
 };
 
 //! Clase auxiliar para manejar mas facil las submallas de una malla que leemos
+//! Se construye solo con los datos en memoria, los buffers de OpenGL se crean en Upload
 class Mesh{
     public:
         Mesh() {};
         Mesh(vector<Vertex> vertices, vector<unsigned int> indices, vector<Texture> textures);
         ~Mesh(){};
+        //! Crea el VAO, VBO y EBO con los vertices e indices, solo desde el hilo de render
+        void Upload();
         /*  Mesh Data  */
         vector<Vertex> vertices;
         vector<unsigned int> indices;
@@ -64,27 +70,68 @@ namespace CLE {
         public:
             CLResourceMesh(){};
             ~CLResourceMesh(){
-                for(auto mesh : vecMesh){
-                    glDeleteTextures(1,&mesh.textures.at(0).id);
+                // Las submallas comparten texturas, se borra cada una una sola vez
+                for(auto& texture : textures_loaded){
+                    if(texture.id)
+                        glDeleteTextures(1,&texture.id);
+                }
+                for(auto& mesh : vecMesh){
                     glDeleteBuffers(1,&mesh.VBO);
                     glDeleteBuffers(1,&mesh.EBO);
                     glDeleteVertexArrays(1,&mesh.VAO);
                 }
             };
             void Draw(GLuint shaderID) override;
+            //! @returns Bytes de los buffers de vertices e indices y de las texturas con sus mipmaps
+            size_t GetMemoryUsage() const override;
+            //! Lee la malla y la sube a OpenGL, solo desde el hilo de render
             bool LoadFile(std::string, bool) override;
+            //! Lee la malla con assimp y decodifica sus texturas sin usar OpenGL, se puede llamar desde cualquier hilo
+            //! @param file Ruta al fichero
+            //! @param flipUV Bool para invertir los UV's al leer la textura
+            //! @returns Si se ha podido leer
+            bool Parse(const std::string& file, bool flipUV);
+            //! Crea las texturas y los buffers de lo leido en Parse y libera las imagenes, solo desde el hilo de render
+            void Upload();
+            //! Anade una submalla generada por codigo en lugar de leida con assimp
+            //! @param vertices Vertices de la submalla
+            //! @param indices Indices de los triangulos
+            //! @param texture Nombre de la textura difusa dentro de media/
+            void LoadMesh(const vector<Vertex>& vertices, const vector<unsigned int>& indices, const string& texture);
             void DrawDepthMap(GLuint shaderID);
             vector<Mesh> GetvectorMesh() { return vecMesh; }
             vector<Mesh> &GetvectorMeshRef() { return vecMesh; }
             vector<Mesh> *GetvectorMeshPtr() { return &vecMesh; }
+            //! Devuelve si la malla tiene vertices para sacar su caja
+            bool HasBounds() const { return hasBounds; }
+            //! Devuelve el vertice menor de la caja de la malla en espacio local
+            const glm::vec3& GetMinBounds() const { return minBounds; }
+            //! Devuelve el vertice mayor de la caja de la malla en espacio local
+            const glm::vec3& GetMaxBounds() const { return maxBounds; }
         private:
+            //! Amplia la caja de la malla con los vertices de una submalla
+            void AddBounds(const vector<Vertex>& vertices);
             void processNode(aiNode *node, const aiScene *scene);
             Mesh processMesh(aiMesh *mesh, const aiScene *scene);
             vector<Texture> loadMaterialTextures(aiMaterial *mat, aiTextureType type, string typeName);
             unsigned int TextureFromFile(const char *path, const string &directory, bool gamma = false);
+            //! Lee una textura de la carpeta media con sus mipmaps sin usar OpenGL
+            static std::unique_ptr<CLTextureData> DecodeTexture(const char *path);
+            //! Crea la textura de OpenGL con todos los niveles ya generados
+            static unsigned int UploadTexture(const CLTextureData* image);
+            //! Memoria que ocupa en la grafica una textura con sus mipmaps
+            static size_t TextureMemory(const CLTextureData* image);
             vector<Mesh> vecMesh;
             vector<Texture> textures_loaded;
             string directory;
+            // Texturas decodificadas en Parse a la espera de Upload, por ruta
+            std::map<string, std::unique_ptr<CLTextureData>> decodedTextures;
             bool gammaCorrection = true;
+            // Bytes de las texturas subidas
+            size_t textureMemory { 0 };
+            // Caja de todas las submallas, se calcula al cargarlas
+            glm::vec3 minBounds {0.f,0.f,0.f};
+            glm::vec3 maxBounds {0.f,0.f,0.f};
+            bool hasBounds { false };
     };
 }
\ No newline at end of file
@@ -22,45 +22,30 @@ bool CLResourceTexture::LoadFile(string file, bool vertically){
 
     glGenTextures(1, &textureID);
 
-    int width, height, nrComponents;
-    
     //stbi_set_flip_vertically_on_load(false);
     if(vertically) {
         //stbi_set_flip_vertically_on_load(true);
     }
-    unsigned char *data = SOIL_load_image(file.c_str(), &width, &height, &nrComponents, 0);
-    widthText = width;
-    heightText = height;
-    
-    if (data)
-    {
-        GLenum format;
-        if (nrComponents == 1)
-            format = GL_RED;
-        else if (nrComponents == 3)
-            format = GL_RGB;
-        else if (nrComponents == 4)
-            format = GL_RGBA;
-        else
-            return false;
-
-        glBindTexture(GL_TEXTURE_2D, textureID);
-        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D); 
-
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE); 
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-        SOIL_free_image_data(data);
-    }
-    else
+    // Se lee de la cache con los mipmaps ya generados, la primera vez se convierte
+    auto image = CLTextureData::Load(file);
+    if (!image)
     {
         std::cout << "Texture failed to load at path: " << file << std::endl;
-        SOIL_free_image_data(data);
         return false;
     }
+    widthText = image->levels[0].width;
+    heightText = image->levels[0].height;
+
+    glBindTexture(GL_TEXTURE_2D, textureID);
+    image->Upload(GL_TEXTURE_2D);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, image->GetLevels() - 1);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE); 
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    memoryUsage = image->GetMemoryUsage();
     return true;
 }
 
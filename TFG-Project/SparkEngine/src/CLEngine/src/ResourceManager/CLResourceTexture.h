@@ -17,6 +17,7 @@
 #pragma once
 
 #include "CLResource.h"
+#include "CLTextureCache.h"
 #include <fstream>
 #include <sstream>
 #include <string>
@@ -39,12 +40,15 @@ namespace CLE {
             unsigned int GetTextureID() { return textureID; };
             int GetWidth(){ return widthText; };
             int GetHeight(){ return heightText; };
+            //! @returns Bytes de la textura con sus mipmaps
+            size_t GetMemoryUsage() const override { return memoryUsage; }
 
          private:
             unsigned int textureID = 0;
             string type;
             int widthText = 0;
             int heightText = 0;
+            size_t memoryUsage = 0;
     };
 
 }
\ No newline at end of file
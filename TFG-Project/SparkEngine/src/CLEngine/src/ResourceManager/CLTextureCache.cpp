@@ -0,0 +1,314 @@
+/**
+ * Beast Brawl
+ * Game created as a final project of the Multimedia Engineering Degree in the University of Alicante.
+ * Made by Clover Games Studio, with members 
+ * Carlos de la Fuente Torres delafuentetorresc@gmail.com,
+ * Antonio Jose Martinez Garcia https://www.linkedin.com/in/antonio-jose-martinez-garcia/,
+ * Jesús Mas Carretero jmasc03@gmail.com, 
+ * Judith Mula Molina https://www.linkedin.com/in/judith-mm-18099215a/, 
+ * Rubén Rubio Martínez https://www.linkedin.com/in/rub%C3%A9n-rubio-mart%C3%ADnez-938700131/, 
+ * and Jose Valdés Sirvent https://www.linkedin.com/in/jose-f-valdés-sirvent-6058b5a5/ github -> josefrvaldes
+ * 
+ * 
+ * @author Clover Games Studio
+ * 
+ */
+ 
+#include "CLTextureCache.h"
+#include "CLMeshCache.h"
+
+extern "C" {
+#include <SOIL2/image_DXT.h>
+}
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <thread>
+
+using namespace CLE;
+
+namespace {
+    constexpr unsigned int FourCC(char a, char b, char c, char d) {
+        return static_cast<unsigned int>(a) | (static_cast<unsigned int>(b) << 8) | (static_cast<unsigned int>(c) << 16) | (static_cast<unsigned int>(d) << 24);
+    }
+
+    //! Marca de los DDS escritos por la cache en el primer campo reservado
+    constexpr unsigned int cacheTag = FourCC('C', 'L', 'T', 'X');
+
+    //! Campos reservados de la cabecera que usa la cache
+    enum ReservedField { TAG, VERSION, OPTIONS, HASH_LOW, HASH_HIGH, COMPONENTS };
+
+    //! Bytes de un nivel segun su formato
+    size_t LevelSize(int width, int height, int components, GLenum compressedFormat) {
+        if (compressedFormat) {
+            size_t blockSize = (compressedFormat == GL_COMPRESSED_RGB_S3TC_DXT1_EXT) ? 8 : 16;
+            return static_cast<size_t>((width + 3) / 4) * ((height + 3) / 4) * blockSize;
+        }
+        return static_cast<size_t>(width) * height * components;
+    }
+
+    GLenum UncompressedFormat(int components) {
+        switch (components) {
+            case 1: return GL_RED;
+            case 3: return GL_RGB;
+            case 4: return GL_RGBA;
+            default: return 0;
+        }
+    }
+
+    //! Reduce un nivel a la mitad haciendo la media de cada bloque de 2x2, en los lados impares se repite el borde
+    CLTextureData::Level Downsample(const CLTextureData::Level& source, int components) {
+        CLTextureData::Level level;
+        level.width = std::max(1, source.width / 2);
+        level.height = std::max(1, source.height / 2);
+        level.data.resize(static_cast<size_t>(level.width) * level.height * components);
+
+        for (int y = 0; y < level.height; ++y) {
+            int y0 = std::min(y * 2, source.height - 1);
+            int y1 = std::min(y * 2 + 1, source.height - 1);
+            for (int x = 0; x < level.width; ++x) {
+                int x0 = std::min(x * 2, source.width - 1);
+                int x1 = std::min(x * 2 + 1, source.width - 1);
+                for (int c = 0; c < components; ++c) {
+                    unsigned int sum = source.data[(static_cast<size_t>(y0) * source.width + x0) * components + c]
+                        + source.data[(static_cast<size_t>(y0) * source.width + x1) * components + c]
+                        + source.data[(static_cast<size_t>(y1) * source.width + x0) * components + c]
+                        + source.data[(static_cast<size_t>(y1) * source.width + x1) * components + c];
+                    level.data[(static_cast<size_t>(y) * level.width + x) * components + c] = static_cast<unsigned char>((sum + 2) / 4);
+                }
+            }
+        }
+        return level;
+    }
+}
+
+// -----------------------------------------
+// -----------Struct CLTextureData----------
+// -----------------------------------------
+
+std::unique_ptr<CLTextureData> CLTextureData::Load(const std::string& file, bool mipmaps) {
+    uint32_t options = (mipmaps ? CLTextureCache::optionMipmaps : 0) | (CLTextureCache::SupportsCompression() ? CLTextureCache::optionCompress : 0);
+
+    uint64_t sourceHash = 0;
+    bool hashed = CLMeshCache::HashFile(file, sourceHash);
+    if (hashed) {
+        auto cached = CLTextureCache::Load(file, sourceHash, options);
+        if (cached)
+            return cached;
+    }
+
+    auto image = CLImageData::Decode(file);
+    if (!image)
+        return nullptr;
+
+    auto texture = CLTextureCache::Convert(*image, options);
+    if (texture && hashed && !CLTextureCache::Save(file, sourceHash, options, *texture))
+        std::cout << "No se ha podido escribir la cache de la textura: " << file << std::endl;
+    return texture;
+}
+
+void CLTextureData::Upload(GLenum target) const {
+    // Las filas de los niveles pequenos no estan alineadas a 4 bytes
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    for (size_t i = 0; i < levels.size(); ++i) {
+        const auto& level = levels[i];
+        if (compressedFormat) {
+            glCompressedTexImage2D(target, static_cast<GLint>(i), compressedFormat, level.width, level.height, 0, static_cast<GLsizei>(level.data.size()), level.data.data());
+        } else {
+            glTexImage2D(target, static_cast<GLint>(i), format, level.width, level.height, 0, format, GL_UNSIGNED_BYTE, level.data.data());
+        }
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+}
+
+size_t CLTextureData::GetMemoryUsage() const {
+    size_t bytes = 0;
+    for (const auto& level : levels)
+        bytes += level.data.size();
+    return bytes;
+}
+
+// -----------------------------------------
+// ----------Clase CLTextureCache-----------
+// -----------------------------------------
+
+bool CLTextureCache::SupportsCompression() {
+    return GLEW_EXT_texture_compression_s3tc;
+}
+
+std::unique_ptr<CLTextureData> CLTextureCache::Convert(const CLImageData& image, uint32_t options) {
+    GLenum format = UncompressedFormat(image.components);
+    if (!format || !image.data)
+        return nullptr;
+
+    auto texture = std::make_unique<CLTextureData>();
+    texture->components = image.components;
+    texture->format = format;
+
+    CLTextureData::Level base;
+    base.width = image.width;
+    base.height = image.height;
+    base.data.assign(image.data, image.data + static_cast<size_t>(image.width) * image.height * image.components);
+    texture->levels.push_back(std::move(base));
+
+    if (options & optionMipmaps) {
+        while (texture->levels.back().width > 1 || texture->levels.back().height > 1)
+            texture->levels.push_back(Downsample(texture->levels.back(), image.components));
+    }
+
+    // Las de un canal se quedan sin comprimir
+    if (!(options & optionCompress) || image.components < 3)
+        return texture;
+
+    GLenum compressedFormat = (image.components == 3) ? GL_COMPRESSED_RGB_S3TC_DXT1_EXT : GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+    std::vector<std::vector<unsigned char>> compressed;
+    for (const auto& level : texture->levels) {
+        int size = 0;
+        unsigned char* data = (image.components == 3)
+            ? convert_image_to_DXT1(level.data.data(), level.width, level.height, image.components, &size)
+            : convert_image_to_DXT5(level.data.data(), level.width, level.height, image.components, &size);
+
+        // Si algun nivel falla se deja todo sin comprimir
+        bool valid = data && static_cast<size_t>(size) == LevelSize(level.width, level.height, image.components, compressedFormat);
+        if (valid)
+            compressed.emplace_back(data, data + size);
+        free(data);
+        if (!valid)
+            return texture;
+    }
+
+    for (size_t i = 0; i < compressed.size(); ++i)
+        texture->levels[i].data = std::move(compressed[i]);
+    texture->compressedFormat = compressedFormat;
+    return texture;
+}
+
+std::unique_ptr<CLTextureData> CLTextureCache::Load(const std::string& file, uint64_t sourceHash, uint32_t options) {
+    CLMappedFile cache;
+    if (!cache.Open(GetCachePath(file)) || cache.GetSize() < sizeof(DDS_header))
+        return nullptr;
+
+    DDS_header header;
+    std::memcpy(&header, cache.GetData(), sizeof(header));
+    if (header.dwMagic != FourCC('D', 'D', 'S', ' ') || header.dwSize != 124 ||
+        header.dwReserved1[TAG] != cacheTag || header.dwReserved1[VERSION] != version || header.dwReserved1[OPTIONS] != options ||
+        header.dwReserved1[HASH_LOW] != static_cast<unsigned int>(sourceHash) || header.dwReserved1[HASH_HIGH] != static_cast<unsigned int>(sourceHash >> 32))
+        return nullptr;
+
+    auto texture = std::make_unique<CLTextureData>();
+    texture->components = static_cast<int>(header.dwReserved1[COMPONENTS]);
+    texture->format = UncompressedFormat(texture->components);
+    if (!texture->format)
+        return nullptr;
+
+    if (header.sPixelFormat.dwFlags & DDPF_FOURCC) {
+        if (header.sPixelFormat.dwFourCC == FourCC('D', 'X', 'T', '1'))
+            texture->compressedFormat = GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+        else if (header.sPixelFormat.dwFourCC == FourCC('D', 'X', 'T', '5'))
+            texture->compressedFormat = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+        else
+            return nullptr;
+    }
+
+    // Se comprueba que cada nivel cabe en el fichero y que no sobra nada
+    size_t offset = sizeof(DDS_header);
+    int width = static_cast<int>(header.dwWidth);
+    int height = static_cast<int>(header.dwHeight);
+    unsigned int numLevels = std::max(header.dwMipMapCount, 1u);
+    if (width < 1 || height < 1 || numLevels > 32)
+        return nullptr;
+    for (unsigned int i = 0; i < numLevels; ++i) {
+        CLTextureData::Level level;
+        level.width = width;
+        level.height = height;
+        size_t size = LevelSize(width, height, texture->components, texture->compressedFormat);
+        if (size > cache.GetSize() - offset)
+            return nullptr;
+        level.data.assign(cache.GetData() + offset, cache.GetData() + offset + size);
+        offset += size;
+        texture->levels.push_back(std::move(level));
+
+        width = std::max(1, width / 2);
+        height = std::max(1, height / 2);
+    }
+    if (offset != cache.GetSize())
+        return nullptr;
+
+    return texture;
+}
+
+bool CLTextureCache::Save(const std::string& file, uint64_t sourceHash, uint32_t options, const CLTextureData& texture) {
+    if (texture.levels.empty())
+        return false;
+
+    DDS_header header;
+    std::memset(&header, 0, sizeof(header));
+    header.dwMagic = FourCC('D', 'D', 'S', ' ');
+    header.dwSize = 124;
+    header.dwFlags = DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT | DDSD_MIPMAPCOUNT;
+    header.dwWidth = texture.levels[0].width;
+    header.dwHeight = texture.levels[0].height;
+    header.dwMipMapCount = static_cast<unsigned int>(texture.levels.size());
+    header.sPixelFormat.dwSize = 32;
+    header.sCaps.dwCaps1 = DDSCAPS_TEXTURE | (texture.levels.size() > 1 ? DDSCAPS_COMPLEX | DDSCAPS_MIPMAP : 0);
+
+    if (texture.compressedFormat) {
+        header.dwFlags |= DDSD_LINEARSIZE;
+        header.dwPitchOrLinearSize = static_cast<unsigned int>(texture.levels[0].data.size());
+        header.sPixelFormat.dwFlags = DDPF_FOURCC;
+        header.sPixelFormat.dwFourCC = (texture.compressedFormat == GL_COMPRESSED_RGB_S3TC_DXT1_EXT) ? FourCC('D', 'X', 'T', '1') : FourCC('D', 'X', 'T', '5');
+    } else {
+        // Los bytes van en orden RGB(A), las mascaras lo indican para otras herramientas
+        header.dwFlags |= DDSD_PITCH;
+        header.dwPitchOrLinearSize = static_cast<unsigned int>(texture.levels[0].width * texture.components);
+        header.sPixelFormat.dwFlags = (texture.components == 1) ? DDPF_LUMINANCE : DDPF_RGB;
+        header.sPixelFormat.dwRGBBitCount = texture.components * 8;
+        header.sPixelFormat.dwRBitMask = 0x000000ff;
+        if (texture.components >= 3) {
+            header.sPixelFormat.dwGBitMask = 0x0000ff00;
+            header.sPixelFormat.dwBBitMask = 0x00ff0000;
+        }
+        if (texture.components == 4) {
+            header.sPixelFormat.dwFlags |= DDPF_ALPHAPIXELS;
+            header.sPixelFormat.dwAlphaBitMask = 0xff000000;
+        }
+    }
+
+    header.dwReserved1[TAG] = cacheTag;
+    header.dwReserved1[VERSION] = version;
+    header.dwReserved1[OPTIONS] = options;
+    header.dwReserved1[HASH_LOW] = static_cast<unsigned int>(sourceHash);
+    header.dwReserved1[HASH_HIGH] = static_cast<unsigned int>(sourceHash >> 32);
+    header.dwReserved1[COMPONENTS] = static_cast<unsigned int>(texture.components);
+
+    // Varias mallas pueden convertir la misma textura a la vez, cada hilo escribe su temporal y se renombra
+    std::string path = GetCachePath(file);
+    std::string temporal = path + ".tmp" + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+    bool written = false;
+    {
+        std::ofstream out(temporal, std::ios::binary | std::ios::trunc);
+        if (!out)
+            return false;
+
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        for (const auto& level : texture.levels)
+            out.write(reinterpret_cast<const char*>(level.data.data()), level.data.size());
+        written = static_cast<bool>(out);
+    }
+    if (!written) {
+        std::remove(temporal.c_str());
+        return false;
+    }
+
+    std::remove(path.c_str());
+    if (std::rename(temporal.c_str(), path.c_str()) != 0) {
+        std::remove(temporal.c_str());
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,105 @@
+/**
+ * Beast Brawl
+ * Game created as a final project of the Multimedia Engineering Degree in the University of Alicante.
+ * Made by Clover Games Studio, with members 
+ * Carlos de la Fuente Torres delafuentetorresc@gmail.com,
+ * Antonio Jose Martinez Garcia https://www.linkedin.com/in/antonio-jose-martinez-garcia/,
+ * Jesús Mas Carretero jmasc03@gmail.com, 
+ * Judith Mula Molina https://www.linkedin.com/in/judith-mm-18099215a/, 
+ * Rubén Rubio Martínez https://www.linkedin.com/in/rub%C3%A9n-rubio-mart%C3%ADnez-938700131/, 
+ * and Jose Valdés Sirvent https://www.linkedin.com/in/jose-f-valdés-sirvent-6058b5a5/ github -> josefrvaldes
+ * 
+ * 
+ * @author Clover Games Studio
+ * 
+ */
+ 
+ 
+#pragma once
+
+#include "CLResourceLoader.h"
+
+#include <GL/glew.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace CLE {
+
+    //! Textura lista para subir a OpenGL: su cadena de mipmaps ya generada, comprimida en BCn o sin comprimir
+    struct CLTextureData {
+        //! Nivel de la cadena de mipmaps
+        struct Level {
+            int width { 0 };
+            int height { 0 };
+            std::vector<unsigned char> data;
+        };
+
+        //! Lee la textura de la cache o la convierte desde la imagen original y guarda la cache, desde cualquier hilo
+        //! @param file Ruta a la imagen original
+        //! @param mipmaps Si se genera la cadena de mipmaps entera o solo el primer nivel
+        //! @returns La textura, nullptr si no se ha podido leer
+        static std::unique_ptr<CLTextureData> Load(const std::string& file, bool mipmaps = true);
+
+        //! Sube todos los niveles al target ligado, solo desde el hilo de render
+        //! El GL_TEXTURE_MAX_LEVEL lo pone quien llama, GetLevels() - 1
+        //! @param target GL_TEXTURE_2D o una cara de un cubemap
+        void Upload(GLenum target) const;
+
+        //! @returns Numero de niveles de mipmaps
+        int GetLevels() const { return static_cast<int>(levels.size()); }
+        //! @returns Bytes que ocupa en la grafica
+        size_t GetMemoryUsage() const;
+
+        std::vector<Level> levels;
+        int components { 0 };
+        //! Formato de OpenGL sin comprimir segun los canales
+        GLenum format { 0 };
+        //! Formato comprimido, 0 si los niveles van sin comprimir
+        GLenum compressedFormat { 0 };
+    };
+
+    //! Cache en disco de las texturas convertidas
+    //! Cada imagen se convierte una vez a un DDS junto al original con los mipmaps ya generados, en DXT1 las de tres
+    //! canales y DXT5 las de cuatro si la grafica lo soporta, sin comprimir si no. Los campos reservados de la cabecera
+    //! llevan la version, las opciones de conversion y un hash de la imagen original, si algo cambia se vuelve a convertir.
+    class CLTextureCache {
+        public:
+            //! Version de la conversion, se sube al cambiarla
+            static constexpr uint32_t version = 1;
+            //! Opciones de conversion
+            static constexpr uint32_t optionMipmaps = 1;
+            static constexpr uint32_t optionCompress = 2;
+
+            //! @param file Ruta a la imagen original
+            //! @returns Ruta de su cache
+            static std::string GetCachePath(const std::string& file) { return file + ".cache.dds"; }
+
+            //! @returns Si la grafica puede usar texturas DXT
+            static bool SupportsCompression();
+
+            //! Lee la cache de una imagen si es valida
+            //! @param file Ruta a la imagen original
+            //! @param sourceHash Hash de la imagen original
+            //! @param options Opciones de conversion
+            //! @returns La textura, nullptr si no hay cache o no es de esta imagen con estas opciones
+            static std::unique_ptr<CLTextureData> Load(const std::string& file, uint64_t sourceHash, uint32_t options);
+
+            //! Escribe la cache de una imagen
+            //! @param file Ruta a la imagen original
+            //! @param sourceHash Hash de la imagen original
+            //! @param options Opciones con las que se ha convertido
+            //! @param texture Textura convertida
+            //! @returns Si se ha podido escribir
+            static bool Save(const std::string& file, uint64_t sourceHash, uint32_t options, const CLTextureData& texture);
+
+            //! Genera los mipmaps de una imagen y los comprime
+            //! @param image Imagen decodificada
+            //! @param options Opciones de conversion
+            //! @returns La textura, nullptr si el formato no se soporta
+            static std::unique_ptr<CLTextureData> Convert(const CLImageData& image, uint32_t options);
+    };
+}
@@ -25,7 +25,7 @@ CLE::CLBillboard::CLBillboard(unsigned int id,CLResourceTexture* texture_, float
 }
 
 void CLE::CLBillboard::Draw(GLuint shaderID){
-    if(texture != nullptr){
+    if(texture){
         glEnable(GL_BLEND);
         glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
         glUniform1f(glGetUniformLocation(shaderID, "width"), width);
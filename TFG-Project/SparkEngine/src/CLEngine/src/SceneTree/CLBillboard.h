@@ -19,6 +19,7 @@
 #include "CLEntity.h"
 #include "../ResourceManager/CLResourceMesh.h"
 #include "../ResourceManager/CLResourceTexture.h"
+#include "../ResourceManager/CLResourceHandle.h"
 
 namespace CLE {
     //! Clase para añadir billboards
@@ -37,12 +38,12 @@ namespace CLE {
             void DrawDepthMap(GLuint shaderID) {};
             //! Devuelve la textura
             //! @returns texture El objeto CLResourceTexture
-            CLResourceTexture* getTexture(){ return texture;};
+            CLResourceTexture* getTexture(){ return texture.Get();};
             //! Asigna una textura
             //! @param t Objeto de la textura
             void setTexture(CLResourceTexture* t) { texture = t;};
         private:
-            CLResourceTexture*  texture = nullptr;
+            CLResourceHandle<CLResourceTexture> texture;
             //Placeholder para mandar algo por el VAO si no no dibuja
             float position[6] = {
                 1.0,1.0,1.0,
@@ -66,6 +66,12 @@ namespace CLE {
             //! @returns cameraTarget
             glm::vec3 GetCameraTarget()      { return cameraTarget; };
             float GetCameraFov()      { return fov; };
+            //! Devuelve la distancia al plano near
+            //! @returns m_near
+            float GetNear() const     { return m_near; };
+            //! Devuelve la distancia al plano far
+            //! @returns m_far
+            float GetFar() const      { return m_far; };
             glm::vec3 GetCameraUp()         { return cameraUp; };
             void Draw(GLuint shaderID);
             void DrawDepthMap (GLuint shaderID);
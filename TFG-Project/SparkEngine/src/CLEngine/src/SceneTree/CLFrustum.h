@@ -0,0 +1,58 @@
+/**
+ * Beast Brawl
+ * Game created as a final project of the Multimedia Engineering Degree in the University of Alicante.
+ * Made by Clover Games Studio, with members 
+ * Carlos de la Fuente Torres delafuentetorresc@gmail.com,
+ * Antonio Jose Martinez Garcia https://www.linkedin.com/in/antonio-jose-martinez-garcia/,
+ * Jesús Mas Carretero jmasc03@gmail.com, 
+ * Judith Mula Molina https://www.linkedin.com/in/judith-mm-18099215a/, 
+ * Rubén Rubio Martínez https://www.linkedin.com/in/rub%C3%A9n-rubio-mart%C3%ADnez-938700131/, 
+ * and Jose Valdés Sirvent https://www.linkedin.com/in/jose-f-valdés-sirvent-6058b5a5/ github -> josefrvaldes
+ * 
+ * 
+ * @author Clover Games Studio
+ * 
+ */
+ 
+ 
+#pragma once
+
+#include <GLM/glm.hpp>
+
+namespace CLE {
+
+//! Planos de un frustum sacados de una matriz de vista y proyeccion
+//! Sirve tanto para la camara como para la proyeccion ortografica de la luz de las sombras
+class CLFrustum {
+    public:
+        //! Saca los 6 planos de la matriz, las normales apuntan hacia dentro
+        //! @param VPmatrix Matriz projection * view
+        explicit CLFrustum(const glm::mat4& VPmatrix) {
+            glm::mat4 m = glm::transpose(VPmatrix);
+            planes[0] = m[3] + m[0]; // izquierda
+            planes[1] = m[3] - m[0]; // derecha
+            planes[2] = m[3] + m[1]; // abajo
+            planes[3] = m[3] - m[1]; // arriba
+            planes[4] = m[3] + m[2]; // near
+            planes[5] = m[3] - m[2]; // far
+        }
+
+        //! Comprueba si una caja alineada con los ejes esta dentro del frustum o lo corta
+        //! Solo se mira el vertice de la caja mas adentro de cada plano, puede dar cajas de las esquinas como visibles
+        //! @param min Vertice menor de la caja
+        //! @param max Vertice mayor de la caja
+        //! @returns bool Si hay que dibujarla
+        bool IntersectsAABB(const glm::vec3& min, const glm::vec3& max) const {
+            for (const auto& plane : planes) {
+                glm::vec3 inside(plane.x > 0 ? max.x : min.x, plane.y > 0 ? max.y : min.y, plane.z > 0 ? max.z : min.z);
+                if (glm::dot(glm::vec3(plane), inside) + plane.w < 0)
+                    return false;
+            }
+            return true;
+        }
+
+    private:
+        glm::vec4 planes[6];
+};
+
+}
@@ -19,6 +19,7 @@
 
 #include "../ResourceManager/CLResourceMesh.h"
 #include "../ResourceManager/CLResourceTexture.h"
+#include "../ResourceManager/CLResourceHandle.h"
 #include "CLEntity.h"
 
 #include <memory>
@@ -33,18 +34,18 @@ class CLMesh : public CLEntity {
         CLMesh();
         CLMesh(unsigned int idEntity) : CLEntity(idEntity){};
         ~CLMesh(){};
-        //! Asigna una malla
+        //! Asigna una malla, la malla no se libera mientras la tenga
         //! @param m Objecto CLResourceMesh donde tiene la malla
         void SetMesh(CLResourceMesh* m) { mesh = m; }
         //GETTERS
         //! Devuelve la malla
         //! @returns mesh Objeto CLResourceMesh almacenado
-        CLResourceMesh* GetMesh() const { return mesh; }
+        CLResourceMesh* GetMesh() const { return mesh.Get(); }
         void Draw(GLuint shaderID);
         void DrawDepthMap(GLuint shaderID);
 
     private:
-        CLResourceMesh* mesh = nullptr;
+        CLResourceHandle<CLResourceMesh> mesh;
         CLResourceMesh* nextMesh = nullptr;
         CLResourceTexture* texture = nullptr;
 };
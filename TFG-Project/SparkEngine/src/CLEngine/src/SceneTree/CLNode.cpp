@@ -40,6 +40,8 @@ CLNode::CLNode(shared_ptr<CLEntity> entity) : CLNode() {
 void CLNode::AddChild(shared_ptr<CLNode> child){
     childs.push_back(child);
     child->SetFather(this);
+    child->ActivateFlag();
+    ActivateTreeFlag();
 }
 
 bool CLNode::RemoveChild(CLNode* child){
@@ -48,6 +50,7 @@ bool CLNode::RemoveChild(CLNode* child){
     for(unsigned int i = 0; i<childs.size(); ++i){
         if(child == childs[i].get()){
             childs.erase(childs.begin()+i);
+            ActivateTreeFlag();
             return true;
         }
     }
@@ -66,33 +69,18 @@ bool CLNode::HasChild(CLNode* child){
 }
 
 glm::vec3 CLNode::GetGlobalTranslation() const{
-    glm::vec3 dev = this->translation;
-    auto fatherNode = this->father;
-    while(fatherNode){
-        dev += fatherNode->GetTranslation();
-        fatherNode = fatherNode->GetFather();
-    }
-    return dev;
+    UpdateTransform();
+    return globalTranslation;
 }
 
 glm::vec3 CLNode::GetGlobalRotation() const{
-    glm::vec3 dev = this->rotation;
-    auto fatherNode = this->father;
-    while(fatherNode){
-        dev += fatherNode->GetRotation();
-        fatherNode = fatherNode->GetFather();
-    }
-    return dev;
+    UpdateTransform();
+    return globalRotation;
 }
 
 glm::vec3 CLNode::GetGlobalScalation() const{
-    glm::vec3 dev = this->scalation;
-    auto fatherNode = this->father;
-    while(fatherNode){
-        dev += fatherNode->GetScalation();
-        fatherNode = fatherNode->GetFather();
-    }
-    return dev;
+    UpdateTransform();
+    return globalScalation;
 }
 
 void CLNode::SetTranslation(glm::vec3 t) {
@@ -111,20 +99,111 @@ void CLNode::SetScalation(glm::vec3 s) {
 }
 
 void CLNode::ActivateFlag() {
+    if (isStatic)
+        staticChanged = true;
+
+    // Si ya estaba marcado sus hijos tambien lo estan
+    if (changed)
+        return;
+
     changed = true;
-    for (auto node : childs) {
+    for (const auto& node : childs) {
         node->ActivateFlag();
     }
-    return;
 }
 
-glm::mat4 CLNode::TranslateMatrix(){
+void CLNode::ActivateTreeFlag() {
+    auto root = this;
+    while (root->father) {
+        root = root->father;
+    }
+    root->treeChanged = true;
+    staticChanged = true;
+}
+
+void CLNode::UpdateTransform() const {
+    if (!changed)
+        return;
+
+    // Traslacion, rotacion y escalado globales se suman con los del padre
+    if (father) {
+        father->UpdateTransform();
+        transformationMat = father->transformationMat * CalculateTransformationMatrix();
+        globalTranslation = translation + father->globalTranslation;
+        globalRotation = rotation + father->globalRotation;
+        globalScalation = scalation + father->globalScalation;
+    } else {
+        transformationMat = CalculateTransformationMatrix();
+        globalTranslation = translation;
+        globalRotation = rotation;
+        globalScalation = scalation;
+    }
+    changed = false;
+    boundsChanged = true;
+}
+
+bool CLNode::GetWorldBounds(glm::vec3& min, glm::vec3& max) const {
+    auto mesh = dynamic_cast<CLMesh*>(entity.get());
+    if (!mesh || !mesh->GetMesh() || !mesh->GetMesh()->HasBounds())
+        return false;
+
+    UpdateTransform();
+    if (boundsChanged || boundsMesh != mesh->GetMesh()) {
+        // La caja local se lleva al espacio global con el centro transformado y la mitad de cada lado proyectada en los ejes
+        auto resource = mesh->GetMesh();
+        glm::vec3 center = (resource->GetMinBounds() + resource->GetMaxBounds()) * 0.5f;
+        glm::vec3 extent = (resource->GetMaxBounds() - resource->GetMinBounds()) * 0.5f;
+        glm::vec3 worldCenter = glm::vec3(transformationMat * glm::vec4(center, 1.0f));
+        glm::vec3 worldExtent(0.0f);
+        for (int i = 0; i < 3; ++i) {
+            worldExtent += glm::abs(glm::vec3(transformationMat[i])) * extent[i];
+        }
+        worldMin = worldCenter - worldExtent;
+        worldMax = worldCenter + worldExtent;
+        boundsMesh = resource;
+        boundsChanged = false;
+    }
+
+    min = worldMin;
+    max = worldMax;
+    return true;
+}
+
+bool CLNode::InsideFrustum(const CLFrustum& frustum) const {
+    glm::vec3 min, max;
+    if (ignoreFrustrum || !GetWorldBounds(min, max))
+        return true;
+
+    return frustum.IntersectsAABB(min, max);
+}
+
+void CLNode::FlattenTree(CLNode* node) {
+    flatTree.push_back(node);
+    for (const auto& child : node->childs) {
+        FlattenTree(child.get());
+    }
+}
+
+void CLNode::UpdateTransforms() {
+    if (treeChanged) {
+        flatTree.clear();
+        FlattenTree(this);
+        treeChanged = false;
+    }
+
+    // Los padres van antes que los hijos, cada nodo modificado se recalcula una vez a partir de su padre ya actualizado
+    for (auto node : flatTree) {
+        node->UpdateTransform();
+    }
+}
+
+glm::mat4 CLNode::TranslateMatrix() const{
     glm::mat4 aux = glm::mat4(1.0f);
     aux = glm::translate(aux, translation);
     return aux;
 }
 
-glm::mat4 CLNode::RotateMatrix(){
+glm::mat4 CLNode::RotateMatrix() const{
     glm::mat4 aux = glm::mat4(1.0f);
     aux = glm::rotate(aux, glm::radians(rotation.y) , glm::vec3(0,1,0));
     aux = glm::rotate(aux, glm::radians(rotation.z) , glm::vec3(0,0,1));
@@ -132,59 +211,81 @@ glm::mat4 CLNode::RotateMatrix(){
     return aux;
 }
 
-glm::mat4 CLNode::ScaleMatrix(){
+glm::mat4 CLNode::ScaleMatrix() const{
     glm::mat4 aux = glm::mat4(1.0f);
     aux = glm::scale(aux, scalation);
     return aux;
 }
 
-glm::mat4 CLNode::CalculateTransformationMatrix() {
+glm::mat4 CLNode::CalculateTransformationMatrix() const {
     return TranslateMatrix()*RotateMatrix()*ScaleMatrix();
 }
 
-void CLNode::DFSTree(glm::mat4 mA, CLCamera* cam, const glm::mat4& VPmatrix) {
-
-    if (changed) {
-        transformationMat = mA*CalculateTransformationMatrix();
-        changed = false;
-    }
-    glm::vec3 pos    = GetGlobalTranslation();
-
-    //Voy a comentar de momento el frustrum ya que para el particle system puede dar problemas
-    if( entity && visible ){ 
-        glUseProgram(shaderProgramID); 
-        glm::mat4 MVP = VPmatrix * transformationMat;
-        glUniformMatrix4fv(glGetUniformLocation(shaderProgramID, "model"), 1, GL_FALSE, glm::value_ptr(transformationMat));
-        glUniformMatrix4fv(glGetUniformLocation(shaderProgramID, "MVP"), 1, GL_FALSE, glm::value_ptr(MVP));
-        glUniform3fv(glGetUniformLocation(shaderProgramID, "position"), 1, glm::value_ptr(pos));
-        auto particleEntity = dynamic_cast<CLParticleSystem*>(entity.get());
-        if((particleEntity && particlesActivated) || !particleEntity){
-            entity->Draw(shaderProgramID);
+//! Se recorre el arbol aplanado, mismo orden que el recorrido en profundidad y con las transformaciones ya calculadas
+//! Los nodos visibles solo se guardan en la cola, que se ordena por estado antes de dibujar
+void CLNode::DFSTree(const glm::mat4& VPmatrix) {
+    UpdateTransforms();
+
+    // Solo se descartan los nodos con malla, las particulas y los billboards se dibujan siempre
+    CLFrustum frustum(VPmatrix);
+    cullingStats.drawn = 0;
+    cullingStats.culled = 0;
+    renderQueue.Clear();
+    for (auto node : flatTree) {
+        if( node->entity && node->visible ){ 
+            if (frustumCulling && !node->InsideFrustum(frustum)) {
+                cullingStats.culled++;
+                continue;
+            }
+            cullingStats.drawn++;
+            auto meshEntity = dynamic_cast<CLMesh*>(node->entity.get());
+            if (meshEntity) {
+                if (meshEntity->GetMesh()) {
+                    for (const auto& mesh : meshEntity->GetMesh()->GetvectorMeshRef())
+                        renderQueue.AddMesh(node->shaderProgramID, mesh, node->transformationMat, node->globalTranslation);
+                }
+                continue;
+            }
+            auto particleEntity = dynamic_cast<CLParticleSystem*>(node->entity.get());
+            if((particleEntity && particlesActivated) || !particleEntity){
+                renderQueue.AddEntity(node->shaderProgramID, node->entity.get(), node->transformationMat, node->globalTranslation);
+            }
         }
     }
-
-    for (auto node : childs) {
-        node->DFSTree(transformationMat, cam, VPmatrix);
-    }
+    renderQueue.Sort();
+    renderQueue.Submit(VPmatrix);
 }
 
-void CLNode::DFSTree(glm::mat4 mA,  CLCamera* cam, GLuint shaderID, const glm::mat4& lightSpaceMatrix) {
-
-    if (changed) {
-        transformationMat = mA*CalculateTransformationMatrix();
-        changed = false;
-    }
-    glm::vec3 pos    = GetGlobalTranslation();
-
-    if( entity && visible ){ 
-        glm::mat4 lightSpaceModel = lightSpaceMatrix * transformationMat;
-        glUniformMatrix4fv(glGetUniformLocation(shaderID, "lightSpaceModel"), 1, GL_FALSE, glm::value_ptr(lightSpaceModel));
-        entity->DrawDepthMap(shaderID);
-    }
-
-    for (auto node : childs) {
-        node->DFSTree(transformationMat, cam, shaderID, lightSpaceMatrix);
+//! Los contadores se acumulan entre las llamadas de cada cascada, se ponen a cero con ResetShadowStats
+void CLNode::DFSTree(GLuint shaderID, const glm::mat4& lightSpaceMatrix, shadowCasters casters) {
+    UpdateTransforms();
+
+    // Lo que queda fuera de la proyeccion de la luz no deja sombra en el mapa
+    CLFrustum frustum(lightSpaceMatrix);
+    shadowQueue.Clear();
+    for (auto node : flatTree) {
+        if( node->entity && node->visible ){ 
+            if ((casters == STATIC_CASTERS && !node->isStatic) || (casters == DYNAMIC_CASTERS && node->isStatic))
+                continue;
+
+            if (frustumCulling && !node->InsideFrustum(frustum)) {
+                cullingStats.shadowCulled++;
+                continue;
+            }
+            cullingStats.shadowDrawn++;
+            auto meshEntity = dynamic_cast<CLMesh*>(node->entity.get());
+            if (meshEntity) {
+                if (meshEntity->GetMesh()) {
+                    for (const auto& mesh : meshEntity->GetMesh()->GetvectorMeshRef())
+                        shadowQueue.AddDepthMesh(mesh, node->transformationMat);
+                }
+                continue;
+            }
+            shadowQueue.AddEntity(shaderID, node->entity.get(), node->transformationMat, node->globalTranslation);
+        }
     }
+    shadowQueue.Sort();
+    shadowQueue.SubmitDepth(shaderID, lightSpaceMatrix);
 }
 
 /**
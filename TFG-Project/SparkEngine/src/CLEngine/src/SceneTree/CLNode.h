@@ -36,6 +36,8 @@
 #include "CLSkybox.h"
 #include "CLShadowMapping.h"
 #include "CLBillboard.h"
+#include "CLFrustum.h"
+#include "CLRenderQueue.h"
 #include "../ResourceManager/CLResourceManager.h"
 #include "../Built-In-Classes/CLColor.h"
 
@@ -43,6 +45,15 @@ using namespace std;
 
 namespace CLE{
     enum typeFrustum{ OBB = 0, AABB = 1};
+    //! Nodos que se dibujan en la pasada de sombras, los estaticos van a la cache del shadow mapping
+    enum shadowCasters{ ALL_CASTERS = 0, STATIC_CASTERS = 1, DYNAMIC_CASTERS = 2 };
+    //! Nodos dibujados y descartados por el frustum en la ultima pasada principal y de sombras
+    struct CLCullingStats {
+        unsigned int drawn { 0 };
+        unsigned int culled { 0 };
+        unsigned int shadowDrawn { 0 };
+        unsigned int shadowCulled { 0 };
+    };
 //! Clase Nodo de la escena
 //! En la escena gestionaremos todo mediante nodos de manera recursiva
 //! aqui puedes crear nodos y asignarles cualquier tipo de entidad disponible
@@ -74,7 +85,7 @@ class CLNode{
         glm::vec3 GetScalation()   const       { return scalation; }
         //! Devuelve la matriz de trasformacion del nodo
         //! @returns transformationMat Matriz de transformacion del nodo
-        glm::mat4 GetTransformationMat() const { return transformationMat; }
+        glm::mat4 GetTransformationMat() const { UpdateTransform(); return transformationMat; }
         //! Devuelve el ID del shader utilizando
         //! @returns shaderProgramID ID de OpenGL para el shader
         GLuint GetShaderProgramID() const      { return shaderProgramID;}
@@ -102,6 +113,26 @@ class CLNode{
         //! Devuelve si estan activadas las particulas 
         //! @returns particlesActivated
         bool static GetParticlesActivated() { return particlesActivated; };
+        //! Devuelve si esta activado el frustum culling
+        //! @returns frustumCulling
+        bool static GetFrustumCulling() { return frustumCulling; };
+        //! Devuelve los nodos dibujados y descartados en el ultimo frame, solo en la raiz
+        //! @returns cullingStats
+        const CLCullingStats& GetCullingStats() const { return cullingStats; }
+        //! Devuelve los paquetes y cambios de estado de la ultima pasada principal
+        //! @returns CLRenderQueueStats
+        const CLRenderQueueStats& GetRenderQueueStats() const { return renderQueue.GetStats(); }
+        //! Devuelve la caja alineada con los ejes del nodo en coordenadas globales
+        //! @param min Vertice menor de la caja
+        //! @param max Vertice mayor de la caja
+        //! @returns bool Si el nodo tiene malla para calcularla
+        bool GetWorldBounds(glm::vec3& min, glm::vec3& max) const;
+        //! Devuelve si el nodo es estatico
+        //! @returns isStatic
+        bool IsStatic() const { return isStatic; }
+        //! Devuelve si algun nodo estatico ha cambiado desde la ultima llamada y lo desmarca
+        //! @returns bool Si hay que volver a renderizar la cache de sombras de los estaticos
+        bool static ConsumeStaticChanged() { bool c = staticChanged; staticChanged = false; return c; };
 
         //Setters
         //! Asigna un padre al nodo
@@ -118,10 +149,21 @@ class CLNode{
         void SetScalation(glm::vec3 s);
         //! Asigna la visibilidad del nodo
         //! @param v Si es visible o no
-        void SetVisible(bool v) {visible = v;};
+        void SetVisible(bool v) { if (isStatic && visible != v) staticChanged = true; visible = v; };
         //! Activa o desactiva las particulas
         //! @param particlesActivated
         void SetParticlesActivated(bool a) { particlesActivated = a; };
+        //! Activa o desactiva el frustum culling
+        //! @param c Si se descartan los nodos fuera de la camara y de la luz
+        void SetFrustumCulling(bool c) { frustumCulling = c; };
+        //! Hace que el nodo se dibuje aunque este fuera del frustum
+        //! @param i Si le afecta el frustum culling o no
+        void SetIgnoreFrustrum(bool i) { ignoreFrustrum = i; };
+        //! Marca el nodo como estatico, su sombra se guarda en cache y no se vuelve a dibujar cada frame
+        //! @param s Si el nodo no se mueve
+        void SetStatic(bool s) { isStatic = s; staticChanged = true; };
+        //! Pone a cero los contadores de la pasada de sombras, que se acumulan entre cascadas
+        void ResetShadowStats() { cullingStats.shadowDrawn = 0; cullingStats.shadowCulled = 0; };
         //! Asigna el shader ID
         //! @param shaderProgramID
         void SetShaderProgramID(GLuint id) { shaderProgramID = id; }
@@ -136,29 +178,43 @@ class CLNode{
         //! Busca un nodo en el arbol por su ID
         //! @param id Identificador para buscar
         //! @returns CLNode* Puntero al nodo
-        glm::mat4 TranslateMatrix();
-        glm::mat4 RotateMatrix();
-        glm::mat4 ScaleMatrix();
-        glm::mat4 CalculateTransformationMatrix();
+        glm::mat4 TranslateMatrix() const;
+        glm::mat4 RotateMatrix() const;
+        glm::mat4 ScaleMatrix() const;
+        glm::mat4 CalculateTransformationMatrix() const;
         //! Calcula la bounding box del objeto
         float CalculateBoundingBox();
         //! Calculate boundbox OBB
         glm::vec3 CalculateBoundingBoxOBB();
+        //! Recalcula las transformaciones globales de los nodos modificados en una sola pasada lineal
+        //! Se llama sobre la raiz una vez por frame antes de dibujar
+        void UpdateTransforms();
         //! Dibuja la escena
-        void DFSTree(glm::mat4,CLCamera* cam, const glm::mat4& VPmatrix);
-        void DFSTree(glm::mat4 mA,  CLCamera* cam, GLuint shaderID, const glm::mat4& lightSpaceMatrix);
+        void DFSTree(const glm::mat4& VPmatrix);
+        void DFSTree(GLuint shaderID, const glm::mat4& lightSpaceMatrix, shadowCasters casters = ALL_CASTERS);
         //DEBUG
         //! Imprime el arbol
         //! @param root Nodo padre
         void DrawTree(CLNode* root); 
     private:
         void ActivateFlag();
+        //! Recalcula la transformacion global a partir de la del padre si el nodo ha cambiado
+        void UpdateTransform() const;
+        //! Avisa a la raiz de que el arbol ha cambiado y hay que volver a aplanarlo
+        void ActivateTreeFlag();
+        //! Recorre el arbol en profundidad guardando los nodos en flatTree
+        void FlattenTree(CLNode* node);
+        //! Comprueba si el nodo esta dentro del frustum, los nodos sin malla siempre se dibujan
+        bool InsideFrustum(const CLFrustum& frustum) const;
 
-        bool changed { true };
+        mutable bool changed { true };
         bool visible { true };
         bool octreeVisible { true };
         bool ignoreFrustrum { false }; //Si esta a true no le afecta el frustrum culling
+        bool isStatic { false }; //Si esta a true su sombra va a la cache de estaticos
+        inline static bool staticChanged { true }; //Si esta a true algun nodo estatico ha cambiado
         inline static bool particlesActivated { true }; //Si esta a true se dibujan las particulas
+        inline static bool frustumCulling { true }; //Si esta a true no se dibujan los nodos fuera del frustum
         shared_ptr<CLEntity> entity {nullptr};
         CLNode* father {nullptr};
         vector<shared_ptr<CLNode>> childs;
@@ -167,7 +223,23 @@ class CLNode{
         glm::vec3 translation       {glm::vec3(0.0f)};  // posicion del nodo
         glm::vec3 rotation          {glm::vec3(0.0f)};  // rotacion del nodo
         glm::vec3 scalation         {glm::vec3(1.0f)};  // escalado del nodo
-        glm::mat4 transformationMat {glm::mat4(1.0f)};  // matriz modelo del nodo
+        mutable glm::mat4 transformationMat {glm::mat4(1.0f)};  // matriz modelo del nodo
+        mutable glm::vec3 globalTranslation {glm::vec3(0.0f)};  // traslacion global cacheada
+        mutable glm::vec3 globalRotation    {glm::vec3(0.0f)};  // rotacion global cacheada
+        mutable glm::vec3 globalScalation   {glm::vec3(1.0f)};  // escalado global cacheado
+
+        // Solo en la raiz: nodos en orden de recorrido en profundidad, los padres siempre antes que los hijos
+        vector<CLNode*> flatTree;
+        bool treeChanged { true };
+        CLCullingStats cullingStats;
+        CLRenderQueue renderQueue;   // paquetes de la pasada principal
+        CLRenderQueue shadowQueue;   // paquetes de la pasada de sombras, se rellena en cada cascada
+
+        // Caja global de la malla, se recalcula cuando cambia la transformacion o la malla
+        mutable glm::vec3 worldMin          {glm::vec3(0.0f)};
+        mutable glm::vec3 worldMax          {glm::vec3(0.0f)};
+        mutable bool boundsChanged { true };
+        mutable CLResourceMesh* boundsMesh { nullptr };
 
         // BOUNDING BOX
         glm::vec3 extremeMinMesh    {glm::vec3(0.0,0.0,0.0)}; // definimos el vertice mayor de la malla para el BoundingBpx
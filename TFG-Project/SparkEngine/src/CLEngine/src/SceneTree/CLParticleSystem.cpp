@@ -18,7 +18,8 @@
  #include "CLParticleSystem.h"
 #include "CLNode.h"
 #include "../Utils.h"
-#include "../Constants.h"
+
+#include <cstddef>
 using namespace CLE;
 
 
@@ -36,8 +37,12 @@ CLParticleSystem::CLParticleSystem(unsigned int idEntity, unsigned int particles
     lifeSpan          = _lifeSpan;
     spawnType         = SpawnType::PointSpawn;
     flags             = _flags;
+    spawnTime         = spawnDelay; //La primera tanda se spawnea al empezar
 
-    particles.reserve(nParticles);
+    positions.resize(nParticles);
+    velocities.resize(nParticles);
+    lifeTimes.resize(nParticles);
+    textureIndices.resize(nParticles);
 
 }
 
@@ -90,10 +95,30 @@ CLParticleSystem::CLParticleSystem(unsigned int idEntity, unsigned int _nParticl
 
 
 
+CLParticleSystem::~CLParticleSystem() {
+    for(auto& fence : regionFences){
+        if(fence) glDeleteSync(fence);
+    }
+    // Borrar el buffer lo desmapea
+    if(VBO) glDeleteBuffers(1, &VBO);
+    if(VAO) glDeleteVertexArrays(1, &VAO);
+}
+
+vector<CLResourceTexture*> CLParticleSystem::GetTextures() const {
+    vector<CLResourceTexture*> textures;
+    for(const auto& texture : clTextures){
+        textures.push_back(texture.Get());
+    }
+    return textures;
+}
+
 void CLParticleSystem::Draw(GLuint shaderID) {
-    if(!started) return;
+    if(!started || clTextures.empty()) return;
     //En este Draw que llama al resto de draws podriamos settear cosas generales para todos las particulas
-    Update(); //Este Update se encarga de cosas como spawnear nuevas particulas
+    Update(); //Este Update se encarga de mover las particulas y spawnear las nuevas
+    if(liveCount == 0) return;
+
+    if(!VAO) CreateBuffers();
 
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
@@ -101,147 +126,183 @@ void CLParticleSystem::Draw(GLuint shaderID) {
     //glDepthMask(GL_FALSE);
     glUseProgram(shaderID);
 
-    for(auto& particle : particles){
-        particle->Draw(shaderID);
+    // Antes de sobrescribir la region se espera a que la GPU haya terminado de leerla
+    if(regionFences[region]){
+        while(glClientWaitSync(regionFences[region], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) == GL_TIMEOUT_EXPIRED);
+        glDeleteSync(regionFences[region]);
+        regionFences[region] = nullptr;
     }
-}
 
-void CLParticleSystem::Update(){
+    vector<GLint> firsts;
+    vector<GLsizei> counts;
+    WriteVertices(firsts, counts);
 
-    //cout << "Hay " << numParticleDeads << " particulas muertas de " << nParticles << endl;
-    
-    //Comprobamos si ha pasado el tiempo de spawn
-    auto diff = duration_cast<milliseconds>(system_clock::now() - timeStart).count();
+    GLint regionStart = region * nParticles;
+    glBindVertexArray(VAO);
+    if(!mappedVertices){
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        glBufferSubData(GL_ARRAY_BUFFER, regionStart * sizeof(ParticleVertex), liveCount * sizeof(ParticleVertex), stagingVertices.data());
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
 
-    if(diff > spawnDelay){
-        timeStart = system_clock::now();
+    glUniform1f(glGetUniformLocation(shaderID, "width"), width);
+    glUniform1f(glGetUniformLocation(shaderID, "height"), height);
+    glActiveTexture(GL_TEXTURE0);
 
-        for(unsigned int i = 0; i<nParticlesToSpawn && particles.size()<nParticles ; ++i){
-            particles.emplace_back(make_shared<CLParticle>(this));
-        }
+    // Un draw por textura, las particulas estan ordenadas por textura en la region
+    for(size_t i = 0; i < clTextures.size(); ++i){
+        if(counts[i] == 0) continue;
+        glBindTexture(GL_TEXTURE_2D, clTextures[i]->GetTextureID());
+        glDrawArrays(GL_POINTS, regionStart + firsts[i], counts[i]);
+    }
+    glBindVertexArray(0);
 
-        //Vamos a comprobar si tenemos que revivir alguna particula porque han activado de nuevo el loop
-        if(loop || oneIterationMode){ 
-            int particlesToRespawn = nParticlesToSpawn; //Solo vamos a revivir por iteracion a nParticlesToSpawn
-            for(auto& particle : particles){
-                if(particle->GetParticleDead()){
-                    particle->ReviveParticle();
-                    particlesToRespawn--;
-                }
+    if(mappedVertices){
+        regionFences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+    region = (region + 1) % STREAM_REGIONS;
+}
 
-                if(particlesToRespawn <= 0) break;
+void CLParticleSystem::Update(){
+    auto now = steady_clock::now();
+    float elapsed = (lastUpdate == time_point<steady_clock>()) ? 0.0f : duration<float, std::milli>(now - lastUpdate).count();
+    lastUpdate = now;
+    float deltaTime = elapsed / 1000.0f;
+    glm::vec3 center = node->GetGlobalTranslation();
+
+    //Comprobamos la vida de las particulas, las muertas se sustituyen por la ultima viva para que sigan compactadas
+    for(unsigned int i = 0; i < liveCount; ){
+        lifeTimes[i] += elapsed;
+        if(lifeTimes[i] >= lifeSpan){
+            if(loop){
+                //la respawneamos en la posicion inicial
+                positions[i] = CalculateSpawnPosition(center);
+                lifeTimes[i] = 0;
+                ++i;
+            }else{
+                --liveCount;
+                positions[i]      = positions[liveCount];
+                velocities[i]     = velocities[liveCount];
+                lifeTimes[i]      = lifeTimes[liveCount];
+                textureIndices[i] = textureIndices[liveCount];
             }
+        }else{
+            //la movemos
+            positions[i] += velocities[i] * deltaTime;
+            ++i;
         }
     }
 
+    //Comprobamos si ha pasado el tiempo de spawn, sin loop solo se spawnean nParticles por iteracion
+    spawnTime += elapsed;
+    if(spawnTime >= spawnDelay){
+        spawnTime = 0;
+        for(unsigned int i = 0; i < nParticlesToSpawn && liveCount < nParticles && (loop || emitted < nParticles); ++i){
+            Spawn(center);
+        }
+    }
 
-    if(numParticleDeads == 0){
+    if(emitted >= nParticles){
         oneIterationMode = false;
     }
 
 }
 
-// -----------------------------------------
-// ------------Clase CLParticle-------------
-// -----------------------------------------
+void CLParticleSystem::Burst(unsigned int count){
+    if(!node) return;
 
-CLParticleSystem::CLParticle::CLParticle(CLParticleSystem* emitter){
-    particleSystem = emitter;   
-    position       = CalculateSpawnPosition();
-    lifeSpan       = particleSystem->GetLifeSpan();
-    velocity       = particleSystem->GetSpeedDirection();
-    timeStart      = system_clock::now();
+    started = true;
+    glm::vec3 center = node->GetGlobalTranslation();
+    count = glm::min(count, nParticles - liveCount);
+    for(unsigned int i = 0; i < count; ++i){
+        Spawn(center);
+    }
+}
+
+void CLParticleSystem::Spawn(const glm::vec3& center){
+    positions[liveCount]  = CalculateSpawnPosition(center);
+    velocities[liveCount] = CalculateVelocity();
+    lifeTimes[liveCount]  = 0;
 
     int indxTexture = 0;
-    if(particleSystem->GetTextures().size() > 1){
-        indxTexture = Utils::getRandomInt(0,particleSystem->GetTextures().size()-1);
+    if(clTextures.size() > 1){
+        indxTexture = Utils::getRandomInt(0,clTextures.size()-1);
     }
-    texture = particleSystem->GetTextures().at(indxTexture);
-    //Comprobamos si el flag del effecto esta activado
-    CalculateVelocity();
-
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
+    textureIndices[liveCount] = indxTexture;
 
+    ++liveCount;
+    ++emitted;
 }
 
+void CLParticleSystem::WriteVertices(vector<GLint>& firsts, vector<GLsizei>& counts){
+    //Counting sort por textura, cada particula se escribe directamente en su hueco
+    counts.assign(clTextures.size(), 0);
+    firsts.assign(clTextures.size(), 0);
+    for(unsigned int i = 0; i < liveCount; ++i){
+        counts[textureIndices[i]]++;
+    }
+    for(size_t i = 1; i < clTextures.size(); ++i){
+        firsts[i] = firsts[i-1] + counts[i-1];
+    }
 
-void CLParticleSystem::CLParticle::Draw(GLuint shaderID){
-    if(particleDead) return;
-    Update();
-    
-    if(particleSystem->GetFlags() & EFFECT_FADING){
-        glUniform1f(glGetUniformLocation(shaderID, "alpha"), glm::min(lifeTime / lifeSpan,1.0f));
+    ParticleVertex* vertices = mappedVertices ? mappedVertices + region * nParticles : stagingVertices.data();
+    vector<GLint> next(firsts);
+    bool fading = flags & EFFECT_FADING;
+    for(unsigned int i = 0; i < liveCount; ++i){
+        auto& vertex = vertices[next[textureIndices[i]]++];
+        vertex.position = positions[i];
+        vertex.alpha = fading ? glm::min(lifeTimes[i] / lifeSpan, 1.0f) : 100.0f;
+    }
+}
 
-    }else{
-        glUniform1f(glGetUniformLocation(shaderID, "alpha"), 100);
+void CLParticleSystem::CreateBuffers(){
+    GLsizeiptr size = STREAM_REGIONS * nParticles * sizeof(ParticleVertex);
 
-    }
-    glUniform1f(glGetUniformLocation(shaderID, "width"), particleSystem->GetWidth());
-    glUniform1f(glGetUniformLocation(shaderID, "height"), particleSystem->GetHeight());
-    
-    glActiveTexture(GL_TEXTURE0); 
-    glBindTexture(GL_TEXTURE_2D, texture->GetTextureID());
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &VBO);
     glBindVertexArray(VAO);
     glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(position), &position[0], GL_STATIC_DRAW);
-    glVertexAttribPointer(0,3, GL_FLOAT, GL_FALSE, 0, (void*)0);    
-    glEnableVertexAttribArray(0);
-    glDrawArrays(GL_POINTS, 0, 1);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
-    
-}
-
-void CLParticleSystem::CLParticle::Update(){
-    //Comprobamos si deberia seguir con vida la particula
-    lifeTime = duration_cast<milliseconds>(system_clock::now() - timeStart).count();
 
-    if(lifeTime >= lifeSpan){
-        lifeTime = lifeSpan;
-        if(particleSystem->GetLoop()){
-            //la respawneamos en la posicion inicial
-            position = CalculateSpawnPosition();
-            timeStart = system_clock::now();
-        }else{
-            //Si no hay loop al llegar a su lifeSpan la desactivamos y reposicionamos
-            particleDead = true;
-            particleSystem->UpdateNumParticlesDead(+1);
-        }
-        
+    //Con buffer storage el buffer queda mapeado siempre y se escribe sin llamadas a GL, si no se sube cada frame
+    if(GLEW_ARB_buffer_storage){
+        GLbitfield mapFlags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage(GL_ARRAY_BUFFER, size, nullptr, mapFlags);
+        mappedVertices = static_cast<ParticleVertex*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, size, mapFlags));
     }else{
-        //la movemos
-        position.x += velocity.x * Constants::DELTA_TIME;
-        position.y += velocity.y * Constants::DELTA_TIME;
-        position.z += velocity.z * Constants::DELTA_TIME;
+        glBufferData(GL_ARRAY_BUFFER, size, nullptr, GL_STREAM_DRAW);
     }
+    if(!mappedVertices){
+        stagingVertices.resize(nParticles);
+    }
+
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(ParticleVertex), (void*)offsetof(ParticleVertex, position));
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 1, GL_FLOAT, GL_FALSE, sizeof(ParticleVertex), (void*)offsetof(ParticleVertex, alpha));
+    glEnableVertexAttribArray(1);
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
 }
 
-glm::vec3 CLParticleSystem::CLParticle::CalculateSpawnPosition(){
+glm::vec3 CLParticleSystem::CalculateSpawnPosition(const glm::vec3& center) const{
     glm::vec3 newPosition(0.0f);
-    SpawnType spawnType = particleSystem->GetSpawnType();
-    glm::vec3 center = particleSystem->GetCLNode()->GetGlobalTranslation();
 
-    
     if(spawnType == SpawnType::PointSpawn){
-        newPosition = particleSystem->GetCLNode()->GetGlobalTranslation();
+        newPosition = center;
     }else if(spawnType == SpawnType::LineSpawn || spawnType == SpawnType::SquareSpawn || spawnType == SpawnType::CubeSpawn){
-        float offX = Utils::getRandomFloat(center.x - particleSystem->GetOffset().x, center.x + particleSystem->GetOffset().x);//genX(rng);
-        float offY = Utils::getRandomFloat(center.y - particleSystem->GetOffset().y, center.y + particleSystem->GetOffset().y);//genY(rng);
-        float offZ = Utils::getRandomFloat(center.z - particleSystem->GetOffset().z, center.z + particleSystem->GetOffset().z);//genZ(rng);
+        float offX = Utils::getRandomFloat(center.x - offset.x, center.x + offset.x);
+        float offY = Utils::getRandomFloat(center.y - offset.y, center.y + offset.y);
+        float offZ = Utils::getRandomFloat(center.z - offset.z, center.z + offset.z);
 
         newPosition = glm::vec3(offX,offY,offZ);
     }else if(spawnType == SpawnType::SphereSpawn || spawnType == SpawnType::CircleSpawn){
-        float radious = particleSystem->GetRadious();
-        glm::vec3 orientation = particleSystem->GetOrientation();
-
         float offX = Utils::getRandomFloat(center.x - (radious*orientation.x), center.x + (radious*orientation.x));
         float offY = Utils::getRandomFloat(center.y - (radious*orientation.y), center.y + (radious*orientation.y));
         float offZ = Utils::getRandomFloat(center.z - (radious*orientation.z), center.z + (radious*orientation.z));
 
         newPosition = glm::vec3(offX,offY,offZ);
     }else{
-        newPosition = particleSystem->GetCLNode()->GetGlobalTranslation();
+        newPosition = center;
 
     }
     
@@ -249,18 +310,10 @@ glm::vec3 CLParticleSystem::CLParticle::CalculateSpawnPosition(){
     return newPosition;
 }
 
-void CLParticleSystem::CLParticle::ReviveParticle(){
-    particleDead = false;
-    particleSystem->UpdateNumParticlesDead(-1);
-    position = CalculateSpawnPosition();
-    CalculateVelocity();
-    timeStart = system_clock::now();
-}
-
-void CLParticleSystem::CLParticle::CalculateVelocity(){
+glm::vec3 CLParticleSystem::CalculateVelocity() const{
 
     //Comprobamos si el flag del effecto esta activado
-    if(particleSystem->GetFlags() & EFFECT_DIR_ALEATORITY){
+    if(flags & EFFECT_DIR_ALEATORITY){
 
         float valueX = 0;
         float valueY = 0;
@@ -272,12 +325,8 @@ void CLParticleSystem::CLParticle::CalculateVelocity(){
             valueZ = Utils::getRandomFloat(-1.0,1.0);
         }while(!valueX && !valueY && !valueZ);
 
-        velocity.x = particleSystem->GetSpeedDirection().x * valueX;
-        velocity.y = particleSystem->GetSpeedDirection().y * valueY;
-        velocity.z = particleSystem->GetSpeedDirection().z * valueZ;
-
-    }else{
-        velocity = particleSystem->GetSpeedDirection();
+        return speedDirection * glm::vec3(valueX, valueY, valueZ);
     }
 
-}
\ No newline at end of file
+    return speedDirection;
+}
@@ -21,6 +21,7 @@
 #include "CLNode.h"
 #include "../ResourceManager/CLResourceManager.h"
 #include "../ResourceManager/CLResourceTexture.h"
+#include "../ResourceManager/CLResourceHandle.h"
 
 #include <chrono>
 #include <iostream>
@@ -118,7 +119,7 @@ class CLNode;
             //! @param _flags Mascara con los efectos para aplicarle
             CLParticleSystem(unsigned int idEntity, unsigned int _nParticles, glm::vec3 _speedDirection,vector<string> texture,uint16_t _width, uint16_t _height,float _spawnDelay,unsigned int _nParticlesToSpawn,float _lifeSpan,float _radious, std::uint_fast8_t _flags);
 
-            ~CLParticleSystem() = default;
+            ~CLParticleSystem();
 
             void Draw(GLuint shaderID) override;
             void DrawDepthMap(GLuint shaderID) override {};
@@ -133,7 +134,10 @@ class CLNode;
             //! Inicia la emisión de particulas
             void Start() { started = true; }
             //! Inicia una sola iteracion de particulas
-            void StartOneIteration() { started = true; oneIterationMode = true; }
+            void StartOneIteration() { started = true; oneIterationMode = true; emitted = 0; }
+            //! Spawnea de golpe un numero de particulas, sin esperar al delay de spawn
+            //! @param count Numero de particulas, se limita a las que quedan libres en el pool
+            void Burst(unsigned int count);
             
 
             //GETTERS
@@ -151,7 +155,7 @@ class CLNode;
             glm::vec3          GetSpawnerPosition()   const { return spawnerPosition; }
             //! Devuelve las texturas de las particulas del spawner
             //! @returns clTextures
-            vector<CLResourceTexture*> GetTextures()           const { return clTextures; }
+            vector<CLResourceTexture*> GetTextures()           const;
             //! Devuelve el ancho de las particulas
             //! @returns width
             uint16_t           GetWidth()             const { return width; }
@@ -192,68 +196,74 @@ class CLNode;
             //! Devuele si esta activado el modo de 1 iteracion
             //! @returns oneIterationMode
             bool               GetOneIterationMode()  const { return oneIterationMode; }
+            //! Devuelve el numero de particulas vivas
+            //! @returns liveCount
+            unsigned int       GetLiveParticles()     const { return liveCount; }
 
 
 
         private:
 
+            //! Vertice de una particula en el buffer de streaming
+            struct ParticleVertex {
+                glm::vec3 position;
+                float alpha;
+            };
+
+            //! Numero de regiones del buffer de streaming, mientras la GPU lee una se escribe en otra
+            static constexpr unsigned int STREAM_REGIONS = 3;
+
+            //! Avanza la vida de las particulas, las mueve y spawnea las nuevas
             void Update();
-            //! Indica que ha muerto o revivido una particula
-            //! @note puede ser 1 o -1
-            void UpdateNumParticlesDead(int change) { numParticleDeads += change; }
+            //! Spawnea una particula al final de las vivas
+            //! @param center Posicion global del spawner
+            void Spawn(const glm::vec3& center);
+            //! Escribe las particulas vivas ordenadas por textura en el buffer de streaming
+            //! @param firsts Primera particula de cada textura
+            //! @param counts Numero de particulas de cada textura
+            void WriteVertices(vector<GLint>& firsts, vector<GLsizei>& counts);
+            //! Crea el VAO y el buffer de streaming, mapeado de forma persistente si el driver lo permite
+            void CreateBuffers();
+            //! Calcula la posicion de spawn segun el tipo de spawner
+            //! @param center Posicion global del spawner
+            glm::vec3 CalculateSpawnPosition(const glm::vec3& center) const;
+            //! Calcula la velocidad de una particula nueva segun los efectos
+            glm::vec3 CalculateVelocity() const;
 
-            class CLParticle; //Forward declaration
+            // Pool de particulas en estructura de arrays, las vivas estan compactadas al principio
+            vector<glm::vec3> positions;
+            vector<glm::vec3> velocities;
+            vector<float> lifeTimes;            //Tiempo vivido en ms
+            vector<uint16_t> textureIndices;
+            unsigned int liveCount { 0 };
+            unsigned int emitted { 0 };         //Particulas spawneadas en la iteracion actual
+
+            // Buffer de streaming
+            GLuint VAO { 0 }, VBO { 0 };
+            ParticleVertex* mappedVertices { nullptr };
+            vector<ParticleVertex> stagingVertices; //Sin buffer persistente se escribe aqui y se sube con glBufferSubData
+            GLsync regionFences[STREAM_REGIONS] { nullptr, nullptr, nullptr };
+            unsigned int region { 0 };
 
-            vector<shared_ptr<CLParticle>> particles;
             CLNode* node {nullptr};     //CLNode para poder acceder a su matriz modelo, vista, proyeccion y demas cosas utiles
             unsigned int nParticles { 10 }; //Numero de particulas que vamos a tener
             glm::vec3 speedDirection;
             glm::vec3 spawnerPosition;
-            vector<CLResourceTexture*> clTextures;
+            vector<CLResourceHandle<CLResourceTexture>> clTextures;
             uint16_t width{0}, height{0};
-            time_point<system_clock> timeStart;
+            time_point<steady_clock> lastUpdate;
+            float spawnTime = 0; //Tiempo desde el ultimo spawn en ms
             float spawnDelay = 1000; //Tiempo en ms
             unsigned int nParticlesToSpawn = 1; //Particulas a spawnear a la vez
             float lifeSpan = 1000; //Tiempo de vida de las particulas
             bool loop = false;
             bool started = false;
             bool oneIterationMode = false;
-            uint32_t numParticleDeads = 0;
             SpawnType spawnType = SpawnType::PointSpawn;
             float radious = 0; //Usado en SpawnType::Circle y SpawnType::Sphere
             glm::vec3 orientation = glm::vec3(1.0f); //Usado en SpawnType::Circle
             glm::vec3 offset; //Usado en SpawnType::Line, SpawnType::Square y  SpawnType::Cube
             std::uint_fast8_t flags = 0x0;
-
-
-            class CLParticle{
-
-                public:
-                    CLParticle() = default;
-                    CLParticle(CLParticleSystem* emitter);
-                    ~CLParticle() { glDeleteVertexArrays(1, &VAO);glDeleteBuffers(1, &VBO);};
-
-                    void Draw(GLuint shaderID);
-                    bool GetParticleDead() const { return particleDead; }
-                    void ReviveParticle();
-
-                private:
-                    void Update();              //Aqui haremos los calculos necesarios de vida, posicion, etc
-                    glm::vec3 CalculateSpawnPosition();
-                    void CalculateVelocity();
-                    
-                    GLuint VBO,VAO;
-                    float lifeTime = 0;
-                    CLResourceTexture* texture;
-                    CLParticleSystem* particleSystem {nullptr};
-                    glm::vec3 position;
-                    glm::vec3 velocity;
-                    float lifeSpan = 1000;
-                    time_point<system_clock> timeStart;
-                    bool particleDead = false;
-
-
-            };
             
     };
 }
\ No newline at end of file
@@ -0,0 +1,202 @@
+/**
+ * Beast Brawl
+ * Game created as a final project of the Multimedia Engineering Degree in the University of Alicante.
+ * Made by Clover Games Studio, with members 
+ * Carlos de la Fuente Torres delafuentetorresc@gmail.com,
+ * Antonio Jose Martinez Garcia https://www.linkedin.com/in/antonio-jose-martinez-garcia/,
+ * Jesús Mas Carretero jmasc03@gmail.com, 
+ * Judith Mula Molina https://www.linkedin.com/in/judith-mm-18099215a/, 
+ * Rubén Rubio Martínez https://www.linkedin.com/in/rub%C3%A9n-rubio-mart%C3%ADnez-938700131/, 
+ * and Jose Valdés Sirvent https://www.linkedin.com/in/jose-f-valdés-sirvent-6058b5a5/ github -> josefrvaldes
+ * 
+ * 
+ * @author Clover Games Studio
+ * 
+ */
+ 
+
+#include "CLRenderQueue.h"
+#include "CLShadowMapping.h"
+
+#include <algorithm>
+#include <glm/gtc/type_ptr.hpp>
+
+using namespace CLE;
+
+namespace {
+    //! Posicion del sampler del material segun el tipo de textura de Assimp, -1 si no tiene
+    int SamplerSlot(const string& type) {
+        if (type == "texture_diffuse")  return 0;
+        if (type == "texture_specular") return 1;
+        if (type == "texture_normal")   return 2;
+        if (type == "texture_height")   return 3;
+        return -1;
+    }
+}
+
+//! Clave de 64 bits: pasada (4) | programa (16) | primera textura (20) | VAO (24)
+uint64_t CLRenderQueue::MakeKey(uint64_t pass, GLuint program, GLuint texture, GLuint vao) {
+    return (pass << 60) | ((uint64_t)(program & 0xFFFF) << 44) | ((uint64_t)(texture & 0xFFFFF) << 24) | (uint64_t)(vao & 0xFFFFFF);
+}
+
+CLRenderQueue::ProgramState& CLRenderQueue::GetProgramState(GLuint program) {
+    auto it = programs.find(program);
+    if (it != programs.end())
+        return it->second;
+
+    ProgramState state;
+    state.model           = glGetUniformLocation(program, "model");
+    state.MVP             = glGetUniformLocation(program, "MVP");
+    state.position        = glGetUniformLocation(program, "position");
+    state.lightSpaceModel = glGetUniformLocation(program, "lightSpaceModel");
+    state.depthMap        = glGetUniformLocation(program, "depthMap");
+    state.samplers        = { glGetUniformLocation(program, "material.diffuse"), glGetUniformLocation(program, "material.specular"),
+                              glGetUniformLocation(program, "material.normal"), glGetUniformLocation(program, "material.height") };
+    return programs.emplace(program, state).first->second;
+}
+
+void CLRenderQueue::AddMesh(GLuint program, const Mesh& mesh, const glm::mat4& model, const glm::vec3& position) {
+    if (mesh.indices.empty())
+        return;
+
+    GLuint texture = mesh.textures.empty() ? 0 : mesh.textures[0].id;
+    packets.push_back({ MakeKey(OPAQUE_PASS, program, texture, mesh.VAO), program, &mesh, nullptr, &model, &position });
+}
+
+void CLRenderQueue::AddDepthMesh(const Mesh& mesh, const glm::mat4& model) {
+    if (mesh.indices.empty())
+        return;
+
+    packets.push_back({ MakeKey(OPAQUE_PASS, 0, 0, mesh.VAO), 0, &mesh, nullptr, &model, nullptr });
+}
+
+void CLRenderQueue::AddEntity(GLuint program, CLEntity* entity, const glm::mat4& model, const glm::vec3& position) {
+    // La clave lleva el orden de llegada, las entidades pueden usar blending y no se reordenan
+    packets.push_back({ ((uint64_t)ENTITY_PASS << 60) | packets.size(), program, nullptr, entity, &model, &position });
+}
+
+//! stable_sort para que los paquetes con el mismo estado sigan en el orden del arbol
+void CLRenderQueue::Sort() {
+    std::stable_sort(packets.begin(), packets.end(), [](const Packet& a, const Packet& b) { return a.key < b.key; });
+}
+
+void CLRenderQueue::Submit(const glm::mat4& VPmatrix) {
+    stats = CLRenderQueueStats();
+    stats.packets = packets.size();
+    for (auto& program : programs)
+        program.second.prepared = false;
+
+    GLuint program = unknownState;
+    GLuint vao = unknownState;
+    GLuint activeUnit = unknownState;
+    std::array<GLuint, maxTextureUnits> boundTextures;
+    boundTextures.fill(unknownState);
+    bool depthMapBound = false;
+    const glm::mat4* model = nullptr;
+    ProgramState* state = nullptr;
+
+    auto activateUnit = [&activeUnit](GLuint unit) {
+        if (activeUnit != unit) {
+            glActiveTexture(GL_TEXTURE0 + unit);
+            activeUnit = unit;
+        }
+    };
+
+    for (const auto& packet : packets) {
+        if (packet.program != program) {
+            program = packet.program;
+            glUseProgram(program);
+            stats.programChanges++;
+            state = &GetProgramState(program);
+            model = nullptr;
+
+            // Los samplers se guardan en el programa, basta con ponerlos una vez por frame
+            if (!state->prepared) {
+                if (state->depthMap != -1)
+                    glUniform1i(state->depthMap, 1);
+                state->samplerUnits.fill(-1);
+                state->prepared = true;
+            }
+        }
+
+        // Los uniforms del nodo solo cambian cuando cambia el nodo o el programa
+        if (packet.model != model) {
+            model = packet.model;
+            glm::mat4 MVP = VPmatrix * (*model);
+            glUniformMatrix4fv(state->model, 1, GL_FALSE, glm::value_ptr(*model));
+            glUniformMatrix4fv(state->MVP, 1, GL_FALSE, glm::value_ptr(MVP));
+            glUniform3fv(state->position, 1, glm::value_ptr(*packet.position));
+        }
+
+        if (!packet.mesh) {
+            // La entidad pone su propio estado, despues no se sabe que queda enlazado
+            activateUnit(0);
+            packet.entity->Draw(program);
+            program = vao = activeUnit = unknownState;
+            boundTextures.fill(unknownState);
+            depthMapBound = false;
+            continue;
+        }
+
+        const Mesh& mesh = *packet.mesh;
+        for (unsigned int i = 0; i < mesh.textures.size(); i++) {
+            int slot = SamplerSlot(mesh.textures[i].type);
+            if (slot != -1 && state->samplerUnits[slot] != (int)i) {
+                glUniform1i(state->samplers[slot], i);
+                state->samplerUnits[slot] = i;
+            }
+            if (i >= maxTextureUnits || boundTextures[i] != mesh.textures[i].id) {
+                activateUnit(i);
+                glBindTexture(GL_TEXTURE_2D, mesh.textures[i].id);
+                stats.textureChanges++;
+                if (i < maxTextureUnits)
+                    boundTextures[i] = mesh.textures[i].id;
+            }
+        }
+
+        // El depth map de las sombras es el mismo para toda la pasada
+        if (!depthMapBound) {
+            activateUnit(1);
+            glBindTexture(GL_TEXTURE_2D_ARRAY, CLShadowMapping::depthMap);
+            depthMapBound = true;
+        }
+
+        if (mesh.VAO != vao) {
+            vao = mesh.VAO;
+            glBindVertexArray(vao);
+            stats.vaoChanges++;
+        }
+        glDrawElements(GL_TRIANGLES, mesh.indices.size(), GL_UNSIGNED_INT, 0);
+    }
+
+    glBindVertexArray(0);
+    glActiveTexture(GL_TEXTURE0);
+}
+
+void CLRenderQueue::SubmitDepth(GLuint program, const glm::mat4& lightSpaceMatrix) {
+    ProgramState& state = GetProgramState(program);
+    GLuint vao = unknownState;
+    const glm::mat4* model = nullptr;
+
+    for (const auto& packet : packets) {
+        if (packet.model != model) {
+            model = packet.model;
+            glm::mat4 lightSpaceModel = lightSpaceMatrix * (*model);
+            glUniformMatrix4fv(state.lightSpaceModel, 1, GL_FALSE, glm::value_ptr(lightSpaceModel));
+        }
+
+        if (!packet.mesh) {
+            packet.entity->DrawDepthMap(program);
+            vao = unknownState;
+            continue;
+        }
+
+        if (packet.mesh->VAO != vao) {
+            vao = packet.mesh->VAO;
+            glBindVertexArray(vao);
+        }
+        glDrawElements(GL_TRIANGLES, packet.mesh->indices.size(), GL_UNSIGNED_INT, 0);
+    }
+
+    glBindVertexArray(0);
+}
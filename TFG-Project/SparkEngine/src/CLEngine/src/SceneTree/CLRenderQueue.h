@@ -0,0 +1,110 @@
+/**
+ * Beast Brawl
+ * Game created as a final project of the Multimedia Engineering Degree in the University of Alicante.
+ * Made by Clover Games Studio, with members 
+ * Carlos de la Fuente Torres delafuentetorresc@gmail.com,
+ * Antonio Jose Martinez Garcia https://www.linkedin.com/in/antonio-jose-martinez-garcia/,
+ * Jesús Mas Carretero jmasc03@gmail.com, 
+ * Judith Mula Molina https://www.linkedin.com/in/judith-mm-18099215a/, 
+ * Rubén Rubio Martínez https://www.linkedin.com/in/rub%C3%A9n-rubio-mart%C3%ADnez-938700131/, 
+ * and Jose Valdés Sirvent https://www.linkedin.com/in/jose-f-valdés-sirvent-6058b5a5/ github -> josefrvaldes
+ * 
+ * 
+ * @author Clover Games Studio
+ * 
+ */
+ 
+ 
+#pragma once
+
+#include "CLEntity.h"
+#include "../ResourceManager/CLResourceMesh.h"
+
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+namespace CLE {
+    //! Paquetes dibujados y cambios de estado de OpenGL en la ultima pasada principal
+    struct CLRenderQueueStats {
+        unsigned int packets { 0 };
+        unsigned int programChanges { 0 };
+        unsigned int textureChanges { 0 };
+        unsigned int vaoChanges { 0 };
+    };
+
+    //! Cola de dibujado de la escena
+    //! El recorrido del arbol solo guarda paquetes con lo necesario para dibujar cada submalla,
+    //! se ordenan por pasada, programa, textura y VAO y al dibujarlos se saltan los cambios de estado repetidos.
+    //! Asi las llamadas al driver dependen de los estados distintos de la escena y no del numero de nodos.
+    //! Las entidades que se dibujan solas (particulas, billboards...) van en una pasada posterior en el orden del arbol.
+    class CLRenderQueue {
+        public:
+            //! Pasadas en el orden en que se dibujan
+            enum Pass : uint64_t { OPAQUE_PASS = 0, ENTITY_PASS = 1 };
+
+            //! Vacia la cola, se llama antes de recorrer el arbol
+            void Clear() { packets.clear(); };
+            //! Añade una submalla a la pasada opaca
+            //! @param program Shader del nodo
+            //! @param mesh Submalla con su VAO y sus texturas
+            //! @param model Matriz modelo del nodo, tiene que seguir viva hasta Submit
+            //! @param position Traslacion global del nodo
+            void AddMesh(GLuint program, const Mesh& mesh, const glm::mat4& model, const glm::vec3& position);
+            //! Añade una submalla a la pasada de sombras, solo se ordena por VAO
+            void AddDepthMesh(const Mesh& mesh, const glm::mat4& model);
+            //! Añade una entidad que se dibuja a si misma, mantiene el orden en que se añade
+            void AddEntity(GLuint program, CLEntity* entity, const glm::mat4& model, const glm::vec3& position);
+            //! Ordena los paquetes por su clave
+            void Sort();
+            //! Dibuja la pasada principal
+            //! @param VPmatrix Matriz projection * view de la camara
+            void Submit(const glm::mat4& VPmatrix);
+            //! Dibuja la pasada de sombras con el programa de profundidad, que tiene que estar en uso
+            //! @param program Shader de profundidad
+            //! @param lightSpaceMatrix Matriz de la luz de la cascada
+            void SubmitDepth(GLuint program, const glm::mat4& lightSpaceMatrix);
+            //! @returns CLRenderQueueStats contadores del ultimo Submit
+            const CLRenderQueueStats& GetStats() const { return stats; };
+
+        private:
+            //! Lo minimo para dibujar una submalla o una entidad, mesh es nullptr en las entidades
+            struct Packet {
+                uint64_t key { 0 };
+                GLuint program { 0 };
+                const Mesh* mesh { nullptr };
+                CLEntity* entity { nullptr };
+                const glm::mat4* model { nullptr };
+                const glm::vec3* position { nullptr };
+            };
+
+            //! Uniforms de un programa, se buscan una sola vez
+            //! samplerUnits guarda la unidad asignada a cada sampler del material para no repetirla,
+            //! prepared dice si ya se han puesto en este Submit
+            struct ProgramState {
+                GLint model { -1 };
+                GLint MVP { -1 };
+                GLint position { -1 };
+                GLint lightSpaceModel { -1 };
+                GLint depthMap { -1 };
+                std::array<GLint, 4> samplers {};
+                std::array<int, 4> samplerUnits {};
+                bool prepared { false };
+            };
+
+            static uint64_t MakeKey(uint64_t pass, GLuint program, GLuint texture, GLuint vao);
+            ProgramState& GetProgramState(GLuint program);
+
+            //! Texturas que se siguen de cada unidad, las mallas no usan mas
+            static constexpr unsigned int maxTextureUnits { 8 };
+            //! Valor de un estado que no se conoce, despues de que una entidad se dibuje sola
+            static constexpr GLuint unknownState { ~0u };
+
+            std::vector<Packet> packets;
+            std::unordered_map<GLuint, ProgramState> programs;
+            CLRenderQueueStats stats;
+    };
+}
@@ -17,29 +17,163 @@
  
  #include "CLShadowMapping.h"
 
+#include <algorithm>
+#include <cmath>
+#include <glm/gtc/matrix_transform.hpp>
+
 using namespace CLE;
 
 
 // url: https://learnopengl.com/Advanced-Lighting/Shadows/Shadow-Mapping
-CLShadowMapping::CLShadowMapping(GLuint _lightId) : CLEntity(_lightId){
-    glGenFramebuffers(1, &depthMapFBO);
-    // create depth texture
-    glGenTextures(1, &depthMap);
-    glBindTexture(GL_TEXTURE_2D, depthMap);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, SHADOW_WIDTH, SHADOW_HEIGHT, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+// url: https://learnopengl.com/Guest-Articles/2021/CSM
+CLShadowMapping::CLShadowMapping(GLuint _lightId, CLShadowQuality _quality) : CLEntity(_lightId){
+    SetQuality(_quality);
+}
+
+CLShadowMapping::~CLShadowMapping(){
+    DeleteMaps();
+}
+
+/**
+ * Cada calidad fija el numero de cascadas y la resolucion de cada capa.
+ */
+void CLShadowMapping::SetQuality(CLShadowQuality q){
+    // Se borran con el numero de cascadas con el que se crearon
+    DeleteMaps();
+    quality = q;
+    switch(quality){
+        case SHADOW_LOW:    numCascades = 1; SHADOW_WIDTH = SHADOW_HEIGHT = 1024; break;
+        case SHADOW_MEDIUM: numCascades = 2; SHADOW_WIDTH = SHADOW_HEIGHT = 1024; break;
+        case SHADOW_HIGH:   numCascades = 4; SHADOW_WIDTH = SHADOW_HEIGHT = 2048; break;
+    }
+    CreateMaps();
+    InvalidateStaticCache();
+}
+
+void CLShadowMapping::CreateMaps(){
     float borderColor[] = { 1.0f, 1.0f, 1.0f, 1.0f };
-    glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);  
-    // attach depth texture as FBO's depth buffer
-    glBindFramebuffer(GL_FRAMEBUFFER, depthMapFBO);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, depthMap, 0);
-    glDrawBuffer(GL_NONE);
-    glReadBuffer(GL_NONE);
+    // create depth textures, el depth map final y la cache de los estaticos
+    for(auto texture : { &cascadeDepthMap, &staticDepthMap }){
+        glGenTextures(1, texture);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, *texture);
+        glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_DEPTH_COMPONENT32F, SHADOW_WIDTH, SHADOW_HEIGHT, numCascades, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+        glTexParameterfv(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BORDER_COLOR, borderColor);
+    }
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+    // attach depth texture as FBO's depth buffer, un framebuffer por capa
+    glGenFramebuffers(numCascades, depthMapFBO.data());
+    glGenFramebuffers(numCascades, staticMapFBO.data());
+    for(unsigned int i = 0; i < numCascades; ++i){
+        glBindFramebuffer(GL_FRAMEBUFFER, depthMapFBO[i]);
+        glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, cascadeDepthMap, 0, i);
+        glDrawBuffer(GL_NONE);
+        glReadBuffer(GL_NONE);
+        glBindFramebuffer(GL_FRAMEBUFFER, staticMapFBO[i]);
+        glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, staticDepthMap, 0, i);
+        glDrawBuffer(GL_NONE);
+        glReadBuffer(GL_NONE);
+    }
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    depthMap = cascadeDepthMap;
+}
 
+void CLShadowMapping::DeleteMaps(){
+    if(cascadeDepthMap){
+        glDeleteFramebuffers(numCascades, depthMapFBO.data());
+        glDeleteFramebuffers(numCascades, staticMapFBO.data());
+        glDeleteTextures(1, &cascadeDepthMap);
+        glDeleteTextures(1, &staticDepthMap);
+        // Si se ha creado otro shadow mapping el depth map de las mallas ya es el suyo
+        if(depthMap == cascadeDepthMap){
+            depthMap = 0;
+        }
+        depthMapFBO.fill(0);
+        staticMapFBO.fill(0);
+        cascadeDepthMap = 0;
+        staticDepthMap = 0;
+    }
+}
+
+/**
+ * Divide la distancia de sombras entre las cascadas mezclando un reparto logaritmico y uno lineal,
+ * y encierra cada tramo del frustum de la camara en una esfera para que el tamaño no cambie al girar.
+ * El centro se mueve en pasos de un cuarto de la cascada, asi la matriz de la luz solo cambia cuando
+ * la camara se desplaza bastante y la cache de los estaticos se puede reutilizar. La proyeccion se
+ * agranda un tercio para que la esfera siga dentro aunque el centro este ajustado al paso.
+ */
+void CLShadowMapping::UpdateCascades(const glm::mat4& view, const glm::mat4& projection, float cameraNear, float cameraFar, const glm::vec3& lightDir){
+    const float lambda = 0.5f;
+    float distance = std::min(cameraFar, shadowDistance);
+
+    // Esquinas del frustum de la camara en coordenadas globales, las 4 del near y las 4 del far
+    glm::mat4 inverseVP = glm::inverse(projection * view);
+    glm::vec3 nearCorners[4], farCorners[4];
+    for(int i = 0; i < 4; ++i){
+        float x = (i & 1) ? 1.0f : -1.0f;
+        float y = (i & 2) ? 1.0f : -1.0f;
+        glm::vec4 n = inverseVP * glm::vec4(x, y, -1.0f, 1.0f);
+        glm::vec4 f = inverseVP * glm::vec4(x, y, 1.0f, 1.0f);
+        nearCorners[i] = glm::vec3(n) / n.w;
+        farCorners[i] = glm::vec3(f) / f.w;
+    }
+
+    glm::vec3 up = (std::abs(lightDir.y) > 0.99f) ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+    glm::mat4 lightRotation = glm::lookAt(glm::vec3(0.0f), lightDir, up);
+    glm::mat4 inverseLightRotation = glm::inverse(lightRotation);
+
+    float splitNear = cameraNear;
+    for(unsigned int c = 0; c < numCascades; ++c){
+        float p = float(c + 1) / numCascades;
+        float logSplit = cameraNear * std::pow(distance / cameraNear, p);
+        float linearSplit = cameraNear + (distance - cameraNear) * p;
+        float splitFar = lambda * logSplit + (1.0f - lambda) * linearSplit;
+        cascadeFar[c] = splitFar;
+
+        // Las aristas del frustum son rectas, la profundidad avanza lineal entre el near y el far
+        glm::vec3 corners[8];
+        glm::vec3 center(0.0f);
+        float t0 = (splitNear - cameraNear) / (cameraFar - cameraNear);
+        float t1 = (splitFar - cameraNear) / (cameraFar - cameraNear);
+        for(int i = 0; i < 4; ++i){
+            corners[i] = nearCorners[i] + (farCorners[i] - nearCorners[i]) * t0;
+            corners[i + 4] = nearCorners[i] + (farCorners[i] - nearCorners[i]) * t1;
+        }
+        for(const auto& corner : corners){
+            center += corner / 8.0f;
+        }
+        float radius = 0.0f;
+        for(const auto& corner : corners){
+            radius = std::max(radius, glm::length(corner - center));
+        }
+        radius = std::ceil(radius);
+
+        // Paso de un cuarto de la proyeccion, es un numero entero de texels
+        float halfSize = radius * 4.0f / 3.0f;
+        float step = halfSize / 4.0f;
+        glm::vec3 lightCenter = glm::vec3(lightRotation * glm::vec4(center, 1.0f));
+        lightCenter.x = std::floor(lightCenter.x / step) * step;
+        lightCenter.y = std::floor(lightCenter.y / step) * step;
+        lightCenter.z = std::floor(lightCenter.z / step) * step;
+        center = glm::vec3(inverseLightRotation * glm::vec4(lightCenter, 1.0f));
+
+        glm::vec3 eye = center - lightDir * (depthRange * 0.5f);
+        glm::mat4 lightProjection = glm::ortho(-halfSize, halfSize, -halfSize, halfSize, 1.0f, depthRange);
+        glm::mat4 lightView = glm::lookAt(eye, center, up);
+        lightSpaceMatrices[c] = lightProjection * lightView;
+
+        splitNear = splitFar;
+    }
+}
+
+void CLShadowMapping::CopyStaticCache(unsigned int i){
+    glCopyImageSubData(staticDepthMap, GL_TEXTURE_2D_ARRAY, 0, 0, 0, i
+        , cascadeDepthMap, GL_TEXTURE_2D_ARRAY, 0, 0, 0, i
+        , SHADOW_WIDTH, SHADOW_HEIGHT, 1);
 }
 
 
@@ -49,4 +183,4 @@ void CLShadowMapping::Draw(GLuint shaderID){
 
 void CLShadowMapping::DrawDepthMap(GLuint shaderID){
 
-}
+}
\ No newline at end of file
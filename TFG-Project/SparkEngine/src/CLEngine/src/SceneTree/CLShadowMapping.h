@@ -18,23 +18,100 @@
 
 #include "CLEntity.h"
 
+#include <array>
+#include <glm/glm.hpp>
+
 namespace CLE {
+    //! Calidad de las sombras, cambia el numero de cascadas y la resolucion de cada una
+    enum CLShadowQuality{ SHADOW_LOW = 0, SHADOW_MEDIUM = 1, SHADOW_HIGH = 2 };
+
     //! Clase para añadir sombras en el motor
+    //! El depth map es un array de texturas con una cascada por capa, cada una ajustada a un tramo del frustum de la camara.
+    //! Los nodos estaticos se renderizan en una cache aparte que solo se repite cuando cambian ellos o la cascada,
+    //! cada frame se copia la cache y encima se dibujan solo los nodos dinamicos.
     class CLShadowMapping : public CLEntity {
         public:
-            CLShadowMapping(GLuint _lightId);
-            ~CLShadowMapping() {};
+            static const unsigned int MAX_CASCADES = 4;
+
+            CLShadowMapping(GLuint _lightId, CLShadowQuality _quality = SHADOW_MEDIUM);
+            ~CLShadowMapping();
 
             //void PrepareToRender();
             void Draw(GLuint shaderID) override;
             void DrawDepthMap(GLuint shaderID) override;
 
+            //! Cambia la calidad y vuelve a crear los mapas
+            //! @param q Calidad de las sombras
+            void SetQuality(CLShadowQuality q);
+            //! Devuelve la calidad de las sombras
+            //! @returns quality
+            CLShadowQuality GetQuality() const { return quality; }
+            //! Asigna la distancia a la camara hasta la que llegan las sombras
+            //! @param d Distancia maxima
+            void SetShadowDistance(float d) { shadowDistance = d; }
+            //! Activa o desactiva la cache de los nodos estaticos
+            //! @param c Si se reutiliza la profundidad de los nodos estaticos
+            void SetStaticCache(bool c) { staticCache = c; InvalidateStaticCache(); }
+            //! Devuelve si la cache de los nodos estaticos esta activada
+            //! @returns staticCache
+            bool GetStaticCache() const { return staticCache; }
+
+            //! Ajusta las cascadas al frustum de la camara
+            //! @param view Matriz view de la camara
+            //! @param projection Matriz projection de la camara
+            //! @param cameraNear Distancia al plano near de la camara
+            //! @param cameraFar Distancia al plano far de la camara
+            //! @param lightDir Direccion de la luz
+            void UpdateCascades(const glm::mat4& view, const glm::mat4& projection, float cameraNear, float cameraFar, const glm::vec3& lightDir);
+            //! Devuelve el numero de cascadas
+            //! @returns numCascades
+            unsigned int GetNumCascades() const { return numCascades; }
+            //! Devuelve la matriz de la luz de una cascada
+            //! @param i Cascada
+            //! @returns lightSpaceMatrix Matriz projection * view de la luz
+            const glm::mat4& GetLightSpaceMatrix(unsigned int i) const { return lightSpaceMatrices[i]; }
+            //! Devuelve la distancia a la camara donde acaba una cascada
+            //! @param i Cascada
+            //! @returns cascadeFar Distancia del final de la cascada
+            float GetCascadeFar(unsigned int i) const { return cascadeFar[i]; }
+
+            //! Devuelve si la cache de los nodos estaticos de una cascada sigue sirviendo
+            //! @param i Cascada
+            //! @returns bool Si no hace falta volver a renderizar los nodos estaticos
+            bool IsStaticCacheValid(unsigned int i) const { return staticValid[i] && staticMatrices[i] == lightSpaceMatrices[i]; }
+            //! Marca la cache de una cascada como renderizada con la matriz actual
+            //! @param i Cascada
+            void ValidateStaticCache(unsigned int i) { staticValid[i] = true; staticMatrices[i] = lightSpaceMatrices[i]; }
+            //! Obliga a renderizar de nuevo los nodos estaticos en todas las cascadas
+            void InvalidateStaticCache() { staticValid.fill(false); }
+            //! Copia la cache de los nodos estaticos al depth map de una cascada
+            //! @param i Cascada
+            void CopyStaticCache(unsigned int i);
+
             // variables
             //GLuint lightId = 0;
-            unsigned int depthMapFBO;
-            static inline unsigned int depthMap;
-            const unsigned int SHADOW_WIDTH = 1024;
-            const unsigned int SHADOW_HEIGHT = 1024;
-                  
+            std::array<unsigned int, MAX_CASCADES> depthMapFBO {};
+            std::array<unsigned int, MAX_CASCADES> staticMapFBO {};
+            static inline unsigned int depthMap;   // depth map que leen las mallas, el del ultimo shadow mapping creado
+            unsigned int cascadeDepthMap { 0 };
+            unsigned int staticDepthMap { 0 };
+            unsigned int SHADOW_WIDTH = 1024;
+            unsigned int SHADOW_HEIGHT = 1024;
+
+        private:
+            //! Crea los arrays de texturas y los framebuffers de cada cascada
+            void CreateMaps();
+            //! Borra los arrays de texturas y los framebuffers
+            void DeleteMaps();
+
+            CLShadowQuality quality { SHADOW_MEDIUM };
+            unsigned int numCascades { 1 };
+            float shadowDistance { 3000.0f };  // distancia a la camara hasta la que hay sombras
+            float depthRange { 5000.0f };      // profundidad de la proyeccion de la luz
+            bool staticCache { true };
+            std::array<glm::mat4, MAX_CASCADES> lightSpaceMatrices {};
+            std::array<float, MAX_CASCADES> cascadeFar {};
+            std::array<glm::mat4, MAX_CASCADES> staticMatrices {};
+            std::array<bool, MAX_CASCADES> staticValid {};
     };
 }
\ No newline at end of file
@@ -16,6 +16,7 @@
  
  
  #include "CLSkybox.h"
+#include "../ResourceManager/CLResourceManager.h"
 
 using namespace CLE;
 
@@ -32,27 +33,28 @@ CLSkybox::CLSkybox(string right, string left, string top, string bottom, string
         front,
         back
     };
+    // Las seis caras se leen a la vez en el pool de carga, aqui solo se espera y se suben
+    // El skybox no usa mipmaps, de la cache solo se guarda el primer nivel
+    auto& loader = CLResourceManager::GetResourceManager()->GetLoader();
+    vector<std::future<std::unique_ptr<CLTextureData>>> faces;
+    for(const auto& face : textures_faces){
+        faces.push_back(loader.Submit([face]() { return CLTextureData::Load(face, false); }));
+    }
+
     glGenTextures(1, &skyboxID);
     glBindTexture(GL_TEXTURE_CUBE_MAP, skyboxID);
 
-    int width, height, nrChannels;
-    //stbi_set_flip_vertically_on_load(false);
-    unsigned char *data;  
     for(GLuint i = 0; i < textures_faces.size(); i++)
     {
-        data = SOIL_load_image(textures_faces[i].c_str(), &width, &height, &nrChannels, 0);
+        auto image = faces[i].get();
 
-        if(data){
-            glTexImage2D(
-                GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 
-                0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data
-            );
-            SOIL_free_image_data(data);
+        if(image){
+            image->Upload(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i);
         }else{
             std::cout << "Cubemap texture failed to load at path: " << textures_faces[i] << std::endl;
-            SOIL_free_image_data(data);
         }
     }
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAX_LEVEL, 0);
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);